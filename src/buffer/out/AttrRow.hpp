@@ -66,8 +66,17 @@ public:
 
 private:
     std::vector<TextAttributeRun> _list;
+
+    // The column just past the end of each run in _list, so that the run
+    // covering a column can be found with a binary search.
+    std::vector<size_t> _runEnds;
+
     size_t _cchRowWidth;
 
+    size_t _GetRunStart(const size_t runIndex) const;
+    void _RefreshRunEnds();
+    void _SpliceRuns(const size_t first, const size_t last, const gsl::span<const TextAttributeRun> runs);
+
 #ifdef UNIT_TESTING
     friend class AttrRowTests;
 #endif
@@ -99,58 +99,97 @@ const TextAttribute& AttrRowIterator::operator*() const
     return _run->GetAttributes();
 }
 
+// Routine Description:
+// - gets the column of the row that the iterator points to
+// Return Value:
+// - the column. This is the width of the row for the end iterator.
+size_t AttrRowIterator::_getColumn() const
+{
+    const auto runIndex = gsl::narrow_cast<size_t>(_run - _pAttrRow->_list.cbegin());
+    return _pAttrRow->_GetRunStart(runIndex) + _currentAttributeIndex;
+}
+
+// Routine Description:
+// - points the iterator at the given column, finding its run with a binary search
+// Arguments:
+// - column - the column to move to. The width of the row moves to the end.
+void AttrRowIterator::_moveToColumn(const size_t column)
+{
+    if (column >= _pAttrRow->_cchRowWidth)
+    {
+        _setToEnd();
+        return;
+    }
+
+    const auto runIndex = _pAttrRow->FindAttrIndex(column, nullptr);
+    _run = _pAttrRow->_list.cbegin() + runIndex;
+    _currentAttributeIndex = column - _pAttrRow->_GetRunStart(runIndex);
+}
+
 // Routine Description:
 // - increments the index the iterator points to
+// - Moving within the run or onto the next one is done in place. Anything
+//   further looks the run up instead of walking over the ones in between.
 // Arguments:
 // - count - the amount to increment by
 void AttrRowIterator::_increment(size_t count)
 {
-    while (count > 0)
+    if (count == 0 || _run >= _pAttrRow->_list.cend())
     {
-        const size_t runLength = _run->GetLength();
-        if (count + _currentAttributeIndex < runLength)
-        {
-            _currentAttributeIndex += count;
-            return;
-        }
-        else
-        {
-            count -= runLength - _currentAttributeIndex;
-            ++_run;
-            _currentAttributeIndex = 0;
-        }
+        return;
+    }
+
+    const size_t remaining = _run->GetLength() - _currentAttributeIndex;
+    if (count < remaining)
+    {
+        _currentAttributeIndex += count;
+    }
+    else if (count == remaining)
+    {
+        ++_run;
+        _currentAttributeIndex = 0;
+    }
+    else
+    {
+        _moveToColumn(_getColumn() + count);
     }
 }
 
 // Routine Description:
 // - decrements the index the iterator points to
+// - Moving within the run or onto the end of the previous one is done in
+//   place. Anything further looks the run up.
 // Arguments:
 // - count - the amount to decrement by
 void AttrRowIterator::_decrement(size_t count)
 {
-    while (count > 0)
+    // If there's still space within this color attribute to move left, do so.
+    if (count <= _currentAttributeIndex)
     {
-        // If there's still space within this color attribute to move left, do so.
-        if (count <= _currentAttributeIndex)
-        {
-            _currentAttributeIndex -= count;
-            return;
-        }
-        // If there's not space, move to the previous attribute run
-        // We'll walk through above on the if branch to move left further (if necessary)
-        else
+        _currentAttributeIndex -= count;
+        return;
+    }
+
+    // make sure we don't go out of bounds
+    const auto column = _getColumn();
+    if (count > column)
+    {
+        _exceeded = true;
+        return;
+    }
+
+    if (count == _currentAttributeIndex + 1)
+    {
+        const auto prev = std::prev(_run);
+        if (prev->GetLength() > 0)
         {
-            // make sure we don't go out of bounds
-            if (_run == _pAttrRow->_list.cbegin())
-            {
-                _exceeded = true;
-                return;
-            }
-            count -= _currentAttributeIndex + 1;
-            --_run;
+            _run = prev;
             _currentAttributeIndex = _run->GetLength() - 1;
+            return;
         }
     }
+
+    _moveToColumn(column - count);
 }
 
 // Routine Description:
@@ -56,6 +56,8 @@ private:
     size_t _currentAttributeIndex; // index of TextAttribute within the current TextAttributeRun
     bool _exceeded;
 
+    size_t _getColumn() const;
+    void _moveToColumn(const size_t column);
     void _increment(size_t count);
     void _decrement(size_t count);
     void _setToEnd() noexcept;
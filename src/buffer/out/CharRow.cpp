@@ -7,6 +7,149 @@
 #include "unicode.hpp"
 #include "Row.hpp"
 
+#include <intrin.h>
+
+#pragma warning(disable : 26429 26481 26490)
+
+namespace
+{
+    // Routine Description:
+    // - finds the first character in the given range that isn't a space.
+    //   Compares 8 characters at a time where SSE2 is available.
+    // Arguments:
+    // - chars - the characters to search
+    // - count - the number of characters
+    // Return Value:
+    // - the index of the first non-space character, or count if there is none
+    size_t FindFirstNonSpace(const wchar_t* const chars, const size_t count) noexcept
+    {
+        size_t i = 0;
+#if defined(_M_IX86) || defined(_M_X64)
+        const auto spaces = _mm_set1_epi16(UNICODE_SPACE);
+        for (; i + 8 <= count; i += 8)
+        {
+            const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + i));
+            const auto mask = static_cast<unsigned long>(_mm_movemask_epi8(_mm_cmpeq_epi16(block, spaces))) ^ 0xffff;
+            unsigned long index;
+            if (_BitScanForward(&index, mask))
+            {
+                return i + index / 2;
+            }
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            if (chars[i] != UNICODE_SPACE)
+            {
+                break;
+            }
+        }
+        return i;
+    }
+
+    // Routine Description:
+    // - finds the last character in the given range that isn't a space.
+    //   Compares 8 characters at a time where SSE2 is available.
+    // Arguments:
+    // - chars - the characters to search
+    // - count - the number of characters
+    // Return Value:
+    // - one past the index of the last non-space character, or 0 if there is none
+    size_t FindEndOfNonSpace(const wchar_t* const chars, const size_t count) noexcept
+    {
+        auto i = count;
+#if defined(_M_IX86) || defined(_M_X64)
+        const auto spaces = _mm_set1_epi16(UNICODE_SPACE);
+        for (; i >= 8; i -= 8)
+        {
+            const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + i - 8));
+            const auto mask = static_cast<unsigned long>(_mm_movemask_epi8(_mm_cmpeq_epi16(block, spaces))) ^ 0xffff;
+            unsigned long index;
+            if (_BitScanReverse(&index, mask))
+            {
+                return i - 8 + index / 2 + 1;
+            }
+        }
+#endif
+        for (; i > 0; --i)
+        {
+            if (chars[i - 1] != UNICODE_SPACE)
+            {
+                break;
+            }
+        }
+        return i;
+    }
+
+    // Routine Description:
+    // - finds the lowest bit that is set
+    // Arguments:
+    // - bits - the bits to search. At least one of them must be set.
+    // Return Value:
+    // - the index of the lowest set bit
+    size_t LowestBit(const uint64_t bits) noexcept
+    {
+        unsigned long index;
+#if defined(_M_X64) || defined(_M_ARM64)
+        _BitScanForward64(&index, bits);
+#else
+        if (!_BitScanForward(&index, static_cast<unsigned long>(bits)))
+        {
+            _BitScanForward(&index, static_cast<unsigned long>(bits >> 32));
+            index += 32;
+        }
+#endif
+        return index;
+    }
+
+    // Routine Description:
+    // - finds the highest bit that is set
+    // Arguments:
+    // - bits - the bits to search. At least one of them must be set.
+    // Return Value:
+    // - the index of the highest set bit
+    size_t HighestBit(const uint64_t bits) noexcept
+    {
+        unsigned long index;
+#if defined(_M_X64) || defined(_M_ARM64)
+        _BitScanReverse64(&index, bits);
+#else
+        if (_BitScanReverse(&index, static_cast<unsigned long>(bits >> 32)))
+        {
+            index += 32;
+        }
+        else
+        {
+            _BitScanReverse(&index, static_cast<unsigned long>(bits));
+        }
+#endif
+        return index;
+    }
+
+    // Routine Description:
+    // - hands out a generation that no row has had before, so that two rows
+    //   with the same generation hold the same characters. Each thread takes
+    //   a block of them at a time, so writers don't contend for the counter.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - the new generation
+    uint64_t NextGeneration() noexcept
+    {
+        static constexpr uint64_t blockSize = 1 << 16;
+        static std::atomic<uint64_t> nextBlock{ 1 };
+        thread_local uint64_t next = 0;
+        thread_local uint64_t end = 0;
+
+        if (next == end)
+        {
+            next = nextBlock.fetch_add(blockSize, std::memory_order_relaxed);
+            end = next + blockSize;
+        }
+        return next++;
+    }
+}
+
 // Routine Description:
 // - constructor
 // Arguments:
@@ -18,7 +161,15 @@
 CharRow::CharRow(size_t rowWidth, ROW* const pParent) :
     _wrapForced{ false },
     _doubleBytePadded{ false },
-    _data(rowWidth, value_type()),
+    _chars(rowWidth, UNICODE_SPACE),
+    _dbcsAttrs(rowWidth),
+    _left{ rowWidth },
+    _right{ 0 },
+    _extentsKnown{ true },
+    _generation{ NextGeneration() },
+    _classBits{},
+    _classBitsGeneration{ 0 },
+    _classBitsClassifierId{ 0 },
     _pParent{ FAIL_FAST_IF_NULL(pParent) }
 {
 }
@@ -75,7 +226,7 @@ bool CharRow::WasDoubleBytePadded() const noexcept
 // - the size of the row
 size_t CharRow::size() const noexcept
 {
-    return _data.size();
+    return _chars.size();
 }
 
 // Routine Description:
@@ -86,10 +237,12 @@ size_t CharRow::size() const noexcept
 // - <none>
 void CharRow::Reset() noexcept
 {
-    for (auto& cell : _data)
-    {
-        cell.Reset();
-    }
+    std::fill(_chars.begin(), _chars.end(), UNICODE_SPACE);
+    std::fill(_dbcsAttrs.begin(), _dbcsAttrs.end(), DbcsAttribute{});
+    _left = _chars.size();
+    _right = 0;
+    _extentsKnown = true;
+    _generation = NextGeneration();
 
     _wrapForced = false;
     _doubleBytePadded = false;
@@ -105,32 +258,49 @@ void CharRow::Reset() noexcept
 {
     try
     {
-        const value_type insertVals;
-        _data.resize(newSize, insertVals);
+        _chars.resize(newSize, UNICODE_SPACE);
+        _dbcsAttrs.resize(newSize);
     }
     CATCH_RETURN();
 
+    _generation = NextGeneration();
+
+    // Cells added on the right are spaces. Cells cut off on the right may
+    // have held the last of the text.
+    if (_right > newSize)
+    {
+        _right = FindEndOfNonSpace(_chars.data(), newSize);
+    }
+    if (_right == 0)
+    {
+        _left = newSize;
+    }
+
     return S_OK;
 }
 
-typename CharRow::iterator CharRow::begin() noexcept
+gsl::span<wchar_t> CharRow::Chars() noexcept
 {
-    return _data.begin();
+    _extentsKnown = false;
+    _generation = NextGeneration();
+    return { _chars.data(), _chars.size() };
 }
 
-typename CharRow::const_iterator CharRow::cbegin() const noexcept
+gsl::span<const wchar_t> CharRow::Chars() const noexcept
 {
-    return _data.cbegin();
+    return { _chars.data(), _chars.size() };
 }
 
-typename CharRow::iterator CharRow::end() noexcept
+gsl::span<DbcsAttribute> CharRow::DbcsAttrs() noexcept
 {
-    return _data.end();
+    // Whether a glyph is stored decides which character it's classified by.
+    _generation = NextGeneration();
+    return { _dbcsAttrs.data(), _dbcsAttrs.size() };
 }
 
-typename CharRow::const_iterator CharRow::cend() const noexcept
+gsl::span<const DbcsAttribute> CharRow::DbcsAttrs() const noexcept
 {
-    return _data.cend();
+    return { _dbcsAttrs.data(), _dbcsAttrs.size() };
 }
 
 // Routine Description:
@@ -141,12 +311,8 @@ typename CharRow::const_iterator CharRow::cend() const noexcept
 // - The calculated left boundary of the internal string.
 size_t CharRow::MeasureLeft() const
 {
-    std::vector<value_type>::const_iterator it = _data.cbegin();
-    while (it != _data.cend() && it->IsSpace())
-    {
-        ++it;
-    }
-    return it - _data.cbegin();
+    _EnsureExtents();
+    return _left;
 }
 
 // Routine Description:
@@ -157,17 +323,28 @@ size_t CharRow::MeasureLeft() const
 // - The calculated right boundary of the internal string.
 size_t CharRow::MeasureRight() const noexcept
 {
-    std::vector<value_type>::const_reverse_iterator it = _data.crbegin();
-    while (it != _data.crend() && it->IsSpace())
-    {
-        ++it;
-    }
-    return _data.crend() - it;
+    _EnsureExtents();
+    return _right;
+}
+
+// Routine Description:
+// - Gets the generation of the characters of this row. It changes whenever
+//   they do, and no other row has the same one unless it holds the same
+//   characters, so it can be used to key what's cached from them.
+// Arguments:
+// - <none>
+// Return Value:
+// - The generation of the characters.
+uint64_t CharRow::GetGeneration() const noexcept
+{
+    return _generation;
 }
 
 void CharRow::ClearCell(const size_t column)
 {
-    _data.at(column).Reset();
+    _chars.at(column) = UNICODE_SPACE;
+    _dbcsAttrs.at(column).Reset();
+    _CharsChanged(column, column + 1);
 }
 
 // Routine Description:
@@ -178,14 +355,7 @@ void CharRow::ClearCell(const size_t column)
 // - True if there is valid text in this row. False otherwise.
 bool CharRow::ContainsText() const noexcept
 {
-    for (const value_type& cell : _data)
-    {
-        if (!cell.IsSpace())
-        {
-            return true;
-        }
-    }
-    return false;
+    return MeasureRight() != 0;
 }
 
 // Routine Description:
@@ -197,7 +367,7 @@ bool CharRow::ContainsText() const noexcept
 // Note: will throw exception if column is out of bounds
 const DbcsAttribute& CharRow::DbcsAttrAt(const size_t column) const
 {
-    return _data.at(column).DbcsAttr();
+    return _dbcsAttrs.at(column);
 }
 
 // Routine Description:
@@ -209,7 +379,8 @@ const DbcsAttribute& CharRow::DbcsAttrAt(const size_t column) const
 // Note: will throw exception if column is out of bounds
 DbcsAttribute& CharRow::DbcsAttrAt(const size_t column)
 {
-    return _data.at(column).DbcsAttr();
+    _generation = NextGeneration();
+    return _dbcsAttrs.at(column);
 }
 
 // Routine Description:
@@ -221,7 +392,9 @@ DbcsAttribute& CharRow::DbcsAttrAt(const size_t column)
 // Note: will throw exception if column is out of bounds
 void CharRow::ClearGlyph(const size_t column)
 {
-    _data.at(column).EraseChars();
+    _dbcsAttrs.at(column).SetGlyphStored(false);
+    _chars.at(column) = UNICODE_SPACE;
+    _CharsChanged(column, column + 1);
 }
 
 // Routine Description:
@@ -233,7 +406,7 @@ void CharRow::ClearGlyph(const size_t column)
 // - Note: will throw exception if column is out of bounds
 const CharRow::reference CharRow::GlyphAt(const size_t column) const
 {
-    THROW_HR_IF(E_INVALIDARG, column >= _data.size());
+    THROW_HR_IF(E_INVALIDARG, column >= _chars.size());
     return { const_cast<CharRow&>(*this), column };
 }
 
@@ -246,54 +419,160 @@ const CharRow::reference CharRow::GlyphAt(const size_t column) const
 // - Note: will throw exception if column is out of bounds
 CharRow::reference CharRow::GlyphAt(const size_t column)
 {
-    THROW_HR_IF(E_INVALIDARG, column >= _data.size());
+    THROW_HR_IF(E_INVALIDARG, column >= _chars.size());
     return { *this, column };
 }
 
+// Routine Description:
+// - gets the text of the row. The trailing halves of wide glyphs are skipped.
+// Arguments:
+// - <none>
+// Return Value:
+// - the text of the row
 std::wstring CharRow::GetText() const
 {
     std::wstring wstr;
-    wstr.reserve(_data.size());
+    wstr.reserve(_chars.size());
 
-    for (size_t i = 0; i < _data.size(); ++i)
+    size_t i = 0;
+    while (i < _chars.size())
     {
-        const auto glyph = GlyphAt(i);
-        if (!DbcsAttrAt(i).IsTrailing())
+        // Runs of cells that hold exactly their one character are appended
+        // straight from the character array.
+        auto end = i;
+        while (end < _chars.size() && _dbcsAttrs[end].IsSingle() && !_dbcsAttrs[end].IsGlyphStored())
+        {
+            ++end;
+        }
+        wstr.append(_chars.data() + i, end - i);
+
+        if (end < _chars.size())
         {
-            for (const auto wch : glyph)
+            if (!_dbcsAttrs[end].IsTrailing())
             {
-                wstr.push_back(wch);
+                wstr.append(std::wstring_view{ GlyphAt(end) });
             }
+            ++end;
         }
+        i = end;
     }
     return wstr;
 }
 
+// Routine Description:
+// - writes narrow text into the row, one character per cell, replacing the
+//   glyphs and dbcs attributes of those cells. This is a straight copy into
+//   the row's storage, so the text must not contain wide glyphs or surrogate
+//   pairs. Stored glyphs that are overwritten are left in UnicodeStorage,
+//   the same as when a cell is assigned a single character.
+// Arguments:
+// - column - the column to start writing at
+// - text - the text to write
+// Return Value:
+// - <none>
+// Note: will throw exception if the text doesn't fit in the row
+void CharRow::WriteNarrowText(const size_t column, const std::wstring_view text)
+{
+    THROW_HR_IF(E_INVALIDARG, column > _chars.size() || text.size() > _chars.size() - column);
+
+    std::copy(text.cbegin(), text.cend(), _chars.begin() + column);
+    std::fill_n(_dbcsAttrs.begin() + column, text.size(), DbcsAttribute{});
+    _CharsChanged(column, column + text.size());
+}
+
 // Method Description:
 // - get delimiter class for a position in the char row
 // - used for double click selection and uia word navigation
 // Arguments:
 // - column: column to get text data for
-// - wordDelimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
+// - classifier: the compiled word delimiters
 // Return Value:
 // - the delimiter class for the given char
-const DelimiterClass CharRow::DelimiterClassAt(const size_t column, const std::wstring_view wordDelimiters) const
+const DelimiterClass CharRow::DelimiterClassAt(const size_t column, const DelimiterClassifier& classifier) const
 {
-    THROW_HR_IF(E_INVALIDARG, column >= _data.size());
+    THROW_HR_IF(E_INVALIDARG, column >= _chars.size());
 
-    const auto glyph = *GlyphAt(column).begin();
-    if (glyph <= UNICODE_SPACE)
+    const auto bits = _GetClassBits(classifier, DelimiterClass::RegularChar);
+    if (til::at(bits, column / 64) & (uint64_t{ 1 } << (column % 64)))
     {
-        return DelimiterClass::ControlChar;
+        return DelimiterClass::RegularChar;
     }
-    else if (wordDelimiters.find(glyph) != std::wstring_view::npos)
+    return classifier.Classify(*GlyphAt(column).begin());
+}
+
+// Method Description:
+// - finds the first column at or after the given one whose delimiter class
+//   is (or isn't) the given one. Whole words of columns are checked at once.
+// Arguments:
+// - column: the column to start at
+// - classifier: the compiled word delimiters
+// - delimiterClass: the delimiter class to look for
+// - equal: true to look for a column of that class, false for one of any other class
+// Return Value:
+// - the column found, or nullopt if there's none up to the end of the row
+std::optional<size_t> CharRow::FindDelimiterClass(const size_t column,
+                                                  const DelimiterClassifier& classifier,
+                                                  const DelimiterClass delimiterClass,
+                                                  const bool equal) const
+{
+    THROW_HR_IF(E_INVALIDARG, column >= _chars.size());
+
+    const auto bits = _GetClassBits(classifier, delimiterClass);
+    const auto flip = equal ? uint64_t{ 0 } : ~uint64_t{ 0 };
+    const auto words = (_chars.size() + 63) / 64;
+
+    auto word = column / 64;
+    auto candidates = (til::at(bits, word) ^ flip) & (~uint64_t{ 0 } << (column % 64));
+    while (candidates == 0)
     {
-        return DelimiterClass::DelimiterChar;
+        if (++word == words)
+        {
+            return std::nullopt;
+        }
+        candidates = til::at(bits, word) ^ flip;
     }
-    else
+
+    // The bits past the end of the row are clear, so when looking for another
+    // class they're set, and must not be mistaken for columns.
+    const auto found = word * 64 + LowestBit(candidates);
+    if (found >= _chars.size())
     {
-        return DelimiterClass::RegularChar;
+        return std::nullopt;
     }
+    return found;
+}
+
+// Method Description:
+// - finds the last column at or before the given one whose delimiter class
+//   is (or isn't) the given one. Whole words of columns are checked at once.
+// Arguments:
+// - column: the column to start at
+// - classifier: the compiled word delimiters
+// - delimiterClass: the delimiter class to look for
+// - equal: true to look for a column of that class, false for one of any other class
+// Return Value:
+// - the column found, or nullopt if there's none down to the start of the row
+std::optional<size_t> CharRow::FindDelimiterClassBackward(const size_t column,
+                                                          const DelimiterClassifier& classifier,
+                                                          const DelimiterClass delimiterClass,
+                                                          const bool equal) const
+{
+    THROW_HR_IF(E_INVALIDARG, column >= _chars.size());
+
+    const auto bits = _GetClassBits(classifier, delimiterClass);
+    const auto flip = equal ? uint64_t{ 0 } : ~uint64_t{ 0 };
+
+    auto word = column / 64;
+    auto candidates = (til::at(bits, word) ^ flip) & (~uint64_t{ 0 } >> (63 - column % 64));
+    while (candidates == 0)
+    {
+        if (word-- == 0)
+        {
+            return std::nullopt;
+        }
+        candidates = til::at(bits, word) ^ flip;
+    }
+    return word * 64 + HighestBit(candidates);
 }
 
 UnicodeStorage& CharRow::GetUnicodeStorage() noexcept
@@ -325,3 +604,108 @@ void CharRow::UpdateParent(ROW* const pParent)
 {
     _pParent = FAIL_FAST_IF_NULL(pParent);
 }
+
+// Routine Description:
+// - Records that the characters in the given columns were written.
+// Arguments:
+// - begin - the first column that was written
+// - end - the column just past the last one that was written
+// Return Value:
+// - <none>
+void CharRow::_CharsChanged(const size_t begin, const size_t end) noexcept
+{
+    _generation = NextGeneration();
+    _UpdateExtents(begin, end);
+}
+
+// Routine Description:
+// - Updates the left and right edges of the text after the characters in the
+//   given columns were written. Only those columns are looked at, and the
+//   text between the old edges if one of them was erased.
+// Arguments:
+// - begin - the first column that was written
+// - end - the column just past the last one that was written
+// Return Value:
+// - <none>
+void CharRow::_UpdateExtents(const size_t begin, const size_t end) noexcept
+{
+    if (!_extentsKnown || begin >= end)
+    {
+        return;
+    }
+
+    const auto coversLeft = begin <= _left && _left < end;
+    const auto coversRight = begin < _right && _right <= end;
+
+    const auto data = _chars.data();
+    const auto textLeft = begin + FindFirstNonSpace(data + begin, end - begin);
+    if (textLeft != end)
+    {
+        // If the columns covered an edge, there was no text beyond them on that side.
+        const auto textRight = begin + FindEndOfNonSpace(data + begin, end - begin);
+        _left = coversLeft ? textLeft : std::min(_left, textLeft);
+        _right = coversRight ? textRight : std::max(_right, textRight);
+    }
+    else if (coversLeft && coversRight)
+    {
+        _left = _chars.size();
+        _right = 0;
+    }
+    else if (coversLeft)
+    {
+        // The text now starts at the first character after the columns.
+        _left = end + FindFirstNonSpace(data + end, _right - end);
+    }
+    else if (coversRight)
+    {
+        // The text now ends at the last character before the columns.
+        _right = _left + FindEndOfNonSpace(data + _left, begin - _left);
+    }
+}
+
+// Routine Description:
+// - Measures the left and right edges of the text again, if the characters
+//   were handed out for writing since they were last known.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void CharRow::_EnsureExtents() const noexcept
+{
+    if (!_extentsKnown)
+    {
+        _left = FindFirstNonSpace(_chars.data(), _chars.size());
+        _right = FindEndOfNonSpace(_chars.data(), _chars.size());
+        _extentsKnown = true;
+    }
+}
+
+// Routine Description:
+// - Gets the columns of the given delimiter class, building them for all the
+//   classes if the characters or the classifier changed since they were built.
+// Arguments:
+// - classifier - the compiled word delimiters
+// - delimiterClass - the delimiter class to get the columns of
+// Return Value:
+// - one bit per column, set for the columns of that class. The bits past the
+//   end of the row are clear.
+const uint64_t* CharRow::_GetClassBits(const DelimiterClassifier& classifier, const DelimiterClass delimiterClass) const
+{
+    const auto words = (_chars.size() + 63) / 64;
+
+    if (_classBitsGeneration != _generation || _classBitsClassifierId != classifier.GetId())
+    {
+        _classBits.assign(words * 3, 0);
+        for (size_t column = 0; column < _chars.size(); ++column)
+        {
+            // A stored glyph is classified by its first character.
+            const auto wch = _dbcsAttrs[column].IsGlyphStored() ? *GlyphAt(column).begin() : _chars[column];
+            const auto index = static_cast<size_t>(classifier.Classify(wch)) * words + column / 64;
+            til::at(_classBits, index) |= uint64_t{ 1 } << (column % 64);
+        }
+        _classBitsGeneration = _generation;
+        _classBitsClassifierId = classifier.GetId();
+    }
+
+    return _classBits.data() + static_cast<size_t>(delimiterClass) * words;
+}
@@ -22,18 +22,11 @@ Revision History:
 
 #include "DbcsAttribute.hpp"
 #include "CharRowCellReference.hpp"
-#include "CharRowCell.hpp"
+#include "DelimiterClassifier.hpp"
 #include "UnicodeStorage.hpp"
 
 class ROW;
 
-enum class DelimiterClass
-{
-    ControlChar,
-    DelimiterChar,
-    RegularChar
-};
-
 // the characters of one row of screen buffer
 // we keep the following values so that we don't write
 // more pixels to the screen than we have to:
@@ -44,13 +37,18 @@ enum class DelimiterClass
 //       ^    ^                  ^                     ^
 //       |    |                  |                     |
 //     Chars Left               Right                end of Chars buffer
+//
+// The characters and their dbcs attributes are kept in two separate arrays,
+// so that scanning or copying the text of a row works on contiguous wchar_t.
+// A cell whose glyph is kept in UnicodeStorage holds UNICODE_REPLACEMENT in
+// the character array, so no such cell ever looks like a space.
+//
+// Left and Right are kept up to date as cells are written, so measuring a
+// row doesn't have to scan it.
 class CharRow final
 {
 public:
     using glyph_type = typename wchar_t;
-    using value_type = typename CharRowCell;
-    using iterator = typename std::vector<value_type>::iterator;
-    using const_iterator = typename std::vector<value_type>::const_iterator;
     using reference = typename CharRowCellReference;
 
     CharRow(size_t rowWidth, ROW* const pParent);
@@ -64,25 +62,37 @@ public:
     [[nodiscard]] HRESULT Resize(const size_t newSize) noexcept;
     size_t MeasureLeft() const;
     size_t MeasureRight() const noexcept;
+    uint64_t GetGeneration() const noexcept;
     void ClearCell(const size_t column);
     bool ContainsText() const noexcept;
     const DbcsAttribute& DbcsAttrAt(const size_t column) const;
     DbcsAttribute& DbcsAttrAt(const size_t column);
     void ClearGlyph(const size_t column);
     std::wstring GetText() const;
-
-    const DelimiterClass DelimiterClassAt(const size_t column, const std::wstring_view wordDelimiters) const;
+    void WriteNarrowText(const size_t column, const std::wstring_view text);
+
+    const DelimiterClass DelimiterClassAt(const size_t column, const DelimiterClassifier& classifier) const;
+    std::optional<size_t> FindDelimiterClass(const size_t column,
+                                             const DelimiterClassifier& classifier,
+                                             const DelimiterClass delimiterClass,
+                                             const bool equal) const;
+    std::optional<size_t> FindDelimiterClassBackward(const size_t column,
+                                                     const DelimiterClassifier& classifier,
+                                                     const DelimiterClass delimiterClass,
+                                                     const bool equal) const;
 
     // working with glyphs
     const reference GlyphAt(const size_t column) const;
     reference GlyphAt(const size_t column);
 
-    // iterators
-    iterator begin() noexcept;
-    const_iterator cbegin() const noexcept;
-
-    iterator end() noexcept;
-    const_iterator cend() const noexcept;
+    // direct access to the storage of the row, one element per column.
+    // Writing to it bypasses UnicodeStorage. See the note on the class.
+    // Taking the characters for writing makes the row measure itself again
+    // the next time it's asked, so don't write through them after that.
+    gsl::span<wchar_t> Chars() noexcept;
+    gsl::span<const wchar_t> Chars() const noexcept;
+    gsl::span<DbcsAttribute> DbcsAttrs() noexcept;
+    gsl::span<const DbcsAttribute> DbcsAttrs() const noexcept;
 
     UnicodeStorage& GetUnicodeStorage() noexcept;
     const UnicodeStorage& GetUnicodeStorage() const noexcept;
@@ -101,7 +111,33 @@ protected:
     bool _doubleBytePadded;
 
     // storage for glyph data and dbcs attributes
-    std::vector<value_type> _data;
+    std::vector<wchar_t> _chars;
+    std::vector<DbcsAttribute> _dbcsAttrs;
+
+    // the column of the first character that isn't a space, and the column
+    // just past the last one. An empty row has them at size() and 0.
+    mutable size_t _left;
+    mutable size_t _right;
+    // false when the characters were handed out for writing, and _left and
+    // _right need to be measured again.
+    mutable bool _extentsKnown;
+
+    // changes whenever the characters do, to a value no other row has had, so
+    // that what's cached from them can tell when it's out of date. A copy of
+    // a row keeps it, since it holds the same characters.
+    uint64_t _generation;
+
+    // one bit per column for each delimiter class, built when a word boundary
+    // is first looked for after the characters change. They're one after the
+    // other, in the order of the DelimiterClass values.
+    mutable std::vector<uint64_t> _classBits;
+    mutable uint64_t _classBitsGeneration;
+    mutable uint64_t _classBitsClassifierId;
+
+    void _CharsChanged(const size_t begin, const size_t end) noexcept;
+    void _UpdateExtents(const size_t begin, const size_t end) noexcept;
+    void _EnsureExtents() const noexcept;
+    const uint64_t* _GetClassBits(const DelimiterClassifier& classifier, const DelimiterClass delimiterClass) const;
 
     // ROW that this CharRow belongs to
     ROW* _pParent;
@@ -111,17 +147,14 @@ constexpr bool operator==(const CharRow& a, const CharRow& b) noexcept
 {
     return (a._wrapForced == b._wrapForced &&
             a._doubleBytePadded == b._doubleBytePadded &&
-            a._data == b._data);
+            a._chars == b._chars &&
+            a._dbcsAttrs == b._dbcsAttrs);
 }
 
 template<typename InputIt1, typename InputIt2>
-void OverwriteColumns(InputIt1 startChars, InputIt1 endChars, InputIt2 startAttrs, CharRow::iterator outIt)
+void OverwriteColumns(InputIt1 startChars, InputIt1 endChars, InputIt2 startAttrs, CharRow& charRow, const size_t column)
 {
-    std::transform(startChars,
-                   endChars,
-                   startAttrs,
-                   outIt,
-                   [](const wchar_t wch, const DbcsAttribute attr) {
-                       return CharRow::value_type{ wch, attr };
-                   });
+    const auto count = std::distance(startChars, endChars);
+    std::copy(startChars, endChars, charRow.Chars().begin() + column);
+    std::copy_n(startAttrs, count, charRow.DbcsAttrs().begin() + column);
 }
@@ -4,6 +4,7 @@
 #include "precomp.h"
 #include "UnicodeStorage.hpp"
 #include "CharRow.hpp"
+#include "unicode.hpp"
 
 // Routine Description:
 // - assignment operator. will store extended glyph data in a separate storage location
@@ -14,16 +15,20 @@ void CharRowCellReference::operator=(const std::wstring_view chars)
     THROW_HR_IF(E_INVALIDARG, chars.empty());
     if (chars.size() == 1)
     {
-        _cellData().Char() = chars.front();
-        _cellData().DbcsAttr().SetGlyphStored(false);
+        _char() = chars.front();
+        _dbcsAttr().SetGlyphStored(false);
     }
     else
     {
         auto& storage = _parent.GetUnicodeStorage();
         const auto key = _parent.GetStorageKey(_index);
         storage.StoreGlyph(key, { chars.cbegin(), chars.cend() });
-        _cellData().DbcsAttr().SetGlyphStored(true);
+        // The char row scans its characters without looking at UnicodeStorage,
+        // so a stored glyph must never look like a space there.
+        _char() = UNICODE_REPLACEMENT;
+        _dbcsAttr().SetGlyphStored(true);
     }
+    _parent._CharsChanged(_index, _index + 1);
 }
 
 // Routine Description:
@@ -36,21 +41,39 @@ CharRowCellReference::operator std::wstring_view() const
 }
 
 // Routine Description:
-// - The CharRowCell this object "references"
+// - The character this object "references"
 // Return Value:
-// - ref to the CharRowCell
-CharRowCell& CharRowCellReference::_cellData()
+// - ref to the character in the parent char row
+wchar_t& CharRowCellReference::_char()
 {
-    return _parent._data.at(_index);
+    return _parent._chars.at(_index);
 }
 
 // Routine Description:
-// - The CharRowCell this object "references"
+// - The character this object "references"
 // Return Value:
-// - ref to the CharRowCell
-const CharRowCell& CharRowCellReference::_cellData() const
+// - ref to the character in the parent char row
+const wchar_t& CharRowCellReference::_char() const
 {
-    return _parent._data.at(_index);
+    return _parent._chars.at(_index);
+}
+
+// Routine Description:
+// - The dbcs attribute of the cell this object "references"
+// Return Value:
+// - ref to the dbcs attribute in the parent char row
+DbcsAttribute& CharRowCellReference::_dbcsAttr()
+{
+    return _parent._dbcsAttrs.at(_index);
+}
+
+// Routine Description:
+// - The dbcs attribute of the cell this object "references"
+// Return Value:
+// - ref to the dbcs attribute in the parent char row
+const DbcsAttribute& CharRowCellReference::_dbcsAttr() const
+{
+    return _parent._dbcsAttrs.at(_index);
 }
 
 // Routine Description:
@@ -59,7 +82,7 @@ const CharRowCell& CharRowCellReference::_cellData() const
 // - the glyph data
 std::wstring_view CharRowCellReference::_glyphData() const
 {
-    if (_cellData().DbcsAttr().IsGlyphStored())
+    if (_dbcsAttr().IsGlyphStored())
     {
         const auto& text = _parent.GetUnicodeStorage().GetText(_parent.GetStorageKey(_index));
 
@@ -67,7 +90,7 @@ std::wstring_view CharRowCellReference::_glyphData() const
     }
     else
     {
-        return { &_cellData().Char(), 1 };
+        return { &_char(), 1 };
     }
 }
 
@@ -77,13 +100,13 @@ std::wstring_view CharRowCellReference::_glyphData() const
 // - iterator of the glyph data
 CharRowCellReference::const_iterator CharRowCellReference::begin() const
 {
-    if (_cellData().DbcsAttr().IsGlyphStored())
+    if (_dbcsAttr().IsGlyphStored())
     {
         return _parent.GetUnicodeStorage().GetText(_parent.GetStorageKey(_index)).data();
     }
     else
     {
-        return &_cellData().Char();
+        return &_char();
     }
 }
 
@@ -96,21 +119,21 @@ CharRowCellReference::const_iterator CharRowCellReference::begin() const
 // TODO GH 2672: eliminate using pointers raw as begin/end markers in this class
 CharRowCellReference::const_iterator CharRowCellReference::end() const
 {
-    if (_cellData().DbcsAttr().IsGlyphStored())
+    if (_dbcsAttr().IsGlyphStored())
     {
         const auto& chars = _parent.GetUnicodeStorage().GetText(_parent.GetStorageKey(_index));
         return chars.data() + chars.size();
     }
     else
     {
-        return &_cellData().Char() + 1;
+        return &_char() + 1;
     }
 }
 #pragma warning(pop)
 
 bool operator==(const CharRowCellReference& ref, const std::vector<wchar_t>& glyph)
 {
-    const DbcsAttribute& dbcsAttr = ref._cellData().DbcsAttr();
+    const DbcsAttribute& dbcsAttr = ref._dbcsAttr();
     if (glyph.size() == 1 && dbcsAttr.IsGlyphStored())
     {
         return false;
@@ -121,7 +144,7 @@ bool operator==(const CharRowCellReference& ref, const std::vector<wchar_t>& gly
     }
     else if (glyph.size() == 1 && !dbcsAttr.IsGlyphStored())
     {
-        return ref._cellData().Char() == glyph.front();
+        return ref._char() == glyph.front();
     }
     else
     {
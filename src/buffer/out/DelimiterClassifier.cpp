@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "DelimiterClassifier.hpp"
+#include "unicode.hpp"
+
+// Routine Description:
+// - constructor
+// Arguments:
+// - wordDelimiters - the characters that separate words, aside from spaces and control characters
+// Return Value:
+// - instantiated object
+DelimiterClassifier::DelimiterClassifier(const std::wstring_view wordDelimiters) :
+    _wordDelimiters{ wordDelimiters },
+    _lowDelimiters{},
+    _highDelimiters{}
+{
+    static std::atomic<uint64_t> nextId{ 0 };
+    _id = ++nextId;
+
+    for (const auto wch : wordDelimiters)
+    {
+        if (wch < _lowDelimiters.size())
+        {
+            _lowDelimiters.set(wch);
+        }
+        else
+        {
+            _highDelimiters.push_back(wch);
+        }
+    }
+
+    std::sort(_highDelimiters.begin(), _highDelimiters.end());
+    _highDelimiters.erase(std::unique(_highDelimiters.begin(), _highDelimiters.end()), _highDelimiters.end());
+}
+
+// Routine Description:
+// - gets the delimiter class of a character
+// Arguments:
+// - wch - the character. For a glyph made of several characters, its first one.
+// Return Value:
+// - the delimiter class of the character
+DelimiterClass DelimiterClassifier::Classify(const wchar_t wch) const noexcept
+{
+    if (wch <= UNICODE_SPACE)
+    {
+        return DelimiterClass::ControlChar;
+    }
+
+    const auto isDelimiter = wch < _lowDelimiters.size() ?
+                                 _lowDelimiters.test(wch) :
+                                 std::binary_search(_highDelimiters.begin(), _highDelimiters.end(), wch);
+    return isDelimiter ? DelimiterClass::DelimiterChar : DelimiterClass::RegularChar;
+}
+
+std::wstring_view DelimiterClassifier::GetWordDelimiters() const noexcept
+{
+    return _wordDelimiters;
+}
+
+uint64_t DelimiterClassifier::GetId() const noexcept
+{
+    return _id;
+}
@@ -0,0 +1,48 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- DelimiterClassifier.hpp
+
+Abstract:
+- Sorts characters into the classes used to find the boundaries of words,
+  for double click selection and UIA word navigation.
+- The word delimiters are compiled once, so that classifying a character
+  doesn't have to search the delimiter string.
+--*/
+
+#pragma once
+
+#include <bitset>
+
+enum class DelimiterClass
+{
+    ControlChar,
+    DelimiterChar,
+    RegularChar
+};
+
+class DelimiterClassifier final
+{
+public:
+    DelimiterClassifier(const std::wstring_view wordDelimiters);
+
+    DelimiterClass Classify(const wchar_t wch) const noexcept;
+
+    std::wstring_view GetWordDelimiters() const noexcept;
+    uint64_t GetId() const noexcept;
+
+private:
+    std::wstring _wordDelimiters;
+
+    // the delimiters below U+0100, which nearly all of them are, one bit each
+    std::bitset<256> _lowDelimiters;
+
+    // the rest of the delimiters, sorted
+    std::vector<wchar_t> _highDelimiters;
+
+    // tells classifiers apart, so that what's cached from one of them isn't
+    // used with another
+    uint64_t _id;
+};
@@ -24,7 +24,9 @@ OutputCellIterator::OutputCellIterator(const wchar_t& wch, const size_t fillLimi
     _attr(InvalidTextAttribute),
     _pos(0),
     _distance(0),
-    _fillLimit(fillLimit)
+    _fillLimit(fillLimit),
+    _measuredStart(0),
+    _measured()
 {
 }
 
@@ -40,7 +42,9 @@ OutputCellIterator::OutputCellIterator(const TextAttribute& attr, const size_t f
     _attr(InvalidTextAttribute),
     _pos(0),
     _distance(0),
-    _fillLimit(fillLimit)
+    _fillLimit(fillLimit),
+    _measuredStart(0),
+    _measured()
 {
 }
 
@@ -57,7 +61,9 @@ OutputCellIterator::OutputCellIterator(const wchar_t& wch, const TextAttribute&
     _attr(InvalidTextAttribute),
     _pos(0),
     _distance(0),
-    _fillLimit(fillLimit)
+    _fillLimit(fillLimit),
+    _measuredStart(0),
+    _measured()
 {
 }
 
@@ -73,7 +79,9 @@ OutputCellIterator::OutputCellIterator(const CHAR_INFO& charInfo, const size_t f
     _attr(InvalidTextAttribute),
     _pos(0),
     _distance(0),
-    _fillLimit(fillLimit)
+    _fillLimit(fillLimit),
+    _measuredStart(0),
+    _measured()
 {
 }
 
@@ -88,7 +96,9 @@ OutputCellIterator::OutputCellIterator(const std::wstring_view utf16Text) :
     _attr(InvalidTextAttribute),
     _pos(0),
     _distance(0),
-    _fillLimit(0)
+    _fillLimit(0),
+    _measuredStart(0),
+    _measured()
 {
 }
 
@@ -104,7 +114,9 @@ OutputCellIterator::OutputCellIterator(const std::wstring_view utf16Text, const
     _attr(attribute),
     _distance(0),
     _pos(0),
-    _fillLimit(0)
+    _fillLimit(0),
+    _measuredStart(0),
+    _measured()
 {
 }
 
@@ -119,7 +131,9 @@ OutputCellIterator::OutputCellIterator(const gsl::span<const WORD> legacyAttrs)
     _attr(InvalidTextAttribute),
     _distance(0),
     _pos(0),
-    _fillLimit(0)
+    _fillLimit(0),
+    _measuredStart(0),
+    _measured()
 {
 }
 
@@ -134,7 +148,9 @@ OutputCellIterator::OutputCellIterator(const gsl::span<const CHAR_INFO> charInfo
     _attr(InvalidTextAttribute),
     _distance(0),
     _pos(0),
-    _fillLimit(0)
+    _fillLimit(0),
+    _measuredStart(0),
+    _measured()
 {
 }
 
@@ -149,7 +165,9 @@ OutputCellIterator::OutputCellIterator(const gsl::span<const OutputCell> cells)
     _attr(InvalidTextAttribute),
     _distance(0),
     _pos(0),
-    _fillLimit(0)
+    _fillLimit(0),
+    _measuredStart(0),
+    _measured()
 {
 }
 
@@ -217,7 +235,7 @@ OutputCellIterator& OutputCellIterator::operator++()
             _pos += _currentView.Chars().size();
             if (operator bool())
             {
-                _currentView = s_GenerateView(std::get<std::wstring_view>(_run).substr(_pos), _attr);
+                _currentView = _GenerateMeasuredView(_attr, TextAttributeBehavior::Stored);
             }
         }
         break;
@@ -231,7 +249,7 @@ OutputCellIterator& OutputCellIterator::operator++()
             _pos += _currentView.Chars().size();
             if (operator bool())
             {
-                _currentView = s_GenerateView(std::get<std::wstring_view>(_run).substr(_pos));
+                _currentView = _GenerateMeasuredView(InvalidTextAttribute, TextAttributeBehavior::Current);
             }
         }
         break;
@@ -353,6 +371,44 @@ bool OutputCellIterator::_TryMoveTrailing() noexcept
     }
 }
 
+// Routine Description:
+// - Creates the view of the glyph at the current position of the text run.
+// - The widths of the glyphs are measured up to 64 characters at a time and
+//   kept until the position moves past them, so walking the text doesn't
+//   look up every glyph on its own. Text that can't be measured in a run
+//   falls back to s_GenerateView.
+// Arguments:
+// - attr - Color attributes to apply to the text
+// - behavior - Behavior of the given text attribute (used when writing)
+// Return Value:
+// - Object representing the view into this cell
+OutputCellView OutputCellIterator::_GenerateMeasuredView(const TextAttribute attr, const TextAttributeBehavior behavior)
+{
+    const auto text = std::get<std::wstring_view>(_run);
+
+    auto offset = _pos - _measuredStart;
+    if (offset >= _measured.length)
+    {
+        _measuredStart = _pos;
+        _measured = MeasureGlyphRun(text.substr(_pos));
+        offset = 0;
+
+        if (_measured.length == 0)
+        {
+            return s_GenerateView(text.substr(_pos), attr, behavior);
+        }
+    }
+
+    DbcsAttribute dbcsAttr;
+    if ((_measured.wide >> offset) & 1)
+    {
+        dbcsAttr.SetLeading();
+    }
+
+    const size_t length = (_measured.pairs >> offset) & 1 ? 2 : 1;
+    return OutputCellView(text.substr(_pos, length), dbcsAttr, attr, behavior);
+}
+
 // Routine Description:
 // - Static function to create a view.
 // - It's pulled out statically so it can be used during construction with just the given
@@ -23,6 +23,7 @@ Revision History:
 
 #include "OutputCell.hpp"
 #include "OutputCellView.hpp"
+#include "../../types/inc/GlyphWidth.hpp"
 
 class OutputCellIterator final
 {
@@ -100,6 +101,8 @@ private:
 
     bool _TryMoveTrailing() noexcept;
 
+    OutputCellView _GenerateMeasuredView(const TextAttribute attr, const TextAttributeBehavior behavior);
+
     static OutputCellView s_GenerateView(const std::wstring_view view);
 
     static OutputCellView s_GenerateView(const std::wstring_view view,
@@ -122,4 +125,8 @@ private:
     size_t _pos;
     size_t _distance;
     size_t _fillLimit;
+
+    // The widths of the text from _measuredStart on, in the text modes.
+    size_t _measuredStart;
+    GlyphWidthRun _measured;
 };
@@ -256,3 +256,52 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const size_t index, co
 
     return it;
 }
+
+// Routine Description:
+// - writes a run of narrow text with a single attribute to the row. Unlike
+//   WriteCells, the text isn't measured one glyph at a time: every character
+//   must take exactly one column, like the ones TextBuffer::MeasureNarrowText
+//   counts. The characters are copied straight into the char row and the
+//   attribute is applied as one run.
+// - If the text splits a wide glyph at either of its edges, the remaining
+//   half of that glyph is cleared.
+// Arguments:
+// - text - the narrow text to write
+// - index - column in row to start writing at
+// - attr - the attribute to apply to the text
+// - wrap - change the wrap flag if the text fills the last column of the row.
+// Return Value:
+// - the number of characters written, which is also the number of columns
+//   they took. Text that doesn't fit in the row isn't written.
+size_t ROW::WriteNarrowText(const std::wstring_view text, const size_t index, const TextAttribute& attr, const std::optional<bool> wrap)
+{
+    THROW_HR_IF(E_INVALIDARG, index >= _charRow.size());
+
+    const auto count = std::min(text.size(), _charRow.size() - index);
+    if (count == 0)
+    {
+        return 0;
+    }
+    const auto end = index + count;
+
+    if (_charRow.DbcsAttrAt(index).IsTrailing() && index > 0)
+    {
+        _charRow.ClearCell(index - 1);
+    }
+    if (_charRow.DbcsAttrAt(end - 1).IsLeading() && end < _charRow.size())
+    {
+        _charRow.ClearCell(end);
+    }
+
+    _charRow.WriteNarrowText(index, text.substr(0, count));
+
+    const TextAttributeRun run{ count, attr };
+    LOG_IF_FAILED(_attrRow.InsertAttrRuns({ &run, 1 }, index, end - 1, _charRow.size()));
+
+    if (wrap.has_value() && end == _charRow.size())
+    {
+        _charRow.SetWrapForced(wrap.value());
+    }
+
+    return count;
+}
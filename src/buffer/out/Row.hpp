@@ -58,6 +58,7 @@ public:
     const UnicodeStorage& GetUnicodeStorage() const noexcept;
 
     OutputCellIterator WriteCells(OutputCellIterator it, const size_t index, const std::optional<bool> wrap = std::nullopt, std::optional<size_t> limitRight = std::nullopt);
+    size_t WriteNarrowText(const std::wstring_view text, const size_t index, const TextAttribute& attr, const std::optional<bool> wrap = std::nullopt);
 
     friend bool operator==(const ROW& a, const ROW& b) noexcept;
 
@@ -0,0 +1,393 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "TextBufferSerializer.hpp"
+
+#pragma hdrstop
+
+using namespace Microsoft::Console::Render;
+
+// Cells and attributes are copied into the stream as they are in memory.
+static_assert(std::is_trivially_copyable_v<DbcsAttribute>);
+static_assert(std::is_trivially_copyable_v<TextAttribute>);
+
+static constexpr HRESULT invalidData = HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+// Row flags
+static constexpr uint8_t wrapForcedFlag = 0x1;
+static constexpr uint8_t doubleBytePaddedFlag = 0x2;
+
+// Cursor flags
+static constexpr uint8_t cursorVisibleFlag = 0x1;
+static constexpr uint8_t cursorBlinkingAllowedFlag = 0x2;
+static constexpr uint8_t cursorDoubleFlag = 0x4;
+
+// Layout:
+//   header:  uint32_t magic, uint16_t version, uint16_t width, uint16_t height
+//            TextAttribute current attributes
+//   cursor:  COORD position, ULONG size, uint8_t flags, uint8_t type, COLORREF color
+//   links:   uint16_t next id, uint16_t count, then for each: uint16_t id, string uri
+//            uint16_t count, then for each: string custom id, uint16_t id
+//   rows:    from the bottom of the buffer to the top, for each:
+//            uint16_t stored cells, uint8_t flags,
+//            uint16_t run count, then for each: uint16_t length, TextAttribute
+//            wchar_t[stored cells], DbcsAttribute[stored cells]
+//            uint16_t stored glyph count, then for each: uint16_t column, string glyph
+//   strings are a uint32_t length followed by that many wchar_t.
+namespace
+{
+    class Writer final
+    {
+    public:
+        template<typename T>
+        void Put(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            PutBytes(&value, sizeof(value));
+        }
+
+        void PutString(const std::wstring_view string)
+        {
+            Put(gsl::narrow<uint32_t>(string.size()));
+            PutBytes(string.data(), string.size() * sizeof(wchar_t));
+        }
+
+        void PutBytes(const void* const data, const size_t size)
+        {
+            const auto bytes = static_cast<const BYTE*>(data);
+            _data.insert(_data.end(), bytes, bytes + size);
+        }
+
+        size_t Position() const noexcept
+        {
+            return _data.size();
+        }
+
+        template<typename T>
+        void PutAt(const size_t position, const T& value) noexcept
+        {
+            memcpy(_data.data() + position, &value, sizeof(value));
+        }
+
+        std::vector<BYTE> Detach() noexcept
+        {
+            return std::move(_data);
+        }
+
+    private:
+        std::vector<BYTE> _data;
+    };
+
+    class Reader final
+    {
+    public:
+        explicit Reader(gsl::span<const BYTE>& data) noexcept :
+            _data{ data }
+        {
+        }
+
+        template<typename T>
+        T Get()
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            T value;
+            GetBytes(&value, sizeof(value));
+            return value;
+        }
+
+        std::wstring GetString()
+        {
+            const auto length = Get<uint32_t>();
+            THROW_HR_IF(invalidData, _data.size() / sizeof(wchar_t) < length);
+
+            std::wstring string(length, UNICODE_NULL);
+            GetBytes(string.data(), length * sizeof(wchar_t));
+            return string;
+        }
+
+        void GetBytes(void* const data, const size_t size)
+        {
+            THROW_HR_IF(invalidData, _data.size() < size);
+            memcpy(data, _data.data(), size);
+            _data = _data.subspan(size);
+        }
+
+    private:
+        gsl::span<const BYTE>& _data;
+    };
+}
+
+// Routine Description:
+// - Saves the given buffer.
+// Arguments:
+// - buffer - The buffer to save.
+// Return Value:
+// - The saved buffer, which TextBufferLoader can load again.
+std::vector<BYTE> TextBufferSerializer::Serialize(const TextBuffer& buffer)
+{
+    const auto size = buffer.GetSize().Dimensions();
+    const auto& cursor = buffer.GetCursor();
+
+    Writer writer;
+    writer.Put(Magic);
+    writer.Put(Version);
+    writer.Put(gsl::narrow<uint16_t>(size.X));
+    writer.Put(gsl::narrow<uint16_t>(size.Y));
+    writer.Put(buffer.GetCurrentAttributes());
+
+    uint8_t cursorFlags = 0;
+    WI_SetFlagIf(cursorFlags, cursorVisibleFlag, cursor.IsVisible());
+    WI_SetFlagIf(cursorFlags, cursorBlinkingAllowedFlag, cursor.IsBlinkingAllowed());
+    WI_SetFlagIf(cursorFlags, cursorDoubleFlag, cursor.IsDouble());
+    writer.Put(cursor.GetPosition());
+    writer.Put(cursor.GetSize());
+    writer.Put(cursorFlags);
+    writer.Put(gsl::narrow<uint8_t>(static_cast<unsigned int>(cursor.GetType())));
+    writer.Put(cursor.GetColor());
+
+    writer.Put(buffer._currentHyperlinkId);
+    writer.Put(gsl::narrow<uint16_t>(buffer._hyperlinkMap.size()));
+    for (const auto& [id, uri] : buffer._hyperlinkMap)
+    {
+        writer.Put(id);
+        writer.PutString(uri);
+    }
+    writer.Put(gsl::narrow<uint16_t>(buffer._hyperlinkCustomIdMap.size()));
+    for (const auto& [customId, id] : buffer._hyperlinkCustomIdMap)
+    {
+        writer.PutString(customId);
+        writer.Put(id);
+    }
+
+    for (auto y = size.Y - 1; y >= 0; --y)
+    {
+        const auto& row = buffer.GetRowByOffset(y);
+        const auto& charRow = row.GetCharRow();
+        const auto& attrRow = row.GetAttrRow();
+        const auto width = charRow.size();
+
+        // Most rows end in a lot of blank cells, which the loader puts back.
+        const auto chars = charRow.Chars();
+        const auto dbcsAttrs = charRow.DbcsAttrs();
+        auto storedCells = width;
+        while (storedCells > 0 && til::at(chars, storedCells - 1) == UNICODE_SPACE && til::at(dbcsAttrs, storedCells - 1).IsSingle())
+        {
+            --storedCells;
+        }
+
+        uint8_t flags = 0;
+        WI_SetFlagIf(flags, wrapForcedFlag, charRow.WasWrapForced());
+        WI_SetFlagIf(flags, doubleBytePaddedFlag, charRow.WasDoubleBytePadded());
+        writer.Put(gsl::narrow<uint16_t>(storedCells));
+        writer.Put(flags);
+
+        const auto runCountPosition = writer.Position();
+        writer.Put(uint16_t{ 0 });
+        uint16_t runCount = 0;
+        for (size_t column = 0; column < width;)
+        {
+            size_t applies = 0;
+            const auto attr = attrRow.GetAttrByColumn(column, &applies);
+            applies = std::min(applies, width - column);
+
+            writer.Put(gsl::narrow<uint16_t>(applies));
+            writer.Put(attr);
+            ++runCount;
+            column += applies;
+        }
+        writer.PutAt(runCountPosition, runCount);
+
+        writer.PutBytes(chars.data(), storedCells * sizeof(wchar_t));
+        writer.PutBytes(dbcsAttrs.data(), storedCells * sizeof(DbcsAttribute));
+
+        const auto glyphCountPosition = writer.Position();
+        writer.Put(uint16_t{ 0 });
+        uint16_t glyphCount = 0;
+        for (size_t column = 0; column < storedCells; ++column)
+        {
+            if (charRow.DbcsAttrAt(column).IsGlyphStored())
+            {
+                const auto& glyph = buffer.GetUnicodeStorage().GetText(charRow.GetStorageKey(column));
+                writer.Put(gsl::narrow<uint16_t>(column));
+                writer.PutString({ glyph.data(), glyph.size() });
+                ++glyphCount;
+            }
+        }
+        writer.PutAt(glyphCountPosition, glyphCount);
+    }
+
+    return writer.Detach();
+}
+
+// Routine Description:
+// - Reads the header of a saved buffer. The rows are read as they're loaded.
+// Arguments:
+// - data - The saved buffer. It has to stay valid until all rows are loaded.
+TextBufferLoader::TextBufferLoader(const gsl::span<const BYTE> data) :
+    _data{ data },
+    _nextRow{ 0 }
+{
+    Reader reader{ _data };
+    THROW_HR_IF(invalidData, reader.Get<uint32_t>() != TextBufferSerializer::Magic);
+    THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_UNSUPPORTED_TYPE), reader.Get<uint16_t>() != TextBufferSerializer::Version);
+
+    const auto width = reader.Get<uint16_t>();
+    const auto height = reader.Get<uint16_t>();
+    THROW_HR_IF(invalidData, width == 0 || height == 0);
+    _size = { gsl::narrow<SHORT>(width), gsl::narrow<SHORT>(height) };
+    _currentAttributes = reader.Get<TextAttribute>();
+
+    _cursorPosition = reader.Get<COORD>();
+    _cursorSize = reader.Get<ULONG>();
+    _cursorFlags = reader.Get<uint8_t>();
+    _cursorType = static_cast<CursorType>(reader.Get<uint8_t>());
+    _cursorColor = reader.Get<COLORREF>();
+
+    _currentHyperlinkId = reader.Get<uint16_t>();
+    const auto hyperlinkCount = reader.Get<uint16_t>();
+    for (uint16_t i = 0; i < hyperlinkCount; ++i)
+    {
+        const auto id = reader.Get<uint16_t>();
+        _hyperlinks.push_back({ id, reader.GetString() });
+    }
+    const auto customIdCount = reader.Get<uint16_t>();
+    for (uint16_t i = 0; i < customIdCount; ++i)
+    {
+        auto customId = reader.GetString();
+        _customIds.push_back({ std::move(customId), reader.Get<uint16_t>() });
+    }
+
+    _nextRow = height;
+}
+
+// Routine Description:
+// - Returns the size of the saved buffer.
+COORD TextBufferLoader::GetBufferSize() const noexcept
+{
+    return _size;
+}
+
+// Routine Description:
+// - Creates an empty buffer the size of the saved one, with the saved cursor,
+//   attributes and hyperlinks. The rows are filled in by LoadRows.
+// Arguments:
+// - renderTarget - The render target for the new buffer.
+// Return Value:
+// - The new buffer.
+std::unique_ptr<TextBuffer> TextBufferLoader::CreateBuffer(IRenderTarget& renderTarget) const
+{
+    auto buffer = std::make_unique<TextBuffer>(_size, _currentAttributes, _cursorSize, renderTarget);
+
+    auto& cursor = buffer->GetCursor();
+    cursor.SetStyle(_cursorSize, _cursorColor, _cursorType);
+    cursor.SetPosition(_cursorPosition);
+    cursor.SetIsVisible(WI_IsFlagSet(_cursorFlags, cursorVisibleFlag));
+    cursor.SetBlinkingAllowed(WI_IsFlagSet(_cursorFlags, cursorBlinkingAllowedFlag));
+    cursor.SetIsDouble(WI_IsFlagSet(_cursorFlags, cursorDoubleFlag));
+
+    for (const auto& hyperlink : _hyperlinks)
+    {
+        buffer->_hyperlinkMap.emplace(hyperlink.id, hyperlink.uri);
+    }
+    for (const auto& customId : _customIds)
+    {
+        buffer->_hyperlinkCustomIdMap.emplace(customId.customId, customId.id);
+    }
+    buffer->_currentHyperlinkId = _currentHyperlinkId;
+
+    return buffer;
+}
+
+// Routine Description:
+// - Loads the next batch of rows into the given buffer. The rows are loaded
+//   from the bottom of the buffer up, so the first batch covers the viewport.
+// Arguments:
+// - buffer - A buffer created by CreateBuffer.
+// - count - The largest number of rows to load.
+// Return Value:
+// - true if there are rows left to load.
+bool TextBufferLoader::LoadRows(TextBuffer& buffer, const size_t count)
+{
+    const auto size = buffer.GetSize().Dimensions();
+    THROW_HR_IF(E_INVALIDARG, size.X != _size.X || size.Y != _size.Y);
+
+    const auto end = _nextRow - std::min(count, _nextRow);
+    while (_nextRow > end)
+    {
+        --_nextRow;
+        _LoadRow(buffer.GetRowByOffset(_nextRow));
+    }
+
+    buffer._NotifyPaint(Microsoft::Console::Types::Viewport::FromInclusive({ 0,
+                                                                             gsl::narrow_cast<SHORT>(end),
+                                                                             _size.X - 1,
+                                                                             _size.Y - 1 }));
+    return _nextRow > 0;
+}
+
+// Routine Description:
+// - Loads all of the rows that weren't loaded yet into the given buffer.
+// Arguments:
+// - buffer - A buffer created by CreateBuffer.
+// Return Value:
+// - <none>
+void TextBufferLoader::LoadAll(TextBuffer& buffer)
+{
+    LoadRows(buffer, _nextRow);
+}
+
+// Routine Description:
+// - Returns the number of rows that weren't loaded yet.
+size_t TextBufferLoader::GetRemainingRows() const noexcept
+{
+    return _nextRow;
+}
+
+// Routine Description:
+// - Reads one row from the saved buffer.
+// Arguments:
+// - row - The row to fill in. It's expected to be blank.
+// Return Value:
+// - <none>
+void TextBufferLoader::_LoadRow(ROW& row)
+{
+    Reader reader{ _data };
+
+    auto& charRow = row.GetCharRow();
+    const auto width = charRow.size();
+
+    const auto storedCells = reader.Get<uint16_t>();
+    const auto flags = reader.Get<uint8_t>();
+    THROW_HR_IF(invalidData, storedCells > width);
+
+    charRow.SetWrapForced(WI_IsFlagSet(flags, wrapForcedFlag));
+    charRow.SetDoubleBytePadded(WI_IsFlagSet(flags, doubleBytePaddedFlag));
+
+    const auto runCount = reader.Get<uint16_t>();
+    std::vector<TextAttributeRun> runs;
+    runs.reserve(runCount);
+    size_t covered = 0;
+    for (uint16_t i = 0; i < runCount; ++i)
+    {
+        const auto length = reader.Get<uint16_t>();
+        runs.emplace_back(length, reader.Get<TextAttribute>());
+        covered += length;
+    }
+    THROW_HR_IF(invalidData, runs.empty() || covered != width);
+    THROW_IF_FAILED(row.GetAttrRow().InsertAttrRuns(runs, 0, width - 1, width));
+
+    reader.GetBytes(charRow.Chars().data(), storedCells * sizeof(wchar_t));
+    reader.GetBytes(charRow.DbcsAttrs().data(), storedCells * sizeof(DbcsAttribute));
+
+    auto& unicodeStorage = row.GetUnicodeStorage();
+    const auto glyphCount = reader.Get<uint16_t>();
+    for (uint16_t i = 0; i < glyphCount; ++i)
+    {
+        const auto column = reader.Get<uint16_t>();
+        const auto glyph = reader.GetString();
+        THROW_HR_IF(invalidData, column >= storedCells);
+        unicodeStorage.StoreGlyph(charRow.GetStorageKey(column), { glyph.begin(), glyph.end() });
+    }
+}
@@ -0,0 +1,81 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- TextBufferSerializer.hpp
+
+Abstract:
+- Saves the contents of a TextBuffer into a compact binary form and loads it
+  back again, so that a session's buffers can be restored when it's reopened.
+- The format is versioned, and holds the text, DBCS attributes, wrap flags and
+  attribute runs of every row, the glyphs kept in the UnicodeStorage, the
+  hyperlinks and the cursor.
+- Rows are written bottom up. A TextBufferLoader can therefore fill in the
+  rows at the bottom of the buffer, where the viewport usually is, first and
+  leave the older history to be loaded in later batches.
+- The cells of a row are copied as they are in memory, with trailing blank
+  cells left out. Attributes are written as they are in memory too, so the
+  format is only meant to be read by the same build that wrote it.
+--*/
+
+#pragma once
+
+#include "textBuffer.hpp"
+
+class TextBufferSerializer final
+{
+public:
+    static constexpr uint32_t Magic = 0x46554254; // "TBUF"
+    static constexpr uint16_t Version = 2;
+
+    static std::vector<BYTE> Serialize(const TextBuffer& buffer);
+};
+
+class TextBufferLoader final
+{
+public:
+    TextBufferLoader(const gsl::span<const BYTE> data);
+
+    COORD GetBufferSize() const noexcept;
+
+    std::unique_ptr<TextBuffer> CreateBuffer(Microsoft::Console::Render::IRenderTarget& renderTarget) const;
+
+    bool LoadRows(TextBuffer& buffer, const size_t count);
+    void LoadAll(TextBuffer& buffer);
+
+    size_t GetRemainingRows() const noexcept;
+
+private:
+    struct Hyperlink
+    {
+        uint16_t id;
+        std::wstring uri;
+    };
+
+    struct CustomId
+    {
+        std::wstring customId;
+        uint16_t id;
+    };
+
+    void _LoadRow(ROW& row);
+
+    gsl::span<const BYTE> _data;
+
+    COORD _size;
+    TextAttribute _currentAttributes;
+
+    COORD _cursorPosition;
+    ULONG _cursorSize;
+    uint8_t _cursorFlags;
+    CursorType _cursorType;
+    COLORREF _cursorColor;
+
+    uint16_t _currentHyperlinkId;
+    std::vector<Hyperlink> _hyperlinks;
+    std::vector<CustomId> _customIds;
+
+    // Rows are stored bottom up, so this counts down to 0.
+    size_t _nextRow;
+};
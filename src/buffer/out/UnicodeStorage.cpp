@@ -96,3 +96,35 @@ void UnicodeStorage::Remap(const std::unordered_map<SHORT, SHORT>& rowMap, const
     // Swap into the stored map, free the temporary when we exit.
     _map.swap(newMap);
 }
+
+// Routine Description:
+// - Remaps the stored items on some of the rows to new row positions.
+//   Unlike Remap, items on rows that aren't in the map stay where they are.
+// Arguments:
+// - rowMap - A map of the old row IDs to the new row IDs, for the rows that moved.
+void UnicodeStorage::RemapRows(const std::unordered_map<SHORT, SHORT>& rowMap)
+{
+    // Most buffers never store anything here, so don't bother walking it.
+    if (_map.empty() || rowMap.empty())
+    {
+        return;
+    }
+
+    std::unordered_map<key_type, mapped_type> newMap;
+    newMap.reserve(_map.size());
+
+    for (auto& pair : _map)
+    {
+        auto coord = pair.first;
+
+        const auto mapIter = rowMap.find(coord.Y);
+        if (mapIter != rowMap.end())
+        {
+            coord.Y = mapIter->second;
+        }
+
+        newMap.emplace(coord, std::move(pair.second));
+    }
+
+    _map.swap(newMap);
+}
@@ -57,6 +57,8 @@ public:
 
     void Remap(const std::unordered_map<SHORT, SHORT>& rowMap, const std::optional<SHORT> width);
 
+    void RemapRows(const std::unordered_map<SHORT, SHORT>& rowMap);
+
 private:
     std::unordered_map<key_type, mapped_type> _map;
 
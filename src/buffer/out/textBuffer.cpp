@@ -35,7 +35,8 @@ TextBuffer::TextBuffer(const COORD screenBufferSize,
     _unicodeStorage{},
     _renderTarget{ renderTarget },
     _size{},
-    _currentHyperlinkId{ 1 }
+    _currentHyperlinkId{ 1 },
+    _delimiterClassifier{}
 {
     // initialize ROWs
     for (size_t i = 0; i < static_cast<size_t>(screenBufferSize.Y); ++i)
@@ -385,6 +386,59 @@ OutputCellIterator TextBuffer::WriteLine(const OutputCellIterator givenIt,
     return newIt;
 }
 
+// Routine Description:
+// - Counts the characters at the start of the given text that can be written
+//   with WriteNarrowText. Those are the printable ASCII characters, which are
+//   always one column wide, whatever the font.
+// Arguments:
+// - text - the text to measure
+// Return Value:
+// - The number of leading characters that each take exactly one column.
+size_t TextBuffer::MeasureNarrowText(const std::wstring_view text) noexcept
+{
+    const auto it = std::find_if(text.cbegin(), text.cend(), [](const wchar_t wch) noexcept {
+        return wch < L' ' || wch > L'~';
+    });
+    return gsl::narrow_cast<size_t>(it - text.cbegin());
+}
+
+// Routine Description:
+// - Writes a run of narrow text with a single attribute to one line of the
+//   output buffer. This skips measuring the text one glyph at a time, so the
+//   caller must have measured it with MeasureNarrowText.
+// Arguments:
+// - text - the narrow text to write
+// - attr - the attribute to apply to the text
+// - target - the row/column to start writing the text to
+// - wrap - change the wrap flag if the text fills the last column of the row.
+// Return Value:
+// - The number of characters written, which is also the number of columns
+//   they took. It stops at the end of the line, and nothing is written if
+//   the target isn't in the buffer.
+size_t TextBuffer::WriteNarrowText(const std::wstring_view text,
+                                   const TextAttribute& attr,
+                                   const COORD target,
+                                   const std::optional<bool> wrap)
+{
+    if (!GetSize().IsInBounds(target))
+    {
+        return 0;
+    }
+
+    const auto written = GetRowByOffset(target.Y).WriteNarrowText(text, target.X, attr, wrap);
+    if (written == 0)
+    {
+        return 0;
+    }
+
+    // The cells on either side of the text may have lost half of a wide glyph.
+    const auto left = std::max(target.X - 1, 0);
+    const auto right = std::min(target.X + gsl::narrow_cast<int>(written) + 1, GetSize().Width());
+    _NotifyPaint(Viewport::FromDimensions({ gsl::narrow_cast<SHORT>(left), target.Y }, { gsl::narrow_cast<SHORT>(right - left), 1 }));
+
+    return written;
+}
+
 //Routine Description:
 // - Inserts one codepoint into the buffer at the current cursor position and advances the cursor as appropriate.
 //Arguments:
@@ -587,6 +641,8 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
 // - If we know the last character is within the given viewport (so we don't
 //   need to check the entire buffer), we can provide a value in viewOptional
 //   that we'll use to search for the last character in.
+// - Each row knows where its text ends, so this only costs a lookup for
+//   every empty row at the bottom of the viewport.
 //Arguments:
 // - The viewport
 //Return value:
@@ -675,6 +731,17 @@ void TextBuffer::_SetFirstRowIndex(const SHORT FirstRowIndex) noexcept
     _firstRow = FirstRowIndex;
 }
 
+// Routine Description:
+// - Moves the given range of rows up or down by rotating the rows themselves
+//   instead of copying their contents. The rows that the range moves over end
+//   up in the space it uncovered, with whatever they held before.
+// - Only the rows between the old and new position of the range are touched.
+// Arguments:
+// - firstRow - Offset of the first row to move, from the top of the buffer
+// - size - The number of rows to move
+// - delta - How far to move them. Negative values move them up.
+// Return Value:
+// - <none>
 void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT delta)
 {
     // If we don't have to move anything, leave early.
@@ -685,16 +752,28 @@ void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT
 
     // OK. We're about to play games by moving rows around within the deque to
     // scroll a massive region in a faster way than copying things.
-    // To make this easier, first correct the circular buffer to have the first row be 0 again.
-    if (_firstRow != 0)
+    // The rows that are touched are the range itself and the rows it moves over.
+    const auto totalRows = _storage.size();
+    const auto touchedTop = gsl::narrow_cast<size_t>(firstRow + std::min<SHORT>(delta, 0));
+    const auto touchedCount = gsl::narrow_cast<size_t>(size + std::abs(delta));
+    auto storageTop = (_firstRow + touchedTop) % totalRows;
+
+    // If those rows wrap around the end of the circular buffer, correct it to
+    // have the first row be 0 again so they're in one piece.
+    const auto wrapsAround = storageTop + touchedCount > totalRows;
+    if (wrapsAround)
     {
         // Rotate the buffer to put the first row at the front.
         std::rotate(_storage.begin(), _storage.begin() + _firstRow, _storage.end());
 
         // The first row is now at the top.
         _firstRow = 0;
+        storageTop = touchedTop;
     }
 
+    // The position of firstRow within the storage.
+    const auto storageFirstRow = storageTop + (firstRow - touchedTop);
+
     // Rotate just the subsection specified
     if (delta < 0)
     {
@@ -731,7 +810,7 @@ void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT
         // | 10
         // | 11
         // - end
-        std::rotate(_storage.begin() + firstRow + delta, _storage.begin() + firstRow, _storage.begin() + firstRow + size);
+        std::rotate(_storage.begin() + storageFirstRow + delta, _storage.begin() + storageFirstRow, _storage.begin() + storageFirstRow + size);
     }
     else
     {
@@ -768,12 +847,20 @@ void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT
         // | 10
         // | 11
         // - end
-        std::rotate(_storage.begin() + firstRow, _storage.begin() + firstRow + size, _storage.begin() + firstRow + size + delta);
+        std::rotate(_storage.begin() + storageFirstRow, _storage.begin() + storageFirstRow + size, _storage.begin() + storageFirstRow + size + delta);
     }
 
     // Renumber the IDs now that we've rearranged where the rows sit within the buffer.
     // Refreshing should also delegate to the UnicodeStorage to re-key all the stored unicode sequences (where applicable).
-    _RefreshRowIDs(std::nullopt);
+    // If the whole buffer was rotated, every row moved. Otherwise only the touched ones did.
+    if (wrapsAround)
+    {
+        _RefreshRowIDs(std::nullopt);
+    }
+    else
+    {
+        _RefreshRowIDs(storageTop, storageTop + touchedCount);
+    }
 }
 
 Cursor& TextBuffer::GetCursor() noexcept
@@ -913,6 +1000,32 @@ void TextBuffer::_RefreshRowIDs(std::optional<SHORT> newRowWidth)
     _unicodeStorage.Remap(rowMap, newRowWidth);
 }
 
+// Routine Description:
+// - Refreshes the Row IDs of a range of rows after they were shuffled around
+//   among themselves. See the other overload for what's refreshed.
+// Arguments:
+// - begin - Index into the storage of the first row to refresh
+// - end - Index into the storage one past the last row to refresh
+void TextBuffer::_RefreshRowIDs(const size_t begin, const size_t end)
+{
+    std::unordered_map<SHORT, SHORT> rowMap;
+    for (auto i = begin; i < end; ++i)
+    {
+        auto& row = _storage.at(i);
+        const auto id = gsl::narrow_cast<SHORT>(i);
+
+        if (row.GetId() != id)
+        {
+            rowMap.emplace(row.GetId(), id);
+            row.SetId(id);
+        }
+
+        row.GetCharRow().UpdateParent(&row);
+    }
+
+    _unicodeStorage.RemapRows(rowMap);
+}
+
 void TextBuffer::_NotifyPaint(const Viewport& viewport) const
 {
     _renderTarget.TriggerRedraw(viewport);
@@ -961,17 +1074,83 @@ Microsoft::Console::Render::IRenderTarget& TextBuffer::GetRenderTarget() noexcep
     return _renderTarget;
 }
 
+// Method Description:
+// - get the compiled form of the given word delimiters. It's kept until
+//   different ones are asked for.
+// Arguments:
+// - wordDelimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
+// Return Value:
+// - the classifier for the delimiters
+const DelimiterClassifier& TextBuffer::_GetDelimiterClassifier(const std::wstring_view wordDelimiters) const
+{
+    if (!_delimiterClassifier || _delimiterClassifier->GetWordDelimiters() != wordDelimiters)
+    {
+        _delimiterClassifier.emplace(wordDelimiters);
+    }
+    return *_delimiterClassifier;
+}
+
 // Method Description:
 // - get delimiter class for buffer cell position
 // - used for double click selection and uia word navigation
 // Arguments:
 // - pos: the buffer cell under observation
-// - wordDelimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
+// - classifier: the compiled word delimiters
 // Return Value:
 // - the delimiter class for the given char
-const DelimiterClass TextBuffer::_GetDelimiterClassAt(const COORD pos, const std::wstring_view wordDelimiters) const
+const DelimiterClass TextBuffer::_GetDelimiterClassAt(const COORD pos, const DelimiterClassifier& classifier) const
 {
-    return GetRowByOffset(pos.Y).GetCharRow().DelimiterClassAt(pos.X, wordDelimiters);
+    return GetRowByOffset(pos.Y).GetCharRow().DelimiterClassAt(pos.X, classifier);
+}
+
+// Method Description:
+// - moves pos forward or backward over the cells that are (or aren't) of the
+//   given delimiter class, a row at a time, like stepping over them with
+//   IncrementInBounds/DecrementInBounds would
+// Arguments:
+// - pos: the cell to start at. Updated to the first cell that wasn't skipped.
+// - classifier: the compiled word delimiters
+// - delimiterClass: the delimiter class to compare the cells to
+// - skipEqual: true to skip the cells of that class, false to skip the cells of any other class
+// - forward: true to move towards the end of the buffer, false to move towards its start
+// Return Value:
+// - true if a cell that isn't skipped was found. False if the edge of the buffer
+//   was reached first, in which case pos is on the last (or first) cell of the buffer.
+bool TextBuffer::_SkipDelimiterClass(COORD& pos,
+                                     const DelimiterClassifier& classifier,
+                                     const DelimiterClass delimiterClass,
+                                     const bool skipEqual,
+                                     const bool forward) const
+{
+    const auto bufferSize = GetSize();
+
+    if (forward)
+    {
+        for (auto y = pos.Y, x = pos.X; y <= bufferSize.BottomInclusive(); ++y, x = bufferSize.Left())
+        {
+            const auto found = GetRowByOffset(y).GetCharRow().FindDelimiterClass(gsl::narrow_cast<size_t>(x), classifier, delimiterClass, !skipEqual);
+            if (found)
+            {
+                pos = { gsl::narrow<SHORT>(*found), y };
+                return true;
+            }
+        }
+        pos = { bufferSize.RightInclusive(), bufferSize.BottomInclusive() };
+    }
+    else
+    {
+        for (auto y = pos.Y, x = pos.X; y >= bufferSize.Top(); --y, x = bufferSize.RightInclusive())
+        {
+            const auto found = GetRowByOffset(y).GetCharRow().FindDelimiterClassBackward(gsl::narrow_cast<size_t>(x), classifier, delimiterClass, !skipEqual);
+            if (found)
+            {
+                pos = { gsl::narrow<SHORT>(*found), y };
+                return true;
+            }
+        }
+        pos = bufferSize.Origin();
+    }
+    return false;
 }
 
 // Method Description:
@@ -1012,13 +1191,14 @@ const COORD TextBuffer::GetWordStart(const COORD target, const std::wstring_view
         copy = { bufferSize.RightInclusive(), bufferSize.BottomInclusive() };
     }
 
+    const auto& classifier = _GetDelimiterClassifier(wordDelimiters);
     if (accessibilityMode)
     {
-        return _GetWordStartForAccessibility(copy, wordDelimiters);
+        return _GetWordStartForAccessibility(copy, classifier);
     }
     else
     {
-        return _GetWordStartForSelection(copy, wordDelimiters);
+        return _GetWordStartForSelection(copy, classifier);
     }
 }
 
@@ -1026,40 +1206,29 @@ const COORD TextBuffer::GetWordStart(const COORD target, const std::wstring_view
 // - Helper method for GetWordStart(). Get the COORD for the beginning of the word (accessibility definition) you are on
 // Arguments:
 // - target - a COORD on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - classifier - what characters are we considering for the separation of words
 // Return Value:
 // - The COORD for the first character on the current/previous READABLE "word" (inclusive)
-const COORD TextBuffer::_GetWordStartForAccessibility(const COORD target, const std::wstring_view wordDelimiters) const
+const COORD TextBuffer::_GetWordStartForAccessibility(const COORD target, const DelimiterClassifier& classifier) const
 {
     COORD result = target;
     const auto bufferSize = GetSize();
     bool stayAtOrigin = false;
 
     // ignore left boundary. Continue until readable text found
-    while (_GetDelimiterClassAt(result, wordDelimiters) != DelimiterClass::RegularChar)
+    if (!_SkipDelimiterClass(result, classifier, DelimiterClass::RegularChar, false, false))
     {
-        if (!bufferSize.DecrementInBounds(result))
-        {
-            // first char in buffer is a DelimiterChar or ControlChar
-            // we can't move any further back
-            stayAtOrigin = true;
-            break;
-        }
+        // first char in buffer is a DelimiterChar or ControlChar
+        // we can't move any further back
+        stayAtOrigin = true;
     }
 
-    // make sure we expand to the left boundary or the beginning of the word
-    while (_GetDelimiterClassAt(result, wordDelimiters) == DelimiterClass::RegularChar)
-    {
-        if (!bufferSize.DecrementInBounds(result))
-        {
-            // first char in buffer is a RegularChar
-            // we can't move any further back
-            break;
-        }
-    }
+    // make sure we expand to the left boundary or the beginning of the word.
+    // If there's no left boundary, we stop on the first char in buffer.
+    _SkipDelimiterClass(result, classifier, DelimiterClass::RegularChar, true, false);
 
     // move off of delimiter and onto word start
-    if (!stayAtOrigin && _GetDelimiterClassAt(result, wordDelimiters) != DelimiterClass::RegularChar)
+    if (!stayAtOrigin && _GetDelimiterClassAt(result, classifier) != DelimiterClass::RegularChar)
     {
         bufferSize.IncrementInBounds(result);
     }
@@ -1071,27 +1240,21 @@ const COORD TextBuffer::_GetWordStartForAccessibility(const COORD target, const
 // - Helper method for GetWordStart(). Get the COORD for the beginning of the word (selection definition) you are on
 // Arguments:
 // - target - a COORD on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - classifier - what characters are we considering for the separation of words
 // Return Value:
 // - The COORD for the first character on the current word or delimiter run (stopped by the left margin)
-const COORD TextBuffer::_GetWordStartForSelection(const COORD target, const std::wstring_view wordDelimiters) const
+const COORD TextBuffer::_GetWordStartForSelection(const COORD target, const DelimiterClassifier& classifier) const
 {
     COORD result = target;
     const auto bufferSize = GetSize();
 
-    const auto initialDelimiter = _GetDelimiterClassAt(result, wordDelimiters);
+    const auto& charRow = GetRowByOffset(result.Y).GetCharRow();
+    const auto initialDelimiter = charRow.DelimiterClassAt(gsl::narrow_cast<size_t>(result.X), classifier);
 
-    // expand left until we hit the left boundary or a different delimiter class
-    while (result.X > bufferSize.Left() && (_GetDelimiterClassAt(result, wordDelimiters) == initialDelimiter))
-    {
-        bufferSize.DecrementInBounds(result);
-    }
-
-    if (_GetDelimiterClassAt(result, wordDelimiters) != initialDelimiter)
-    {
-        // move off of delimiter
-        bufferSize.IncrementInBounds(result);
-    }
+    // expand left until we hit the left boundary or a different delimiter class,
+    // then move off of that delimiter
+    const auto found = charRow.FindDelimiterClassBackward(gsl::narrow_cast<size_t>(result.X), classifier, initialDelimiter, false);
+    result.X = found ? gsl::narrow<SHORT>(*found + 1) : bufferSize.Left();
 
     return result;
 }
@@ -1124,13 +1287,14 @@ const COORD TextBuffer::GetWordEnd(const COORD target, const std::wstring_view w
         return target;
     }
 
+    const auto& classifier = _GetDelimiterClassifier(wordDelimiters);
     if (accessibilityMode)
     {
-        return _GetWordEndForAccessibility(target, wordDelimiters);
+        return _GetWordEndForAccessibility(target, classifier);
     }
     else
     {
-        return _GetWordEndForSelection(target, wordDelimiters);
+        return _GetWordEndForSelection(target, classifier);
     }
 }
 
@@ -1138,33 +1302,22 @@ const COORD TextBuffer::GetWordEnd(const COORD target, const std::wstring_view w
 // - Helper method for GetWordEnd(). Get the COORD for the beginning of the next READABLE word
 // Arguments:
 // - target - a COORD on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - classifier - what characters are we considering for the separation of words
 // Return Value:
 // - The COORD for the first character of the next readable "word". If no next word, return one past the end of the buffer
-const COORD TextBuffer::_GetWordEndForAccessibility(const COORD target, const std::wstring_view wordDelimiters) const
+const COORD TextBuffer::_GetWordEndForAccessibility(const COORD target, const DelimiterClassifier& classifier) const
 {
-    const auto bufferSize = GetSize();
     COORD result = target;
 
-    // ignore right boundary. Continue through readable text found
-    while (_GetDelimiterClassAt(result, wordDelimiters) == DelimiterClass::RegularChar)
+    // ignore right boundary. Continue through readable text found,
+    // then make sure we expand to the beginning of the NEXT word
+    if (!_SkipDelimiterClass(result, classifier, DelimiterClass::RegularChar, true, true) ||
+        !_SkipDelimiterClass(result, classifier, DelimiterClass::RegularChar, false, true))
     {
-        if (!bufferSize.IncrementInBounds(result, true))
-        {
-            break;
-        }
-    }
-
-    // make sure we expand to the beginning of the NEXT word
-    while (_GetDelimiterClassAt(result, wordDelimiters) != DelimiterClass::RegularChar)
-    {
-        if (!bufferSize.IncrementInBounds(result, true))
-        {
-            // we are at the EndInclusive COORD
-            // this signifies that we must include the last char in the buffer
-            // but the position of the COORD points to nothing
-            break;
-        }
+        // we are past the EndInclusive COORD
+        // this signifies that we must include the last char in the buffer
+        // but the position of the COORD points to nothing
+        return GetSize().EndExclusive();
     }
 
     return result;
@@ -1174,10 +1327,10 @@ const COORD TextBuffer::_GetWordEndForAccessibility(const COORD target, const st
 // - Helper method for GetWordEnd(). Get the COORD for the beginning of the NEXT word
 // Arguments:
 // - target - a COORD on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - classifier - what characters are we considering for the separation of words
 // Return Value:
 // - The COORD for the last character of the current word or delimiter run (stopped by right margin)
-const COORD TextBuffer::_GetWordEndForSelection(const COORD target, const std::wstring_view wordDelimiters) const
+const COORD TextBuffer::_GetWordEndForSelection(const COORD target, const DelimiterClassifier& classifier) const
 {
     const auto bufferSize = GetSize();
 
@@ -1188,19 +1341,13 @@ const COORD TextBuffer::_GetWordEndForSelection(const COORD target, const std::w
     }
 
     COORD result = target;
-    const auto initialDelimiter = _GetDelimiterClassAt(result, wordDelimiters);
-
-    // expand right until we hit the right boundary or a different delimiter class
-    while (result.X < bufferSize.RightInclusive() && (_GetDelimiterClassAt(result, wordDelimiters) == initialDelimiter))
-    {
-        bufferSize.IncrementInBounds(result);
-    }
+    const auto& charRow = GetRowByOffset(result.Y).GetCharRow();
+    const auto initialDelimiter = charRow.DelimiterClassAt(gsl::narrow_cast<size_t>(result.X), classifier);
 
-    if (_GetDelimiterClassAt(result, wordDelimiters) != initialDelimiter)
-    {
-        // move off of delimiter
-        bufferSize.DecrementInBounds(result);
-    }
+    // expand right until we hit the right boundary or a different delimiter class,
+    // then move off of that delimiter
+    const auto found = charRow.FindDelimiterClass(gsl::narrow_cast<size_t>(result.X), classifier, initialDelimiter, false);
+    result.X = found ? gsl::narrow<SHORT>(*found - 1) : bufferSize.RightInclusive();
 
     return result;
 }
@@ -1265,15 +1412,14 @@ bool TextBuffer::MoveToNextWord(COORD& pos, const std::wstring_view wordDelimite
         return false;
     }
 
+    const auto& classifier = _GetDelimiterClassifier(wordDelimiters);
+
     // started on a word, continue until the end of the word
-    while (_GetDelimiterClassAt(copy, wordDelimiters) == DelimiterClass::RegularChar)
+    if (!_SkipDelimiterClass(copy, classifier, DelimiterClass::RegularChar, true, true))
     {
-        if (!bufferSize.IncrementInBounds(copy))
-        {
-            // last char in buffer is a RegularChar
-            // thus there is no next word
-            return false;
-        }
+        // last char in buffer is a RegularChar
+        // thus there is no next word
+        return false;
     }
 
     // we are already on/past the last RegularChar
@@ -1283,14 +1429,11 @@ bool TextBuffer::MoveToNextWord(COORD& pos, const std::wstring_view wordDelimite
     }
 
     // on whitespace, continue until the beginning of the next word
-    while (_GetDelimiterClassAt(copy, wordDelimiters) != DelimiterClass::RegularChar)
+    if (!_SkipDelimiterClass(copy, classifier, DelimiterClass::RegularChar, false, true))
     {
-        if (!bufferSize.IncrementInBounds(copy))
-        {
-            // last char in buffer is a DelimiterChar or ControlChar
-            // there is no next word
-            return false;
-        }
+        // last char in buffer is a DelimiterChar or ControlChar
+        // there is no next word
+        return false;
     }
 
     // successful move, copy result out
@@ -1318,26 +1461,22 @@ bool TextBuffer::MoveToPreviousWord(COORD& pos, std::wstring_view wordDelimiters
         copy = { bufferSize.RightInclusive(), bufferSize.BottomInclusive() };
     }
 
+    const auto& classifier = _GetDelimiterClassifier(wordDelimiters);
+
     // started on whitespace/delimiter, continue until the end of the previous word
-    while (_GetDelimiterClassAt(copy, wordDelimiters) != DelimiterClass::RegularChar)
+    if (!_SkipDelimiterClass(copy, classifier, DelimiterClass::RegularChar, false, false))
     {
-        if (!bufferSize.DecrementInBounds(copy))
-        {
-            // first char in buffer is a DelimiterChar or ControlChar
-            // there is no previous word
-            return false;
-        }
+        // first char in buffer is a DelimiterChar or ControlChar
+        // there is no previous word
+        return false;
     }
 
     // on a word, continue until the beginning of the word
-    while (_GetDelimiterClassAt(copy, wordDelimiters) == DelimiterClass::RegularChar)
+    if (!_SkipDelimiterClass(copy, classifier, DelimiterClass::RegularChar, true, false))
     {
-        if (!bufferSize.DecrementInBounds(copy))
-        {
-            // first char in buffer is a RegularChar
-            // there is no previous word
-            return false;
-        }
+        // first char in buffer is a RegularChar
+        // there is no previous word
+        return false;
     }
 
     // successful move, copy result out
@@ -1528,6 +1667,40 @@ void TextBuffer::_ExpandTextRow(SMALL_RECT& textRow) const
     }
 }
 
+// Routine Description:
+// - Retrieves the text of a part of a single row, like GetText does without
+//   CR/LF and without trimming. The text is cached by the generation of the
+//   row's characters, so asking again for a row that hasn't changed since
+//   doesn't read it out of the buffer again.
+// Arguments:
+// - rect - the columns of the row to read, inclusive. Top is the row.
+// Return Value:
+// - The text. It's valid until the next call to GetRowText.
+const std::wstring& TextBuffer::GetRowText(const SMALL_RECT& rect) const
+{
+    const auto generation = GetRowByOffset(rect.Top).GetCharRow().GetGeneration();
+
+    if (_rowTextCache.empty())
+    {
+        _rowTextCache.resize(_rowTextCacheSize);
+    }
+
+    // Generations are handed out in order, so rows written one after another
+    // land in different entries.
+    auto& entry = til::at(_rowTextCache, generation % _rowTextCacheSize);
+    if (entry.generation != generation || entry.left != rect.Left || entry.right != rect.Right)
+    {
+        // Clear the entry first, so that it isn't left half updated if reading
+        // the text throws.
+        entry.generation = 0;
+        entry.text = std::move(GetText(false, false, { rect }).text.at(0));
+        entry.left = rect.Left;
+        entry.right = rect.Right;
+        entry.generation = generation;
+    }
+    return entry.text;
+}
+
 // Routine Description:
 // - Retrieves the text data from the selected region and presents it in a clipboard-ready format (given little post-processing).
 // Arguments:
@@ -95,6 +95,12 @@ public:
                                  const std::optional<bool> setWrap = std::nullopt,
                                  const std::optional<size_t> limitRight = std::nullopt);
 
+    static size_t MeasureNarrowText(const std::wstring_view text) noexcept;
+    size_t WriteNarrowText(const std::wstring_view text,
+                           const TextAttribute& attr,
+                           const COORD target,
+                           const std::optional<bool> wrap = true);
+
     bool InsertCharacter(const wchar_t wch, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool InsertCharacter(const std::wstring_view chars, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool IncrementCursor();
@@ -161,6 +167,8 @@ public:
                                const std::vector<SMALL_RECT>& textRects,
                                std::function<std::pair<COLORREF, COLORREF>(const TextAttribute&)> GetAttributeColors = nullptr) const;
 
+    const std::wstring& GetRowText(const SMALL_RECT& rect) const;
+
     static std::string GenHTML(const TextAndColor& rows,
                                const int fontHeightPoints,
                                const std::wstring_view fontFaceName,
@@ -199,7 +207,25 @@ private:
     std::unordered_map<std::wstring, uint16_t> _hyperlinkCustomIdMap;
     uint16_t _currentHyperlinkId;
 
+    // The word delimiters last asked for, compiled. They rarely change, and
+    // the rows cache which of their columns are in which class for them.
+    mutable std::optional<DelimiterClassifier> _delimiterClassifier;
+
+    // The text last read out of rows by GetRowText, keyed by the generation
+    // of the row's characters and the columns that were read. Accessibility
+    // clients ask for the same rows over and over while little changes.
+    struct RowTextCacheEntry
+    {
+        uint64_t generation{ 0 };
+        SHORT left{ 0 };
+        SHORT right{ 0 };
+        std::wstring text;
+    };
+    static constexpr size_t _rowTextCacheSize = 256;
+    mutable std::vector<RowTextCacheEntry> _rowTextCache;
+
     void _RefreshRowIDs(std::optional<SHORT> newRowWidth);
+    void _RefreshRowIDs(const size_t begin, const size_t end);
 
     Microsoft::Console::Render::IRenderTarget& _renderTarget;
 
@@ -221,14 +247,23 @@ private:
 
     void _ExpandTextRow(SMALL_RECT& selectionRow) const;
 
-    const DelimiterClass _GetDelimiterClassAt(const COORD pos, const std::wstring_view wordDelimiters) const;
-    const COORD _GetWordStartForAccessibility(const COORD target, const std::wstring_view wordDelimiters) const;
-    const COORD _GetWordStartForSelection(const COORD target, const std::wstring_view wordDelimiters) const;
-    const COORD _GetWordEndForAccessibility(const COORD target, const std::wstring_view wordDelimiters) const;
-    const COORD _GetWordEndForSelection(const COORD target, const std::wstring_view wordDelimiters) const;
+    const DelimiterClassifier& _GetDelimiterClassifier(const std::wstring_view wordDelimiters) const;
+    const DelimiterClass _GetDelimiterClassAt(const COORD pos, const DelimiterClassifier& classifier) const;
+    bool _SkipDelimiterClass(COORD& pos,
+                             const DelimiterClassifier& classifier,
+                             const DelimiterClass delimiterClass,
+                             const bool skipEqual,
+                             const bool forward) const;
+    const COORD _GetWordStartForAccessibility(const COORD target, const DelimiterClassifier& classifier) const;
+    const COORD _GetWordStartForSelection(const COORD target, const DelimiterClassifier& classifier) const;
+    const COORD _GetWordEndForAccessibility(const COORD target, const DelimiterClassifier& classifier) const;
+    const COORD _GetWordEndForSelection(const COORD target, const DelimiterClassifier& classifier) const;
 
     void _PruneHyperlinks();
 
+    friend class TextBufferSerializer;
+    friend class TextBufferLoader;
+
 #ifdef UNIT_TESTING
     friend class TextBufferTests;
     friend class UiaTextRangeTests;
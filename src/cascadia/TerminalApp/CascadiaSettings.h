@@ -26,6 +26,7 @@ Author(s):
 
 #include "Profile.h"
 #include "ColorScheme.h"
+#include "SettingsSnapshot.h"
 
 // fwdecl unittest classes
 namespace TerminalAppLocalTests
@@ -118,8 +119,12 @@ namespace winrt::TerminalApp::implementation
 
         static bool _IsPackaged();
         static void _WriteSettings(const std::string_view content);
+        static void _WriteFile(const std::filesystem::path& path, const std::string_view content);
         static std::optional<std::string> _ReadUserSettings();
         static std::optional<std::string> _ReadFile(HANDLE hFile);
+        static std::filesystem::path _GetSettingsSnapshotPath();
+        static std::optional<::TerminalApp::SettingsSnapshot::Documents> _ReadSettingsSnapshot(const std::string_view userSettings);
+        static void _WriteSettingsSnapshot(const Json::Value& defaultSettings, const Json::Value& userSettings, const std::string_view userSettingsString);
 
         std::optional<guid> _GetProfileGuidByName(const hstring) const;
         std::optional<guid> _GetProfileGuidByIndex(std::optional<int> index) const;
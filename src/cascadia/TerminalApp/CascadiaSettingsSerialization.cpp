@@ -27,6 +27,8 @@ static constexpr std::wstring_view UnpackagedSettingsFolderName{ L"Microsoft\\Wi
 
 static constexpr std::wstring_view DefaultsFilename{ L"defaults.json" };
 
+static constexpr std::wstring_view SettingsSnapshotFilename{ L"settings.snapshot" };
+
 static constexpr std::string_view SchemaKey{ "$schema" };
 static constexpr std::string_view ProfilesKey{ "profiles" };
 static constexpr std::string_view DefaultSettingsKey{ "defaults" };
@@ -98,20 +100,16 @@ static void _CatchRethrowSerializationExceptionWithLocationInfo(std::string_view
 // - Also runs and dynamic profile generators. If any of those generators create
 //   new profiles, we'll write the user settings back to the file, with the new
 //   profiles inserted into their list of profiles.
+// - If neither the defaults nor the user's settings changed since they were
+//   last loaded, their parsed JSON is loaded from the snapshot saved then,
+//   instead of being parsed again. The snapshot is saved again whenever they
+//   had to be parsed.
 // Return Value:
 // - a unique_ptr containing a new CascadiaSettings object.
 winrt::TerminalApp::CascadiaSettings CascadiaSettings::LoadAll()
 {
     try
     {
-        auto settings = LoadDefaults();
-        auto resultPtr = winrt::get_self<CascadiaSettings>(settings);
-
-        // GH 3588, we need this below to know if the user chose something that wasn't our default.
-        // Collect it up here in case it gets modified by any of the other layers between now and when
-        // the user's preferences are loaded and layered.
-        const auto hardcodedDefaultGuid = resultPtr->GlobalSettings().DefaultProfile();
-
         std::optional<std::string> fileData = _ReadUserSettings();
         const bool foundFile = fileData.has_value();
 
@@ -119,7 +117,37 @@ winrt::TerminalApp::CascadiaSettings CascadiaSettings::LoadAll()
         // like it doesn't exist at all.
         const bool fileHasData = foundFile && !fileData.value().empty();
         bool needToWriteFile = false;
+
+        std::optional<::TerminalApp::SettingsSnapshot::Documents> snapshot;
         if (fileHasData)
+        {
+            snapshot = _ReadSettingsSnapshot(fileData.value());
+        }
+
+        // This is LoadDefaults, except that the defaults may already be parsed.
+        auto resultPtr{ winrt::make_self<CascadiaSettings>() };
+        if (snapshot)
+        {
+            resultPtr->_defaultSettings = std::move(snapshot->defaults);
+        }
+        else
+        {
+            resultPtr->_ParseJsonString(DefaultJson, true);
+        }
+        resultPtr->LayerJson(resultPtr->_defaultSettings);
+        resultPtr->_ResolveDefaultProfile();
+
+        // GH 3588, we need this below to know if the user chose something that wasn't our default.
+        // Collect it up here in case it gets modified by any of the other layers between now and when
+        // the user's preferences are loaded and layered.
+        const auto hardcodedDefaultGuid = resultPtr->GlobalSettings().DefaultProfile();
+
+        if (snapshot)
+        {
+            resultPtr->_userSettings = std::move(snapshot->user);
+            resultPtr->_userSettingsString = fileData.value();
+        }
+        else if (fileHasData)
         {
             resultPtr->_ParseJsonString(fileData.value(), false);
         }
@@ -191,6 +219,12 @@ winrt::TerminalApp::CascadiaSettings CascadiaSettings::LoadAll()
         // If this throws, the app will catch it and use the default settings
         resultPtr->_ValidateSettings();
 
+        // Save what we parsed for the next launch, unless it's already saved.
+        if (!snapshot || needToWriteFile)
+        {
+            _WriteSettingsSnapshot(resultPtr->_defaultSettings, resultPtr->_userSettings, resultPtr->_userSettingsString);
+        }
+
         // GH 3855 - Gathering Data on custom profiles to inform better defaults
         // Do it after everything else so it won't happen unless validation passed.
         // Also, avoid processing unless someone's listening for measures. The keybindings work, at least,
@@ -793,9 +827,22 @@ bool CascadiaSettings::_IsPackaged()
 //      fail to write the file
 void CascadiaSettings::_WriteSettings(const std::string_view content)
 {
-    auto pathToSettingsFile{ CascadiaSettings::GetSettingsPath() };
+    _WriteFile(CascadiaSettings::GetSettingsPath(), content);
+}
 
-    wil::unique_hfile hOut{ CreateFileW(pathToSettingsFile.c_str(),
+// Method Description:
+// - Writes the given content to the given file, replacing anything that was
+//   already in it.
+// Arguments:
+// - path: the file to write
+// - content: the content to write
+// Return Value:
+// - <none>
+//   This can throw an exception if we fail to open the file for writing, or we
+//      fail to write the file
+void CascadiaSettings::_WriteFile(const std::filesystem::path& path, const std::string_view content)
+{
+    wil::unique_hfile hOut{ CreateFileW(path.c_str(),
                                         GENERIC_WRITE,
                                         FILE_SHARE_READ | FILE_SHARE_WRITE,
                                         nullptr,
@@ -908,6 +955,79 @@ std::optional<std::string> CascadiaSettings::_ReadFile(HANDLE hFile)
     return { utf8string };
 }
 
+// Method Description:
+// - Returns the path to the snapshot of the parsed settings. It lives next to
+//   the settings file.
+// Arguments:
+// - <none>
+// Return Value:
+// - the full path to the settings snapshot
+std::filesystem::path CascadiaSettings::_GetSettingsSnapshotPath()
+{
+    auto path{ CascadiaSettings::GetSettingsPath() };
+    path.replace_filename(SettingsSnapshotFilename);
+    return path;
+}
+
+// Method Description:
+// - Loads the parsed defaults and user settings from the snapshot saved by a
+//   previous launch, if there is one and it was made from the same text.
+// Arguments:
+// - userSettings: the text of the user's settings file as it is now
+// Return Value:
+// - the parsed defaults and user settings, or nullopt if they need to be
+//   parsed from their text.
+std::optional<::TerminalApp::SettingsSnapshot::Documents> CascadiaSettings::_ReadSettingsSnapshot(const std::string_view userSettings)
+{
+    try
+    {
+        wil::unique_hfile hFile{ CreateFileW(_GetSettingsSnapshotPath().c_str(),
+                                             GENERIC_READ,
+                                             FILE_SHARE_READ,
+                                             nullptr,
+                                             OPEN_EXISTING,
+                                             FILE_ATTRIBUTE_NORMAL,
+                                             nullptr) };
+        if (!hFile)
+        {
+            // There's no snapshot until settings were parsed once.
+            return std::nullopt;
+        }
+
+        const auto data = _ReadFile(hFile.get());
+        if (!data)
+        {
+            return std::nullopt;
+        }
+
+        return ::TerminalApp::SettingsSnapshot::Load(data.value(), DefaultJson, userSettings);
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+        return std::nullopt;
+    }
+}
+
+// Method Description:
+// - Saves the parsed defaults and user settings for the next launch. Failing
+//   to do so only costs that launch some time, so errors are just logged.
+// Arguments:
+// - defaultSettings: the parsed defaults
+// - userSettings: the parsed user settings
+// - userSettingsString: the text userSettings was parsed from
+// Return Value:
+// - <none>
+void CascadiaSettings::_WriteSettingsSnapshot(const Json::Value& defaultSettings, const Json::Value& userSettings, const std::string_view userSettingsString)
+{
+    try
+    {
+        const auto snapshot = ::TerminalApp::SettingsSnapshot::Serialize(DefaultJson, defaultSettings, userSettingsString, userSettings);
+        _WriteFile(_GetSettingsSnapshotPath(), snapshot);
+    }
+    CATCH_LOG();
+}
+
 // function Description:
 // - Returns the full path to the settings file, either within the application
 //   package, or in its unpackaged location. This path is under the "Local
@@ -361,6 +361,9 @@ namespace winrt::TerminalApp::implementation
     // - <none>
     void CommandPalette::_updateUIForStackChange()
     {
+        // The commands to filter are now different ones.
+        _matcherIsStale = true;
+
         if (_searchBox().Text().empty())
         {
             // Manually call _filterTextChanged, because setting the text to the
@@ -597,6 +600,7 @@ namespace winrt::TerminalApp::implementation
     void CommandPalette::SetCommands(Collections::IVector<TerminalApp::Command> const& actions)
     {
         _allCommands = actions;
+        _matcherIsStale = true;
         _updateFilteredActions();
     }
 
@@ -615,6 +619,7 @@ namespace winrt::TerminalApp::implementation
         if (mode != _currentMode)
         {
             _currentMode = mode;
+            _matcherIsStale = true;
             _filteredActions.Clear();
             auto commandsToFilter = _commandsToFilter();
 
@@ -658,37 +663,10 @@ namespace winrt::TerminalApp::implementation
         return leftName.compare(rightName) < 0;
     }
 
-    // This is a helper struct to aid in sorting Commands by a given weighting.
-    struct WeightedCommand
-    {
-        TerminalApp::Command command;
-        int weight;
-        int inOrderCounter;
-
-        bool operator<(const WeightedCommand& other) const
-        {
-            if (weight == other.weight)
-            {
-                // If two commands have the same weight, then we'll sort them alphabetically.
-                // If they both have the same name, fall back to the order in which they were
-                // pushed into the heap.
-                if (command.Name() == other.command.Name())
-                {
-                    return inOrderCounter > other.inOrderCounter;
-                }
-                else
-                {
-                    return !_compareCommandNames(command, other.command);
-                }
-            }
-            return weight < other.weight;
-        }
-    };
-
     // Method Description:
     // - Produce a list of filtered actions to reflect the current contents of
     //   the input box. For more details on which commands will be displayed,
-    //   see `_getWeight`.
+    //   see `FuzzyMatcher::GetWeight`.
     // Arguments:
     // - A collection that will receive the filtered actions
     // Return Value:
@@ -749,38 +727,34 @@ namespace winrt::TerminalApp::implementation
         //        higher the more recently they were used, then weighting all
         //        the unused commands as 1
 
-        // Use a priority queue to order commands so that "better" matches
-        // appear first in the list. The ordering will be determined by the
-        // match weight produced by _getWeight.
-        std::priority_queue<WeightedCommand> heap;
-
-        // TODO GH#7205: Find a better way to ensure that WCs of the same
-        // weight and name stay in the order in which they were pushed onto
-        // the PQ.
-        uint32_t counter = 0;
-        for (auto action : commandsToFilter)
+        // The matcher keeps the names of the commands between keystrokes, so
+        // only give it new ones when the commands may have changed. The names
+        // of the tabs change whenever their titles do, so those are always
+        // given again. There aren't that many of them.
+        if (_matcherIsStale || _currentMode == CommandPaletteMode::TabSearchMode || _currentMode == CommandPaletteMode::TabSwitchMode)
         {
-            const auto weight = CommandPalette::_getWeight(searchText, action.Name());
-            if (weight > 0)
-            {
-                WeightedCommand wc;
-                wc.command = action;
-                wc.weight = weight;
-                wc.inOrderCounter = counter++;
+            std::vector<std::wstring> names;
+            names.reserve(commandsToFilter.Size());
+            _matcherCommands.clear();
+            _matcherCommands.reserve(commandsToFilter.Size());
 
-                heap.push(wc);
+            for (auto action : commandsToFilter)
+            {
+                names.emplace_back(action.Name());
+                _matcherCommands.push_back(action);
             }
+
+            _matcher.SetNames(std::move(names));
+            _matcherIsStale = false;
         }
 
-        // At this point, all the commands in heap are matches. We've also
-        // sorted commands with the same weight alphabetically.
-        // Remove everything in-order from the queue, and add to the list of
-        // filtered actions.
-        while (!heap.empty())
+        // The matches are ordered so that "better" matches appear first in
+        // the list, then alphabetically.
+        const auto& matches = _matcher.Filter(searchText);
+        actions.reserve(matches.size());
+        for (const auto& match : matches)
         {
-            auto top = heap.top();
-            heap.pop();
-            actions.push_back(top.command);
+            actions.push_back(til::at(_matcherCommands, match.index));
         }
 
         return actions;
@@ -789,7 +763,7 @@ namespace winrt::TerminalApp::implementation
     // Method Description:
     // - Update our list of filtered actions to reflect the current contents of
     //   the input box. For more details on which commands will be displayed,
-    //   see `_getWeight`.
+    //   see `FuzzyMatcher::GetWeight`.
     // Arguments:
     // - <none>
     // Return Value:
@@ -839,92 +813,6 @@ namespace winrt::TerminalApp::implementation
         }
     }
 
-    // Function Description:
-    // - Calculates a "weighting" by which should be used to order a command
-    //   name relative to other names, given a specific search string.
-    //   Currently, this is based off of two factors:
-    //   * The weight is incremented once for each matched character of the
-    //     search text.
-    //   * If a matching character from the search text was found at the start
-    //     of a word in the name, then we increment the weight again.
-    //     * For example, for a search string "sp", we want "Split Pane" to
-    //       appear in the list before "Close Pane"
-    //   * Consecutive matches will be weighted higher than matches with
-    //     characters in between the search characters.
-    // - This will return 0 if the command should not be shown. If all the
-    //   characters of search text appear in order in `name`, then this function
-    //   will return a positive number. There can be any number of characters
-    //   separating consecutive characters in searchText.
-    //   * For example:
-    //      "name": "New Tab"
-    //      "name": "Close Tab"
-    //      "name": "Close Pane"
-    //      "name": "[-] Split Horizontal"
-    //      "name": "[ | ] Split Vertical"
-    //      "name": "Next Tab"
-    //      "name": "Prev Tab"
-    //      "name": "Open Settings"
-    //      "name": "Open Media Controls"
-    //   * "open" should return both "**Open** Settings" and "**Open** Media Controls".
-    //   * "Tab" would return "New **Tab**", "Close **Tab**", "Next **Tab**" and "Prev
-    //     **Tab**".
-    //   * "P" would return "Close **P**ane", "[-] S**p**lit Horizontal", "[ | ]
-    //     S**p**lit Vertical", "**P**rev Tab", "O**p**en Settings" and "O**p**en Media
-    //     Controls".
-    //   * "sv" would return "[ | ] Split Vertical" (by matching the **S** in
-    //     "Split", then the **V** in "Vertical").
-    // Arguments:
-    // - searchText: the string of text to search for in `name`
-    // - name: the name to check
-    // Return Value:
-    // - the relative weight of this match
-    int CommandPalette::_getWeight(const winrt::hstring& searchText,
-                                   const winrt::hstring& name)
-    {
-        int totalWeight = 0;
-        bool lastWasSpace = true;
-
-        auto it = name.cbegin();
-
-        for (auto searchChar : searchText)
-        {
-            searchChar = std::towlower(searchChar);
-            // Advance the iterator to the next character that we're looking
-            // for.
-
-            bool lastWasMatch = true;
-            while (true)
-            {
-                // If we are at the end of the name string, we haven't found
-                // it.
-                if (it == name.cend())
-                {
-                    return false;
-                }
-
-                // found it
-                if (std::towlower(*it) == searchChar)
-                {
-                    break;
-                }
-
-                lastWasSpace = *it == L' ';
-                ++it;
-                lastWasMatch = false;
-            }
-
-            // Advance the iterator by one character so that we don't
-            // end up on the same character in the next iteration.
-            ++it;
-
-            totalWeight += 1;
-            totalWeight += lastWasSpace ? 1 : 0;
-            totalWeight += (lastWasMatch) ? 1 : 0;
-        }
-
-        return totalWeight;
-    }
-
     void CommandPalette::SetDispatch(const winrt::TerminalApp::ShortcutActionDispatch& dispatch)
     {
         _dispatch = dispatch;
@@ -953,6 +841,7 @@ namespace winrt::TerminalApp::implementation
 
         ParentCommandName(L"");
         _currentNestedCommands.Clear();
+        _matcherIsStale = true;
     }
 
     // Method Description:
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "CommandPalette.g.h"
+#include "FuzzyMatcher.h"
 #include "../../cascadia/inc/cppwinrt_utils.h"
 
 namespace winrt::TerminalApp::implementation
@@ -75,7 +76,11 @@ namespace winrt::TerminalApp::implementation
 
         std::vector<winrt::TerminalApp::Command> _collectFilteredActions();
 
-        static int _getWeight(const winrt::hstring& searchText, const winrt::hstring& name);
+        // The commands that _matcher was given the names of, in the same order.
+        ::TerminalApp::FuzzyMatcher _matcher;
+        std::vector<TerminalApp::Command> _matcherCommands;
+        bool _matcherIsStale{ true };
+
         void _close();
 
         CommandPaletteMode _currentMode;
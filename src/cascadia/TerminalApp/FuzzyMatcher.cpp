@@ -0,0 +1,229 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "FuzzyMatcher.h"
+
+using namespace TerminalApp;
+
+// Method Description:
+// - Replaces the names that are matched against, and forgets the last search.
+// Arguments:
+// - names: the names of the commands, in the order the caller keeps them in.
+//   The indices of the matches returned by Filter refer to this order.
+// Return Value:
+// - <none>
+void FuzzyMatcher::SetNames(std::vector<std::wstring> names)
+{
+    _entries.clear();
+    _entries.reserve(names.size());
+
+    for (auto& name : names)
+    {
+        std::wstring lowercase{ name };
+        std::transform(lowercase.begin(), lowercase.end(), lowercase.begin(), std::towlower);
+
+        const auto signature = _GetSignature(lowercase);
+        _entries.push_back({ std::move(name), std::move(lowercase), signature });
+    }
+
+    _lastSearch.clear();
+    _candidates.clear();
+    _candidatesValid = false;
+    _matches.clear();
+}
+
+size_t FuzzyMatcher::GetNameCount() const noexcept
+{
+    return _entries.size();
+}
+
+// Method Description:
+// - Finds the names that match the given search text, best match first. Names
+//   with the same weight are ordered alphabetically, and names that are the
+//   same keep the order they were given in. For how names are weighted, see
+//   GetWeight.
+// - If the search text starts with the text of the last search, only the names
+//   that matched the last search are checked again.
+// Arguments:
+// - searchText: the text to search for. Nothing matches the empty string.
+// Return Value:
+// - The matches. They stay valid until the next call to Filter or SetNames.
+const std::vector<FuzzyMatcher::Match>& FuzzyMatcher::Filter(const std::wstring_view searchText)
+{
+    std::wstring search{ searchText };
+    std::transform(search.begin(), search.end(), search.begin(), std::towlower);
+
+    // Every name that matches "abc" also matches "ab", so when the search only
+    // grew at its end, there's no need to look past the last matches.
+    const auto narrowing = _candidatesValid &&
+                           search.size() >= _lastSearch.size() &&
+                           search.compare(0, _lastSearch.size(), _lastSearch) == 0;
+
+    const auto signature = _GetSignature(search);
+
+    std::vector<size_t> candidates;
+    _matches.clear();
+
+    const auto tryMatch = [&](const size_t index) {
+        const auto& entry = til::at(_entries, index);
+        if ((entry.signature & signature) != signature)
+        {
+            return;
+        }
+
+        const auto weight = _GetWeight(search, entry);
+        if (weight > 0)
+        {
+            candidates.push_back(index);
+            _matches.push_back({ index, weight });
+        }
+    };
+
+    if (narrowing)
+    {
+        for (const auto index : _candidates)
+        {
+            tryMatch(index);
+        }
+    }
+    else
+    {
+        for (size_t index = 0; index < _entries.size(); ++index)
+        {
+            tryMatch(index);
+        }
+    }
+
+    // The candidates were visited in order, so a stable sort keeps identical
+    // names in the order they were given in.
+    std::stable_sort(_matches.begin(), _matches.end(), [this](const Match& lhs, const Match& rhs) {
+        if (lhs.weight != rhs.weight)
+        {
+            return lhs.weight > rhs.weight;
+        }
+        return std::wstring_view{ til::at(_entries, lhs.index).name } < std::wstring_view{ til::at(_entries, rhs.index).name };
+    });
+
+    _lastSearch = std::move(search);
+    _candidates = std::move(candidates);
+    _candidatesValid = !_lastSearch.empty();
+
+    return _matches;
+}
+
+// Function Description:
+// - Calculates a "weighting" by which should be used to order a command
+//   name relative to other names, given a specific search string.
+//   Currently, this is based off of three factors:
+//   * The weight is incremented once for each matched character of the
+//     search text.
+//   * If a matching character from the search text was found at the start
+//     of a word in the name, then we increment the weight again.
+//     * For example, for a search string "sp", we want "Split Pane" to
+//       appear in the list before "Close Pane"
+//   * Consecutive matches will be weighted higher than matches with
+//     characters in between the search characters.
+// - This will return 0 if the command should not be shown. If all the
+//   characters of search text appear in order in `name`, then this function
+//   will return a positive number. There can be any number of characters
+//   separating consecutive characters in searchText.
+//   * For example, "sv" matches "[ | ] Split Vertical" (by matching the **S**
+//     in "Split", then the **V** in "Vertical").
+// - The comparison ignores case.
+// Arguments:
+// - searchText: the string of text to search for in `name`
+// - name: the name to check
+// Return Value:
+// - the relative weight of this match
+int FuzzyMatcher::GetWeight(const std::wstring_view searchText, const std::wstring_view name)
+{
+    std::wstring search{ searchText };
+    std::transform(search.begin(), search.end(), search.begin(), std::towlower);
+
+    Entry entry{ std::wstring{ name }, std::wstring{ name }, 0 };
+    std::transform(entry.lowercase.begin(), entry.lowercase.end(), entry.lowercase.begin(), std::towlower);
+
+    return _GetWeight(search, entry);
+}
+
+// Function Description:
+// - Sets a bit for each kind of character in the given string: one for each
+//   letter and digit, a few shared by the rest of ASCII, and one for anything
+//   else. If a name lacks a bit that the search text has, it can't match.
+// Arguments:
+// - lowercase: the lowercased string
+// Return Value:
+// - the signature of the string
+uint64_t FuzzyMatcher::_GetSignature(const std::wstring_view lowercase) noexcept
+{
+    uint64_t signature = 0;
+    for (const auto ch : lowercase)
+    {
+        unsigned int bit;
+        if (ch >= L'a' && ch <= L'z')
+        {
+            bit = ch - L'a';
+        }
+        else if (ch >= L'0' && ch <= L'9')
+        {
+            bit = 26 + (ch - L'0');
+        }
+        else if (ch < 0x80)
+        {
+            bit = 36 + (ch % 27);
+        }
+        else
+        {
+            bit = 63;
+        }
+        signature |= uint64_t{ 1 } << bit;
+    }
+    return signature;
+}
+
+// Function Description:
+// - Weighs the given lowercased search text against a name. See GetWeight.
+// - Each character of the search text is looked for with a single find on the
+//   rest of the name, which the standard library does with a vectorized
+//   character search, instead of testing the name one character at a time.
+// Arguments:
+// - search: the lowercased search text
+// - entry: the name to check
+// Return Value:
+// - the relative weight of this match, or 0 if it doesn't match.
+int FuzzyMatcher::_GetWeight(const std::wstring_view search, const Entry& entry) noexcept
+{
+    const std::wstring_view name{ entry.lowercase };
+
+    int totalWeight = 0;
+    bool lastWasSpace = true;
+    size_t start = 0;
+
+    for (const auto searchChar : search)
+    {
+        const auto found = name.find(searchChar, start);
+        if (found == std::wstring_view::npos)
+        {
+            return 0;
+        }
+
+        // lastWasSpace only changes when we had to skip over characters to
+        // find this one. It then tells if this one starts a word.
+        const auto lastWasMatch = found == start;
+        if (!lastWasMatch)
+        {
+            lastWasSpace = til::at(name, found - 1) == L' ';
+        }
+
+        // Advance by one character so that we don't end up on the same
+        // character for the next one.
+        start = found + 1;
+
+        totalWeight += 1;
+        totalWeight += lastWasSpace ? 1 : 0;
+        totalWeight += lastWasMatch ? 1 : 0;
+    }
+
+    return totalWeight;
+}
@@ -0,0 +1,61 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- FuzzyMatcher.h
+
+Abstract:
+- Matches the command palette's search text against the names of the commands
+  it can show, and orders the matches by how well they match.
+- It knows nothing about the UI. The palette hands it the names once, and the
+  matcher keeps a lowercased copy and a signature of the characters in each one.
+  A name missing any character of the search text is rejected by its signature
+  without being scanned at all.
+- Typing another character at the end of the search text only ever removes
+  matches, so in that case only the previous matches are looked at again.
+
+--*/
+#pragma once
+
+namespace TerminalApp
+{
+    class FuzzyMatcher;
+};
+
+class TerminalApp::FuzzyMatcher final
+{
+public:
+    struct Match
+    {
+        size_t index; // into the names given to SetNames
+        int weight;
+    };
+
+    void SetNames(std::vector<std::wstring> names);
+    size_t GetNameCount() const noexcept;
+
+    const std::vector<Match>& Filter(const std::wstring_view searchText);
+
+    static int GetWeight(const std::wstring_view searchText, const std::wstring_view name);
+
+private:
+    struct Entry
+    {
+        std::wstring name;
+        std::wstring lowercase;
+        uint64_t signature;
+    };
+
+    static uint64_t _GetSignature(const std::wstring_view lowercase) noexcept;
+    static int _GetWeight(const std::wstring_view lowercaseSearch, const Entry& entry) noexcept;
+
+    std::vector<Entry> _entries;
+
+    // The last search, and the indices of the names that matched it, in order.
+    std::wstring _lastSearch;
+    std::vector<size_t> _candidates;
+    bool _candidatesValid{ false };
+
+    std::vector<Match> _matches;
+};
@@ -45,6 +45,7 @@ static constexpr std::string_view DebugFeaturesKey{ "debugFeatures" };
 static constexpr std::string_view ForceFullRepaintRenderingKey{ "experimental.rendering.forceFullRepaint" };
 static constexpr std::string_view SoftwareRenderingKey{ "experimental.rendering.software" };
 static constexpr std::string_view ForceVTInputKey{ "experimental.input.forceVT" };
+static constexpr std::string_view MouseMotionRateLimitKey{ "experimental.input.mouseMotionRateLimit" };
 
 #ifdef _DEBUG
 static constexpr bool debugFeaturesDefault{ true };
@@ -147,6 +148,7 @@ void GlobalAppSettings::LayerJson(const Json::Value& json)
 
     JsonUtils::GetValueForKey(json, SoftwareRenderingKey, _SoftwareRendering);
     JsonUtils::GetValueForKey(json, ForceVTInputKey, _ForceVTInput);
+    JsonUtils::GetValueForKey(json, MouseMotionRateLimitKey, _MouseMotionRateLimit);
 
     JsonUtils::GetValueForKey(json, EnableStartupTaskKey, _StartOnUserLogin);
 
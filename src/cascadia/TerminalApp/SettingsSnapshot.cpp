@@ -0,0 +1,308 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "SettingsSnapshot.h"
+
+using namespace TerminalApp;
+
+namespace
+{
+    // The header of a snapshot. The two documents follow it, defaults first.
+    struct Header
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t reserved;
+        uint64_t defaultsHash;
+        uint64_t defaultsLength;
+        uint64_t userHash;
+        uint64_t userLength;
+    };
+}
+
+// Function Description:
+// - Hashes the given text with 64-bit FNV-1a.
+// Arguments:
+// - content: the text to hash
+// Return Value:
+// - the hash of the text
+uint64_t SettingsSnapshot::HashContent(const std::string_view content) noexcept
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const auto ch : content)
+    {
+        hash ^= static_cast<uint8_t>(ch);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Function Description:
+// - Saves the given parsed documents into a snapshot keyed by the text they
+//   were parsed from.
+// Arguments:
+// - defaultsText: the text that `defaults` was parsed from
+// - defaults: the parsed defaults
+// - userText: the text that `user` was parsed from
+// - user: the parsed user settings
+// Return Value:
+// - the snapshot
+std::string SettingsSnapshot::Serialize(const std::string_view defaultsText,
+                                        const Json::Value& defaults,
+                                        const std::string_view userText,
+                                        const Json::Value& user)
+{
+    Header header{};
+    header.magic = Magic;
+    header.version = Version;
+    header.defaultsHash = HashContent(defaultsText);
+    header.defaultsLength = defaultsText.size();
+    header.userHash = HashContent(userText);
+    header.userLength = userText.size();
+
+    std::string out;
+    out.reserve(sizeof(header) + defaultsText.size() / 2 + userText.size() / 2);
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    _WriteValue(out, defaults);
+    _WriteValue(out, user);
+    return out;
+}
+
+// Function Description:
+// - Loads the documents from a snapshot, if it was made from the given text.
+// Arguments:
+// - snapshot: the snapshot, as written by Serialize
+// - defaultsText: the text of the defaults as it is now
+// - userText: the text of the user settings as it is now
+// Return Value:
+// - the parsed documents, or nullopt if the snapshot doesn't match the text,
+//   is from another version, or is damaged. Callers should parse the text
+//   themselves in that case.
+std::optional<SettingsSnapshot::Documents> SettingsSnapshot::Load(const std::string_view snapshot,
+                                                                  const std::string_view defaultsText,
+                                                                  const std::string_view userText)
+{
+    Header header;
+    if (snapshot.size() < sizeof(header))
+    {
+        return std::nullopt;
+    }
+    memcpy(&header, snapshot.data(), sizeof(header));
+
+    if (header.magic != Magic ||
+        header.version != Version ||
+        header.defaultsLength != defaultsText.size() ||
+        header.userLength != userText.size() ||
+        header.defaultsHash != HashContent(defaultsText) ||
+        header.userHash != HashContent(userText))
+    {
+        return std::nullopt;
+    }
+
+    try
+    {
+        auto in = snapshot.substr(sizeof(header));
+
+        Documents documents;
+        documents.defaults = _ReadValue(in, 0);
+        documents.user = _ReadValue(in, 0);
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), !in.empty());
+
+        return documents;
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+        return std::nullopt;
+    }
+}
+
+void SettingsSnapshot::_WriteVarint(std::string& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void SettingsSnapshot::_WriteString(std::string& out, const char* begin, const char* end)
+{
+    _WriteVarint(out, gsl::narrow_cast<uint64_t>(end - begin));
+    out.append(begin, end);
+}
+
+// Function Description:
+// - Writes a value and everything in it. Each value is its type, its offsets
+//   and then its contents. Integers are written as varints, signed ones
+//   zigzag encoded so that small negative numbers stay small.
+// Arguments:
+// - out: the string to append the value to
+// - value: the value to write
+// Return Value:
+// - <none>
+void SettingsSnapshot::_WriteValue(std::string& out, const Json::Value& value)
+{
+    const auto type = value.type();
+    out.push_back(static_cast<char>(type));
+    _WriteVarint(out, gsl::narrow_cast<uint64_t>(value.getOffsetStart()));
+    _WriteVarint(out, gsl::narrow_cast<uint64_t>(value.getOffsetLimit()));
+
+    switch (type)
+    {
+    case Json::nullValue:
+        break;
+    case Json::intValue:
+    {
+        const auto i = value.asLargestInt();
+        _WriteVarint(out, (static_cast<uint64_t>(i) << 1) ^ static_cast<uint64_t>(i >> 63));
+        break;
+    }
+    case Json::uintValue:
+        _WriteVarint(out, value.asLargestUInt());
+        break;
+    case Json::realValue:
+    {
+        const auto d = value.asDouble();
+        out.append(reinterpret_cast<const char*>(&d), sizeof(d));
+        break;
+    }
+    case Json::stringValue:
+    {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        value.getString(&begin, &end);
+        _WriteString(out, begin, end);
+        break;
+    }
+    case Json::booleanValue:
+        out.push_back(value.asBool() ? 1 : 0);
+        break;
+    case Json::arrayValue:
+        _WriteVarint(out, value.size());
+        for (const auto& element : value)
+        {
+            _WriteValue(out, element);
+        }
+        break;
+    case Json::objectValue:
+        _WriteVarint(out, value.size());
+        for (auto it = value.begin(); it != value.end(); ++it)
+        {
+            const auto name = it.name();
+            _WriteString(out, name.data(), name.data() + name.size());
+            _WriteValue(out, *it);
+        }
+        break;
+    }
+}
+
+uint64_t SettingsSnapshot::_ReadVarint(std::string_view& in)
+{
+    uint64_t value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7)
+    {
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), in.empty());
+        const auto byte = static_cast<uint8_t>(in.front());
+        in.remove_prefix(1);
+
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return value;
+        }
+    }
+    THROW_HR(HRESULT_FROM_WIN32(ERROR_INVALID_DATA));
+}
+
+std::string_view SettingsSnapshot::_ReadBytes(std::string_view& in, const size_t count)
+{
+    THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), count > in.size());
+    const auto bytes = in.substr(0, count);
+    in.remove_prefix(count);
+    return bytes;
+}
+
+// Function Description:
+// - Reads a value written by _WriteValue.
+// Arguments:
+// - in: the rest of the snapshot. Advanced past the value.
+// - depth: how deeply nested the value is
+// Return Value:
+// - the value
+Json::Value SettingsSnapshot::_ReadValue(std::string_view& in, const size_t depth)
+{
+    THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), depth > MaxDepth);
+
+    const auto type = static_cast<Json::ValueType>(static_cast<uint8_t>(_ReadBytes(in, 1).front()));
+    const auto offsetStart = gsl::narrow<ptrdiff_t>(_ReadVarint(in));
+    const auto offsetLimit = gsl::narrow<ptrdiff_t>(_ReadVarint(in));
+
+    Json::Value value;
+    switch (type)
+    {
+    case Json::nullValue:
+        break;
+    case Json::intValue:
+    {
+        const auto zigzag = _ReadVarint(in);
+        value = static_cast<Json::LargestInt>((zigzag >> 1) ^ (0 - (zigzag & 1)));
+        break;
+    }
+    case Json::uintValue:
+        value = static_cast<Json::LargestUInt>(_ReadVarint(in));
+        break;
+    case Json::realValue:
+    {
+        double d;
+        const auto bytes = _ReadBytes(in, sizeof(d));
+        memcpy(&d, bytes.data(), sizeof(d));
+        value = d;
+        break;
+    }
+    case Json::stringValue:
+    {
+        const auto string = _ReadBytes(in, gsl::narrow<size_t>(_ReadVarint(in)));
+        value = Json::Value{ string.data(), string.data() + string.size() };
+        break;
+    }
+    case Json::booleanValue:
+        value = _ReadBytes(in, 1).front() != 0;
+        break;
+    case Json::arrayValue:
+    {
+        const auto count = _ReadVarint(in);
+        // Every element takes at least 3 bytes, so a count that couldn't
+        // possibly fit is damage, not a reason to allocate.
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), count > in.size() / 3);
+
+        value = Json::Value{ Json::arrayValue };
+        value.resize(gsl::narrow<Json::ArrayIndex>(count));
+        for (Json::ArrayIndex i = 0; i < count; ++i)
+        {
+            value[i] = _ReadValue(in, depth + 1);
+        }
+        break;
+    }
+    case Json::objectValue:
+    {
+        const auto count = _ReadVarint(in);
+        value = Json::Value{ Json::objectValue };
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            const auto name = _ReadBytes(in, gsl::narrow<size_t>(_ReadVarint(in)));
+            value[Json::String{ name }] = _ReadValue(in, depth + 1);
+        }
+        break;
+    }
+    default:
+        THROW_HR(HRESULT_FROM_WIN32(ERROR_INVALID_DATA));
+    }
+
+    value.setOffsetStart(offsetStart);
+    value.setOffsetLimit(offsetLimit);
+    return value;
+}
@@ -0,0 +1,61 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- SettingsSnapshot.h
+
+Abstract:
+- Saves the parsed defaults and user settings documents in a compact binary
+  form, so that the next launch can load them without parsing the JSON again.
+- A snapshot is keyed by a hash and the length of the text of each document.
+  It's only used if both still match the text that was read at startup, and
+  it's ignored if it was written by another version of this format.
+- The offsets of the values into their text are kept, because the settings
+  loader uses them to patch the user's settings and to report errors.
+  Comments are not kept.
+
+--*/
+#pragma once
+
+namespace TerminalApp
+{
+    class SettingsSnapshot;
+};
+
+class TerminalApp::SettingsSnapshot final
+{
+public:
+    static constexpr uint32_t Magic = 0x504E5354; // "TSNP"
+    static constexpr uint16_t Version = 1;
+
+    struct Documents
+    {
+        Json::Value defaults;
+        Json::Value user;
+    };
+
+    static uint64_t HashContent(const std::string_view content) noexcept;
+
+    static std::string Serialize(const std::string_view defaultsText,
+                                 const Json::Value& defaults,
+                                 const std::string_view userText,
+                                 const Json::Value& user);
+
+    static std::optional<Documents> Load(const std::string_view snapshot,
+                                         const std::string_view defaultsText,
+                                         const std::string_view userText);
+
+private:
+    // Values nested deeper than this aren't loaded. This matches the stack
+    // limit of the JSON reader.
+    static constexpr size_t MaxDepth = 1000;
+
+    static void _WriteVarint(std::string& out, uint64_t value);
+    static void _WriteString(std::string& out, const char* begin, const char* end);
+    static void _WriteValue(std::string& out, const Json::Value& value);
+
+    static uint64_t _ReadVarint(std::string_view& in);
+    static std::string_view _ReadBytes(std::string_view& in, const size_t count);
+    static Json::Value _ReadValue(std::string_view& in, const size_t depth);
+};
@@ -171,6 +171,7 @@ namespace winrt::TerminalApp::implementation
         _ForceFullRepaintRendering = globalSettings.ForceFullRepaintRendering();
         _SoftwareRendering = globalSettings.SoftwareRendering();
         _ForceVTInput = globalSettings.ForceVTInput();
+        _MouseMotionRateLimit = globalSettings.MouseMotionRateLimit();
     }
 
     // Method Description:
@@ -112,6 +112,7 @@ namespace winrt::TerminalApp::implementation
         GETSET_PROPERTY(bool, ForceFullRepaintRendering, false);
         GETSET_PROPERTY(bool, SoftwareRendering, false);
         GETSET_PROPERTY(bool, ForceVTInput, false);
+        GETSET_PROPERTY(uint32_t, MouseMotionRateLimit, 0);
 
 #pragma warning(pop)
 
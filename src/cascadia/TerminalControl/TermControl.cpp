@@ -67,6 +67,7 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         _autoScrollVelocity{ 0 },
         _autoScrollingPointerPoint{ std::nullopt },
         _autoScrollTimer{},
+        _mouseMotionFlushTimer{},
         _lastAutoScrollUpdateTime{ std::nullopt },
         _desiredFont{ DEFAULT_FONT_FACE, 0, DEFAULT_FONT_WEIGHT, { 0, DEFAULT_FONT_SIZE }, CP_UTF8 },
         _actualFont{ DEFAULT_FONT_FACE, 0, DEFAULT_FONT_WEIGHT, { 0, DEFAULT_FONT_SIZE }, CP_UTF8, false },
@@ -101,9 +102,16 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         auto pfnCopyToClipboard = std::bind(&TermControl::_CopyToClipboard, this, std::placeholders::_1);
         _terminal->SetCopyToClipboardCallback(pfnCopyToClipboard);
 
+        // The output is parsed on the workers of the scheduler shared by all
+        // the controls, rather than on the thread of the connection.
+        _outputScheduler = ::Microsoft::Terminal::Core::OutputScheduler::GetShared();
+        _outputQueue = _outputScheduler->CreateQueue(*_terminal);
+
         // This event is explicitly revoked in the destructor: does not need weak_ref
+        // Writing waits while the queue is full, which holds back the
+        // connection until the terminal catches up.
         auto onReceiveOutputFn = [this](const hstring str) {
-            _terminal->Write(str);
+            _outputQueue->Write(str);
         };
         _connectionOutputEventToken = _connection.TerminalOutput(onReceiveOutputFn);
 
@@ -169,6 +177,8 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         _autoScrollTimer.Interval(AutoScrollUpdateInterval);
         _autoScrollTimer.Tick({ this, &TermControl::_UpdateAutoScroll });
 
+        _mouseMotionFlushTimer.Tick({ this, &TermControl::_MouseMotionFlushTimerTick });
+
         _ApplyUISettings();
     }
 
@@ -632,6 +642,9 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
             // Set up the DX Engine
             auto dxEngine = std::make_unique<::Microsoft::Console::Render::DxEngine>();
             _renderer->AddRenderEngine(dxEngine.get());
+            // We change the engine's settings and size while only holding the
+            // terminal's lock, so it can't be painted without it.
+            _renderer->PaintUnderConsoleLock(dxEngine.get());
 
             // Initialize our font with the renderer
             // We don't have to care about DPI. We'll get a change message immediately if it's not 96
@@ -1043,7 +1056,20 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
 
         const auto modifiers = _GetPressedModifierKeys();
         const TerminalInput::MouseButtonState state{ props.IsLeftButtonPressed(), props.IsMiddleButtonPressed(), props.IsRightButtonPressed() };
-        return _terminal->SendMouseEvent(terminalPosition, uiButton, modifiers, sWheelDelta, state);
+        const auto handled = _terminal->SendMouseEvent(terminalPosition, uiButton, modifiers, sWheelDelta, state);
+
+        // If the motion rate limit held this event back, send it once the
+        // mouse has been idle for as long as the limit allows between events.
+        // Starting the timer again restarts it, so it only fires when the
+        // mouse stops.
+        if (_terminal->HasPendingMouseMotion())
+        {
+            const auto maxRate = _settings.MouseMotionRateLimit();
+            _mouseMotionFlushTimer.Interval(maxRate ? std::chrono::duration_cast<winrt::Windows::Foundation::TimeSpan>(std::chrono::seconds(1)) / maxRate : winrt::Windows::Foundation::TimeSpan{});
+            _mouseMotionFlushTimer.Start();
+        }
+
+        return handled;
     }
 
     // Method Description:
@@ -1766,6 +1792,7 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         }
 
         _focused = true;
+        _outputQueue->SetFocused(true);
 
         InputPane::GetForCurrentView().TryShow();
 
@@ -1830,6 +1857,7 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         }
 
         _focused = false;
+        _outputQueue->SetFocused(false);
 
         if (_uiaEngine.get())
         {
@@ -1862,14 +1890,31 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
     // - <none>
     void TermControl::_SendInputToConnection(const winrt::hstring& wstr)
     {
+        _NotifyUserInput();
         _connection.WriteInput(wstr);
     }
 
     void TermControl::_SendInputToConnection(std::wstring_view wstr)
     {
+        _NotifyUserInput();
         _connection.WriteInput(wstr);
     }
 
+    // Method Description:
+    // - Lets the renderer know the user sent input, so whatever it echoes is
+    //   painted right away instead of after the usual gap between frames.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void TermControl::_NotifyUserInput()
+    {
+        if (_renderer)
+        {
+            _renderer->NotifyUserInput();
+        }
+    }
+
     // Method Description:
     // - Pre-process text pasted (presumably from the clipboard)
     //   before sending it over the terminal's connection, converting
@@ -2080,6 +2125,23 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         }
     }
 
+    // Method Description:
+    // - Sends the mouse motion that the motion rate limit held back, now that
+    //   the mouse has stopped moving.
+    // Arguments:
+    // - sender: not used
+    // - e: not used
+    void TermControl::_MouseMotionFlushTimerTick(Windows::Foundation::IInspectable const& /* sender */,
+                                                 Windows::Foundation::IInspectable const& /* e */)
+    {
+        _mouseMotionFlushTimer.Stop();
+        if (!_closing)
+        {
+            auto lock = _terminal->LockForWriting();
+            _terminal->FlushPendingMouseMotion();
+        }
+    }
+
     // Method Description:
     // - Sets selection's end position to match supplied cursor position, e.g. while mouse dragging.
     // Arguments:
@@ -2350,8 +2412,13 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
             _connection.TerminalOutput(_connectionOutputEventToken);
             _connectionStateChangedRevoker.revoke();
 
+            // Drop the output that hasn't been processed yet, and wait for
+            // the batch that is, so the terminal isn't written to anymore.
+            _outputQueue->Close();
+
             TSFInputControl().Close(); // Disconnect the TSF input control so it doesn't receive EditContext events.
             _autoScrollTimer.Stop();
+            _mouseMotionFlushTimer.Stop();
 
             // GH#1996 - Close the connection asynchronously on a background
             // thread.
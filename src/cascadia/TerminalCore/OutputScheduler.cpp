@@ -0,0 +1,337 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "OutputScheduler.hpp"
+#include "Terminal.hpp"
+
+using namespace Microsoft::Terminal::Core;
+
+// Routine Description:
+// - Creates a scheduler and starts its workers.
+// Arguments:
+// - threadCount: the number of workers. With none, nothing is processed until
+//   ProcessOne is called, which makes the order of work predictable in tests.
+OutputScheduler::OutputScheduler(const size_t threadCount) :
+    _focusedBatches{ 0 },
+    _stopping{ false }
+{
+    _workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        _workers.emplace_back([this]() { _WorkerLoop(); });
+    }
+}
+
+OutputScheduler::~OutputScheduler()
+{
+    {
+        std::lock_guard<std::mutex> guard{ _mutex };
+        _stopping = true;
+    }
+    _wake.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+// Routine Description:
+// - Gets the scheduler shared by every terminal in the process, creating it
+//   if there isn't one. It's destroyed along with the last reference to it.
+// Arguments:
+// - <none>
+// Return Value:
+// - the shared scheduler
+std::shared_ptr<OutputScheduler> OutputScheduler::GetShared()
+{
+    static std::mutex mutex;
+    static std::weak_ptr<OutputScheduler> shared;
+
+    std::lock_guard<std::mutex> guard{ mutex };
+    auto scheduler = shared.lock();
+    if (!scheduler)
+    {
+        // Half the processors is plenty: the connections and the renderers
+        // need threads of their own.
+        const size_t threadCount = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+        scheduler = std::make_shared<OutputScheduler>(threadCount);
+        shared = scheduler;
+    }
+    return scheduler;
+}
+
+// Routine Description:
+// - Creates the queue that the output for the given terminal is written to.
+// Arguments:
+// - terminal: the terminal to process the output with. It must outlive the
+//   queue, or the queue must be closed first.
+// - maxPendingCharacters: writes wait while this many characters are pending.
+// Return Value:
+// - the queue
+std::shared_ptr<OutputScheduler::Queue> OutputScheduler::CreateQueue(Terminal& terminal, const size_t maxPendingCharacters)
+{
+    return std::make_shared<Queue>(*this, terminal, maxPendingCharacters);
+}
+
+// Routine Description:
+// - Processes one batch of output of the next ready terminal on this thread.
+// Arguments:
+// - <none>
+// Return Value:
+// - true if there was output to process.
+bool OutputScheduler::ProcessOne()
+{
+    std::unique_lock<std::mutex> lock{ _mutex };
+    const auto queue = _TakeReady();
+    if (!queue)
+    {
+        return false;
+    }
+
+    _ProcessBatch(lock, *queue);
+    return true;
+}
+
+void OutputScheduler::_WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock{ _mutex };
+    while (!_stopping)
+    {
+        if (const auto queue = _TakeReady())
+        {
+            _ProcessBatch(lock, *queue);
+        }
+        else
+        {
+            _wake.wait(lock);
+        }
+    }
+}
+
+// Routine Description:
+// - Takes the next terminal off the ready lists. Focused terminals come first,
+//   except for every MaxFocusedBatches-th batch, which goes to another one.
+// - The scheduler's mutex must be held.
+// Arguments:
+// - <none>
+// Return Value:
+// - the queue of the terminal, or nullptr if none is ready
+std::shared_ptr<OutputScheduler::Queue> OutputScheduler::_TakeReady() noexcept
+{
+    const auto preferOthers = _focusedBatches >= MaxFocusedBatches && !_ready.empty();
+    auto& list = (_focusedReady.empty() || preferOthers) ? _ready : _focusedReady;
+    if (list.empty())
+    {
+        return nullptr;
+    }
+
+    _focusedBatches = &list == &_focusedReady ? _focusedBatches + 1 : 0;
+
+    auto queue = std::move(list.front());
+    list.pop_front();
+    queue->_scheduled = false;
+    return queue;
+}
+
+// Routine Description:
+// - Puts a terminal at the back of the ready list for its focus, and wakes a
+//   worker to process it.
+// - The scheduler's mutex must be held.
+// Arguments:
+// - queue: the queue of the terminal
+// Return Value:
+// - <none>
+void OutputScheduler::_MakeReady(const std::shared_ptr<Queue>& queue)
+{
+    queue->_scheduled = true;
+    (queue->_focused ? _focusedReady : _ready).push_back(queue);
+    _wake.notify_one();
+}
+
+// Routine Description:
+// - Processes up to MaxBatchSize characters of the pending output of a
+//   terminal. The mutex is released while the terminal is written to.
+// - Since a queue is only ever on a ready list once, and isn't put back on
+//   one until the batch is done, no other thread processes it meanwhile.
+// Arguments:
+// - lock: the lock on the scheduler's mutex
+// - queue: the queue to process
+// Return Value:
+// - <none>
+void OutputScheduler::_ProcessBatch(std::unique_lock<std::mutex>& lock, Queue& queue)
+{
+    std::vector<std::wstring> batch;
+    size_t characters = 0;
+    while (!queue._chunks.empty() && (batch.empty() || characters + queue._chunks.front().size() <= MaxBatchSize))
+    {
+        characters += queue._chunks.front().size();
+        batch.emplace_back(std::move(queue._chunks.front()));
+        queue._chunks.pop_front();
+    }
+    queue._pendingCharacters -= characters;
+    queue._running = true;
+
+    // There's room in the queue again for writes that were waiting.
+    queue._drained.notify_all();
+
+    lock.unlock();
+    for (const auto& chunk : batch)
+    {
+        try
+        {
+            queue._terminal.Write(chunk);
+        }
+        CATCH_LOG();
+    }
+    lock.lock();
+
+    queue._running = false;
+    queue._processedCharacters += characters;
+    queue._batches++;
+
+    if (!queue._closed && !queue._chunks.empty())
+    {
+        _MakeReady(queue.shared_from_this());
+    }
+    else
+    {
+        queue._drained.notify_all();
+    }
+}
+
+OutputScheduler::Queue::Queue(OutputScheduler& scheduler, Terminal& terminal, const size_t maxPendingCharacters) noexcept :
+    _scheduler{ scheduler },
+    _terminal{ terminal },
+    _maxPendingCharacters{ maxPendingCharacters },
+    _pendingCharacters{ 0 },
+    _processedCharacters{ 0 },
+    _batches{ 0 },
+    _focused{ false },
+    _scheduled{ false },
+    _running{ false },
+    _closed{ false }
+{
+}
+
+// Routine Description:
+// - Adds output to be processed after everything written before it. Nothing
+//   is added once the queue is closed.
+// - While the queue has its limit of pending characters, this waits until a
+//   worker takes some of them, or until the queue is closed. That holds back
+//   the thread of the connection, so output can't pile up without bound when
+//   a client writes faster than the terminal can process it.
+// Arguments:
+// - string: the output
+// Return Value:
+// - <none>
+void OutputScheduler::Queue::Write(const std::wstring_view string)
+{
+    if (string.empty())
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock{ _scheduler._mutex };
+    _drained.wait(lock, [this]() { return _closed || _pendingCharacters < _maxPendingCharacters; });
+    if (_closed)
+    {
+        return;
+    }
+
+    if (!_chunks.empty() && _chunks.back().size() + string.size() <= MaxChunkSize)
+    {
+        _chunks.back().append(string);
+    }
+    else
+    {
+        _chunks.emplace_back(string);
+    }
+    _pendingCharacters += string.size();
+
+    if (!_scheduled && !_running)
+    {
+        _scheduler._MakeReady(shared_from_this());
+    }
+}
+
+// Routine Description:
+// - Sets whether the terminal has the user's focus. If it's waiting to be
+//   processed, it's moved to the back of the ready list for its new focus.
+// Arguments:
+// - focused: true if the terminal has the focus
+// Return Value:
+// - <none>
+void OutputScheduler::Queue::SetFocused(const bool focused)
+{
+    std::lock_guard<std::mutex> guard{ _scheduler._mutex };
+    if (_focused == focused)
+    {
+        return;
+    }
+
+    if (_scheduled)
+    {
+        auto& list = _focused ? _scheduler._focusedReady : _scheduler._ready;
+        list.erase(std::find(list.begin(), list.end(), shared_from_this()));
+        _focused = focused;
+        _scheduler._MakeReady(shared_from_this());
+    }
+    else
+    {
+        _focused = focused;
+    }
+}
+
+// Routine Description:
+// - Gets how much output is waiting to be processed, and how much has been.
+// Arguments:
+// - <none>
+// Return Value:
+// - the backlog of the terminal
+OutputScheduler::Backlog OutputScheduler::Queue::GetBacklog()
+{
+    std::lock_guard<std::mutex> guard{ _scheduler._mutex };
+    return { _chunks.size(), _pendingCharacters, _processedCharacters, _batches };
+}
+
+// Routine Description:
+// - Waits until all the output written so far has been processed. The
+//   scheduler must have workers to do that.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void OutputScheduler::Queue::Flush()
+{
+    std::unique_lock<std::mutex> lock{ _scheduler._mutex };
+    _drained.wait(lock, [this]() { return _chunks.empty() && !_running; });
+}
+
+// Routine Description:
+// - Drops the pending output and stops accepting more, which also releases
+//   writes that are waiting for room. Waits for a batch that is being
+//   processed to finish, so that the terminal can be destroyed afterwards.
+//   Must not be called while the terminal is locked for writing.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void OutputScheduler::Queue::Close()
+{
+    std::unique_lock<std::mutex> lock{ _scheduler._mutex };
+    _closed = true;
+    _chunks.clear();
+    _pendingCharacters = 0;
+    _drained.notify_all();
+
+    if (_scheduled)
+    {
+        auto& list = _focused ? _scheduler._focusedReady : _scheduler._ready;
+        list.erase(std::find(list.begin(), list.end(), shared_from_this()));
+        _scheduled = false;
+    }
+
+    _drained.wait(lock, [this]() { return !_running; });
+}
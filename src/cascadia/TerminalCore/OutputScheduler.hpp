@@ -0,0 +1,118 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- OutputScheduler.hpp
+
+Abstract:
+- Processes the output of connections on a small pool of worker threads
+  shared by every terminal in the process, instead of on the thread of each
+  connection.
+- Each terminal gets a Queue. The output written to a queue is always
+  processed in order, by one worker at a time. Small writes are joined into
+  bigger chunks, so that the parser runs on fewer, longer strings.
+- A queue with pending output is put on a ready list. Any idle worker takes
+  the next terminal from it and processes one batch of its output, then puts
+  it at the back of the list if it has more. Terminals that have the user's
+  focus are taken before the others.
+- A queue only holds so much pending output. Once it's full, writes wait
+  for the workers to catch up, so the connection stops reading output and
+  the client stops producing it.
+
+--*/
+
+#pragma once
+
+#include <condition_variable>
+
+namespace Microsoft::Terminal::Core
+{
+    class Terminal;
+    class OutputScheduler;
+};
+
+class Microsoft::Terminal::Core::OutputScheduler final
+{
+public:
+    class Queue;
+
+    struct Backlog
+    {
+        size_t pendingChunks;
+        size_t pendingCharacters;
+        uint64_t processedCharacters;
+        uint64_t batches;
+    };
+
+    // Writes are joined with the last pending chunk while it stays below this size.
+    static constexpr size_t MaxChunkSize = 4096;
+    // After this many characters, a terminal goes to the back of the ready list.
+    static constexpr size_t MaxBatchSize = 16384;
+    // Writes to a queue wait while it has this many characters pending.
+    static constexpr size_t MaxPendingCharacters = 64 * MaxBatchSize;
+    // After this many batches of focused terminals in a row, one batch of
+    // another terminal is processed, so that they aren't starved entirely.
+    static constexpr size_t MaxFocusedBatches = 4;
+
+    explicit OutputScheduler(const size_t threadCount);
+    ~OutputScheduler();
+
+    OutputScheduler(const OutputScheduler&) = delete;
+    OutputScheduler(OutputScheduler&&) = delete;
+    OutputScheduler& operator=(const OutputScheduler&) = delete;
+    OutputScheduler& operator=(OutputScheduler&&) = delete;
+
+    static std::shared_ptr<OutputScheduler> GetShared();
+
+    std::shared_ptr<Queue> CreateQueue(Terminal& terminal, const size_t maxPendingCharacters = MaxPendingCharacters);
+    bool ProcessOne();
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::deque<std::shared_ptr<Queue>> _focusedReady;
+    std::deque<std::shared_ptr<Queue>> _ready;
+    size_t _focusedBatches;
+    bool _stopping;
+    std::vector<std::thread> _workers;
+
+    void _WorkerLoop();
+    std::shared_ptr<Queue> _TakeReady() noexcept;
+    void _MakeReady(const std::shared_ptr<Queue>& queue);
+    void _ProcessBatch(std::unique_lock<std::mutex>& lock, Queue& queue);
+};
+
+class Microsoft::Terminal::Core::OutputScheduler::Queue final :
+    public std::enable_shared_from_this<Queue>
+{
+public:
+    // Use OutputScheduler::CreateQueue.
+    Queue(OutputScheduler& scheduler, Terminal& terminal, const size_t maxPendingCharacters) noexcept;
+
+    void Write(const std::wstring_view string);
+    void SetFocused(const bool focused);
+    Backlog GetBacklog();
+    void Flush();
+    void Close();
+
+private:
+    friend class OutputScheduler;
+
+    // Whoever owns a queue also keeps its scheduler alive, and closing the
+    // queue takes it off the ready lists, so the scheduler outlives it.
+    OutputScheduler& _scheduler;
+    Terminal& _terminal;
+    const size_t _maxPendingCharacters;
+
+    // Everything below is guarded by the mutex of the scheduler.
+    std::condition_variable _drained;
+    std::deque<std::wstring> _chunks;
+    size_t _pendingCharacters;
+    uint64_t _processedCharacters;
+    uint64_t _batches;
+    bool _focused;
+    bool _scheduled;
+    bool _running;
+    bool _closed;
+};
@@ -148,6 +148,7 @@ void Terminal::UpdateSettings(ICoreSettings settings)
     _startingTitle = settings.StartingTitle();
 
     _terminalInput->ForceDisableWin32InputMode(settings.ForceVTInput());
+    _terminalInput->SetMouseMotionRateLimit(settings.MouseMotionRateLimit());
 
     if (settings.TabColor() == nullptr)
     {
@@ -408,6 +409,25 @@ bool Terminal::IsTrackingMouseInput() const noexcept
     return _terminalInput->IsTrackingMouseInput();
 }
 
+// Method Description:
+// - Determines if a mouse motion event is being held back by the
+//   MouseMotionRateLimit setting.
+// Return Value:
+// - true if there is a motion event waiting for FlushPendingMouseMotion.
+bool Terminal::HasPendingMouseMotion() const noexcept
+{
+    return _terminalInput->HasPendingMouseMotion();
+}
+
+// Method Description:
+// - Sends the mouse motion event that was held back by the
+//   MouseMotionRateLimit setting, if there is one. The control calls this
+//   once the mouse has gone idle, so the client sees where it stopped.
+void Terminal::FlushPendingMouseMotion()
+{
+    _terminalInput->FlushPendingMouseMotion();
+}
+
 // Method Description:
 // - If the clicked text is a hyperlink, open it
 // Arguments:
@@ -783,6 +803,19 @@ void Terminal::_WriteBuffer(const std::wstring_view& stringView)
         const COORD cursorPosBefore = cursor.GetPosition();
         COORD proposedCursorPosition = cursorPosBefore;
 
+        // Runs of plain ASCII take one cell per character, so as much of them
+        // as fits on the current line is written in one go.
+        const auto columnsLeft = std::max(0, _buffer->GetSize().Width() - cursorPosBefore.X);
+        const auto narrowRun = TextBuffer::MeasureNarrowText(stringView.substr(i, columnsLeft));
+        const auto written = narrowRun > 0 ? _buffer->WriteNarrowText(stringView.substr(i, narrowRun), _buffer->GetCurrentAttributes(), cursorPosBefore) : 0;
+        if (written > 0)
+        {
+            proposedCursorPosition.X += gsl::narrow<SHORT>(written);
+            i += written - 1;
+            _AdjustCursorPosition(proposedCursorPosition);
+            continue;
+        }
+
         // TODO: MSFT 21006766
         // This is not great but I need it demoable. Fix by making a buffer stream writer.
         //
@@ -128,6 +128,8 @@ public:
 
     void TrySnapOnInput() override;
     bool IsTrackingMouseInput() const noexcept;
+    bool HasPendingMouseMotion() const noexcept;
+    void FlushPendingMouseMotion();
 
     std::wstring GetHyperlinkAtPosition(const COORD position);
     uint16_t GetHyperlinkIdAtPosition(const COORD position);
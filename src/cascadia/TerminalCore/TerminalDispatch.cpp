@@ -496,7 +496,7 @@ bool TerminalDispatch::SoftReset() noexcept
     //     success = _pConApi->SetConsoleOutputCP(_initialCodePage.value()) && success;
     // }
 
-    const auto opt = DispatchTypes::GraphicsOptions::Off;
+    const size_t opt = DispatchTypes::GraphicsOptions::Off;
     success = SetGraphicsRendition({ &opt, 1 }) && success; // Normal rendition.
 
     // // Reset the saved cursor state.
@@ -39,23 +39,27 @@ const BYTE BRIGHT_WHITE   = BRIGHT_ATTR | RED_ATTR | GREEN_ATTR | BLUE_ATTR;
 // - options - An array of options that will be used to generate the RGB color
 // - attr - The attribute that will be updated with the parsed color.
 // - isForeground - Whether or not the parsed color is for the foreground.
+// - hasColorSpaceId - Whether the RGB parts are preceded by a color space id, as they
+//   are in the colon-delimited form "38:2::r:g:b". The id itself is ignored.
 // Return Value:
 // - The number of options consumed, not including the initial 38/48.
-size_t TerminalDispatch::_SetRgbColorsHelper(const gsl::span<const DispatchTypes::GraphicsOptions> options,
+size_t TerminalDispatch::_SetRgbColorsHelper(const gsl::span<const size_t> options,
                                              TextAttribute& attr,
-                                             const bool isForeground) noexcept
+                                             const bool isForeground,
+                                             const bool hasColorSpaceId) noexcept
 {
     size_t optionsConsumed = 0;
     if (options.size() >= 1)
     {
         optionsConsumed = 1;
         const auto typeOpt = til::at(options, 0);
-        if (typeOpt == DispatchTypes::GraphicsOptions::RGBColorOrFaint && options.size() >= 4)
+        const size_t rgbOffset = hasColorSpaceId ? 2 : 1;
+        if (typeOpt == DispatchTypes::GraphicsOptions::RGBColorOrFaint && options.size() >= rgbOffset + 3)
         {
-            optionsConsumed = 4;
-            const size_t red = til::at(options, 1);
-            const size_t green = til::at(options, 2);
-            const size_t blue = til::at(options, 3);
+            optionsConsumed = rgbOffset + 3;
+            const size_t red = til::at(options, rgbOffset);
+            const size_t green = til::at(options, rgbOffset + 1);
+            const size_t blue = til::at(options, rgbOffset + 2);
             // ensure that each value fits in a byte
             if (red <= 255 && green <= 255 && blue <= 255)
             {
@@ -92,16 +96,17 @@ size_t TerminalDispatch::_SetRgbColorsHelper(const gsl::span<const DispatchTypes
 // Arguments:
 // - options - An array of options that will be applied from 0 to N, in order,
 //   one at a time by setting or removing flags in the font style properties.
+//   Extended colors and underline styles may also be given as sub-parameters.
 // Return Value:
 // - True if handled successfully. False otherwise.
-bool TerminalDispatch::SetGraphicsRendition(const gsl::span<const DispatchTypes::GraphicsOptions> options) noexcept
+bool TerminalDispatch::SetGraphicsRendition(const VTParameters options) noexcept
 {
     TextAttribute attr = _terminalApi.GetTextAttributes();
 
     // Run through the graphics options and apply them
     for (size_t i = 0; i < options.size(); i++)
     {
-        const auto opt = til::at(options, i);
+        const auto opt = static_cast<DispatchTypes::GraphicsOptions>(options.at(i));
         switch (opt)
         {
         case Off:
@@ -157,7 +162,18 @@ bool TerminalDispatch::SetGraphicsRendition(const gsl::span<const DispatchTypes:
             attr.SetReverseVideo(false);
             break;
         case Underline:
-            attr.SetUnderlined(true);
+            if (const auto style = options.subParametersFor(i); !style.empty())
+            {
+                // A sub-parameter selects the underline style. 0 is none and 2 is double,
+                // while the curly, dotted, and dashed styles are drawn as a single underline.
+                const auto styleId = til::at(style, 0);
+                attr.SetUnderlined(styleId != 0 && styleId != 2);
+                attr.SetDoublyUnderlined(styleId == 2);
+            }
+            else
+            {
+                attr.SetUnderlined(true);
+            }
             break;
         case DoublyUnderlined:
             attr.SetDoublyUnderlined(true);
@@ -269,10 +285,17 @@ bool TerminalDispatch::SetGraphicsRendition(const gsl::span<const DispatchTypes:
             attr.SetIndexedBackground(BRIGHT_WHITE);
             break;
         case ForegroundExtended:
-            i += _SetRgbColorsHelper(options.subspan(i + 1), attr, true);
-            break;
         case BackgroundExtended:
-            i += _SetRgbColorsHelper(options.subspan(i + 1), attr, false);
+            if (const auto color = options.subParametersFor(i); !color.empty())
+            {
+                // The colon-delimited form keeps the whole color in the sub-parameters,
+                // with an optional color space id ahead of the RGB parts.
+                _SetRgbColorsHelper(color, attr, opt == ForegroundExtended, color.size() > 4);
+            }
+            else
+            {
+                i += _SetRgbColorsHelper(options.subspan(i + 1), attr, opt == ForegroundExtended, false);
+            }
             break;
         }
     }
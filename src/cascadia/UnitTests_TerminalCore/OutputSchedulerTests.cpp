@@ -0,0 +1,231 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include <WexTestClass.h>
+
+#include "../cascadia/TerminalCore/Terminal.hpp"
+#include "../cascadia/TerminalCore/OutputScheduler.hpp"
+#include "../renderer/inc/DummyRenderTarget.hpp"
+#include "consoletaeftemplates.hpp"
+
+using namespace Microsoft::Terminal::Core;
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace TerminalCoreUnitTests
+{
+    class OutputSchedulerTests
+    {
+        TEST_CLASS(OutputSchedulerTests);
+
+        TEST_METHOD(ProcessesEachTerminalInOrder);
+        TEST_METHOD(JoinsSmallWrites);
+        TEST_METHOD(FocusedTerminalsGoFirst);
+        TEST_METHOD(CloseDropsPendingOutput);
+        TEST_METHOD(WritesWaitWhenTheQueueIsFull);
+    };
+};
+
+using namespace TerminalCoreUnitTests;
+
+void OutputSchedulerTests::ProcessesEachTerminalInOrder()
+{
+    constexpr size_t terminalCount = 4;
+    constexpr size_t lineCount = 100;
+
+    DummyRenderTarget emptyRT;
+    std::vector<std::unique_ptr<Terminal>> terminals;
+    for (size_t i = 0; i < terminalCount; ++i)
+    {
+        terminals.emplace_back(std::make_unique<Terminal>());
+        terminals.back()->Create({ 80, 32 }, 100, emptyRT);
+    }
+
+    OutputScheduler scheduler{ 2 };
+    std::vector<std::shared_ptr<OutputScheduler::Queue>> queues;
+    for (auto& terminal : terminals)
+    {
+        queues.emplace_back(scheduler.CreateQueue(*terminal));
+    }
+
+    Log::Comment(L"Write to every terminal at once, each line in a few small pieces.");
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < terminalCount; ++i)
+    {
+        producers.emplace_back([&, i]() {
+            for (size_t line = 0; line < lineCount; ++line)
+            {
+                queues.at(i)->Write(fmt::format(L"pane {} ", i));
+                queues.at(i)->Write(fmt::format(L"line {}", line));
+                queues.at(i)->Write(L"\r\n");
+                if (line % 25 == 0)
+                {
+                    queues.at(i)->SetFocused(line % 50 == 0);
+                }
+            }
+        });
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    for (size_t i = 0; i < terminalCount; ++i)
+    {
+        queues.at(i)->Flush();
+
+        const auto backlog = queues.at(i)->GetBacklog();
+        Log::Comment(NoThrowString().Format(L"Terminal %zu: %llu characters in %llu batches", i, backlog.processedCharacters, backlog.batches));
+        VERIFY_ARE_EQUAL(size_t{ 0 }, backlog.pendingChunks);
+        VERIFY_ARE_EQUAL(size_t{ 0 }, backlog.pendingCharacters);
+
+        const auto& buffer = terminals.at(i)->GetTextBuffer();
+        for (size_t line = 0; line < lineCount; ++line)
+        {
+            const auto expected = fmt::format(L"pane {} line {} ", i, line);
+            const auto actual = buffer.GetRowByOffset(line).GetText().substr(0, expected.size());
+            VERIFY_ARE_EQUAL(expected, actual);
+        }
+    }
+}
+
+void OutputSchedulerTests::JoinsSmallWrites()
+{
+    Terminal term;
+    DummyRenderTarget emptyRT;
+    term.Create({ 80, 32 }, 100, emptyRT);
+
+    // Without workers, output is only processed when asked to.
+    OutputScheduler scheduler{ 0 };
+    const auto queue = scheduler.CreateQueue(term);
+
+    for (auto i = 0; i < 100; ++i)
+    {
+        queue->Write(L"ab");
+    }
+
+    auto backlog = queue->GetBacklog();
+    VERIFY_ARE_EQUAL(size_t{ 1 }, backlog.pendingChunks);
+    VERIFY_ARE_EQUAL(size_t{ 200 }, backlog.pendingCharacters);
+    VERIFY_ARE_EQUAL(uint64_t{ 0 }, backlog.processedCharacters);
+
+    Log::Comment(L"A write that doesn't fit in the last chunk starts a new one.");
+    queue->Write(std::wstring(OutputScheduler::MaxChunkSize, L'c'));
+    backlog = queue->GetBacklog();
+    VERIFY_ARE_EQUAL(size_t{ 2 }, backlog.pendingChunks);
+
+    VERIFY_IS_TRUE(scheduler.ProcessOne());
+    VERIFY_IS_FALSE(scheduler.ProcessOne());
+
+    backlog = queue->GetBacklog();
+    VERIFY_ARE_EQUAL(size_t{ 0 }, backlog.pendingChunks);
+    VERIFY_ARE_EQUAL(size_t{ 0 }, backlog.pendingCharacters);
+    VERIFY_ARE_EQUAL(uint64_t{ 200 + OutputScheduler::MaxChunkSize }, backlog.processedCharacters);
+    VERIFY_ARE_EQUAL(uint64_t{ 1 }, backlog.batches);
+
+    VERIFY_ARE_EQUAL(std::wstring{ L"abab" }, term.GetTextBuffer().GetRowByOffset(0).GetText().substr(0, 4));
+}
+
+void OutputSchedulerTests::FocusedTerminalsGoFirst()
+{
+    DummyRenderTarget emptyRT;
+    Terminal background;
+    background.Create({ 80, 32 }, 100, emptyRT);
+    Terminal focused;
+    focused.Create({ 80, 32 }, 100, emptyRT);
+
+    OutputScheduler scheduler{ 0 };
+    const auto backgroundQueue = scheduler.CreateQueue(background);
+    const auto focusedQueue = scheduler.CreateQueue(focused);
+
+    backgroundQueue->Write(L"background");
+    Log::Comment(L"Give the focused terminal more output than fits in the batches it may take in a row.");
+    const std::wstring chunk(OutputScheduler::MaxChunkSize, L'f');
+    for (size_t i = 0; i < (OutputScheduler::MaxFocusedBatches + 1) * OutputScheduler::MaxBatchSize / chunk.size(); ++i)
+    {
+        focusedQueue->Write(chunk);
+    }
+    focusedQueue->SetFocused(true);
+
+    for (size_t i = 0; i < OutputScheduler::MaxFocusedBatches; ++i)
+    {
+        VERIFY_IS_TRUE(scheduler.ProcessOne());
+        VERIFY_ARE_EQUAL(uint64_t{ i + 1 }, focusedQueue->GetBacklog().batches);
+        VERIFY_ARE_EQUAL(uint64_t{ 0 }, backgroundQueue->GetBacklog().batches);
+    }
+
+    Log::Comment(L"Then the other terminal gets a turn, so that it isn't starved.");
+    VERIFY_IS_TRUE(scheduler.ProcessOne());
+    VERIFY_ARE_EQUAL(uint64_t{ 1 }, backgroundQueue->GetBacklog().batches);
+    VERIFY_ARE_EQUAL(std::wstring{ L"background" }, background.GetTextBuffer().GetRowByOffset(0).GetText().substr(0, 10));
+
+    VERIFY_IS_TRUE(scheduler.ProcessOne());
+    VERIFY_IS_FALSE(scheduler.ProcessOne());
+    VERIFY_ARE_EQUAL(size_t{ 0 }, focusedQueue->GetBacklog().pendingCharacters);
+}
+
+void OutputSchedulerTests::CloseDropsPendingOutput()
+{
+    Terminal term;
+    DummyRenderTarget emptyRT;
+    term.Create({ 80, 32 }, 100, emptyRT);
+
+    OutputScheduler scheduler{ 0 };
+    const auto queue = scheduler.CreateQueue(term);
+
+    queue->Write(L"dropped");
+    queue->Close();
+    queue->Write(L"ignored");
+
+    VERIFY_IS_FALSE(scheduler.ProcessOne());
+
+    const auto backlog = queue->GetBacklog();
+    VERIFY_ARE_EQUAL(size_t{ 0 }, backlog.pendingChunks);
+    VERIFY_ARE_EQUAL(uint64_t{ 0 }, backlog.processedCharacters);
+    VERIFY_ARE_EQUAL(std::wstring(7, L' '), term.GetTextBuffer().GetRowByOffset(0).GetText().substr(0, 7));
+}
+
+void OutputSchedulerTests::WritesWaitWhenTheQueueIsFull()
+{
+    Terminal term;
+    DummyRenderTarget emptyRT;
+    term.Create({ 80, 32 }, 100, emptyRT);
+
+    constexpr size_t maxPending = 100;
+    OutputScheduler scheduler{ 0 };
+    const auto queue = scheduler.CreateQueue(term, maxPending);
+
+    Log::Comment(L"Fill the queue up to its limit.");
+    queue->Write(std::wstring(maxPending, L'a'));
+    VERIFY_ARE_EQUAL(maxPending, queue->GetBacklog().pendingCharacters);
+
+    Log::Comment(L"The next write waits until a batch is taken off the queue.");
+    std::atomic<bool> written{ false };
+    std::thread producer{ [&]() {
+        queue->Write(L"b");
+        written = true;
+    } };
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    VERIFY_IS_FALSE(written.load());
+    VERIFY_ARE_EQUAL(maxPending, queue->GetBacklog().pendingCharacters);
+
+    VERIFY_IS_TRUE(scheduler.ProcessOne());
+    producer.join();
+    VERIFY_IS_TRUE(written.load());
+    VERIFY_ARE_EQUAL(size_t{ 1 }, queue->GetBacklog().pendingCharacters);
+
+    Log::Comment(L"Closing the queue releases a write that is waiting.");
+    queue->Write(std::wstring(maxPending, L'c'));
+    std::thread waiting{ [&]() {
+        queue->Write(L"d");
+    } };
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    queue->Close();
+    waiting.join();
+
+    VERIFY_ARE_EQUAL(size_t{ 0 }, queue->GetBacklog().pendingCharacters);
+    VERIFY_ARE_EQUAL(uint64_t{ maxPending }, queue->GetBacklog().processedCharacters);
+}
@@ -0,0 +1,140 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "../TerminalApp/FuzzyMatcher.h"
+
+using namespace ::TerminalApp;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using namespace WEX::Common;
+
+namespace TerminalAppUnitTests
+{
+    class FuzzyMatcherTests
+    {
+        BEGIN_TEST_CLASS(FuzzyMatcherTests)
+            TEST_CLASS_PROPERTY(L"ActivationContext", L"TerminalApp.Unit.Tests.manifest")
+        END_TEST_CLASS()
+
+        TEST_METHOD(GetWeight);
+        TEST_METHOD(FilterOrdersMatches);
+        TEST_METHOD(NarrowingMatchesFullSearch);
+
+    private:
+        static std::vector<std::wstring> _MakeNames(const size_t count);
+        static void _VerifyMatchesEqual(const std::vector<FuzzyMatcher::Match>& expected,
+                                        const std::vector<FuzzyMatcher::Match>& actual);
+    };
+
+    std::vector<std::wstring> FuzzyMatcherTests::_MakeNames(const size_t count)
+    {
+        static constexpr std::wstring_view verbs[]{ L"Open", L"Close", L"Split", L"Switch to", L"Move", L"Set color of", L"Rename", L"Duplicate" };
+        static constexpr std::wstring_view nouns[]{ L"Pane", L"Tab", L"Window", L"Profile", L"Scheme", L"Settings", L"Focus", L"Title" };
+
+        std::vector<std::wstring> names;
+        names.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::wstring name{ til::at(verbs, i % std::size(verbs)) };
+            name.push_back(L' ');
+            name.append(til::at(nouns, (i / std::size(verbs)) % std::size(nouns)));
+            name.append(L", profile ");
+            name.append(std::to_wstring(i));
+            names.push_back(std::move(name));
+        }
+        return names;
+    }
+
+    void FuzzyMatcherTests::_VerifyMatchesEqual(const std::vector<FuzzyMatcher::Match>& expected,
+                                                const std::vector<FuzzyMatcher::Match>& actual)
+    {
+        VERIFY_ARE_EQUAL(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(expected[i].index, actual[i].index);
+            VERIFY_ARE_EQUAL(expected[i].weight, actual[i].weight);
+        }
+    }
+
+    void FuzzyMatcherTests::GetWeight()
+    {
+        Log::Comment(L"Each matched character counts once, and once more each for starting a word and following the last match.");
+        VERIFY_ARE_EQUAL(6, FuzzyMatcher::GetWeight(L"ab", L"ab"));
+        VERIFY_ARE_EQUAL(6, FuzzyMatcher::GetWeight(L"AB", L"aB"));
+        VERIFY_ARE_EQUAL(6, FuzzyMatcher::GetWeight(L"sp", L"Split Pane"));
+        VERIFY_ARE_EQUAL(3, FuzzyMatcher::GetWeight(L"sp", L"Close Pane"));
+        VERIFY_ARE_EQUAL(4, FuzzyMatcher::GetWeight(L"sv", L"[ | ] Split Vertical"));
+
+        Log::Comment(L"Names that lack a character, or have them out of order, don't match.");
+        VERIFY_ARE_EQUAL(0, FuzzyMatcher::GetWeight(L"sx", L"Split Pane"));
+        VERIFY_ARE_EQUAL(0, FuzzyMatcher::GetWeight(L"ps", L"Split"));
+        VERIFY_ARE_EQUAL(0, FuzzyMatcher::GetWeight(L"tabs", L"New Tab"));
+    }
+
+    void FuzzyMatcherTests::FilterOrdersMatches()
+    {
+        FuzzyMatcher matcher;
+        matcher.SetNames({ L"Close Pane", L"Split Pane", L"New Tab", L"Close Pane", L"Open Settings", L"Prev Tab" });
+        VERIFY_ARE_EQUAL(size_t{ 6 }, matcher.GetNameCount());
+
+        Log::Comment(L"Better matches come first, then names in alphabetical order, then names in the order they were given.");
+        const auto matches = matcher.Filter(L"p");
+        const size_t expected[]{ 5, 0, 3, 4, 1 };
+        VERIFY_ARE_EQUAL(std::size(expected), matches.size());
+        for (size_t i = 0; i < matches.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(til::at(expected, i), matches[i].index);
+        }
+
+        Log::Comment(L"The empty string matches nothing.");
+        VERIFY_ARE_EQUAL(size_t{ 0 }, matcher.Filter(L"").size());
+
+        Log::Comment(L"New names replace the old ones.");
+        matcher.SetNames({ L"Find" });
+        VERIFY_ARE_EQUAL(size_t{ 0 }, matcher.Filter(L"p").size());
+        VERIFY_ARE_EQUAL(size_t{ 1 }, matcher.Filter(L"fi").size());
+    }
+
+    void FuzzyMatcherTests::NarrowingMatchesFullSearch()
+    {
+        const auto names = _MakeNames(10000);
+
+        FuzzyMatcher typing;
+        typing.SetNames(names);
+        FuzzyMatcher fresh;
+
+        const std::wstring_view searches[]{ L"s", L"sp", L"spl", L"split", L"split p", L"split pa", L"split pane", L"split pane 9", L"split pane 99", L"split pane 9", L"sw", L"swi", L"switch t", L"x" };
+
+        std::chrono::steady_clock::duration typingTime{};
+        std::chrono::steady_clock::duration freshTime{};
+
+        for (const auto search : searches)
+        {
+            Log::Comment(NoThrowString().Format(L"Searching for '%.*s'", gsl::narrow<int>(search.size()), search.data()));
+
+            auto start = std::chrono::steady_clock::now();
+            const auto narrowed = typing.Filter(search);
+            typingTime += std::chrono::steady_clock::now() - start;
+
+            start = std::chrono::steady_clock::now();
+            fresh.SetNames(names);
+            const auto full = fresh.Filter(search);
+            freshTime += std::chrono::steady_clock::now() - start;
+
+            _VerifyMatchesEqual(full, narrowed);
+
+            for (size_t i = 0; i < full.size(); i += 97)
+            {
+                VERIFY_ARE_EQUAL(full[i].weight, FuzzyMatcher::GetWeight(search, til::at(names, full[i].index)));
+            }
+        }
+
+        Log::Comment(NoThrowString().Format(L"%zu searches over %zu names: %lldus while typing, %lldus from scratch",
+                                            std::size(searches),
+                                            names.size(),
+                                            std::chrono::duration_cast<std::chrono::microseconds>(typingTime).count(),
+                                            std::chrono::duration_cast<std::chrono::microseconds>(freshTime).count()));
+    }
+}
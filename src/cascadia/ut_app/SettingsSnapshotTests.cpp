@@ -0,0 +1,189 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "../TerminalApp/SettingsSnapshot.h"
+
+using namespace ::TerminalApp;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using namespace WEX::Common;
+
+namespace TerminalAppUnitTests
+{
+    class SettingsSnapshotTests
+    {
+        BEGIN_TEST_CLASS(SettingsSnapshotTests)
+            TEST_CLASS_PROPERTY(L"ActivationContext", L"TerminalApp.Unit.Tests.manifest")
+        END_TEST_CLASS()
+
+        TEST_METHOD(RoundTrip);
+        TEST_METHOD(RejectsStaleSnapshots);
+        TEST_METHOD(RejectsDamagedSnapshots);
+        TEST_METHOD(LargeSettings);
+
+    private:
+        static Json::Value _Parse(const std::string_view text);
+        static void _VerifyOffsetsEqual(const Json::Value& expected, const Json::Value& actual);
+
+        static constexpr std::string_view _defaultsText{ R"({
+            "defaultProfile": "{61c54bbd-c053-5c3a-9b8e-f4d3c5e6b7a8}",
+            "initialCols": 120,
+            "profiles": [ { "name": "cmd", "hidden": false, "opacity": 0.75 } ]
+        })" };
+
+        static constexpr std::string_view _userText{ R"({
+            // Comments are fine, they just aren't kept.
+            "copyOnSelect": true,
+            "rowsToScroll": -3,
+            "largeNumber": 18446744073709551615,
+            "nothing": null,
+            "profiles": {
+                "defaults": { "fontFace": "Cascadia Code", "padding": "8, 8, 8, 8" },
+                "list": [
+                    { "name": "\u00e9l\u00e8ve \ud83d\ude00", "commandline": "wsl.exe ~ -d Ubuntu" },
+                    { "name": "nested", "a": [ [ [ 1, 2 ], [] ], {} ] }
+                ]
+            },
+            "keybindings": [ { "command": { "action": "splitPane", "split": "auto" }, "keys": "alt+shift+d" } ]
+        })" };
+    };
+
+    Json::Value SettingsSnapshotTests::_Parse(const std::string_view text)
+    {
+        Json::Value root;
+        std::string errs;
+        std::unique_ptr<Json::CharReader> reader{ Json::CharReaderBuilder::CharReaderBuilder().newCharReader() };
+        VERIFY_IS_TRUE(reader->parse(text.data(), text.data() + text.size(), &root, &errs));
+        return root;
+    }
+
+    void SettingsSnapshotTests::_VerifyOffsetsEqual(const Json::Value& expected, const Json::Value& actual)
+    {
+        VERIFY_ARE_EQUAL(expected.getOffsetStart(), actual.getOffsetStart());
+        VERIFY_ARE_EQUAL(expected.getOffsetLimit(), actual.getOffsetLimit());
+        if (expected.isArray() || expected.isObject())
+        {
+            auto it = actual.begin();
+            for (const auto& child : expected)
+            {
+                _VerifyOffsetsEqual(child, *it);
+                ++it;
+            }
+        }
+    }
+
+    void SettingsSnapshotTests::RoundTrip()
+    {
+        const auto defaults = _Parse(_defaultsText);
+        const auto user = _Parse(_userText);
+
+        const auto snapshot = SettingsSnapshot::Serialize(_defaultsText, defaults, _userText, user);
+        Log::Comment(NoThrowString().Format(L"%zu bytes of settings saved into %zu bytes", _defaultsText.size() + _userText.size(), snapshot.size()));
+
+        const auto loaded = SettingsSnapshot::Load(snapshot, _defaultsText, _userText);
+        VERIFY_IS_TRUE(loaded.has_value());
+
+        VERIFY_IS_TRUE(defaults == loaded->defaults);
+        VERIFY_IS_TRUE(user == loaded->user);
+
+        Log::Comment(L"Every value kept its type and its offsets into the text.");
+        VERIFY_IS_TRUE(loaded->user["rowsToScroll"].isInt());
+        VERIFY_ARE_EQUAL(-3, loaded->user["rowsToScroll"].asInt());
+        VERIFY_IS_TRUE(loaded->user["largeNumber"].isUInt64());
+        VERIFY_ARE_EQUAL(UINT64_MAX, loaded->user["largeNumber"].asUInt64());
+        VERIFY_ARE_EQUAL(0.75, loaded->defaults["profiles"][0]["opacity"].asDouble());
+        VERIFY_IS_TRUE(loaded->user["nothing"].isNull());
+        _VerifyOffsetsEqual(defaults, loaded->defaults);
+        _VerifyOffsetsEqual(user, loaded->user);
+    }
+
+    void SettingsSnapshotTests::RejectsStaleSnapshots()
+    {
+        const auto defaults = _Parse(_defaultsText);
+        const auto user = _Parse(_userText);
+        const auto snapshot = SettingsSnapshot::Serialize(_defaultsText, defaults, _userText, user);
+
+        Log::Comment(L"Any change to the user's settings makes the snapshot stale, even one of the same length.");
+        std::string changedUser{ _userText };
+        changedUser[changedUser.find("true")] = 'T';
+        VERIFY_IS_FALSE(SettingsSnapshot::Load(snapshot, _defaultsText, changedUser).has_value());
+        VERIFY_IS_FALSE(SettingsSnapshot::Load(snapshot, _defaultsText, std::string{ _userText } + " ").has_value());
+
+        Log::Comment(L"So does a change to the defaults, like in an update.");
+        VERIFY_IS_FALSE(SettingsSnapshot::Load(snapshot, _userText, _userText).has_value());
+
+        Log::Comment(L"A snapshot from another version of the format isn't used.");
+        auto otherVersion{ snapshot };
+        const uint16_t version = SettingsSnapshot::Version + 1;
+        memcpy(otherVersion.data() + sizeof(uint32_t), &version, sizeof(version));
+        VERIFY_IS_FALSE(SettingsSnapshot::Load(otherVersion, _defaultsText, _userText).has_value());
+    }
+
+    void SettingsSnapshotTests::RejectsDamagedSnapshots()
+    {
+        const auto defaults = _Parse(_defaultsText);
+        const auto user = _Parse(_userText);
+        const auto snapshot = SettingsSnapshot::Serialize(_defaultsText, defaults, _userText, user);
+
+        VERIFY_IS_FALSE(SettingsSnapshot::Load("", _defaultsText, _userText).has_value());
+        VERIFY_IS_FALSE(SettingsSnapshot::Load(std::string(64, '\xAB'), _defaultsText, _userText).has_value());
+
+        Log::Comment(L"Cutting the snapshot off anywhere after its header is caught.");
+        for (auto length = snapshot.size() - 1; length > 40; length -= 7)
+        {
+            VERIFY_IS_FALSE(SettingsSnapshot::Load(std::string_view{ snapshot }.substr(0, length), _defaultsText, _userText).has_value());
+        }
+
+        Log::Comment(L"So are bytes left over after the documents.");
+        VERIFY_IS_FALSE(SettingsSnapshot::Load(snapshot + '\0', _defaultsText, _userText).has_value());
+    }
+
+    void SettingsSnapshotTests::LargeSettings()
+    {
+        std::string userText{ "{ \"profiles\": [" };
+        for (auto i = 0; i < 500; ++i)
+        {
+            userText += fmt::format(R"({}{{ "name": "Profile {}", "guid": "{{00000000-0000-0000-0000-{:012}}}", "commandline": "cmd.exe /k echo {}", "fontSize": {}, "acrylicOpacity": 0.{}, "hidden": false }})",
+                                    i == 0 ? "" : ",\n",
+                                    i,
+                                    i,
+                                    i,
+                                    8 + i % 10,
+                                    i % 10);
+        }
+        userText += "] }";
+
+        const auto defaults = _Parse(_defaultsText);
+        const auto user = _Parse(userText);
+        const auto snapshot = SettingsSnapshot::Serialize(_defaultsText, defaults, userText, user);
+
+        constexpr auto iterations = 20;
+
+        const auto parseStart = std::chrono::steady_clock::now();
+        for (auto i = 0; i < iterations; ++i)
+        {
+            _Parse(userText);
+        }
+        const auto parseTime = std::chrono::steady_clock::now() - parseStart;
+
+        const auto loadStart = std::chrono::steady_clock::now();
+        std::optional<SettingsSnapshot::Documents> loaded;
+        for (auto i = 0; i < iterations; ++i)
+        {
+            loaded = SettingsSnapshot::Load(snapshot, _defaultsText, userText);
+        }
+        const auto loadTime = std::chrono::steady_clock::now() - loadStart;
+
+        Log::Comment(NoThrowString().Format(L"%zu bytes of settings, %zu bytes of snapshot. %d times: %lldus parsing, %lldus loading",
+                                            userText.size(),
+                                            snapshot.size(),
+                                            iterations,
+                                            std::chrono::duration_cast<std::chrono::microseconds>(parseTime).count(),
+                                            std::chrono::duration_cast<std::chrono::microseconds>(loadTime).count()));
+
+        VERIFY_IS_TRUE(loaded.has_value());
+        VERIFY_IS_TRUE(user == loaded->user);
+    }
+}
@@ -532,15 +532,23 @@ constexpr unsigned int LOCAL_BUFFER_SIZE = 100;
             }
 
             // line was wrapped if we're writing up to the end of the current row
-            OutputCellIterator it(std::wstring_view(LocalBuffer, i), Attributes);
-            const auto itEnd = screenInfo.Write(it);
+            // The number of "spaces" or "cells" we have consumed needs to be reported and stored for later
+            // when/if we need to erase the command line.
+            const std::wstring_view text{ LocalBuffer, i };
+            if (TextBuffer::MeasureNarrowText(text) == text.size())
+            {
+                // Plain ASCII takes one cell per character, so it's copied straight into the row.
+                TempNumSpaces += textBuffer.WriteNarrowText(text, Attributes, CursorPosition);
+            }
+            else
+            {
+                OutputCellIterator it(text, Attributes);
+                const auto itEnd = screenInfo.Write(it);
+                TempNumSpaces += itEnd.GetCellDistance(it);
+            }
 
             // Notify accessibility
             screenInfo.NotifyAccessibilityEventing(CursorPosition.X, CursorPosition.Y, CursorPosition.X + gsl::narrow<SHORT>(i - 1), CursorPosition.Y);
-
-            // The number of "spaces" or "cells" we have consumed needs to be reported and stored for later
-            // when/if we need to erase the command line.
-            TempNumSpaces += itEnd.GetCellDistance(it);
             CursorPosition.X = XPosition;
 
             // enforce a delayed newline if we're about to pass the end and the WC_DELAY_EOL_WRAP flag is set.
@@ -24,28 +24,33 @@
 
 using Microsoft::Console::Interactivity::ServiceLocator;
 
+// Hashes the lowercased key one character at a time (FNV-1a),
+// so that lookups don't have to make a lowercased copy of it first.
 struct case_insensitive_hash
 {
-    std::size_t operator()(const std::wstring& key) const
+    std::size_t operator()(const std::wstring& key) const noexcept
     {
-        std::wstring lower(key);
-        std::transform(lower.begin(), lower.end(), lower.begin(), ::towlower);
-        std::hash<std::wstring> hash;
-        return hash(lower);
+        uint64_t hash = 14695981039346656037ull;
+        for (const auto ch : key)
+        {
+            hash ^= static_cast<uint64_t>(towlower(ch));
+            hash *= 1099511628211ull;
+        }
+        return static_cast<std::size_t>(hash);
     }
 };
 
 struct case_insensitive_equality
 {
-    bool operator()(const std::wstring& lhs, const std::wstring& rhs) const
+    bool operator()(const std::wstring& lhs, const std::wstring& rhs) const noexcept
     {
-        return 0 == _wcsicmp(lhs.data(), rhs.data());
+        return lhs.size() == rhs.size() && 0 == _wcsicmp(lhs.data(), rhs.data());
     }
 };
 
 std::unordered_map<std::wstring,
                    std::unordered_map<std::wstring,
-                                      std::wstring,
+                                      AliasTemplate,
                                       case_insensitive_hash,
                                       case_insensitive_equality>,
                    case_insensitive_hash,
@@ -117,7 +122,7 @@ std::unordered_map<std::wstring,
         else
         {
             // Map will auto-create each level as necessary
-            g_aliasData[exeNameString][sourceString] = targetString;
+            g_aliasData[exeNameString].insert_or_assign(std::move(sourceString), AliasTemplate{ std::move(targetString) });
         }
     }
     CATCH_RETURN();
@@ -159,10 +164,10 @@ std::unordered_map<std::wstring,
     // We use .find for the iterators then dereference to search without creating entries.
     const auto exeIter = g_aliasData.find(exeNameString);
     RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_GEN_FAILURE), exeIter == g_aliasData.end());
-    const auto exeData = exeIter->second;
+    const auto& exeData = exeIter->second;
     const auto sourceIter = exeData.find(sourceString);
     RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_GEN_FAILURE), sourceIter == exeData.end());
-    const auto targetString = sourceIter->second;
+    const auto& targetString = sourceIter->second.GetTarget();
     RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_GEN_FAILURE), targetString.size() == 0);
 
     // TargetLength is a byte count, convert to characters.
@@ -336,18 +341,18 @@ static std::wstring aliasesSeparator(L"=");
         auto exeIter = g_aliasData.find(exeNameString);
         if (exeIter != g_aliasData.end())
         {
-            auto list = exeIter->second;
+            const auto& list = exeIter->second;
             for (auto& pair : list)
             {
                 // Alias stores lengths in bytes.
                 size_t cchSource = pair.first.size();
-                size_t cchTarget = pair.second.size();
+                size_t cchTarget = pair.second.GetTarget().size();
 
                 // If we're counting how much multibyte space will be needed, trial convert the source and target strings before we add.
                 if (!countInUnicode)
                 {
                     cchSource = GetALengthFromW(codepage, pair.first);
-                    cchTarget = GetALengthFromW(codepage, pair.second);
+                    cchTarget = GetALengthFromW(codepage, pair.second.GetTarget());
                 }
 
                 // Accumulate all sizes to the final string count.
@@ -467,12 +472,12 @@ void Alias::s_ClearCmdExeAliases()
     auto exeIter = g_aliasData.find(exeNameString);
     if (exeIter != g_aliasData.end())
     {
-        auto list = exeIter->second;
+        const auto& list = exeIter->second;
         for (auto& pair : list)
         {
             // Alias stores lengths in bytes.
             size_t const cchSource = pair.first.size();
-            size_t const cchTarget = pair.second.size();
+            size_t const cchTarget = pair.second.GetTarget().size();
 
             // Add up how many characters we will need for the full alias data.
             size_t cchNeeded = 0;
@@ -502,7 +507,7 @@ void Alias::s_ClearCmdExeAliases()
                 RETURN_IF_FAILED(SizeTSub(cchAliasBufferRemaining, aliasesSeparator.size(), &cchAliasBufferRemaining));
                 AliasesBufferPtrW += aliasesSeparator.size();
 
-                RETURN_IF_FAILED(StringCchCopyNW(AliasesBufferPtrW, cchAliasBufferRemaining, pair.second.data(), cchTarget));
+                RETURN_IF_FAILED(StringCchCopyNW(AliasesBufferPtrW, cchAliasBufferRemaining, pair.second.GetTarget().data(), cchTarget));
                 RETURN_IF_FAILED(SizeTSub(cchAliasBufferRemaining, cchTarget, &cchAliasBufferRemaining));
                 AliasesBufferPtrW += cchTarget;
 
@@ -845,113 +850,6 @@ void Alias::s_TrimTrailingCrLf(std::wstring& str)
     }
 }
 
-// Routine Description:
-// - Tokenizes a string into a collection using space as a separator
-// Arguments:
-// - str - String to tokenize
-// Return Value:
-// - Collection of tokenized strings
-std::deque<std::wstring> Alias::s_Tokenize(const std::wstring& str)
-{
-    std::deque<std::wstring> result;
-
-    size_t prevIndex = 0;
-    auto spaceIndex = str.find(L' ');
-    while (std::wstring::npos != spaceIndex)
-    {
-        const auto length = spaceIndex - prevIndex;
-
-        result.emplace_back(str.substr(prevIndex, length));
-
-        spaceIndex++;
-        prevIndex = spaceIndex;
-
-        spaceIndex = str.find(L' ', spaceIndex);
-    }
-
-    // Place the final one into the set.
-    result.emplace_back(str.substr(prevIndex));
-
-    return result;
-}
-
-// Routine Description:
-// - Gets just the arguments portion of the command string
-//   Specifically, all text after the first space character.
-// Arguments:
-// - str - String to split into just args
-// Return Value:
-// - Only the arguments part of the string or empty if there are no arguments.
-std::wstring Alias::s_GetArgString(const std::wstring& str)
-{
-    std::wstring result;
-    auto firstSpace = str.find_first_of(L' ');
-    if (std::wstring::npos != firstSpace)
-    {
-        firstSpace++;
-        if (firstSpace < str.size())
-        {
-            result = str.substr(firstSpace);
-        }
-    }
-
-    return result;
-}
-
-// Routine Description:
-// - Checks the given character to see if it is a numbered arg replacement macro
-//   and replaces it with the counted argument if there is a match
-// Arguments:
-// - ch - Character to test as a macro
-// - appendToStr - Append the macro result here if it matched
-// - tokens - Tokens of the original command string. 0 is alias. 1-N are arguments.
-// Return Value:
-// - True if we found the macro and appended to the string.
-// - False if the given character doesn't match this macro.
-bool Alias::s_TryReplaceNumberedArgMacro(const wchar_t ch,
-                                         std::wstring& appendToStr,
-                                         const std::deque<std::wstring>& tokens)
-{
-    if (ch >= L'1' && ch <= L'9')
-    {
-        // Numerical macros substitute that numbered argument
-        const size_t index = ch - L'0';
-
-        if (index < tokens.size() && index > 0)
-        {
-            appendToStr.append(tokens[index]);
-        }
-
-        return true;
-    }
-
-    return false;
-}
-
-// Routine Description:
-// - Checks the given character to see if it is a wildcard arg replacement macro
-//   and replaces it with the entire argument string if there is a match
-// Arguments:
-// - ch - Character to test as a macro
-// - appendToStr - Append the macro result here if it matched
-// - fullArgString - All of the arguments as one big string.
-// Return Value:
-// - True if we found the macro and appended to the string.
-// - False if the given character doesn't match this macro.
-bool Alias::s_TryReplaceWildcardArgMacro(const wchar_t ch,
-                                         std::wstring& appendToStr,
-                                         const std::wstring fullArgString)
-{
-    if (L'*' == ch)
-    {
-        // Wildcard substitutes all arguments
-        appendToStr.append(fullArgString);
-        return true;
-    }
-
-    return false;
-}
-
 // Routine Description:
 // - Checks the given character to see if it is an input redirection macro
 //   and replaces it with the < redirector if there is a match
@@ -1052,83 +950,110 @@ void Alias::s_AppendCrLf(std::wstring& appendToStr,
 }
 
 // Routine Description:
-// - Searches through the given string for macros and replaces them
-//   with the matching action
+// - Compiles an alias target. Redirection and command separator macros are
+//   replaced now. Argument macros are recorded as slots where the arguments
+//   of each command are to be inserted when the alias is expanded.
 // Arguments:
-// - str - On input, the string to search. On output, the string is replaced.
-// - tokens - The tokenized command line input. 0 is the alias, 1-N are arguments.
-// - fullArgString - Shorthand to 1-N argument string in case of wildcard match.
-// Return Value:
-// - The number of commands in the final string (line feeds, CRLFs)
-size_t Alias::s_ReplaceMacros(std::wstring& str,
-                              const std::deque<std::wstring>& tokens,
-                              const std::wstring& fullArgString)
+// - target - The text the alias expands to, with its macros.
+AliasTemplate::AliasTemplate(std::wstring target) :
+    _target{ std::move(target) },
+    _lineCount{ 0 }
 {
-    size_t lineCount = 0;
-    std::wstring finalText;
+    _literals.reserve(_target.size() + 2);
 
-    // The target text may contain substitution macros indicated by $.
-    // Walk through and substitute them as appropriate.
-    for (auto ch = str.cbegin(); ch < str.cend(); ch++)
+    for (auto ch = _target.cbegin(); ch < _target.cend(); ch++)
     {
-        if (L'$' == *ch)
+        // A $ with nothing after it is just a $.
+        if (L'$' != *ch || ch + 1 == _target.cend())
         {
-            // Attempt to read ahead by one character.
-            const auto chNext = ch + 1;
-
-            if (chNext < str.cend())
-            {
-                auto isProcessed = s_TryReplaceNumberedArgMacro(*chNext, finalText, tokens);
-                if (!isProcessed)
-                {
-                    isProcessed = s_TryReplaceWildcardArgMacro(*chNext, finalText, fullArgString);
-                }
-                if (!isProcessed)
-                {
-                    isProcessed = s_TryReplaceInputRedirMacro(*chNext, finalText);
-                }
-                if (!isProcessed)
-                {
-                    isProcessed = s_TryReplaceOutputRedirMacro(*chNext, finalText);
-                }
-                if (!isProcessed)
-                {
-                    isProcessed = s_TryReplacePipeRedirMacro(*chNext, finalText);
-                }
-                if (!isProcessed)
-                {
-                    isProcessed = s_TryReplaceNextCommandMacro(*chNext, finalText, lineCount);
-                }
-                if (!isProcessed)
-                {
-                    // If nothing matches, just push these two characters in.
-                    finalText.push_back(*ch);
-                    finalText.push_back(*chNext);
-                }
+            _literals.push_back(*ch);
+            continue;
+        }
 
-                // Since we read ahead and used that character,
-                // advance the iterator one extra to compensate.
-                ch++;
-            }
-            else
-            {
-                // If no read-ahead, just push this character and be done.
-                finalText.push_back(*ch);
-            }
+        const auto chNext = *++ch;
+        if (chNext >= L'1' && chNext <= L'9')
+        {
+            _slots.push_back({ _literals.size(), gsl::narrow_cast<size_t>(chNext - L'0') });
         }
-        else
+        else if (L'*' == chNext)
+        {
+            _slots.push_back({ _literals.size(), 0 });
+        }
+        else if (!Alias::s_TryReplaceInputRedirMacro(chNext, _literals) &&
+                 !Alias::s_TryReplaceOutputRedirMacro(chNext, _literals) &&
+                 !Alias::s_TryReplacePipeRedirMacro(chNext, _literals) &&
+                 !Alias::s_TryReplaceNextCommandMacro(chNext, _literals, _lineCount))
         {
-            // If it didn't match the macro specifier $, push the character.
-            finalText.push_back(*ch);
+            // If nothing matches, just keep these two characters.
+            _literals.push_back(L'$');
+            _literals.push_back(chNext);
         }
     }
 
     // We always terminate with a CRLF to symbolize end of command.
-    s_AppendCrLf(finalText, lineCount);
+    Alias::s_AppendCrLf(_literals, _lineCount);
+}
 
-    // Give back the final text and count.
-    str.swap(finalText);
-    return lineCount;
+// Routine Description:
+// - Gets the alias target as it was given, macros and all.
+// Return Value:
+// - The target text.
+const std::wstring& AliasTemplate::GetTarget() const noexcept
+{
+    return _target;
+}
+
+// Routine Description:
+// - Expands the alias for the given command line.
+// Arguments:
+// - command - The command line, starting with the alias. Its space separated
+//   tokens 1-9 are the arguments for $1-$9, everything after the first space is $*.
+// - lineCount - Receives the number of commands in the result (CRLFs).
+// Return Value:
+// - The target text with all of its macros replaced.
+std::wstring AliasTemplate::Expand(const std::wstring_view command, size_t& lineCount) const
+{
+    // Token 0 is the alias itself. Tokens past 9 can't be referred to.
+    std::array<std::wstring_view, 10> tokens;
+    size_t start = 0;
+    for (auto& token : tokens)
+    {
+        const auto space = command.find(L' ', start);
+        token = command.substr(start, space == std::wstring_view::npos ? space : space - start);
+        if (space == std::wstring_view::npos)
+        {
+            break;
+        }
+        start = space + 1;
+    }
+
+    const auto firstSpace = command.find(L' ');
+    const auto allArgs = firstSpace == std::wstring_view::npos ? std::wstring_view{} : command.substr(firstSpace + 1);
+
+    const auto argument = [&](const Slot& slot) noexcept {
+        return slot.argument == 0 ? allArgs : til::at(tokens, slot.argument);
+    };
+
+    auto length = _literals.size();
+    for (const auto& slot : _slots)
+    {
+        length += argument(slot).size();
+    }
+
+    std::wstring result;
+    result.reserve(length);
+
+    size_t literal = 0;
+    for (const auto& slot : _slots)
+    {
+        result.append(_literals, literal, slot.position - literal);
+        result.append(argument(slot));
+        literal = slot.position;
+    }
+    result.append(_literals, literal, std::wstring::npos);
+
+    lineCount = _lineCount;
+    return result;
 }
 
 // Routine Description:
@@ -1162,24 +1087,16 @@ std::wstring Alias::s_MatchAndCopyAlias(const std::wstring& sourceText,
         return std::wstring();
     }
 
-    auto exeList = exeIter->second;
+    const auto& exeList = exeIter->second;
     if (exeList.size() == 0)
     {
         // If there's no match, give back an empty string.
         return std::wstring();
     }
 
-    // Tokenize the text by spaces
-    const auto tokens = s_Tokenize(sourceCopy);
-
-    // If there are no tokens, return an empty string
-    if (tokens.size() == 0)
-    {
-        return std::wstring();
-    }
-
-    // Find alias. If there isn't one, return an empty string
-    const auto alias = tokens.front();
+    // Find alias. It's everything up to the first space.
+    // If there isn't one, return an empty string
+    const auto alias = sourceCopy.substr(0, sourceCopy.find(L' '));
     const auto aliasIter = exeList.find(alias);
     if (aliasIter == exeList.end())
     {
@@ -1187,20 +1104,14 @@ std::wstring Alias::s_MatchAndCopyAlias(const std::wstring& sourceText,
         return std::wstring();
     }
 
-    const auto target = aliasIter->second;
-    if (target.size() == 0)
+    const auto& target = aliasIter->second;
+    if (target.GetTarget().size() == 0)
     {
         return std::wstring();
     }
 
-    // Get the string of all parameters as a shorthand for $* later.
-    const auto allParams = s_GetArgString(sourceCopy);
-
     // The final text will be the target but with macros replaced.
-    std::wstring finalText(target);
-    lineCount = s_ReplaceMacros(finalText, tokens, allParams);
-
-    return finalText;
+    return target.Expand(sourceCopy, lineCount);
 }
 
 // Routine Description:
@@ -1261,7 +1172,7 @@ void Alias::s_TestAddAlias(std::wstring& exe,
                            std::wstring& alias,
                            std::wstring& target)
 {
-    g_aliasData[exe][alias] = target;
+    g_aliasData[exe].insert_or_assign(alias, AliasTemplate{ target });
 }
 
 void Alias::s_TestClearAliases()
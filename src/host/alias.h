@@ -11,6 +11,31 @@ Abstract:
 --*/
 #pragma once
 
+// An alias target, compiled when the alias is added. The redirection and
+// command separator macros are replaced right away and the argument macros
+// become slots, so that expanding the alias is a single pass over the parts.
+class AliasTemplate final
+{
+public:
+    explicit AliasTemplate(std::wstring target);
+
+    const std::wstring& GetTarget() const noexcept;
+
+    std::wstring Expand(const std::wstring_view command, size_t& lineCount) const;
+
+private:
+    struct Slot
+    {
+        size_t position; // where in _literals the argument goes
+        size_t argument; // 1-9 for $1-$9, 0 for $*
+    };
+
+    std::wstring _target;
+    std::wstring _literals;
+    std::vector<Slot> _slots;
+    size_t _lineCount;
+};
+
 class Alias
 {
 public:
@@ -31,18 +56,6 @@ public:
 private:
     static void s_TrimLeadingSpaces(std::wstring& str);
     static void s_TrimTrailingCrLf(std::wstring& str);
-    static std::deque<std::wstring> s_Tokenize(const std::wstring& str);
-    static std::wstring s_GetArgString(const std::wstring& str);
-    static size_t s_ReplaceMacros(std::wstring& str,
-                                  const std::deque<std::wstring>& tokens,
-                                  const std::wstring& fullArgString);
-
-    static bool s_TryReplaceNumberedArgMacro(const wchar_t ch,
-                                             std::wstring& appendToStr,
-                                             const std::deque<std::wstring>& tokens);
-    static bool s_TryReplaceWildcardArgMacro(const wchar_t ch,
-                                             std::wstring& appendToStr,
-                                             const std::wstring fullArgString);
 
     static bool s_TryReplaceInputRedirMacro(const wchar_t ch,
                                             std::wstring& appendToStr);
@@ -58,6 +71,8 @@ private:
     static void s_AppendCrLf(std::wstring& appendToStr,
                              size_t& lineCount);
 
+    friend class AliasTemplate;
+
 #ifdef UNIT_TESTING
     static void s_TestAddAlias(std::wstring& exe,
                                std::wstring& alias,
@@ -106,6 +106,7 @@ ULONG CONSOLE_INFORMATION::GetCSRecursionCount()
     try
     {
         gci.pInputBuffer = new InputBuffer();
+        gci.pInputBuffer->GetTerminalInput().SetMouseMotionRateLimit(gci.GetMouseMotionRateLimit());
     }
     catch (...)
     {
@@ -77,6 +77,18 @@ static bool CaseInsensitiveEquality(wchar_t a, wchar_t b)
     return ::towlower(a) == ::towlower(b);
 }
 
+// Routine Description:
+// - Lowercases the given text the same way CaseInsensitiveEquality compares it,
+//   to make the keys of the command index.
+static std::wstring FoldCase(const std::wstring_view text)
+{
+    std::wstring folded{ text };
+    std::transform(folded.begin(), folded.end(), folded.begin(), [](const wchar_t wch) {
+        return gsl::narrow_cast<wchar_t>(::towlower(wch));
+    });
+    return folded;
+}
+
 bool CommandHistory::IsAppNameMatch(const std::wstring_view other) const
 {
     return std::equal(_appName.cbegin(), _appName.cend(), other.cbegin(), other.cend(), CaseInsensitiveEquality);
@@ -124,6 +136,7 @@ void CommandHistory::_Reset()
             // find free record.  if all records are used, free the lru one.
             if ((SHORT)_commands.size() == _maxCommands)
             {
+                _IndexErase(0);
                 _commands.erase(_commands.cbegin());
                 // move LastDisplayed back one in order to stay synced with the
                 // command it referred to before erasing the lru one
@@ -139,6 +152,7 @@ void CommandHistory::_Reset()
             {
                 _commands.emplace_back(newCommand);
             }
+            _IndexInsert(gsl::narrow<SHORT>(_commands.size() - 1));
 
             if (LastDisplayed == -1 ||
                 _commands.at(LastDisplayed).size() != newCommand.size() ||
@@ -249,6 +263,7 @@ std::wstring_view CommandHistory::GetLastCommand() const
 void CommandHistory::Empty()
 {
     _commands.clear();
+    _index.clear();
     LastDisplayed = -1;
     WI_SetFlag(Flags, CLE_RESET);
 }
@@ -290,6 +305,7 @@ void CommandHistory::Realloc(const size_t commands)
     {
         _commands.emplace_back(oldCommands[i]);
     }
+    _RebuildIndex();
 
     WI_SetFlag(Flags, CLE_RESET);
     LastDisplayed = gsl::narrow<SHORT>(_commands.size()) - 1;
@@ -392,6 +408,7 @@ CommandHistory* CommandHistory::s_Allocate(const std::wstring_view appName, cons
         if (!SameApp)
         {
             BestCandidate->_commands.clear();
+            BestCandidate->_index.clear();
             BestCandidate->LastDisplayed = -1;
             BestCandidate->_appName = appName;
         }
@@ -471,6 +488,7 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
     try
     {
         const auto str = _commands.at(iDel);
+        _IndexErase(iDel);
 
         if (iDel < iLast)
         {
@@ -527,24 +545,54 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
         return true;
     }
 
+    if (indexFound < 0 || indexFound >= gsl::narrow<SHORT>(_commands.size()))
+    {
+        return false;
+    }
+
     try
     {
-        for (size_t i = 0; i < _commands.size(); i++)
-        {
-            const auto& storedCommand = _commands.at(indexFound);
-            if ((WI_IsFlagClear(options, MatchOptions::ExactMatch) && (givenCommand.size() <= storedCommand.size())) || (givenCommand.size() == storedCommand.size()))
+        // The search goes backwards from indexFound and wraps around at the
+        // start, so the match it would find first is the last one at or
+        // before indexFound, or failing that the last one of all.
+        std::optional<SHORT> lastBefore;
+        std::optional<SHORT> last;
+        const auto consider = [&](const std::vector<size_t>& indices) {
+            for (const auto stored : indices)
             {
-                if (std::equal(storedCommand.begin(),
-                               storedCommand.begin() + givenCommand.size(),
-                               givenCommand.begin(),
-                               givenCommand.end(),
-                               CaseInsensitiveEquality))
+                const auto index = gsl::narrow_cast<SHORT>(stored - _indexBase);
+                if (index <= indexFound && (!lastBefore || index > *lastBefore))
+                {
+                    lastBefore = index;
+                }
+                if (!last || index > *last)
                 {
-                    return true;
+                    last = index;
                 }
             }
+        };
 
-            _Prev(indexFound);
+        const auto key = FoldCase(givenCommand);
+        if (WI_IsFlagSet(options, MatchOptions::ExactMatch))
+        {
+            const auto entry = _index.find(key);
+            if (entry != _index.end())
+            {
+                consider(entry->second);
+            }
+        }
+        else
+        {
+            for (auto entry = _index.lower_bound(key); entry != _index.end() && entry->first.compare(0, key.size(), key) == 0; ++entry)
+            {
+                consider(entry->second);
+            }
+        }
+
+        if (lastBefore || last)
+        {
+            indexFound = lastBefore.value_or(*last);
+            return true;
         }
     }
     CATCH_LOG();
@@ -552,6 +600,83 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
     return false;
 }
 
+// Routine Description:
+// - Adds the command at the given index to the index of commands.
+// Arguments:
+// - index - The index of the command. It has to be the last one.
+void CommandHistory::_IndexInsert(const SHORT index)
+{
+    _index[FoldCase(_commands.at(index))].push_back(_indexBase + index);
+}
+
+// Routine Description:
+// - Removes the command at the given index from the index of commands, and
+//   moves the commands after it up by one, as erasing it from _commands will.
+// Arguments:
+// - index - The index of the command that's about to be erased.
+void CommandHistory::_IndexErase(const SHORT index)
+{
+    const size_t stored = _indexBase + index;
+    const auto entry = _index.find(FoldCase(_commands.at(index)));
+    if (entry != _index.end())
+    {
+        auto& indices = entry->second;
+        indices.erase(std::remove(indices.begin(), indices.end(), stored), indices.end());
+        if (indices.empty())
+        {
+            _index.erase(entry);
+        }
+    }
+
+    // Moving all of the commands up by one is a matter of moving the base.
+    if (index == 0)
+    {
+        ++_indexBase;
+        return;
+    }
+
+    for (auto& [command, indices] : _index)
+    {
+        for (auto& i : indices)
+        {
+            if (i > stored)
+            {
+                --i;
+            }
+        }
+    }
+}
+
+// Routine Description:
+// - Updates the index of commands for two commands that are about to trade places.
+// Arguments:
+// - indexA - index of one command
+// - indexB - index of the other command
+void CommandHistory::_IndexSwap(const SHORT indexA, const SHORT indexB)
+{
+    auto& indicesA = _index.at(FoldCase(_commands.at(indexA)));
+    auto& indicesB = _index.at(FoldCase(_commands.at(indexB)));
+    if (&indicesA == &indicesB)
+    {
+        return;
+    }
+
+    std::replace(indicesA.begin(), indicesA.end(), _indexBase + indexA, _indexBase + indexB);
+    std::replace(indicesB.begin(), indicesB.end(), _indexBase + indexB, _indexBase + indexA);
+}
+
+// Routine Description:
+// - Builds the index of commands from scratch.
+void CommandHistory::_RebuildIndex()
+{
+    _index.clear();
+    _indexBase = 0;
+    for (SHORT i = 0; i < gsl::narrow<SHORT>(_commands.size()); ++i)
+    {
+        _IndexInsert(i);
+    }
+}
+
 #ifdef UNIT_TESTING
 void CommandHistory::s_ClearHistoryListStorage()
 {
@@ -566,6 +691,7 @@ void CommandHistory::s_ClearHistoryListStorage()
 // - indexB - index of one history item to swap
 void CommandHistory::Swap(const short indexA, const short indexB)
 {
+    _IndexSwap(indexA, indexB);
     std::swap(_commands.at(indexA), _commands.at(indexB));
 }
 
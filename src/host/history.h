@@ -83,9 +83,22 @@ private:
     void _Dec(SHORT& ind) const;
     void _Inc(SHORT& ind) const;
 
+    void _IndexInsert(const SHORT index);
+    void _IndexErase(const SHORT index);
+    void _IndexSwap(const SHORT indexA, const SHORT indexB);
+    void _RebuildIndex();
+
     std::vector<std::wstring> _commands;
     SHORT _maxCommands;
 
+    // Every distinct command, case folded, and the indices in _commands it's
+    // stored at. Commands that share a prefix sort next to each other, so the
+    // commands starting with some text are a single range of the map.
+    // The indices are offset by _indexBase, so that dropping the oldest
+    // command when the history is full doesn't have to touch all of them.
+    std::map<std::wstring, std::vector<size_t>> _index;
+    size_t _indexBase{ 0 };
+
     std::wstring _appName;
     HANDLE _processHandle;
 
@@ -382,15 +382,19 @@ void ScrollRegion(SCREEN_INFORMATION& screenInfo,
 
     // Determine the cell we will use to fill in any revealed/uncovered space.
     // We generally use exactly what was given to us.
-    OutputCellIterator fillData(fillCharGiven, fillAttrsGiven);
+    auto fillChar = fillCharGiven;
+    auto fillAttrs = fillAttrsGiven;
 
     // However, if the character is null and we were given a null attribute (represented as legacy 0),
     // then we'll just fill with spaces and whatever the buffer's default colors are.
     if (fillCharGiven == UNICODE_NULL && fillAttrsGiven == TextAttribute{ 0 })
     {
-        fillData = OutputCellIterator(UNICODE_SPACE, screenInfo.GetAttributes());
+        fillChar = UNICODE_SPACE;
+        fillAttrs = screenInfo.GetAttributes();
     }
 
+    const OutputCellIterator fillData(fillChar, fillAttrs);
+
     // ------ 4. PREP TARGET ------
     // Now it's time to think about the target. We're only given the origin of the target
     // because it is assumed that it will have the same relative dimensions as the original source.
@@ -450,7 +454,22 @@ void ScrollRegion(SCREEN_INFORMATION& screenInfo,
     for (size_t i = 0; i < remaining.size(); i++)
     {
         const auto& view = remaining.at(i);
-        screenInfo.WriteRect(fillData, view);
+
+        // Rows that are filled from edge to edge with spaces are exactly what
+        // a reset row looks like, so reset them instead of writing every cell.
+        if (fillChar == UNICODE_SPACE && view.Width() == buffer.Width())
+        {
+            auto& textBuffer = screenInfo.GetTextBuffer();
+            for (auto row = view.Top(); row < view.BottomExclusive(); row++)
+            {
+                THROW_HR_IF(E_OUTOFMEMORY, !textBuffer.GetRowByOffset(row).Reset(fillAttrs));
+            }
+            screenInfo.GetRenderTarget().TriggerRedraw(view);
+        }
+        else
+        {
+            screenInfo.WriteRect(fillData, view);
+        }
     }
 }
 
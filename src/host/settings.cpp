@@ -59,7 +59,8 @@ Settings::Settings() :
     _DefaultForeground(INVALID_COLOR),
     _DefaultBackground(INVALID_COLOR),
     _fUseDx(false),
-    _fCopyColor(false)
+    _fCopyColor(false),
+    _dwMouseMotionRateLimit(0)
 {
     _dwScreenBufferSize.X = 80;
     _dwScreenBufferSize.Y = 25;
@@ -835,3 +836,13 @@ bool Settings::GetCopyColor() const noexcept
 {
     return _fCopyColor;
 }
+
+// Routine Description:
+// - Gets the most mouse motion events per second to send to an application
+//   that tracks the mouse. Motion that comes in faster is coalesced.
+// Return Value:
+// - The rate limit, or 0 if every motion event is sent.
+DWORD Settings::GetMouseMotionRateLimit() const noexcept
+{
+    return _dwMouseMotionRateLimit;
+}
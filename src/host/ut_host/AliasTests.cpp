@@ -58,6 +58,13 @@ class AliasTests
         expected = targetExpectedPair.Mid(sepIndex + 1);
     }
 
+    // Expands the target for the command, without going through an exe's alias list.
+    static std::wstring _Expand(const std::wstring& target, const std::wstring& command)
+    {
+        size_t lineCount = 0;
+        return AliasTemplate{ target }.Expand(command, lineCount);
+    }
+
     TEST_METHOD(TestMatchAndCopy)
     {
         BEGIN_TEST_METHOD_PROPERTIES()
@@ -396,36 +403,14 @@ class AliasTests
 
     TEST_METHOD(Tokenize)
     {
-        std::wstring tokenStr(L"one two three");
-        std::deque<std::wstring> tokensExpected;
-        tokensExpected.emplace_back(L"one");
-        tokensExpected.emplace_back(L"two");
-        tokensExpected.emplace_back(L"three");
-
-        auto tokensActual = Alias::s_Tokenize(tokenStr);
-
-        VERIFY_ARE_EQUAL(tokensExpected.size(), tokensActual.size());
-
-        for (size_t i = 0; i < tokensExpected.size(); i++)
-        {
-            VERIFY_ARE_EQUAL(String(tokensExpected[i].data()), String(tokensActual[i].data()));
-        }
+        const auto actual = _Expand(L"[$1][$2][$3]", L"alias one two three");
+        VERIFY_ARE_EQUAL(String(L"[one][two][three]\r\n"), String(actual.c_str()));
     }
 
     TEST_METHOD(TokenizeNothing)
     {
-        std::wstring tokenStr(L"alias");
-        std::deque<std::wstring> tokensExpected;
-        tokensExpected.emplace_back(tokenStr);
-
-        auto tokensActual = Alias::s_Tokenize(tokenStr);
-
-        VERIFY_ARE_EQUAL(tokensExpected.size(), tokensActual.size());
-
-        for (size_t i = 0; i < tokensExpected.size(); i++)
-        {
-            VERIFY_ARE_EQUAL(String(tokensExpected[i].data()), String(tokensActual[i].data()));
-        }
+        const auto actual = _Expand(L"[$1]", L"alias");
+        VERIFY_ARE_EQUAL(String(L"[]\r\n"), String(actual.c_str()));
     }
 
     TEST_METHOD(GetArgString)
@@ -441,8 +426,9 @@ class AliasTests
         std::wstring target;
         std::wstring expected;
         _RetrieveTargetExpectedPair(target, expected);
+        expected.append(L"\r\n");
 
-        std::wstring actual = Alias::s_GetArgString(target);
+        const auto actual = _Expand(L"$*", target);
 
         VERIFY_ARE_EQUAL(String(expected.data()), String(actual.data()));
     }
@@ -461,35 +447,18 @@ class AliasTests
                                  L"7=seven,"
                                  L"8=eight,"
                                  L"9=nine,"
-                                 L"A=,"
-                                 L"0=,"
+                                 L"A=$A,"
+                                 L"0=$0,"
                                  L"}")
         END_TEST_METHOD_PROPERTIES()
 
         std::wstring target;
         std::wstring expected;
         _RetrieveTargetExpectedPair(target, expected);
+        expected.append(L"\r\n");
 
-        std::deque<std::wstring> tokens;
-        tokens.emplace_back(L"alias");
-        tokens.emplace_back(L"one");
-        tokens.emplace_back(L"two");
-        tokens.emplace_back(L"three");
-        tokens.emplace_back(L"four");
-        tokens.emplace_back(L"five");
-        tokens.emplace_back(L"six");
-        tokens.emplace_back(L"seven");
-        tokens.emplace_back(L"eight");
-        tokens.emplace_back(L"nine");
-        tokens.emplace_back(L"ten");
-
-        // if we expect non-empty results, then we should get a bool back saying it was processed
-        const bool returnExpected = !expected.empty();
+        const auto actual = _Expand(L"$" + target, L"alias one two three four five six seven eight nine ten");
 
-        std::wstring actual;
-        const bool returnActual = Alias::s_TryReplaceNumberedArgMacro(target[0], actual, tokens);
-
-        VERIFY_ARE_EQUAL(returnExpected, returnActual);
         VERIFY_ARE_EQUAL(String(expected.data()), String(actual.data()));
     }
 
@@ -499,24 +468,18 @@ class AliasTests
             TEST_METHOD_PROPERTY(L"Data:targetExpectedPair",
                                  L"{"
                                  L"*=one two three,"
-                                 L"A=,"
-                                 L"0=,"
+                                 L"A=$A,"
+                                 L"0=$0,"
                                  L"}")
         END_TEST_METHOD_PROPERTIES()
 
         std::wstring target;
         std::wstring expected;
         _RetrieveTargetExpectedPair(target, expected);
+        expected.append(L"\r\n");
 
-        std::wstring fullArgString(L"one two three");
-
-        // if we expect non-empty results, then we should get a bool back saying it was processed
-        const bool returnExpected = !expected.empty();
-
-        std::wstring actual;
-        const bool returnActual = Alias::s_TryReplaceWildcardArgMacro(target[0], actual, fullArgString);
+        const auto actual = _Expand(L"$" + target, L"alias one two three");
 
-        VERIFY_ARE_EQUAL(returnExpected, returnActual);
         VERIFY_ARE_EQUAL(String(expected.data()), String(actual.data()));
     }
 
@@ -647,4 +610,94 @@ class AliasTests
         VERIFY_ARE_EQUAL(String(expected.data()), String(actual.data()));
         VERIFY_ARE_EQUAL(lineCountExpected, lineCountActual);
     }
+
+    TEST_METHOD(TemplateExpansion)
+    {
+        struct Case
+        {
+            const wchar_t* target;
+            const wchar_t* command;
+            const wchar_t* expected;
+            size_t lineCount;
+        };
+
+        const Case cases[] = {
+            { L"bar", L"foo one", L"bar\r\n", 1 },
+            { L"", L"foo", L"\r\n", 1 },
+            { L"$", L"foo", L"$\r\n", 1 },
+            { L"bar $", L"foo one", L"bar $\r\n", 1 },
+            { L"$$1", L"foo one", L"$$1\r\n", 1 },
+            { L"$x$Y$0$?", L"foo one", L"$x$Y$0$?\r\n", 1 },
+            { L"$1$2$3$4$5$6$7$8$9",
+              L"foo one two three four five six seven eight nine ten eleven twelve",
+              L"onetwothreefourfivesixseveneightnine\r\n",
+              1 },
+            { L"bar $* baz $*", L"foo one two", L"bar one two baz one two\r\n", 1 },
+            { L"[$*]", L"foo ", L"[]\r\n", 1 },
+            { L"$L$l$G$g$B$b", L"foo", L"<<>>||\r\n", 1 },
+            { L"one$Ttwo$tthree", L"foo", L"one\r\ntwo\r\nthree\r\n", 3 },
+            { L"$1 $* $T$3 $L $9 $", L"foo  one  two", L"  one  two \r\n <  $\r\n", 2 },
+            { L"$1 $2", L"foo \x3042 \xD83C\xDD71 wide", L"\x3042 \xD83C\xDD71\r\n", 1 },
+        };
+
+        for (const auto& c : cases)
+        {
+            Log::Comment(NoThrowString().Format(L"Target '%s' with command '%s'", c.target, c.command));
+
+            const AliasTemplate aliasTemplate{ c.target };
+            VERIFY_ARE_EQUAL(String(c.target), String(aliasTemplate.GetTarget().c_str()));
+
+            size_t lineCount = 0;
+            const auto actual = aliasTemplate.Expand(c.command, lineCount);
+
+            VERIFY_ARE_EQUAL(String(c.expected), String(actual.c_str()));
+            VERIFY_ARE_EQUAL(c.lineCount, lineCount);
+        }
+    }
+
+    TEST_METHOD(TemplateExpansionPerformance)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+        END_TEST_METHOD_PROPERTIES()
+
+        const std::wstring target(L"git log --oneline -n $1 $2 $L $3 $G out.txt $T echo $*");
+        const std::wstring command(L"gl 20 --graph in.txt extra arguments that only $* picks up");
+        constexpr auto iterations = 100000;
+
+        const auto compileStart = std::chrono::steady_clock::now();
+        const AliasTemplate aliasTemplate{ target };
+        const auto compileTime = std::chrono::steady_clock::now() - compileStart;
+
+        const auto expandStart = std::chrono::steady_clock::now();
+        std::wstring expanded;
+        size_t lineCount = 0;
+        for (auto i = 0; i < iterations; ++i)
+        {
+            expanded = aliasTemplate.Expand(command, lineCount);
+        }
+        const auto expandTime = std::chrono::steady_clock::now() - expandStart;
+
+        Log::Comment(NoThrowString().Format(L"%d expansions: %lldus compiling once and %lldus expanding the template",
+                                            iterations,
+                                            std::chrono::duration_cast<std::chrono::microseconds>(compileTime).count(),
+                                            std::chrono::duration_cast<std::chrono::microseconds>(expandTime).count()));
+
+        VERIFY_ARE_EQUAL(String(L"git log --oneline -n 20 --graph < in.txt > out.txt \r\n echo 20 --graph in.txt extra arguments that only $* picks up\r\n"),
+                         String(expanded.c_str()));
+        VERIFY_ARE_EQUAL(2u, gsl::narrow<unsigned int>(lineCount));
+    }
+
+    TEST_METHOD(LookupIgnoresCase)
+    {
+        std::wstring exe(L"test.exe");
+        std::wstring alias(L"foo");
+        std::wstring target(L"bar $1");
+        Alias::s_TestAddAlias(exe, alias, target);
+
+        size_t lineCount = 0;
+        const auto actual = Alias::s_MatchAndCopyAlias(L"FoO one", L"TEST.EXE", lineCount);
+        VERIFY_ARE_EQUAL(String(L"bar one\r\n"), String(actual.c_str()));
+        VERIFY_ARE_EQUAL(1u, gsl::narrow<unsigned int>(lineCount));
+    }
 };
@@ -12,6 +12,8 @@
 
 #include "input.h"
 
+#include <random>
+
 using namespace WEX::Common;
 using namespace WEX::Logging;
 using namespace WEX::TestExecution;
@@ -124,6 +126,9 @@ class AttrRowTests
             pRun->SetLength(sChainLeftover);
         }
 
+        // The runs were written directly, so update where they end.
+        pChain->_RefreshRunEnds();
+
         return true;
     }
 
@@ -275,6 +280,7 @@ class AttrRowTests
         originalRow._list[1].SetLength(5);
         originalRow._list[2].SetAttributes(TextAttribute{ 'G' });
         originalRow._list[2].SetLength(2);
+        originalRow._RefreshRunEnds();
         LogChain(L"Original: ", originalRow._list);
 
         // Set up our "insertion run"
@@ -559,6 +565,7 @@ class AttrRowTests
             // Then default color to end the run
             chain->_list[3].SetAttributes(TextAttribute());
             chain->_list[3].SetLength(73);
+            chain->_RefreshRunEnds();
 
             // The sum of the lengths should be 121.
             VERIFY_ARE_EQUAL(chain->_cchRowWidth, chain->_list[0]._cchLength + chain->_list[1]._cchLength + chain->_list[2]._cchLength + chain->_list[3]._cchLength);
@@ -587,6 +594,7 @@ class AttrRowTests
             // Color 12 for the next 1
             chain->_list[2].SetAttributes(TextAttribute(0xC));
             chain->_list[2].SetLength(1);
+            chain->_RefreshRunEnds();
 
             // The sum of the lengths should be 3.
             VERIFY_ARE_EQUAL(chain->_cchRowWidth, chain->_list[0]._cchLength + chain->_list[1]._cchLength + chain->_list[2]._cchLength);
@@ -616,6 +624,7 @@ class AttrRowTests
             // Color 12 for the next 1
             chain->_list[2].SetAttributes(TextAttribute(0xC));
             chain->_list[2].SetLength(1);
+            chain->_RefreshRunEnds();
 
             // The sum of the lengths should be 3.
             VERIFY_ARE_EQUAL(chain->_cchRowWidth, chain->_list[0]._cchLength + chain->_list[1]._cchLength + chain->_list[2]._cchLength);
@@ -732,4 +741,167 @@ class AttrRowTests
         state.CleanupGlobalScreenBuffer();
         state.CleanupGlobalFont();
     }
+
+    // Checks that the cached run ends match the runs, and that looking up and iterating
+    // over the row gives the same attributes as the expected unpacked row.
+    void VerifyRowMatches(const ATTR_ROW& row, const std::vector<TextAttribute>& expected)
+    {
+        VERIFY_ARE_EQUAL(expected.size(), row._cchRowWidth);
+        VERIFY_ARE_EQUAL(row._list.size(), row._runEnds.size());
+
+        size_t end = 0;
+        for (size_t i = 0; i < row._list.size(); i++)
+        {
+            end += row._list[i].GetLength();
+            VERIFY_ARE_EQUAL(end, row._runEnds[i]);
+        }
+        VERIFY_ARE_EQUAL(expected.size(), end);
+
+        for (size_t column = 0; column < expected.size(); column++)
+        {
+            size_t applies = 0;
+            VERIFY_ARE_EQUAL(expected[column], row.GetAttrByColumn(column, &applies));
+
+            // The attribute has to apply to at least this column, and to no column of another color.
+            VERIFY_IS_TRUE(applies > 0 && column + applies <= expected.size());
+            VERIFY_ARE_EQUAL(expected[column], expected[column + applies - 1]);
+        }
+
+        const std::vector<TextAttribute> unpacked{ row.begin(), row.end() };
+        VERIFY_ARE_EQUAL(expected.size(), unpacked.size());
+        for (size_t column = 0; column < expected.size(); column++)
+        {
+            VERIFY_ARE_EQUAL(expected[column], unpacked[column]);
+        }
+    }
+
+    TEST_METHOD(TestRunLookupMatchesUnpacked)
+    {
+        constexpr size_t width = 97;
+        ATTR_ROW row{ gsl::narrow<UINT>(width), _DefaultAttr };
+        std::vector<TextAttribute> expected(width, _DefaultAttr);
+
+        // A fixed seed, so that a failure can be reproduced.
+        std::minstd_rand rng{ 1234 };
+
+        Log::Comment(L"Insert runs of random lengths and colors all over the row, checking it after each one.");
+        for (auto i = 0; i < 500; i++)
+        {
+            const auto start = rng() % width;
+            const auto maxLength = std::min<size_t>(width - start, 12);
+
+            std::vector<TextAttributeRun> insert;
+            auto column = start;
+            while (column < start + maxLength && insert.size() < 3)
+            {
+                const auto length = std::min<size_t>(1 + rng() % 5, start + maxLength - column);
+                const TextAttribute attr{ gsl::narrow_cast<WORD>(rng() % 4) };
+                insert.emplace_back(length, attr);
+                std::fill_n(expected.begin() + column, length, attr);
+                column += length;
+            }
+
+            VERIFY_SUCCEEDED(row.InsertAttrRuns(insert, start, column - 1, width));
+            VerifyRowMatches(row, expected);
+        }
+
+        Log::Comment(L"Move an iterator around the row by varying amounts in both directions.");
+        auto it = row.cbegin();
+        size_t position = 0;
+        for (auto i = 0; i < 500; i++)
+        {
+            const auto target = rng() % width;
+            it += gsl::narrow_cast<ptrdiff_t>(target) - gsl::narrow_cast<ptrdiff_t>(position);
+            position = target;
+
+            VERIFY_IS_TRUE(it);
+            VERIFY_ARE_EQUAL(expected[position], *it);
+        }
+
+        Log::Comment(L"Stepping off either end of the row stops the iterator.");
+        it += gsl::narrow_cast<ptrdiff_t>(width - position);
+        VERIFY_IS_TRUE(row.cend() == it);
+        it = row.cbegin();
+        it += 5;
+        it -= 6;
+        VERIFY_IS_FALSE(it);
+
+        Log::Comment(L"Resizing the row keeps the run ends up to date.");
+        row.Resize(width + 20);
+        expected.resize(width + 20, expected.back());
+        VerifyRowMatches(row, expected);
+
+        row.Resize(width / 2);
+        expected.resize(width / 2);
+        VerifyRowMatches(row, expected);
+    }
+
+    TEST_METHOD(TestManyRunsPerformance)
+    {
+        constexpr size_t width = 1000;
+        constexpr auto repeats = 10;
+        const TextAttribute highlight{ FOREGROUND_RED | BACKGROUND_RED };
+
+        for (const size_t runCount : { 1u, 10u, 100u, 250u, 500u })
+        {
+            // A row with the given number of runs of (nearly) the same length.
+            std::vector<TextAttribute> expected;
+            for (size_t column = 0; column < width; column++)
+            {
+                expected.emplace_back(gsl::narrow_cast<WORD>(column * runCount / width % 8));
+            }
+
+            ATTR_ROW row{ gsl::narrow<UINT>(width), _DefaultAttr };
+            const auto packed = ATTR_ROW::PackAttrs(expected);
+            VERIFY_SUCCEEDED(row.InsertAttrRuns(packed, 0, width - 1, width));
+            VERIFY_ARE_EQUAL(runCount, row.GetNumberOfRuns());
+
+            // Look up every column in the row.
+            auto start = std::chrono::steady_clock::now();
+            for (auto i = 0; i < repeats; i++)
+            {
+                for (size_t column = 0; column < width; column++)
+                {
+                    if (row.GetAttrByColumn(column) != expected[column])
+                    {
+                        VERIFY_FAIL(L"Wrong attribute found");
+                    }
+                }
+            }
+            const auto lookupTime = std::chrono::steady_clock::now() - start;
+
+            // Write two cells of another color at every column, then put the original colors back.
+            // Each write splits the row in the middle and each restore merges it again.
+            const std::vector<std::vector<TextAttributeRun>> originals = [&]() {
+                std::vector<std::vector<TextAttributeRun>> runs;
+                for (size_t column = 0; column < width - 1; column++)
+                {
+                    runs.push_back(ATTR_ROW::PackAttrs({ expected[column], expected[column + 1] }));
+                }
+                return runs;
+            }();
+            const TextAttributeRun cells{ 2, highlight };
+
+            start = std::chrono::steady_clock::now();
+            for (auto i = 0; i < repeats; i++)
+            {
+                for (size_t column = 0; column < width - 1; column++)
+                {
+                    VERIFY_SUCCEEDED(row.InsertAttrRuns({ &cells, 1 }, column, column + 1, width));
+                    VERIFY_SUCCEEDED(row.InsertAttrRuns(originals[column], column, column + 1, width));
+                }
+            }
+            const auto insertTime = std::chrono::steady_clock::now() - start;
+
+            VERIFY_ARE_EQUAL(runCount, row.GetNumberOfRuns());
+            VerifyRowMatches(row, expected);
+
+            Log::Comment(NoThrowString().Format(L"%zu runs: %lldus for %zu lookups, %lldus for %zu writes",
+                                                runCount,
+                                                std::chrono::duration_cast<std::chrono::microseconds>(lookupTime).count(),
+                                                repeats * width,
+                                                std::chrono::duration_cast<std::chrono::microseconds>(insertTime).count(),
+                                                repeats * (width - 1) * 2));
+        }
+    }
 };
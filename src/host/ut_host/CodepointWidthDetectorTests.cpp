@@ -76,26 +76,68 @@ class CodepointWidthDetectorTests
 
     TEST_METHOD(AmbiguousCache)
     {
-        // Set up a detector with fallback.
+        // Set up a detector with fallback that counts how often it's asked.
+        size_t calls = 0;
         CodepointWidthDetector widthDetector;
-        widthDetector.SetFallbackMethod(std::bind(&FallbackMethod, std::placeholders::_1));
-
-        // Ensure fallback cache is empty.
-        VERIFY_ARE_EQUAL(0u, widthDetector._fallbackCache.size());
+        widthDetector.SetFallbackMethod([&](const std::wstring_view glyph) {
+            ++calls;
+            return FallbackMethod(glyph);
+        });
 
         // Lookup ambiguous width character.
-        widthDetector.IsWide(ambiguous);
+        const auto wide = widthDetector.IsWide(ambiguous);
+        VERIFY_ARE_EQUAL(FallbackMethod(ambiguous), wide);
+        VERIFY_ARE_EQUAL(1u, calls);
 
-        // Cache should hold it.
-        VERIFY_ARE_EQUAL(1u, widthDetector._fallbackCache.size());
+        // The second time, the answer should come from the cache.
+        VERIFY_ARE_EQUAL(wide, widthDetector.IsWide(ambiguous));
+        VERIFY_ARE_EQUAL(1u, calls);
 
-        // Cached item should match what we expect
-        const auto it = widthDetector._fallbackCache.begin();
-        VERIFY_ARE_EQUAL(ambiguous, it->first);
-        VERIFY_ARE_EQUAL(FallbackMethod(ambiguous), it->second);
+        // Glyphs outside the BMP are cached too.
+        const std::wstring_view privateUse{ L"\xDB80\xDC00" }; // U+F0000
+        widthDetector.IsWide(privateUse);
+        widthDetector.IsWide(privateUse);
+        VERIFY_ARE_EQUAL(2u, calls);
 
-        // Cache should empty when font changes.
+        // Cache should be emptied when font changes.
         widthDetector.NotifyFontChanged();
-        VERIFY_ARE_EQUAL(0u, widthDetector._fallbackCache.size());
+        VERIFY_ARE_EQUAL(wide, widthDetector.IsWide(ambiguous));
+        VERIFY_ARE_EQUAL(3u, calls);
+    }
+
+    TEST_METHOD(MeasureRunMatchesGetWidth)
+    {
+        CodepointWidthDetector widthDetector;
+        widthDetector.SetFallbackMethod(std::bind(&FallbackMethod, std::placeholders::_1));
+
+        // ASCII, box drawing, Greek, Cyrillic, CJK and a surrogate pair.
+        std::wstring text{ L"ab \x2500\x2502 \x03B1\x03B2 \x0414\x0416 \x306A\x72D7 \xD83D\xDC7E\a" };
+        while (text.size() < 100)
+        {
+            text += text;
+        }
+
+        size_t pos = 0;
+        while (pos < text.size())
+        {
+            const auto run = widthDetector.MeasureRun(std::wstring_view{ text }.substr(pos));
+            VERIFY_IS_GREATER_THAN(run.length, 0u);
+            VERIFY_IS_LESS_THAN_OR_EQUAL(run.length, 64u);
+
+            for (size_t i = 0; i < run.length;)
+            {
+                const size_t length = (run.pairs >> i) & 1 ? 2 : 1;
+                const auto glyph = std::wstring_view{ text }.substr(pos + i, length);
+                VERIFY_ARE_EQUAL(widthDetector.IsWide(glyph), ((run.wide >> i) & 1) != 0);
+                i += length;
+            }
+
+            pos += run.length;
+        }
+
+        Log::Comment(L"A surrogate that isn't part of a pair ends the run.");
+        const auto run = widthDetector.MeasureRun(L"ab\xD83D" L"c");
+        VERIFY_ARE_EQUAL(2u, run.length);
+        VERIFY_ARE_EQUAL(0u, widthDetector.MeasureRun(L"\xDC7E").length);
     }
 };
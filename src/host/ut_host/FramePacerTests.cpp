@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+
+#include "..\..\renderer\base\FramePacer.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using namespace Microsoft::Console::Render;
+using namespace std::chrono;
+
+class FramePacerTests
+{
+    TEST_CLASS(FramePacerTests);
+
+    steady_clock::time_point _now;
+    std::unique_ptr<FramePacer> _pacer;
+
+    TEST_METHOD_SETUP(MethodSetup)
+    {
+        _now = {};
+        _pacer = std::make_unique<FramePacer>([this]() { return _now; });
+        return true;
+    }
+
+    // Runs one frame the way RenderThread does, with the fake clock advancing by
+    // the given paint time and the returned delay, and the given number of
+    // paint requests coming in while the frame was being painted.
+    milliseconds _Frame(const milliseconds paintTime, const int requestsWhilePainting)
+    {
+        _pacer->FrameStarted();
+        _now += paintTime;
+        for (auto i = 0; i < requestsWhilePainting; ++i)
+        {
+            _pacer->NotifyOutput();
+        }
+        _pacer->FrameCompleted();
+
+        const auto delay = _pacer->NextFrameDelay();
+        _now += delay;
+        return delay;
+    }
+
+    TEST_METHOD(IdleFramesUseMinimumInterval)
+    {
+        for (auto i = 0; i < 50; ++i)
+        {
+            VERIFY_ARE_EQUAL(FramePacer::MinimumInterval.count(), _Frame(2ms, 0).count());
+        }
+        VERIFY_ARE_EQUAL(FramePacer::MinimumInterval.count(), _pacer->GetStats().interval.count());
+    }
+
+    TEST_METHOD(FloodBacksOffToMaximumInterval)
+    {
+        Log::Comment(L"A few busy frames in a row don't change anything yet.");
+        for (unsigned int i = 1; i < FramePacer::FloodFrames; ++i)
+        {
+            VERIFY_ARE_EQUAL(FramePacer::MinimumInterval.count(), _Frame(1ms, 10).count());
+        }
+
+        Log::Comment(L"After that, the interval doubles for every run of busy frames.");
+        VERIFY_ARE_EQUAL((FramePacer::MinimumInterval * 2 - 1ms).count(), _Frame(1ms, 10).count());
+        VERIFY_ARE_EQUAL((FramePacer::MinimumInterval * 2).count(), _pacer->GetStats().interval.count());
+
+        for (auto i = 0; i < 100; ++i)
+        {
+            const auto delay = _Frame(1ms, 10);
+            VERIFY_IS_LESS_THAN_OR_EQUAL(delay.count(), FramePacer::MaximumInterval.count());
+        }
+        VERIFY_ARE_EQUAL(FramePacer::MaximumInterval.count(), _pacer->GetStats().interval.count());
+        Log::Comment(L"The time spent painting counts towards the interval.");
+        VERIFY_ARE_EQUAL((FramePacer::MaximumInterval - 30ms).count(), _Frame(30ms, 10).count());
+
+        Log::Comment(L"The first frame that finds nothing waiting ends the flood.");
+        VERIFY_ARE_EQUAL(FramePacer::MinimumInterval.count(), _Frame(1ms, 0).count());
+        VERIFY_ARE_EQUAL(FramePacer::MinimumInterval.count(), _Frame(1ms, 10).count());
+    }
+
+    TEST_METHOD(UserInputTakesTheFastPath)
+    {
+        for (auto i = 0; i < 100; ++i)
+        {
+            _Frame(1ms, 10);
+        }
+        VERIFY_ARE_EQUAL(FramePacer::MaximumInterval.count(), _pacer->GetStats().interval.count());
+
+        _pacer->NotifyUserInput();
+        VERIFY_ARE_EQUAL(milliseconds::zero().count(), _pacer->NextFrameDelay().count(), L"Input cuts the wait short.");
+
+        VERIFY_ARE_EQUAL(FramePacer::MinimumInterval.count(), _Frame(1ms, 10).count(), L"The back-off is forgotten.");
+        VERIFY_ARE_EQUAL(1u, _pacer->GetStats().fastPathFrames);
+    }
+
+    TEST_METHOD(StatsTrackFrames)
+    {
+        for (auto i = 0; i < 40; ++i)
+        {
+            _Frame(3ms, 0);
+            _pacer->NotifyOutput();
+        }
+
+        const auto stats = _pacer->GetStats();
+        VERIFY_ARE_EQUAL(40u, stats.frames);
+        VERIFY_ARE_EQUAL(0u, stats.fastPathFrames);
+        VERIFY_ARE_EQUAL(3000, stats.lastPaintDuration.count());
+        VERIFY_ARE_EQUAL(3000, stats.averagePaintDuration.count());
+
+        // One request per 11ms frame (3ms painting plus the 8ms gap) is about 90 per second.
+        Log::Comment(NoThrowString().Format(L"Output requests per second: %f", stats.outputRequestsPerSecond));
+        VERIFY_IS_GREATER_THAN(stats.outputRequestsPerSecond, 60.0);
+        VERIFY_IS_LESS_THAN(stats.outputRequestsPerSecond, 91.0);
+    }
+};
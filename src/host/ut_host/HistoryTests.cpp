@@ -242,7 +242,129 @@ class HistoryTests
         VERIFY_ARE_EQUAL(2ul, history->GetNumberOfCommands());
     }
 
+    TEST_METHOD(FindMatchingCommandByPrefix)
+    {
+        auto history = CommandHistory::s_Allocate(_manyApps[0], _MakeHandle(0));
+        VERIFY_IS_NOT_NULL(history);
+        for (size_t i = 0; i < s_BufferSize; i++)
+        {
+            VERIFY_SUCCEEDED(history->Add(_manyHistoryItems[i], false));
+        }
+
+        SHORT index;
+        Log::Comment(L"The most recent command with the prefix is found first, ignoring case.");
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"IPCONFIG", 0, index, CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(String(L"ipconfig /all"), String(history->GetNth(index).data()));
+
+        Log::Comment(L"Searching again from there finds the one before it.");
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"ipconfig", index, index, CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(String(L"ipconfig"), String(history->GetNth(index).data()));
+
+        Log::Comment(L"And again wraps around to the most recent one.");
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"ipconfig", index, index, CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(String(L"ipconfig /all"), String(history->GetNth(index).data()));
+
+        Log::Comment(L"An exact match doesn't accept longer commands.");
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"Dir", 0, index, CommandHistory::MatchOptions::JustLooking | CommandHistory::MatchOptions::ExactMatch));
+        VERIFY_ARE_EQUAL(String(L"dir"), String(history->GetNth(index).data()));
+        VERIFY_IS_FALSE(history->FindMatchingCommand(L"dir /", 0, index, CommandHistory::MatchOptions::JustLooking | CommandHistory::MatchOptions::ExactMatch));
+
+        VERIFY_IS_FALSE(history->FindMatchingCommand(L"notepad", 0, index, CommandHistory::MatchOptions::JustLooking));
+    }
+
+    TEST_METHOD(IndexFollowsEveryChange)
+    {
+        auto history = CommandHistory::s_Allocate(_manyApps[0], _MakeHandle(0));
+        VERIFY_IS_NOT_NULL(history);
+
+        Log::Comment(L"Overfill the history, so the oldest commands are dropped.");
+        for (const auto& command : _manyHistoryItems)
+        {
+            VERIFY_SUCCEEDED(history->Add(command, false));
+            VERIFY_SUCCEEDED(history->Add(L"DIR", false));
+        }
+        _VerifyIndex(*history);
+
+        Log::Comment(L"Add a duplicate that replaces an older copy.");
+        VERIFY_SUCCEEDED(history->Add(L"ping 127.0.0.1", true));
+        _VerifyIndex(*history);
+
+        Log::Comment(L"Remove from the middle.");
+        history->Remove(3);
+        _VerifyIndex(*history);
+
+        Log::Comment(L"Swap commands.");
+        history->Swap(0, gsl::narrow<SHORT>(history->GetNumberOfCommands() - 1));
+        history->Swap(1, 2);
+        _VerifyIndex(*history);
+
+        Log::Comment(L"Shrink the history.");
+        history->Realloc(4);
+        _VerifyIndex(*history);
+
+        Log::Comment(L"Empty it.");
+        history->Empty();
+        _VerifyIndex(*history);
+        SHORT index;
+        VERIFY_IS_FALSE(history->FindMatchingCommand(L"d", 0, index, CommandHistory::MatchOptions::JustLooking));
+    }
+
+    TEST_METHOD(LargeHistoryLookups)
+    {
+        auto history = CommandHistory::s_Allocate(_manyApps[0], _MakeHandle(0));
+        VERIFY_IS_NOT_NULL(history);
+        history->Realloc(SHORT_MAX);
+
+        Log::Comment(L"Fill the largest history there can be, suppressing duplicates, and keep going.");
+        const auto addStart = std::chrono::steady_clock::now();
+        for (auto i = 0; i < 50000; ++i)
+        {
+            VERIFY_SUCCEEDED(history->Add(L"command " + std::to_wstring(i % 40000), true));
+        }
+        const auto addTime = std::chrono::steady_clock::now() - addStart;
+        VERIFY_ARE_EQUAL(static_cast<size_t>(SHORT_MAX), history->GetNumberOfCommands());
+
+        const auto findStart = std::chrono::steady_clock::now();
+        SHORT index = 0;
+        for (auto i = 0; i < 10000; ++i)
+        {
+            VERIFY_IS_TRUE(history->FindMatchingCommand(L"command 3999", index, index, CommandHistory::MatchOptions::JustLooking));
+        }
+        const auto findTime = std::chrono::steady_clock::now() - findStart;
+
+        Log::Comment(NoThrowString().Format(L"50000 adds took %lldms, 10000 prefix searches took %lldms",
+                                            std::chrono::duration_cast<std::chrono::milliseconds>(addTime).count(),
+                                            std::chrono::duration_cast<std::chrono::milliseconds>(findTime).count()));
+
+        Log::Comment(L"The searches cycled through the 11 matches, newest first.");
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"command 3999", 0, index, CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(String(L"command 39999"), String(history->GetNth(index).data()));
+    }
+
 private:
+    // Checks that every command is in the index at its own position, and nothing else is.
+    void _VerifyIndex(const CommandHistory& history)
+    {
+        size_t indexed = 0;
+        for (const auto& [command, indices] : history._index)
+        {
+            indexed += indices.size();
+        }
+        VERIFY_ARE_EQUAL(history.GetNumberOfCommands(), indexed);
+
+        for (SHORT i = 0; i < gsl::narrow<SHORT>(history.GetNumberOfCommands()); ++i)
+        {
+            std::wstring folded{ history.GetNth(i) };
+            std::transform(folded.begin(), folded.end(), folded.begin(), [](const wchar_t wch) {
+                return gsl::narrow_cast<wchar_t>(::towlower(wch));
+            });
+
+            const auto entry = history._index.find(folded);
+            VERIFY_IS_TRUE(entry != history._index.end());
+            VERIFY_IS_TRUE(std::find(entry->second.begin(), entry->second.end(), history._indexBase + i) != entry->second.end());
+        }
+    }
+
     const std::array<std::wstring, 5> _manyApps = {
         L"foo.exe",
         L"bar.exe",
@@ -6,6 +6,8 @@
 #include "..\..\inc\consoletaeftemplates.hpp"
 
 #include "../buffer/out/outputCellIterator.hpp"
+#include "../types/inc/GlyphWidth.hpp"
+#include "../types/inc/Utf16Parser.hpp"
 
 using namespace WEX::Common;
 using namespace WEX::Logging;
@@ -305,6 +307,50 @@ class OutputCellIteratorTests
         VERIFY_IS_FALSE(it);
     }
 
+    TEST_METHOD(MixedWidthStringData)
+    {
+        SetVerifyOutput settings(VerifyOutputSettings::LogOnlyFailures);
+
+        // Longer than one measured run, with a pair across the end of the first one
+        // and surrogates that aren't part of a pair.
+        std::wstring testText(63, L'\x2500');
+        testText += L"\xD83D\xDC7E\x03B1\x30a2" L"a\xD83D" L"b\xDC7E\x0414\x72D7\xD83D";
+
+        OutputCellIterator it(testText);
+
+        size_t pos = 0;
+        while (pos < testText.size())
+        {
+            const auto glyph = Utf16Parser::ParseNext(std::wstring_view{ testText }.substr(pos));
+            const auto wide = IsGlyphFullWidth(glyph);
+
+            auto expected = OutputCellView(glyph,
+                                           wide ? DbcsAttribute(DbcsAttribute::Attribute::Leading) : DbcsAttribute(),
+                                           InvalidTextAttribute,
+                                           TextAttributeBehavior::Current);
+
+            VERIFY_IS_TRUE(it);
+            VERIFY_ARE_EQUAL(expected, *it);
+            it++;
+
+            if (wide)
+            {
+                expected = OutputCellView(glyph,
+                                          DbcsAttribute(DbcsAttribute::Attribute::Trailing),
+                                          InvalidTextAttribute,
+                                          TextAttributeBehavior::Current);
+
+                VERIFY_IS_TRUE(it);
+                VERIFY_ARE_EQUAL(expected, *it);
+                it++;
+            }
+
+            pos += glyph.size();
+        }
+
+        VERIFY_IS_FALSE(it);
+    }
+
     TEST_METHOD(StringDataWithColor)
     {
         SetVerifyOutput settings(VerifyOutputSettings::LogOnlyFailures);
@@ -3,21 +3,216 @@
 
 #include "precomp.h"
 #include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
 
 #include "CommonState.hpp"
 
-#include "..\..\host\renderData.hpp"
+#include "selection.hpp"
+
 #include "..\..\renderer\base\renderer.hpp"
+#include "..\..\renderer\inc\RenderEngineBase.hpp"
 
+using namespace WEX::Common;
 using namespace WEX::Logging;
 using namespace WEX::TestExecution;
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::Types;
+
+// An engine that doesn't draw anything, but keeps track of what it's been
+// told to invalidate the same way the DX engine does, in a bitmap that's
+// translated by every scroll.
+class InvalidationRecordingEngine : public RenderEngineBase
+{
+public:
+    InvalidationRecordingEngine(const til::size size, const bool synchronous) :
+        invalidMap{ size },
+        synchronous{ synchronous }
+    {
+    }
+
+    til::bitmap invalidMap;
+    til::point scrolled;
+    size_t calls = 0;
+    const bool synchronous;
+
+    bool RequiresSynchronousInvalidation() const noexcept override
+    {
+        return synchronous;
+    }
+
+    [[nodiscard]] HRESULT Invalidate(const SMALL_RECT* const psrRegion) noexcept override
+    try
+    {
+        ++calls;
+        til::rectangle rc{ Viewport::FromExclusive(*psrRegion).ToInclusive() };
+        rc &= til::rectangle{ invalidMap.size() };
+        if (!rc.empty())
+        {
+            invalidMap.set(rc);
+        }
+        return S_OK;
+    }
+    CATCH_RETURN();
+
+    [[nodiscard]] HRESULT InvalidateCursor(const COORD* const pcoordCursor) noexcept override
+    try
+    {
+        ++calls;
+        const til::point pt{ *pcoordCursor };
+        if (til::rectangle{ invalidMap.size() }.contains(pt))
+        {
+            invalidMap.set(pt);
+        }
+        return S_OK;
+    }
+    CATCH_RETURN();
+
+    [[nodiscard]] HRESULT InvalidateSelection(const std::vector<SMALL_RECT>& rectangles) noexcept override
+    {
+        for (const auto& rect : rectangles)
+        {
+            RETURN_IF_FAILED(Invalidate(&rect));
+        }
+        return S_OK;
+    }
+
+    [[nodiscard]] HRESULT InvalidateScroll(const COORD* const pcoordDelta) noexcept override
+    try
+    {
+        ++calls;
+        const til::point delta{ *pcoordDelta };
+        invalidMap.translate(delta, true);
+        scrolled += delta;
+        return S_OK;
+    }
+    CATCH_RETURN();
+
+    [[nodiscard]] HRESULT InvalidateAll() noexcept override
+    {
+        ++calls;
+        invalidMap.set_all();
+        return S_OK;
+    }
+
+    // Nothing is ever painted; the renderer stops at StartPaint.
+    [[nodiscard]] HRESULT StartPaint() noexcept override { return S_FALSE; }
+    [[nodiscard]] HRESULT EndPaint() noexcept override { return S_OK; }
+    [[nodiscard]] HRESULT Present() noexcept override { return S_OK; }
+    [[nodiscard]] HRESULT PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept override
+    {
+        *pForcePaint = false;
+        return S_OK;
+    }
+    [[nodiscard]] HRESULT ScrollFrame() noexcept override { return S_OK; }
+    [[nodiscard]] HRESULT InvalidateSystem(const RECT* const /*prcDirtyClient*/) noexcept override { return S_OK; }
+    [[nodiscard]] HRESULT InvalidateCircling(_Out_ bool* const pForcePaint) noexcept override
+    {
+        *pForcePaint = false;
+        return S_OK;
+    }
+    [[nodiscard]] HRESULT PaintBackground() noexcept override { return S_OK; }
+    [[nodiscard]] HRESULT PaintBufferLine(gsl::span<const Cluster> const /*clusters*/,
+                                          const COORD /*coord*/,
+                                          const bool /*fTrimLeft*/,
+                                          const bool /*lineWrapped*/) noexcept override { return S_OK; }
+    [[nodiscard]] HRESULT PaintBufferGridLines(const GridLines /*lines*/,
+                                               const COLORREF /*color*/,
+                                               const size_t /*cchLine*/,
+                                               const COORD /*coordTarget*/) noexcept override { return S_OK; }
+    [[nodiscard]] HRESULT PaintSelection(const SMALL_RECT /*rect*/) noexcept override { return S_OK; }
+    [[nodiscard]] HRESULT PaintCursor(const CursorOptions& /*options*/) noexcept override { return S_OK; }
+    [[nodiscard]] HRESULT UpdateDrawingBrushes(const TextAttribute& /*textAttributes*/,
+                                               const gsl::not_null<IRenderData*> /*pData*/,
+                                               const bool /*isSettingDefaultBrushes*/) noexcept override { return S_OK; }
+    [[nodiscard]] HRESULT UpdateFont(const FontInfoDesired& /*FontInfoDesired*/,
+                                     _Out_ FontInfo& /*FontInfo*/) noexcept override { return S_OK; }
+    [[nodiscard]] HRESULT UpdateDpi(const int /*iDpi*/) noexcept override { return S_OK; }
+    [[nodiscard]] HRESULT UpdateViewport(const SMALL_RECT /*srNewViewport*/) noexcept override { return S_OK; }
+    [[nodiscard]] HRESULT GetProposedFont(const FontInfoDesired& /*FontInfoDesired*/,
+                                          _Out_ FontInfo& /*FontInfo*/,
+                                          const int /*iDpi*/) noexcept override { return S_OK; }
+    std::vector<til::rectangle> GetDirtyArea() override { return {}; }
+    [[nodiscard]] HRESULT GetFontSize(_Out_ COORD* const pFontSize) noexcept override
+    {
+        *pFontSize = { 1, 1 };
+        return S_OK;
+    }
+    [[nodiscard]] HRESULT IsGlyphWideByFont(const std::wstring_view /*glyph*/, _Out_ bool* const pResult) noexcept override
+    {
+        *pResult = false;
+        return S_OK;
+    }
+
+protected:
+    [[nodiscard]] HRESULT _DoUpdateTitle(const std::wstring& /*newTitle*/) noexcept override { return S_OK; }
+};
+
+// An engine that actually paints what it was told to invalidate, and remembers
+// the text it was given. Once it's been given a line, it signals `painting` and
+// holds the frame there until `resume` is set.
+class BlockingPaintEngine final : public InvalidationRecordingEngine
+{
+public:
+    BlockingPaintEngine(const til::size size, const bool synchronous) :
+        InvalidationRecordingEngine{ size, synchronous }
+    {
+        painting.create(wil::EventOptions::ManualReset);
+        resume.create(wil::EventOptions::ManualReset);
+    }
+
+    wil::unique_event painting;
+    wil::unique_event resume;
+    std::atomic<bool> painted{ false };
+    std::map<SHORT, std::wstring> lines;
+    size_t titles = 0;
+
+    [[nodiscard]] HRESULT InvalidateTitle(const std::wstring& proposedTitle) noexcept override
+    {
+        ++titles;
+        return InvalidationRecordingEngine::InvalidateTitle(proposedTitle);
+    }
+
+    [[nodiscard]] HRESULT StartPaint() noexcept override
+    {
+        return invalidMap.any() ? S_OK : S_FALSE;
+    }
+
+    [[nodiscard]] HRESULT EndPaint() noexcept override
+    {
+        invalidMap.reset_all();
+        painted = true;
+        return S_OK;
+    }
+
+    std::vector<til::rectangle> GetDirtyArea() override
+    {
+        return invalidMap.runs();
+    }
+
+    [[nodiscard]] HRESULT PaintBufferLine(gsl::span<const Cluster> const clusters,
+                                          const COORD coord,
+                                          const bool /*fTrimLeft*/,
+                                          const bool /*lineWrapped*/) noexcept override
+    try
+    {
+        painting.SetEvent();
+        resume.wait();
+
+        auto& line = lines[coord.Y];
+        for (const auto& cluster : clusters)
+        {
+            line.append(cluster.GetText());
+        }
+        return S_OK;
+    }
+    CATCH_RETURN();
+};
 
 class RendererTests
 {
     TEST_CLASS(RendererTests);
 
     std::unique_ptr<CommonState> m_state;
-    std::unique_ptr<RenderData> m_renderData;
     std::unique_ptr<Renderer> m_renderer;
 
     TEST_CLASS_SETUP(ClassSetup)
@@ -29,15 +224,11 @@ class RendererTests
 
         m_state->PrepareGlobalInputBuffer();
 
-        m_renderData = std::make_unique<RenderData>();
-
         return true;
     }
 
     TEST_CLASS_CLEANUP(ClassCleanup)
     {
-        m_renderData.reset(nullptr);
-
         m_state->CleanupGlobalInputBuffer();
 
         m_state->CleanupGlobalScreenBuffer();
@@ -50,11 +241,9 @@ class RendererTests
 
     TEST_METHOD_SETUP(MethodSetup)
     {
-        Renderer* pRenderer = nullptr;
         Globals& g = ServiceLocator::LocateGlobals();
         CONSOLE_INFORMATION& gci = g.getConsoleInformation();
-        VERIFY_SUCCEEDED(Renderer::s_CreateInstance(gci.renderData, &pRenderer));
-        m_renderer.reset(pRenderer);
+        m_renderer = std::make_unique<Renderer>(&gci.renderData, nullptr, 0, nullptr);
         return true;
     }
 
@@ -64,8 +253,400 @@ class RendererTests
         return true;
     }
 
+    // Converts a viewport-relative position into the buffer position the renderer expects.
+    static COORD _BufferPosition(const short x, const short y)
+    {
+        const CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        COORD coord{ x, y };
+        gci.renderData.GetViewport().ConvertFromOrigin(&coord);
+        return coord;
+    }
+
+    static Viewport _BufferRow(const short y, const short left, const short width)
+    {
+        return Viewport::FromDimensions(_BufferPosition(left, y), width, 1);
+    }
+
     TEST_METHOD(Sample)
     {
         m_renderer->TriggerTitleChange();
     }
+
+    TEST_METHOD(AccumulatorMergesRowsAndShiftsByScroll)
+    {
+        InvalidationAccumulator accumulator;
+        InvalidationAccumulator::Frame frame;
+
+        Log::Comment(L"Consecutive rows with the same columns are merged into one region.");
+        accumulator.Invalidate({ 0, 2, 10, 3 });
+        accumulator.Invalidate({ 0, 3, 10, 4 });
+        accumulator.Invalidate({ 4, 4, 6, 5 });
+        accumulator.InvalidateCursor({ 5, 4 }, false);
+        accumulator.Drain(frame);
+        VERIFY_ARE_EQUAL(2u, frame.regions.size());
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 0, 2, 10, 4 }), frame.regions.at(0));
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 4, 4, 6, 5 }), frame.regions.at(1));
+        VERIFY_ARE_EQUAL(1u, frame.cursors.size());
+        VERIFY_ARE_EQUAL(til::point(5, 4), frame.cursors.at(0));
+        VERIFY_IS_FALSE(accumulator.HasPending());
+
+        Log::Comment(L"Rows written before a scroll move with it. Those that scrolled out are dropped.");
+        accumulator.Invalidate({ 0, 0, 80, 1 });
+        accumulator.Invalidate({ 0, 29, 80, 30 });
+        accumulator.InvalidateScroll({ 0, -1 });
+        accumulator.Invalidate({ 0, 29, 5, 30 });
+        accumulator.InvalidateCursor({ 5, 29 }, true);
+        accumulator.Drain(frame);
+        VERIFY_ARE_EQUAL(til::point(0, -1), frame.scroll);
+        VERIFY_ARE_EQUAL(2u, frame.regions.size());
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 0, 28, 80, 29 }), frame.regions.at(0));
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 0, 29, 5, 30 }), frame.regions.at(1));
+        VERIFY_ARE_EQUAL(til::point(5, 29), frame.cursors.at(0));
+        VERIFY_IS_TRUE(frame.cursorDoubleWidth);
+
+        Log::Comment(L"Draining with nothing recorded produces an empty frame.");
+        accumulator.Drain(frame);
+        VERIFY_IS_TRUE(frame.empty());
+    }
+
+    TEST_METHOD(SelectionTrackerFindsChangedCells)
+    {
+        SelectionTracker tracker;
+        std::vector<SMALL_RECT> changes;
+        const til::size viewport{ 80, 25 };
+
+        Log::Comment(L"A new selection is a change in all of its cells.");
+        VERIFY_IS_TRUE(tracker.Update({ { 5, 2, 80, 3 }, { 0, 3, 80, 4 }, { 0, 4, 80, 5 }, { 0, 5, 10, 6 } }, viewport, changes));
+        VERIFY_ARE_EQUAL(3u, changes.size());
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 5, 2, 80, 3 }), changes.at(0));
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 0, 3, 80, 5 }), changes.at(1));
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 0, 5, 10, 6 }), changes.at(2));
+
+        Log::Comment(L"Dragging the end along its row only changes the cells it passed over.");
+        VERIFY_IS_TRUE(tracker.Update({ { 5, 2, 80, 3 }, { 0, 3, 80, 4 }, { 0, 4, 80, 5 }, { 0, 5, 13, 6 } }, viewport, changes));
+        VERIFY_ARE_EQUAL(1u, changes.size());
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 10, 5, 13, 6 }), changes.at(0));
+
+        Log::Comment(L"Dragging it up a row deselects the rest of the last row and part of the one above.");
+        VERIFY_IS_TRUE(tracker.Update({ { 5, 2, 80, 3 }, { 0, 3, 80, 4 }, { 0, 4, 13, 5 } }, viewport, changes));
+        VERIFY_ARE_EQUAL(2u, changes.size());
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 13, 4, 80, 5 }), changes.at(0));
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 0, 5, 13, 6 }), changes.at(1));
+
+        Log::Comment(L"The same selection again changes nothing.");
+        VERIFY_IS_FALSE(tracker.Update({ { 5, 2, 80, 3 }, { 0, 3, 80, 4 }, { 0, 4, 13, 5 } }, viewport, changes));
+        VERIFY_ARE_EQUAL(0u, changes.size());
+
+        Log::Comment(L"The selection moves with the viewport, and changes outside of it aren't given out.");
+        tracker.Scroll({ 0, -3 });
+        VERIFY_IS_TRUE(tracker.Update({ { 5, -1, 80, 0 }, { 0, 0, 80, 1 }, { 0, 1, 20, 2 } }, viewport, changes));
+        VERIFY_ARE_EQUAL(1u, changes.size());
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 13, 1, 20, 2 }), changes.at(0));
+        VERIFY_IS_TRUE(tracker.Update({ { 7, -1, 80, 0 }, { 0, 0, 80, 1 }, { 0, 1, 20, 2 } }, viewport, changes));
+        VERIFY_ARE_EQUAL(0u, changes.size());
+
+        Log::Comment(L"Clearing the selection changes every cell it had.");
+        VERIFY_IS_TRUE(tracker.Update({}, viewport, changes));
+        VERIFY_ARE_EQUAL(2u, changes.size());
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 0, 0, 80, 1 }), changes.at(0));
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 0, 1, 20, 2 }), changes.at(1));
+    }
+
+    TEST_METHOD(SelectionInvalidatesOnlyChangedCells)
+    {
+        const CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto dimensions = gci.renderData.GetViewport().Dimensions();
+        auto& selection = Selection::Instance();
+        selection.SetLineSelection(true);
+        auto clearSelection = wil::scope_exit([&] { selection.ClearSelection(); });
+
+        InvalidationRecordingEngine engine{ til::size{ dimensions }, false };
+        m_renderer->AddRenderEngine(&engine);
+
+        // The cells of the selection as it is now, relative to the viewport, row by row.
+        const auto selectedCells = [&]() {
+            std::vector<bool> cells(gsl::narrow_cast<size_t>(dimensions.X) * dimensions.Y);
+            for (const auto& rect : selection.GetSelectionRects())
+            {
+                const auto viewportRect = gci.renderData.GetViewport().ConvertToOrigin(Viewport::FromInclusive(rect)).ToInclusive();
+                for (auto y = std::max<SHORT>(viewportRect.Top, 0); y <= std::min(viewportRect.Bottom, gsl::narrow_cast<SHORT>(dimensions.Y - 1)); ++y)
+                {
+                    for (auto x = std::max<SHORT>(viewportRect.Left, 0); x <= std::min(viewportRect.Right, gsl::narrow_cast<SHORT>(dimensions.X - 1)); ++x)
+                    {
+                        cells.at(gsl::narrow_cast<size_t>(y) * dimensions.X + x) = true;
+                    }
+                }
+            }
+            return cells;
+        };
+
+        const auto countCells = [](const til::bitmap& map) {
+            size_t count = 0;
+            for (const auto& run : map.runs())
+            {
+                count += run.size().area<size_t>();
+            }
+            return count;
+        };
+
+        // Selects from the start to the end, paints a frame and checks that the
+        // engine was told about exactly the cells that went in or out of the selection.
+        const auto selectAndVerify = [&](const COORD start, const COORD end) {
+            const auto before = selectedCells();
+            engine.invalidMap.reset_all();
+
+            selection.SelectNewRegion(_BufferPosition(start.X, start.Y), _BufferPosition(end.X, end.Y));
+            m_renderer->TriggerSelection();
+            VERIFY_SUCCEEDED(m_renderer->PaintFrame());
+
+            const auto after = selectedCells();
+            til::bitmap expected{ til::size{ dimensions } };
+            size_t either = 0;
+            for (SHORT y = 0; y < dimensions.Y; ++y)
+            {
+                for (SHORT x = 0; x < dimensions.X; ++x)
+                {
+                    const auto index = gsl::narrow_cast<size_t>(y) * dimensions.X + x;
+                    if (before.at(index) != after.at(index))
+                    {
+                        expected.set(til::point{ x, y });
+                    }
+                    if (before.at(index) || after.at(index))
+                    {
+                        ++either;
+                    }
+                }
+            }
+
+            // Invalidating the old and the new selection, as it used to be done,
+            // would have invalidated every cell that's in either of them.
+            Log::Comment(NoThrowString().Format(L"%zu cells invalidated, %zu cells in the old and new selection",
+                                                countCells(engine.invalidMap),
+                                                either));
+            VERIFY_ARE_EQUAL(expected, engine.invalidMap);
+        };
+
+        Log::Comment(L"Select across a few rows.");
+        selectAndVerify({ 5, 2 }, { 10, 8 });
+
+        Log::Comment(L"Drag the end a few columns to the right.");
+        selectAndVerify({ 5, 2 }, { 13, 8 });
+        VERIFY_ARE_EQUAL(3u, countCells(engine.invalidMap));
+
+        Log::Comment(L"Drag it up a row.");
+        selectAndVerify({ 5, 2 }, { 13, 7 });
+
+        Log::Comment(L"Select the same region again.");
+        const auto calls = engine.calls;
+        selectAndVerify({ 5, 2 }, { 13, 7 });
+        VERIFY_ARE_EQUAL(calls, engine.calls);
+    }
+
+    TEST_METHOD(DeferredInvalidationMatchesSynchronous)
+    {
+        const CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto dimensions = gci.renderData.GetViewport().Dimensions();
+        const auto width = dimensions.X;
+        const auto bottom = gsl::narrow_cast<short>(dimensions.Y - 1);
+
+        InvalidationRecordingEngine synchronousEngine{ til::size{ dimensions }, true };
+        InvalidationRecordingEngine deferredEngine{ til::size{ dimensions }, false };
+        m_renderer->AddRenderEngine(&synchronousEngine);
+        m_renderer->AddRenderEngine(&deferredEngine);
+
+        // The cursor only ever rests on cells that are written before it moves
+        // on, as it does when text is output. Positions it merely passed through
+        // in the middle of a frame aren't kept.
+        Log::Comment(L"Write a bit of text on the second row and move the cursor along.");
+        auto cursor = _BufferPosition(2, 1);
+        m_renderer->TriggerRedrawCursor(&cursor);
+        m_renderer->TriggerRedraw(_BufferRow(1, 2, 7));
+        cursor = _BufferPosition(8, 1);
+        m_renderer->TriggerRedrawCursor(&cursor);
+
+        Log::Comment(L"Flood the bottom row, scrolling the contents up after every line.");
+        const COORD up{ 0, -1 };
+        for (auto i = 0; i < 50; ++i)
+        {
+            m_renderer->TriggerRedraw(_BufferRow(bottom, 0, width));
+            m_renderer->TriggerScroll(&up);
+            cursor = _BufferPosition(0, bottom);
+            m_renderer->TriggerRedrawCursor(&cursor);
+        }
+        m_renderer->TriggerRedraw(_BufferRow(bottom, 0, 5));
+
+        Log::Comment(L"Scroll back down a little and touch the top of the viewport.");
+        const COORD down{ 0, 2 };
+        m_renderer->TriggerScroll(&down);
+        m_renderer->TriggerRedraw(_BufferRow(0, 1, 3));
+        cursor = _BufferPosition(4, 0);
+        m_renderer->TriggerRedrawCursor(&cursor);
+
+        VERIFY_IS_TRUE(synchronousEngine.invalidMap.any());
+        VERIFY_IS_TRUE(deferredEngine.invalidMap.none(), L"The deferred engine hasn't been told anything before the frame.");
+
+        VERIFY_SUCCEEDED(m_renderer->PaintFrame());
+
+        VERIFY_ARE_EQUAL(synchronousEngine.invalidMap, deferredEngine.invalidMap);
+        VERIFY_ARE_EQUAL(synchronousEngine.scrolled, deferredEngine.scrolled);
+        Log::Comment(NoThrowString().Format(L"Synchronous engine: %zu calls, deferred engine: %zu calls", synchronousEngine.calls, deferredEngine.calls));
+        VERIFY_IS_LESS_THAN(deferredEngine.calls, synchronousEngine.calls);
+    }
+
+    TEST_METHOD(SnapshotReleasesLockBeforePainting)
+    {
+        CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto dimensions = gci.renderData.GetViewport().Dimensions();
+
+        {
+            gci.LockConsole();
+            auto unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+            gci.GetActiveOutputBuffer().Write(OutputCellIterator(L"Hello"), _BufferPosition(0, 0));
+        }
+
+        // Paints a whole frame on another thread, and returns whether the lock
+        // could be taken while the engine was held at its first line.
+        const auto lockAvailableWhilePainting = [&](BlockingPaintEngine& engine) {
+            Renderer renderer{ &gci.renderData, nullptr, 0, nullptr };
+            renderer.AddRenderEngine(&engine);
+            renderer.TriggerRedrawAll();
+
+            HRESULT hr = E_FAIL;
+            std::thread painter{ [&]() { hr = renderer.PaintFrame(); } };
+            engine.painting.wait();
+
+            const auto locked = gci.TryLockConsole();
+            if (locked)
+            {
+                gci.UnlockConsole();
+            }
+
+            engine.resume.SetEvent();
+            painter.join();
+            VERIFY_SUCCEEDED(hr);
+            return locked;
+        };
+
+        BlockingPaintEngine synchronousEngine{ til::size{ dimensions }, true };
+        Log::Comment(L"Painting under the lock keeps it for the whole frame.");
+        VERIFY_IS_FALSE(lockAvailableWhilePainting(synchronousEngine));
+
+        BlockingPaintEngine deferredEngine{ til::size{ dimensions }, false };
+        Log::Comment(L"Painting from the snapshot lets go of it before the first line.");
+        VERIFY_IS_TRUE(lockAvailableWhilePainting(deferredEngine));
+
+        Log::Comment(L"Both engines painted the same frame.");
+        VERIFY_ARE_EQUAL(gsl::narrow_cast<size_t>(dimensions.Y), deferredEngine.lines.size());
+        VERIFY_IS_TRUE(synchronousEngine.lines == deferredEngine.lines);
+        VERIFY_ARE_EQUAL(String(L"Hello"), String(deferredEngine.lines[0].substr(0, 5).c_str()));
+    }
+
+    TEST_METHOD(WritersDontWaitForSnapshotFrames)
+    {
+        CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto dimensions = gci.renderData.GetViewport().Dimensions();
+
+        BlockingPaintEngine engine{ til::size{ dimensions }, false };
+        Renderer renderer{ &gci.renderData, nullptr, 0, nullptr };
+        renderer.AddRenderEngine(&engine);
+        renderer.TriggerRedrawAll();
+
+        HRESULT hr = E_FAIL;
+        std::thread painter{ [&]() { hr = renderer.PaintFrame(); } };
+        engine.painting.wait();
+
+        // Calls the renderer the way a writer does, on its own thread and with
+        // the console lock held, while the engine is held in the middle of the
+        // frame. A call that's stuck behind the frame never finishes, so the
+        // wait is only bounded to fail the test rather than hang it.
+        const auto finishesWhilePainting = [&](const wchar_t* const name, auto&& call) {
+            wil::unique_event done;
+            done.create(wil::EventOptions::ManualReset);
+            std::thread writer{ [&]() {
+                gci.LockConsole();
+                call();
+                gci.UnlockConsole();
+                done.SetEvent();
+            } };
+
+            const auto finished = done.wait(10000);
+            if (!finished)
+            {
+                engine.resume.SetEvent();
+            }
+            writer.join();
+
+            Log::Comment(NoThrowString().Format(L"%s %s while the frame was being painted", name, finished ? L"finished" : L"didn't finish"));
+            return finished;
+        };
+
+        const bool finished[]{
+            finishesWhilePainting(L"TriggerScroll", [&]() { renderer.TriggerScroll(); }),
+            finishesWhilePainting(L"TriggerTitleChange", [&]() { renderer.TriggerTitleChange(); }),
+            finishesWhilePainting(L"TriggerCircling", [&]() { renderer.TriggerCircling(); }),
+            finishesWhilePainting(L"IsGlyphWideByFont", [&]() { renderer.IsGlyphWideByFont(L"\x3042"); }),
+        };
+        const auto paintedMeanwhile = engine.painted.load();
+
+        engine.resume.SetEvent();
+        painter.join();
+
+        Log::Comment(L"All of them were done while the frame was still being painted.");
+        VERIFY_IS_FALSE(paintedMeanwhile);
+        for (const auto f : finished)
+        {
+            VERIFY_IS_TRUE(f);
+        }
+        VERIFY_SUCCEEDED(hr);
+
+        Log::Comment(L"The engine is given the new title at the start of the next frame.");
+        VERIFY_ARE_EQUAL(0u, engine.titles);
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+        VERIFY_ARE_EQUAL(1u, engine.titles);
+    }
+
+    TEST_METHOD(WriterSideInvalidationPerformance)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+        END_TEST_METHOD_PROPERTIES()
+
+        const CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto dimensions = gci.renderData.GetViewport().Dimensions();
+        const auto width = dimensions.X;
+        const auto bottom = gsl::narrow_cast<short>(dimensions.Y - 1);
+        constexpr auto iterations = 200000;
+
+        // What the writer does for every line of a flood of output: write the
+        // bottom row, scroll the contents up and move the cursor.
+        const auto flood = [&](Renderer& renderer) {
+            const COORD up{ 0, -1 };
+            const auto start = std::chrono::steady_clock::now();
+            for (auto i = 0; i < iterations; ++i)
+            {
+                renderer.TriggerRedraw(_BufferRow(bottom, 0, width));
+                renderer.TriggerScroll(&up);
+                auto cursor = _BufferPosition(0, bottom);
+                renderer.TriggerRedrawCursor(&cursor);
+            }
+            const auto end = std::chrono::steady_clock::now();
+            return std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        };
+
+        InvalidationRecordingEngine synchronousEngine{ til::size{ dimensions }, true };
+        Renderer synchronousRenderer{ &gci.renderData, nullptr, 0, nullptr };
+        synchronousRenderer.AddRenderEngine(&synchronousEngine);
+        const auto synchronousTime = flood(synchronousRenderer);
+
+        InvalidationRecordingEngine deferredEngine{ til::size{ dimensions }, false };
+        Renderer deferredRenderer{ &gci.renderData, nullptr, 0, nullptr };
+        deferredRenderer.AddRenderEngine(&deferredEngine);
+        const auto deferredTime = flood(deferredRenderer);
+        VERIFY_SUCCEEDED(deferredRenderer.PaintFrame());
+
+        Log::Comment(NoThrowString().Format(L"Synchronous: %lld ms, %zu engine calls", synchronousTime.count(), synchronousEngine.calls));
+        Log::Comment(NoThrowString().Format(L"Deferred: %lld ms, %zu engine calls", deferredTime.count(), deferredEngine.calls));
+        VERIFY_ARE_EQUAL(synchronousEngine.invalidMap, deferredEngine.invalidMap);
+        VERIFY_IS_LESS_THAN(deferredEngine.calls, synchronousEngine.calls);
+    }
 };
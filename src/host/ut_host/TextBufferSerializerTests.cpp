@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../inc/consoletaeftemplates.hpp"
+
+#include "../buffer/out/textBuffer.hpp"
+#include "../buffer/out/TextBufferSerializer.hpp"
+
+#include "../renderer/inc/DummyRenderTarget.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class TextBufferSerializerTests
+{
+    DummyRenderTarget _renderTarget;
+
+    TEST_CLASS(TextBufferSerializerTests);
+
+    // Fills a buffer with a bit of everything the format has to keep, and
+    // circles it a few times so that its first row isn't the first in storage.
+    std::unique_ptr<TextBuffer> _MakeBuffer()
+    {
+        auto buffer = std::make_unique<TextBuffer>(COORD{ 30, 10 }, TextAttribute{ 0x07 }, 25, _renderTarget);
+        for (auto i = 0; i < 4; ++i)
+        {
+            VERIFY_IS_TRUE(buffer->IncrementCircularBuffer());
+        }
+
+        TextAttribute red{ FOREGROUND_RED | FOREGROUND_INTENSITY };
+        red.SetBold(true);
+        TextAttribute link{ 0x1f };
+        link.SetHyperlinkId(buffer->GetHyperlinkId(L"custom"));
+        buffer->AddHyperlinkToMap(L"https://example.com", link.GetHyperlinkId());
+
+        buffer->Write(OutputCellIterator{ L"Plain text" }, { 0, 0 });
+        buffer->Write(OutputCellIterator{ L"Bold red", red }, { 5, 1 });
+        buffer->Write(OutputCellIterator{ L"Link", link }, { 20, 1 });
+        buffer->Write(OutputCellIterator{ L"Wide \x3042\x3044 and \xD83C\xDD71" }, { 0, 2 });
+        buffer->Write(OutputCellIterator{ L'x', 30 }, { 0, 3 });
+        buffer->GetRowByOffset(3).GetCharRow().SetWrapForced(true);
+        buffer->Write(OutputCellIterator{ L"Bottom row" }, { 0, 9 });
+
+        auto& cursor = buffer->GetCursor();
+        cursor.SetStyle(50, RGB(1, 2, 3), CursorType::VerticalBar);
+        cursor.SetPosition({ 7, 4 });
+        cursor.SetIsVisible(false);
+        cursor.SetBlinkingAllowed(false);
+
+        buffer->SetCurrentAttributes(red);
+        return buffer;
+    }
+
+    void _VerifyRowsEqual(const TextBuffer& expected, const TextBuffer& actual, const SHORT top, const SHORT bottom)
+    {
+        for (auto y = top; y < bottom; ++y)
+        {
+            Log::Comment(NoThrowString().Format(L"Row %d", y));
+            const auto& expectedRow = expected.GetRowByOffset(y);
+            const auto& actualRow = actual.GetRowByOffset(y);
+            VERIFY_IS_TRUE(expectedRow.GetCharRow() == actualRow.GetCharRow());
+            VERIFY_IS_TRUE(expectedRow.GetAttrRow() == actualRow.GetAttrRow());
+            VERIFY_ARE_EQUAL(String(expectedRow.GetText().c_str()), String(actualRow.GetText().c_str()));
+        }
+    }
+
+    TEST_METHOD(RoundTrip)
+    {
+        const auto original = _MakeBuffer();
+        const auto data = TextBufferSerializer::Serialize(*original);
+        Log::Comment(NoThrowString().Format(L"Saved into %zu bytes", data.size()));
+
+        TextBufferLoader loader{ data };
+        VERIFY_ARE_EQUAL(original->GetSize().Dimensions(), loader.GetBufferSize());
+
+        const auto restored = loader.CreateBuffer(_renderTarget);
+        loader.LoadAll(*restored);
+        VERIFY_ARE_EQUAL(0u, gsl::narrow<unsigned int>(loader.GetRemainingRows()));
+
+        _VerifyRowsEqual(*original, *restored, 0, 10);
+
+        Log::Comment(L"The surrogate pair came back out of the unicode storage.");
+        const auto glyph = *restored->GetTextDataAt({ 14, 2 });
+        VERIFY_ARE_EQUAL(String(L"\xD83C\xDD71"), String(glyph.data(), gsl::narrow<int>(glyph.size())));
+
+        Log::Comment(L"The hyperlink and its custom id came back.");
+        const auto linkId = restored->GetRowByOffset(1).GetAttrRow().GetAttrByColumn(20).GetHyperlinkId();
+        VERIFY_IS_TRUE(linkId != 0);
+        VERIFY_ARE_EQUAL(String(L"https://example.com"), String(restored->GetHyperlinkUriFromId(linkId).c_str()));
+        VERIFY_ARE_EQUAL(linkId, restored->GetHyperlinkId(L"custom"));
+
+        Log::Comment(L"The cursor and the current attributes came back.");
+        const auto& cursor = restored->GetCursor();
+        VERIFY_ARE_EQUAL(COORD({ 7, 4 }), cursor.GetPosition());
+        VERIFY_ARE_EQUAL(50ul, cursor.GetSize());
+        VERIFY_ARE_EQUAL(RGB(1, 2, 3), cursor.GetColor());
+        VERIFY_IS_TRUE(cursor.GetType() == CursorType::VerticalBar);
+        VERIFY_IS_FALSE(cursor.IsVisible());
+        VERIFY_IS_FALSE(cursor.IsBlinkingAllowed());
+        VERIFY_ARE_EQUAL(original->GetCurrentAttributes(), restored->GetCurrentAttributes());
+
+        Log::Comment(L"Saving the restored buffer again takes just as many bytes.");
+        VERIFY_ARE_EQUAL(data.size(), TextBufferSerializer::Serialize(*restored).size());
+    }
+
+    TEST_METHOD(LoadsBottomRowsFirst)
+    {
+        const auto original = _MakeBuffer();
+        const auto data = TextBufferSerializer::Serialize(*original);
+
+        TextBufferLoader loader{ data };
+        const auto restored = loader.CreateBuffer(_renderTarget);
+
+        Log::Comment(L"The first batch fills in the bottom of the buffer only.");
+        VERIFY_IS_TRUE(loader.LoadRows(*restored, 3));
+        VERIFY_ARE_EQUAL(7u, gsl::narrow<unsigned int>(loader.GetRemainingRows()));
+        _VerifyRowsEqual(*original, *restored, 7, 10);
+        VERIFY_IS_FALSE(restored->GetRowByOffset(0).GetCharRow().ContainsText());
+
+        Log::Comment(L"The rest follows.");
+        VERIFY_IS_TRUE(loader.LoadRows(*restored, 5));
+        VERIFY_IS_FALSE(loader.LoadRows(*restored, 5));
+        VERIFY_ARE_EQUAL(0u, gsl::narrow<unsigned int>(loader.GetRemainingRows()));
+        _VerifyRowsEqual(*original, *restored, 0, 10);
+    }
+
+    TEST_METHOD(BlankRowsAreSmall)
+    {
+        const TextBuffer blank{ COORD{ 200, 100 }, TextAttribute{ 0x07 }, 25, _renderTarget };
+        const auto data = TextBufferSerializer::Serialize(blank);
+
+        Log::Comment(NoThrowString().Format(L"Saved 100 blank rows into %zu bytes", data.size()));
+        VERIFY_IS_LESS_THAN(data.size(), 100u * 200u * (sizeof(wchar_t) + sizeof(DbcsAttribute)) / 10u);
+    }
+
+    TEST_METHOD(RejectsBadData)
+    {
+        const auto original = _MakeBuffer();
+        auto data = TextBufferSerializer::Serialize(*original);
+
+        Log::Comment(L"A truncated stream fails to load instead of reading past its end.");
+        {
+            const gsl::span<const BYTE> truncated{ data.data(), data.size() - 1 };
+            TextBufferLoader loader{ truncated };
+            const auto restored = loader.CreateBuffer(_renderTarget);
+            VERIFY_THROWS_SPECIFIC(loader.LoadAll(*restored), wil::ResultException, [](auto& e) { return e.GetErrorCode() == HRESULT_FROM_WIN32(ERROR_INVALID_DATA); });
+        }
+
+        Log::Comment(L"A stream from another version isn't loaded at all.");
+        {
+            const uint16_t version = TextBufferSerializer::Version + 1;
+            memcpy(data.data() + sizeof(uint32_t), &version, sizeof(version));
+            VERIFY_THROWS_SPECIFIC(TextBufferLoader{ data }, wil::ResultException, [](auto& e) { return e.GetErrorCode() == HRESULT_FROM_WIN32(ERROR_UNSUPPORTED_TYPE); });
+        }
+
+        Log::Comment(L"Neither is something that isn't a saved buffer.");
+        {
+            const std::vector<BYTE> garbage(64, 0xAB);
+            VERIFY_THROWS_SPECIFIC(TextBufferLoader{ garbage }, wil::ResultException, [](auto& e) { return e.GetErrorCode() == HRESULT_FROM_WIN32(ERROR_INVALID_DATA); });
+        }
+    }
+};
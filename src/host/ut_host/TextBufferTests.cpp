@@ -17,6 +17,8 @@
 #include "../interactivity/inc/ServiceLocator.hpp"
 #include "../renderer/inc/DummyRenderTarget.hpp"
 
+#include <random>
+
 using namespace Microsoft::Console::Types;
 using namespace Microsoft::Console::Interactivity;
 using namespace Microsoft::Console::VirtualTerminal;
@@ -140,6 +142,7 @@ class TextBufferTests
 
     TEST_METHOD(ResizeTraditionalRotationPreservesHighUnicode);
     TEST_METHOD(ScrollBufferRotationPreservesHighUnicode);
+    TEST_METHOD(ScrollRowsInCircularBuffer);
 
     TEST_METHOD(ResizeTraditionalHighUnicodeRowRemoval);
     TEST_METHOD(ResizeTraditionalHighUnicodeColumnRemoval);
@@ -152,6 +155,13 @@ class TextBufferTests
 
     TEST_METHOD(GetTextRects);
     TEST_METHOD(GetText);
+    TEST_METHOD(CharRowScansMatchCells);
+    TEST_METHOD(CharRowWriteNarrowText);
+    TEST_METHOD(CharRowExtentsFollowWrites);
+    TEST_METHOD(CharRowDelimiterClassScans);
+    TEST_METHOD(WriteNarrowTextMatchesWrite);
+    TEST_METHOD(WriteNarrowTextSplitsWideGlyphs);
+    TEST_METHOD(GetRowTextIsCached);
 
     TEST_METHOD(HyperlinkTrim);
     TEST_METHOD(NoHyperlinkTrim);
@@ -1909,6 +1919,71 @@ void TextBufferTests::ScrollBufferRotationPreservesHighUnicode()
     VERIFY_ARE_EQUAL(String(fire), String(shouldBeFireText.data(), gsl::narrow<int>(shouldBeFireText.size())));
 }
 
+// This tests that scrolling a range of rows when the circular buffer has been rotated moves
+// the right rows, and only touches the rows it has to unless the range wraps around the storage.
+void TextBufferTests::ScrollRowsInCircularBuffer()
+{
+    const COORD bufferSize{ 20, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    // Mark each row with a letter, and put an emoji on the row marked 'J'.
+    for (SHORT row = 0; row < bufferSize.Y; row++)
+    {
+        const std::wstring marker(1, gsl::narrow_cast<wchar_t>(L'A' + row));
+        _buffer->WriteLine(OutputCellIterator(marker), { 0, row });
+    }
+    const auto fire = L"\xD83D\xDD25";
+    auto position = _buffer->GetRowByOffset(9).GetCharRow().GlyphAt(3);
+    position = fire;
+
+    Log::Comment(L"Rotate the circular buffer so that the first row isn't at the start of the storage.");
+    for (auto i = 0; i < 3; i++)
+    {
+        VERIFY_IS_TRUE(_buffer->IncrementCircularBuffer());
+    }
+    VERIFY_ARE_EQUAL(3, _buffer->GetFirstRowIndex());
+
+    // The letters on each row, from the top of the buffer. The last three rows are blank.
+    std::wstring expected{ L"DEFGHIJ   " };
+
+    const auto verifyRows = [&]() {
+        for (SHORT row = 0; row < bufferSize.Y; row++)
+        {
+            const auto text = *_buffer->GetTextDataAt({ 0, row });
+            VERIFY_ARE_EQUAL(String(expected.substr(row, 1).c_str()), String(text.data(), gsl::narrow<int>(text.size())));
+
+            const auto glyph = *_buffer->GetTextDataAt({ 3, row });
+            const auto expectedGlyph = expected.at(row) == L'J' ? fire : L" ";
+            VERIFY_ARE_EQUAL(String(expectedGlyph), String(glyph.data(), gsl::narrow<int>(glyph.size())));
+        }
+
+        for (size_t i = 0; i < _buffer->_storage.size(); i++)
+        {
+            VERIFY_ARE_EQUAL(gsl::narrow<SHORT>(i), _buffer->_storage.at(i).GetId());
+        }
+    };
+
+    Log::Comment(L"Move rows 1-3 up by one.");
+    _buffer->ScrollRows(1, 3, -1);
+    std::rotate(expected.begin(), expected.begin() + 1, expected.begin() + 4);
+    verifyRows();
+    VERIFY_ARE_EQUAL(3, _buffer->GetFirstRowIndex(), L"The rows didn't wrap around the storage, so it wasn't rotated.");
+
+    Log::Comment(L"Move rows 0-1 down by three.");
+    _buffer->ScrollRows(0, 2, 3);
+    std::rotate(expected.begin(), expected.begin() + 2, expected.begin() + 5);
+    verifyRows();
+    VERIFY_ARE_EQUAL(3, _buffer->GetFirstRowIndex(), L"The rows didn't wrap around the storage, so it wasn't rotated.");
+
+    Log::Comment(L"Move rows 4-7 down by two. These rows wrap around the end of the storage.");
+    _buffer->ScrollRows(4, 4, 2);
+    std::rotate(expected.begin() + 4, expected.begin() + 8, expected.begin() + 10);
+    verifyRows();
+    VERIFY_ARE_EQUAL(0, _buffer->GetFirstRowIndex());
+}
+
 // This tests that rows removed from the buffer while resizing traditionally will also drop the high unicode
 // characters from the Unicode Storage buffer
 void TextBufferTests::ResizeTraditionalHighUnicodeRowRemoval()
@@ -2447,6 +2522,379 @@ void TextBufferTests::GetText()
     }
 }
 
+void TextBufferTests::CharRowScansMatchCells()
+{
+    const auto fire = L"\xD83D\xDD25";
+
+    // Checks the scans of the char row against the same answers found one cell at a time.
+    const auto verifyScans = [](const CharRow& charRow) {
+        const auto width = charRow.size();
+        size_t left = width;
+        size_t right = 0;
+        std::wstring text;
+        for (size_t i = 0; i < width; ++i)
+        {
+            const std::wstring_view glyph{ charRow.GlyphAt(i) };
+            if (glyph != L" ")
+            {
+                left = std::min(left, i);
+                right = i + 1;
+            }
+            if (!charRow.DbcsAttrAt(i).IsTrailing())
+            {
+                text.append(glyph);
+            }
+        }
+
+        VERIFY_ARE_EQUAL(left, charRow.MeasureLeft());
+        VERIFY_ARE_EQUAL(right, charRow.MeasureRight());
+        VERIFY_ARE_EQUAL(right != 0, charRow.ContainsText());
+        VERIFY_ARE_EQUAL(String(text.c_str()), String(charRow.GetText().c_str()));
+    };
+
+    // Widths on either side of the 8 characters the scans compare at a time.
+    for (const SHORT width : { 1, 7, 8, 9, 15, 16, 17, 33, 80 })
+    {
+        Log::Comment(NoThrowString().Format(L"Row width %d", width));
+        TextBuffer buffer({ width, 1 }, TextAttribute{ 0x7 }, 12, _renderTarget);
+        auto& charRow = buffer.GetRowByOffset(0).GetCharRow();
+        verifyScans(charRow);
+
+        for (size_t column = 0; column < charRow.size(); ++column)
+        {
+            charRow.Reset();
+            charRow.GlyphAt(column) = L"a";
+            verifyScans(charRow);
+
+            Log::Comment(L"A stored glyph is text, whatever its cell holds in the char row.");
+            charRow.Reset();
+            charRow.GlyphAt(column) = fire;
+            verifyScans(charRow);
+
+            charRow.ClearGlyph(column);
+            verifyScans(charRow);
+
+            if (column + 1 < charRow.size())
+            {
+                charRow.Reset();
+                charRow.GlyphAt(column) = L"\x3042";
+                charRow.DbcsAttrAt(column).SetLeading();
+                charRow.GlyphAt(column + 1) = L"\x3042";
+                charRow.DbcsAttrAt(column + 1).SetTrailing();
+                charRow.GlyphAt(charRow.size() - 1 - column) = fire;
+                verifyScans(charRow);
+            }
+        }
+    }
+}
+
+void TextBufferTests::CharRowWriteNarrowText()
+{
+    const COORD bufferSize{ 20, 1 };
+    TextBuffer buffer(bufferSize, TextAttribute{ 0x7 }, 12, _renderTarget);
+    auto& charRow = buffer.GetRowByOffset(0).GetCharRow();
+
+    charRow.GlyphAt(4) = L"\xD83D\xDD25";
+    charRow.GlyphAt(5) = L"\x3042";
+    charRow.DbcsAttrAt(5).SetLeading();
+    charRow.GlyphAt(6) = L"\x3042";
+    charRow.DbcsAttrAt(6).SetTrailing();
+
+    Log::Comment(L"Writing narrow text replaces the glyphs and dbcs attributes of the cells it covers.");
+    charRow.WriteNarrowText(3, L"hello");
+    VERIFY_ARE_EQUAL(String(L"   hello            "), String(charRow.GetText().c_str()));
+    for (size_t i = 3; i < 8; ++i)
+    {
+        VERIFY_IS_TRUE(charRow.DbcsAttrAt(i).IsSingle());
+        VERIFY_IS_FALSE(charRow.DbcsAttrAt(i).IsGlyphStored());
+    }
+    VERIFY_ARE_EQUAL(3u, charRow.MeasureLeft());
+    VERIFY_ARE_EQUAL(8u, charRow.MeasureRight());
+
+    Log::Comment(L"Text may end at the end of the row, but not go past it.");
+    charRow.WriteNarrowText(15, L"world");
+    VERIFY_ARE_EQUAL(20u, charRow.MeasureRight());
+    VERIFY_THROWS_SPECIFIC(charRow.WriteNarrowText(16, L"world"), wil::ResultException, [](auto& e) { return e.GetErrorCode() == E_INVALIDARG; });
+    VERIFY_ARE_EQUAL(String(L"   hello       world"), String(charRow.GetText().c_str()));
+}
+
+void TextBufferTests::CharRowExtentsFollowWrites()
+{
+    const COORD bufferSize{ 40, 1 };
+    TextBuffer buffer(bufferSize, TextAttribute{ 0x7 }, 12, _renderTarget);
+    auto& charRow = buffer.GetRowByOffset(0).GetCharRow();
+
+    // The edges of the text, found by looking at every cell.
+    const auto verifyExtents = [&]() {
+        const auto chars = std::as_const(charRow).Chars();
+        const auto left = std::find_if(chars.begin(), chars.end(), [](auto wch) { return wch != L' '; }) - chars.begin();
+        const auto right = std::find_if(chars.rbegin(), chars.rend(), [](auto wch) { return wch != L' '; }).base() - chars.begin();
+        VERIFY_ARE_EQUAL(gsl::narrow<size_t>(left), charRow.MeasureLeft());
+        VERIFY_ARE_EQUAL(gsl::narrow<size_t>(right), charRow.MeasureRight());
+        VERIFY_ARE_EQUAL(right != 0, charRow.ContainsText());
+    };
+
+    std::mt19937 rng{ 1234 };
+    const auto random = [&](const size_t bound) {
+        return std::uniform_int_distribution<size_t>{ 0, bound - 1 }(rng);
+    };
+
+    // Mostly spaces, so that the edges of the text move around a lot.
+    const auto randomText = [&](const size_t length) {
+        std::wstring text;
+        for (size_t i = 0; i < length; ++i)
+        {
+            text.push_back(random(4) == 0 ? L'x' : L' ');
+        }
+        return text;
+    };
+
+    for (auto step = 0; step < 2000; ++step)
+    {
+        const auto width = charRow.size();
+        const auto column = random(width);
+        switch (random(8))
+        {
+        case 0:
+            charRow.GlyphAt(column) = L"x";
+            break;
+        case 1:
+            charRow.GlyphAt(column) = L" ";
+            break;
+        case 2:
+            charRow.GlyphAt(column) = L"\xD83D\xDD25";
+            break;
+        case 3:
+            charRow.ClearCell(column);
+            break;
+        case 4:
+            charRow.ClearGlyph(column);
+            break;
+        case 5:
+            charRow.WriteNarrowText(column, randomText(random(width - column + 1)));
+            break;
+        case 6:
+            VERIFY_SUCCEEDED(charRow.Resize(20 + random(40)));
+            break;
+        default:
+            if (random(10) == 0)
+            {
+                charRow.Reset();
+            }
+            else
+            {
+                const auto chars = charRow.Chars();
+                til::at(chars, column) = random(2) ? L'x' : L' ';
+            }
+            break;
+        }
+        verifyExtents();
+    }
+}
+
+void TextBufferTests::CharRowDelimiterClassScans()
+{
+    Log::Comment(L"Delimiters above U+00FF are found too, and duplicates are fine.");
+    const DelimiterClassifier classifier{ L"/\\()\"'-.,:;<>~!@#$%^&*|+=[]{}~?\x2502\x3001\x3001" };
+    VERIFY_ARE_EQUAL(DelimiterClass::ControlChar, classifier.Classify(L'\0'));
+    VERIFY_ARE_EQUAL(DelimiterClass::ControlChar, classifier.Classify(L' '));
+    VERIFY_ARE_EQUAL(DelimiterClass::DelimiterChar, classifier.Classify(L'/'));
+    VERIFY_ARE_EQUAL(DelimiterClass::DelimiterChar, classifier.Classify(L'\x3001'));
+    VERIFY_ARE_EQUAL(DelimiterClass::DelimiterChar, classifier.Classify(L'\x2502'));
+    VERIFY_ARE_EQUAL(DelimiterClass::RegularChar, classifier.Classify(L'a'));
+    VERIFY_ARE_EQUAL(DelimiterClass::RegularChar, classifier.Classify(L'\xe9'));
+    VERIFY_ARE_EQUAL(DelimiterClass::RegularChar, classifier.Classify(L'\x3042'));
+
+    const DelimiterClassifier otherClassifier{ L"x" };
+
+    const COORD bufferSize{ 150, 1 };
+    TextBuffer buffer(bufferSize, TextAttribute{ 0x7 }, 12, _renderTarget);
+    auto& charRow = buffer.GetRowByOffset(0).GetCharRow();
+
+    // The scans must agree with classifying the cells one at a time.
+    const auto verifyScans = [&](const DelimiterClassifier& c) {
+        const auto width = charRow.size();
+        for (const auto delimiterClass : { DelimiterClass::ControlChar, DelimiterClass::DelimiterChar, DelimiterClass::RegularChar })
+        {
+            for (const auto equal : { true, false })
+            {
+                std::optional<size_t> expected;
+                for (size_t column = width; column-- > 0;)
+                {
+                    if ((c.Classify(*charRow.GlyphAt(column).begin()) == delimiterClass) == equal)
+                    {
+                        expected = column;
+                    }
+                    VERIFY_IS_TRUE(expected == charRow.FindDelimiterClass(column, c, delimiterClass, equal));
+                }
+
+                expected.reset();
+                for (size_t column = 0; column < width; ++column)
+                {
+                    const auto actualClass = c.Classify(*charRow.GlyphAt(column).begin());
+                    VERIFY_ARE_EQUAL(actualClass, charRow.DelimiterClassAt(column, c));
+                    if ((actualClass == delimiterClass) == equal)
+                    {
+                        expected = column;
+                    }
+                    VERIFY_IS_TRUE(expected == charRow.FindDelimiterClassBackward(column, c, delimiterClass, equal));
+                }
+            }
+        }
+    };
+
+    std::mt19937 rng{ 5678 };
+    const auto random = [&](const size_t bound) {
+        return std::uniform_int_distribution<size_t>{ 0, bound - 1 }(rng);
+    };
+
+    static constexpr std::wstring_view samples[]{ L"x", L" ", L"/", L"\x3001", L"\x3042", L"\t" };
+    const auto randomText = [&](const size_t length) {
+        std::wstring text;
+        for (size_t i = 0; i < length; ++i)
+        {
+            text.push_back(random(3) ? L'x' : L'.');
+        }
+        return text;
+    };
+
+    verifyScans(classifier);
+    for (auto step = 0; step < 200; ++step)
+    {
+        const auto width = charRow.size();
+        const auto column = random(width);
+        switch (random(6))
+        {
+        case 0:
+            charRow.GlyphAt(column) = til::at(samples, random(std::size(samples)));
+            break;
+        case 1:
+            // A stored glyph is classified by its first character.
+            charRow.GlyphAt(column) = random(2) ? L"\xD83D\xDD25" : L"/\x0301";
+            break;
+        case 2:
+            charRow.ClearGlyph(column);
+            break;
+        case 3:
+            charRow.WriteNarrowText(column, randomText(random(width - column + 1)));
+            break;
+        case 4:
+            VERIFY_SUCCEEDED(charRow.Resize(40 + random(160)));
+            break;
+        default:
+        {
+            const auto chars = charRow.Chars();
+            til::at(chars, column) = random(2) ? L'x' : L'/';
+            break;
+        }
+        }
+
+        verifyScans(classifier);
+
+        // The columns found for one classifier aren't used for another.
+        if (step % 50 == 0)
+        {
+            verifyScans(otherClassifier);
+            verifyScans(classifier);
+        }
+    }
+}
+
+void TextBufferTests::WriteNarrowTextMatchesWrite()
+{
+    const COORD bufferSize{ 20, 3 };
+    const TextAttribute attr{ 0x5e };
+
+    VERIFY_ARE_EQUAL(0u, TextBuffer::MeasureNarrowText(L""));
+    VERIFY_ARE_EQUAL(6u, TextBuffer::MeasureNarrowText(L"ab c~!\tdef"));
+    VERIFY_ARE_EQUAL(2u, TextBuffer::MeasureNarrowText(L"ab\x7f"));
+    VERIFY_ARE_EQUAL(1u, TextBuffer::MeasureNarrowText(L"a\x3042"));
+
+    for (const SHORT column : { 0, 5, 13, 19 })
+    {
+        Log::Comment(NoThrowString().Format(L"Writing at column %d", column));
+        const std::wstring_view text{ L"The quick brown fox" };
+
+        TextBuffer expected(bufferSize, TextAttribute{ 0x7 }, 12, _renderTarget);
+        const OutputCellIterator it{ text, attr };
+        const auto end = expected.WriteLine(it, { column, 1 }, true);
+
+        TextBuffer actual(bufferSize, TextAttribute{ 0x7 }, 12, _renderTarget);
+        const auto written = actual.WriteNarrowText(text, attr, { column, 1 });
+
+        VERIFY_ARE_EQUAL(end.GetInputDistance(it), written);
+        VERIFY_ARE_EQUAL(end.GetCellDistance(it), written);
+        VERIFY_IS_TRUE(expected.GetRowByOffset(1).GetCharRow() == actual.GetRowByOffset(1).GetCharRow());
+        VERIFY_IS_TRUE(expected.GetRowByOffset(1).GetAttrRow() == actual.GetRowByOffset(1).GetAttrRow());
+        VERIFY_ARE_EQUAL(column + written == 20u, actual.GetRowByOffset(1).GetCharRow().WasWrapForced());
+    }
+
+    Log::Comment(L"Nothing is written outside of the buffer.");
+    TextBuffer buffer(bufferSize, TextAttribute{ 0x7 }, 12, _renderTarget);
+    VERIFY_ARE_EQUAL(0u, buffer.WriteNarrowText(L"abc", attr, { 0, 3 }));
+    VERIFY_ARE_EQUAL(0u, buffer.WriteNarrowText(L"abc", attr, { 20, 0 }));
+}
+
+void TextBufferTests::WriteNarrowTextSplitsWideGlyphs()
+{
+    const COORD bufferSize{ 10, 1 };
+    TextBuffer buffer(bufferSize, TextAttribute{ 0x7 }, 12, _renderTarget);
+    const TextAttribute attr{ 0x5e };
+
+    // Three wide glyphs in columns 0-5.
+    buffer.WriteLine(OutputCellIterator{ L"\x3042\x3044\x3046", TextAttribute{ 0x7 } }, { 0, 0 });
+    const auto& charRow = buffer.GetRowByOffset(0).GetCharRow();
+    VERIFY_IS_TRUE(charRow.DbcsAttrAt(4).IsLeading());
+
+    Log::Comment(L"Writing over columns 1 and 2 splits the first two glyphs, so their other halves are cleared.");
+    VERIFY_ARE_EQUAL(2u, buffer.WriteNarrowText(L"ab", attr, { 1, 0 }));
+    VERIFY_ARE_EQUAL(String(L" ab \x3046    "), String(charRow.GetText().c_str()));
+    for (size_t i = 0; i < 4; ++i)
+    {
+        VERIFY_IS_TRUE(charRow.DbcsAttrAt(i).IsSingle());
+    }
+    VERIFY_IS_TRUE(charRow.DbcsAttrAt(4).IsLeading());
+    VERIFY_IS_TRUE(charRow.DbcsAttrAt(5).IsTrailing());
+
+    Log::Comment(L"The text gets the attribute as one run, and the cleared halves keep theirs.");
+    const auto& attrRow = buffer.GetRowByOffset(0).GetAttrRow();
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x7 }, attrRow.GetAttrByColumn(0));
+    VERIFY_ARE_EQUAL(attr, attrRow.GetAttrByColumn(1));
+    VERIFY_ARE_EQUAL(attr, attrRow.GetAttrByColumn(2));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x7 }, attrRow.GetAttrByColumn(3));
+}
+
+void TextBufferTests::GetRowTextIsCached()
+{
+    const COORD bufferSize{ 20, 4 };
+    TextBuffer buffer(bufferSize, TextAttribute{ 0x7 }, 12, _renderTarget);
+    const TextAttribute attr{ 0x7 };
+    buffer.WriteLine(OutputCellIterator{ L"The quick brown fox", attr }, { 0, 1 });
+    buffer.WriteLine(OutputCellIterator{ L"a\x3042" L"b", attr }, { 0, 2 });
+
+    for (const SMALL_RECT rect : { SMALL_RECT{ 0, 1, 19, 1 }, SMALL_RECT{ 4, 1, 8, 1 }, SMALL_RECT{ 0, 2, 19, 2 }, SMALL_RECT{ 0, 3, 19, 3 } })
+    {
+        const auto expected = buffer.GetText(false, false, { rect }).text.at(0);
+        VERIFY_ARE_EQUAL(expected, buffer.GetRowText(rect));
+    }
+
+    Log::Comment(L"Asking again for a row that hasn't changed hands out the same text.");
+    const SMALL_RECT row{ 0, 1, 19, 1 };
+    const auto& first = buffer.GetRowText(row);
+    VERIFY_ARE_EQUAL(&first, &buffer.GetRowText(row));
+    VERIFY_ARE_EQUAL(std::wstring{ L"quick" }, buffer.GetRowText({ 4, 1, 8, 1 }));
+
+    Log::Comment(L"Writing to the row brings the text up to date.");
+    buffer.WriteLine(OutputCellIterator{ L"slow", attr }, { 4, 1 });
+    VERIFY_ARE_EQUAL(std::wstring{ L"The slowk brown fox " }, buffer.GetRowText(row));
+    VERIFY_ARE_EQUAL(buffer.GetText(false, false, { row }).text.at(0), buffer.GetRowText(row));
+
+    Log::Comment(L"So does moving the rows around.");
+    buffer.ScrollRows(1, 2, -1);
+    VERIFY_ARE_EQUAL(buffer.GetText(false, false, { row }).text.at(0), buffer.GetRowText(row));
+    VERIFY_ARE_EQUAL(buffer.GetText(false, false, { SMALL_RECT{ 0, 2, 19, 2 } }).text.at(0), buffer.GetRowText({ 0, 2, 19, 2 }));
+}
+
 // This tests that when we increment the circular buffer, obsolete hyperlink references
 // are removed from the hyperlink map
 void TextBufferTests::HyperlinkTrim()
@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+
+#include "..\..\renderer\base\UiaNotificationCoalescer.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using namespace Microsoft::Console::Render;
+using namespace std::chrono;
+
+class UiaNotificationCoalescerTests
+{
+    TEST_CLASS(UiaNotificationCoalescerTests);
+
+    steady_clock::time_point _now;
+    std::unique_ptr<UiaNotificationCoalescer> _coalescer;
+
+    TEST_METHOD_SETUP(MethodSetup)
+    {
+        _now = {};
+        _coalescer = std::make_unique<UiaNotificationCoalescer>([this]() { return _now; });
+        return true;
+    }
+
+    TEST_METHOD(NothingPending)
+    {
+        VERIFY_IS_FALSE(_coalescer->HasPending());
+        VERIFY_IS_FALSE(_coalescer->Take().has_value());
+    }
+
+    TEST_METHOD(FirstChangeIsHandedOutRightAway)
+    {
+        _coalescer->TextChanged();
+        VERIFY_IS_TRUE(_coalescer->HasPending());
+
+        const auto notification = _coalescer->Take();
+        VERIFY_IS_TRUE(notification.has_value());
+        VERIFY_IS_TRUE(notification->textChanged);
+        VERIFY_IS_FALSE(notification->selectionChanged);
+        VERIFY_IS_FALSE(notification->cursorChanged);
+
+        VERIFY_IS_FALSE(_coalescer->HasPending());
+    }
+
+    TEST_METHOD(ChangesWithinWindowAreMerged)
+    {
+        _coalescer->CursorChanged();
+        VERIFY_IS_TRUE(_coalescer->Take().has_value());
+
+        Log::Comment(L"Changes that come in while the window is open are held back.");
+        for (auto i = 0; i < 5; ++i)
+        {
+            _now += 10ms;
+            _coalescer->TextChanged();
+            _coalescer->CursorChanged();
+            VERIFY_IS_FALSE(_coalescer->Take().has_value());
+            VERIFY_IS_TRUE(_coalescer->HasPending());
+        }
+        _coalescer->SelectionChanged();
+
+        Log::Comment(L"Once it closes, they're handed out together.");
+        _now += UiaNotificationCoalescer::Window;
+        const auto notification = _coalescer->Take();
+        VERIFY_IS_TRUE(notification.has_value());
+        VERIFY_IS_TRUE(notification->textChanged);
+        VERIFY_IS_TRUE(notification->selectionChanged);
+        VERIFY_IS_TRUE(notification->cursorChanged);
+
+        VERIFY_IS_FALSE(_coalescer->HasPending());
+        VERIFY_IS_FALSE(_coalescer->Take().has_value());
+    }
+
+    TEST_METHOD(WindowStartsWithEachNotification)
+    {
+        _coalescer->SelectionChanged();
+        VERIFY_IS_TRUE(_coalescer->Take().has_value());
+
+        Log::Comment(L"A change is held back until the window is over, and no longer.");
+        _coalescer->SelectionChanged();
+        _now += UiaNotificationCoalescer::Window - 1ms;
+        VERIFY_IS_FALSE(_coalescer->Take().has_value());
+        _now += 1ms;
+        VERIFY_IS_TRUE(_coalescer->Take().has_value());
+
+        Log::Comment(L"Handing it out starts the next window.");
+        _coalescer->SelectionChanged();
+        VERIFY_IS_FALSE(_coalescer->Take().has_value());
+    }
+};
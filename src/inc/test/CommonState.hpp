@@ -261,7 +261,7 @@ private:
         attrs[6].SetTrailing();
 
         CharRow& charRow = pRow->GetCharRow();
-        OverwriteColumns(pwszText, pwszText + length, attrs.cbegin(), charRow.begin());
+        OverwriteColumns(pwszText, pwszText + length, attrs.cbegin(), charRow, 0);
 
         // set some colors
         TextAttribute Attr = TextAttribute(0);
@@ -326,7 +326,7 @@ private:
         attrs[79].SetLeading();
 
         CharRow& charRow = pRow->GetCharRow();
-        OverwriteColumns(pwszText, pwszText + length, attrs.cbegin(), charRow.begin());
+        OverwriteColumns(pwszText, pwszText + length, attrs.cbegin(), charRow, 0);
 
         // everything gets default attributes
         pRow->GetAttrRow().Reset(gci.GetActiveOutputBuffer().GetAttributes());
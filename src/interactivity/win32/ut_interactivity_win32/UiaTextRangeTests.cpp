@@ -145,10 +145,8 @@ class UiaTextRangeTests
         {
             ROW& row = _pTextBuffer->GetRowByOffset(i);
             auto& charRow = row.GetCharRow();
-            for (auto& cell : charRow)
-            {
-                cell.Char() = L' ';
-            }
+            const auto chars = charRow.Chars();
+            std::fill(chars.begin(), chars.end(), L' ');
         }
 
         return true;
@@ -141,7 +141,21 @@ bool HandleTerminalMouseEvent(const COORD cMousePosition,
         auto clampedPosition{ cMousePosition };
         const auto clampViewport{ gci.GetActiveOutputBuffer().GetViewport().ToOrigin() };
         clampViewport.Clamp(clampedPosition);
-        fWasHandled = gci.GetActiveInputBuffer()->GetTerminalInput().HandleMouse(clampedPosition, uiButton, sModifierKeystate, sWheelDelta, state);
+        auto& terminalInput = gci.GetActiveInputBuffer()->GetTerminalInput();
+        fWasHandled = terminalInput.HandleMouse(clampedPosition, uiButton, sModifierKeystate, sWheelDelta, state);
+
+        // If the motion rate limit held this event back, send it once the
+        // mouse has been idle for as long as the limit allows between events.
+        // Setting the timer again restarts it, so it only fires when the mouse
+        // stops. See HandleTimerEvent.
+        if (terminalInput.HasPendingMouseMotion())
+        {
+            const auto maxRate = gci.GetMouseMotionRateLimit();
+            SetTimer(ServiceLocator::LocateConsoleWindow()->GetWindowHandle(),
+                     MOUSE_MOTION_FLUSH_TIMER,
+                     maxRate ? 1000 / maxRate : USER_TIMER_MINIMUM,
+                     nullptr);
+        }
     }
 
     return fWasHandled;
@@ -170,6 +184,12 @@ void HandleKeyEvent(const HWND hWnd,
         // when nothing is happening, or the user has merely clicked on the title bar, and
         // this can incorrectly mark the session as being interactive.
         Telemetry::Instance().SetUserInteractive();
+
+        // Whatever this key echoes should be painted right away.
+        if (ServiceLocator::LocateGlobals().pRender != nullptr)
+        {
+            ServiceLocator::LocateGlobals().pRender->NotifyUserInput();
+        }
     }
 
     // Make sure we retrieve the key info first, or we could chew up
@@ -574,6 +594,26 @@ BOOL HandleSysKeyEvent(const HWND hWnd, const UINT Message, const WPARAM wParam,
     return S_OK;
 }
 
+// Routine Description:
+// - Handles the timers that conhost sets on its window.
+// - Returns TRUE if DefWindowProc should be called.
+BOOL HandleTimerEvent(const HWND hWnd,
+                      const WPARAM wParam)
+{
+    if (wParam == MOUSE_MOTION_FLUSH_TIMER)
+    {
+        // The mouse has stopped moving, so send the motion that the rate
+        // limit held back.
+        KillTimer(hWnd, MOUSE_MOTION_FLUSH_TIMER);
+
+        CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        gci.GetActiveInputBuffer()->GetTerminalInput().FlushPendingMouseMotion();
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
 // Routine Description:
 // - Returns TRUE if DefWindowProc should be called.
 BOOL HandleMouseEvent(const SCREEN_INFORMATION& ScreenInfo,
@@ -23,6 +23,11 @@ BOOL HandleMouseEvent(const SCREEN_INFORMATION& ScreenInfo,
                       const UINT Message,
                       const WPARAM wParam,
                       const LPARAM lParam);
+BOOL HandleTimerEvent(const HWND hWnd,
+                      const WPARAM wParam);
+
+// Sends the mouse motion that the motion rate limit held back once the mouse goes idle.
+#define MOUSE_MOTION_FLUSH_TIMER 1
 
 VOID SetConsoleWindowOwner(const HWND hwnd, _Inout_opt_ ConsoleProcessHandle* pProcessData);
 DWORD WINAPI ConsoleInputThreadProcWin32(LPVOID lpParameter);
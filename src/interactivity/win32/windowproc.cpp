@@ -612,6 +612,15 @@ using namespace Microsoft::Console::Types;
         break;
     }
 
+    case WM_TIMER:
+    {
+        if (HandleTimerEvent(hWnd, wParam))
+        {
+            goto CallDefWin;
+        }
+        break;
+    }
+
     case WM_MOUSEMOVE:
     case WM_LBUTTONDOWN:
     case WM_LBUTTONUP:
@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "FramePacer.hpp"
+
+#pragma hdrstop
+
+using namespace Microsoft::Console::Render;
+using namespace std::chrono;
+
+// Weight of the newest sample in the running averages.
+static constexpr double averageWeight = 0.125;
+
+FramePacer::FramePacer() :
+    FramePacer(&steady_clock::now)
+{
+}
+
+FramePacer::FramePacer(Clock clock) :
+    _clock{ std::move(clock) },
+    _outputRequests{ 0 },
+    _userInput{ false },
+    _busyFrames{ 0 },
+    _interval{ MinimumInterval }
+{
+    _frameStart = _clock();
+    _stats.interval = _interval;
+}
+
+// Routine Description:
+// - Called whenever a frame is requested because of new output.
+void FramePacer::NotifyOutput() noexcept
+{
+    _outputRequests.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Routine Description:
+// - Called when the user typed, clicked, etc. The next frame is painted
+//   right away and any flood back-off is forgotten.
+void FramePacer::NotifyUserInput() noexcept
+{
+    _userInput.store(true, std::memory_order_release);
+}
+
+// Routine Description:
+// - Called by the render thread right before it paints a frame.
+void FramePacer::FrameStarted()
+{
+    const auto previousFrameStart = _frameStart;
+    _frameStart = _clock();
+
+    const auto fastPath = _userInput.exchange(false, std::memory_order_acq_rel);
+    if (fastPath)
+    {
+        _ResetBackoff();
+    }
+
+    const auto requests = _outputRequests.exchange(0, std::memory_order_relaxed);
+    const auto period = duration_cast<duration<double>>(_frameStart - previousFrameStart);
+
+    std::lock_guard<std::mutex> lock{ _statsLock };
+    if (fastPath)
+    {
+        ++_stats.fastPathFrames;
+    }
+    if (_stats.frames != 0 && period.count() > 0)
+    {
+        const auto rate = requests / period.count();
+        _stats.outputRequestsPerSecond = _stats.outputRequestsPerSecond * (1 - averageWeight) + rate * averageWeight;
+    }
+}
+
+// Routine Description:
+// - Called by the render thread right after it painted a frame.
+void FramePacer::FrameCompleted()
+{
+    const auto paintDuration = duration_cast<microseconds>(_clock() - _frameStart);
+
+    std::lock_guard<std::mutex> lock{ _statsLock };
+    _stats.lastPaintDuration = paintDuration;
+    _stats.averagePaintDuration = _stats.frames == 0 ?
+                                      paintDuration :
+                                      duration_cast<microseconds>(_stats.averagePaintDuration * (1 - averageWeight) + paintDuration * averageWeight);
+    ++_stats.frames;
+}
+
+// Routine Description:
+// - Called by the render thread after FrameCompleted. Returns how long it should
+//   wait before it starts looking for the next frame to paint.
+// - A frame that completes with more output already waiting counts towards a
+//   flood. Once enough of them happen in a row, the interval is doubled, and
+//   again after every further run of that length, up to MaximumInterval.
+//   The first frame that completes with nothing waiting ends the flood.
+// - The time spent painting counts towards the interval, but the wait is never
+//   shorter than MinimumInterval, which is what it always used to be.
+// Arguments:
+// - <none>
+// Return Value:
+// - How long to wait. The wait should end early if NotifyUserInput is called.
+milliseconds FramePacer::NextFrameDelay()
+{
+    if (_userInput.load(std::memory_order_acquire))
+    {
+        return milliseconds::zero();
+    }
+
+    // Requests that came in while painting are left for FrameStarted to count.
+    if (_outputRequests.load(std::memory_order_relaxed) == 0)
+    {
+        _ResetBackoff();
+    }
+    else if (++_busyFrames % FloodFrames == 0)
+    {
+        _interval = std::min(_interval * 2, MaximumInterval);
+    }
+
+    milliseconds paintDuration;
+    {
+        std::lock_guard<std::mutex> lock{ _statsLock };
+        _stats.interval = _interval;
+        paintDuration = duration_cast<milliseconds>(_stats.lastPaintDuration);
+    }
+
+    return std::max(_interval - paintDuration, MinimumInterval);
+}
+
+// Routine Description:
+// - Returns a snapshot of the frame statistics. May be called from any thread.
+FrameStats FramePacer::GetStats() const
+{
+    std::lock_guard<std::mutex> lock{ _statsLock };
+    return _stats;
+}
+
+void FramePacer::_ResetBackoff() noexcept
+{
+    _busyFrames = 0;
+    _interval = MinimumInterval;
+}
@@ -0,0 +1,66 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- FramePacer.hpp
+
+Abstract:
+- Decides how long the render thread waits between two frames.
+- Normally that's the same fixed gap the render thread has always slept for.
+  When output keeps arriving frame after frame (a flood), the gap is doubled
+  every so often, up to a ceiling, so painting doesn't steal time from the
+  text it's trying to show. User input resets all of that, and the first
+  frame after it is painted without waiting.
+- The clock is injectable so the policy can be tested without sleeping.
+- Notify* may be called from any thread. Everything else is only meant to be
+  called by the render thread, except for GetStats.
+--*/
+
+#pragma once
+
+#include "..\inc\IRenderThread.hpp"
+
+namespace Microsoft::Console::Render
+{
+    class FramePacer final
+    {
+    public:
+        using Clock = std::function<std::chrono::steady_clock::time_point()>;
+
+        // The gap the render thread used to always sleep for after a frame.
+        static constexpr std::chrono::milliseconds MinimumInterval{ 8 };
+        // Floods are painted at no less than 10 frames per second.
+        static constexpr std::chrono::milliseconds MaximumInterval{ 100 };
+        // How many consecutive frames need to find more output waiting before
+        // the interval is doubled (and again for every further such run).
+        static constexpr unsigned int FloodFrames = 12;
+
+        FramePacer();
+        explicit FramePacer(Clock clock);
+
+        void NotifyOutput() noexcept;
+        void NotifyUserInput() noexcept;
+
+        void FrameStarted();
+        void FrameCompleted();
+        std::chrono::milliseconds NextFrameDelay();
+
+        FrameStats GetStats() const;
+
+    private:
+        void _ResetBackoff() noexcept;
+
+        Clock _clock;
+
+        std::atomic<uint32_t> _outputRequests;
+        std::atomic<bool> _userInput;
+
+        std::chrono::steady_clock::time_point _frameStart;
+        unsigned int _busyFrames;
+        std::chrono::milliseconds _interval;
+
+        mutable std::mutex _statsLock;
+        FrameStats _stats;
+    };
+}
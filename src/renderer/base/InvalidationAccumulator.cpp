@@ -0,0 +1,315 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "InvalidationAccumulator.hpp"
+
+#pragma hdrstop
+
+using namespace Microsoft::Console::Render;
+
+static constexpr int32_t emptyLow = std::numeric_limits<int32_t>::max();
+static constexpr int32_t emptyHigh = std::numeric_limits<int32_t>::min();
+
+// Routine Description:
+// - Lowers the given atomic to value if value is smaller than what it holds.
+static void AtomicMin(std::atomic<int32_t>& target, const int32_t value) noexcept
+{
+    auto current = target.load(std::memory_order_relaxed);
+    while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+// Routine Description:
+// - Raises the given atomic to value if value is larger than what it holds.
+static void AtomicMax(std::atomic<int32_t>& target, const int32_t value) noexcept
+{
+    auto current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+void InvalidationAccumulator::Frame::Clear() noexcept
+{
+    all = false;
+    selection = false;
+    cursorDoubleWidth = false;
+    scroll = {};
+    regions.clear();
+    cursors.clear();
+}
+
+bool InvalidationAccumulator::Frame::empty() const noexcept
+{
+    return !all && !selection && scroll == til::point{} && regions.empty() && cursors.empty();
+}
+
+InvalidationAccumulator::InvalidationAccumulator() noexcept :
+    _rows{},
+    _rowsTop{ emptyLow },
+    _rowsBottom{ emptyHigh },
+    _overflowLeft{ emptyLow },
+    _overflowTop{ emptyLow },
+    _overflowRight{ emptyHigh },
+    _overflowBottom{ emptyHigh },
+    _scrollX{ 0 },
+    _scrollY{ 0 },
+    _cursorFirst{ _noCursor },
+    _cursorTop{ _noCursor },
+    _cursorLast{ _noCursor },
+    _cursorDoubleWidth{ false },
+    _selection{ false },
+    _all{ false },
+    _pending{ false }
+{
+}
+
+constexpr uint32_t InvalidationAccumulator::_PackColumns(const SHORT left, const SHORT right) noexcept
+{
+    return static_cast<uint32_t>(static_cast<uint16_t>(left)) | (static_cast<uint32_t>(static_cast<uint16_t>(right)) << 16);
+}
+
+constexpr uint64_t InvalidationAccumulator::_PackCursor(const SHORT x, const int32_t y) noexcept
+{
+    return static_cast<uint64_t>(static_cast<uint16_t>(x)) | (1ull << 16) | (static_cast<uint64_t>(static_cast<uint32_t>(y)) << 32);
+}
+
+constexpr til::point InvalidationAccumulator::_UnpackCursor(const uint64_t packed) noexcept
+{
+    return { static_cast<SHORT>(packed & 0xFFFF), static_cast<int32_t>(packed >> 32) };
+}
+
+// Routine Description:
+// - Records that the given region of the viewport has changed.
+// Arguments:
+// - region - Viewport-relative, exclusive rectangle that needs to be repainted.
+// Return Value:
+// - <none>
+void InvalidationAccumulator::Invalidate(const SMALL_RECT& region) noexcept
+{
+    if (region.Left >= region.Right || region.Top >= region.Bottom)
+    {
+        return;
+    }
+
+    const auto scrollX = _scrollX.load(std::memory_order_relaxed);
+    const auto scrollY = _scrollY.load(std::memory_order_relaxed);
+    const int32_t top = region.Top - scrollY;
+    const int32_t bottom = region.Bottom - scrollY;
+
+    // The row table only stores columns as they were given, so anything that
+    // was horizontally scrolled this frame (rare) goes to the bounding rectangle.
+    if (scrollX != 0 || top < 0 || bottom > gsl::narrow_cast<int32_t>(TrackedRows))
+    {
+        _InvalidateOverflow(region.Left - scrollX, top, region.Right - scrollX, bottom);
+    }
+    else
+    {
+        for (auto row = top; row < bottom; ++row)
+        {
+            auto& slot = til::at(_rows, row);
+            auto current = slot.load(std::memory_order_relaxed);
+            uint32_t desired;
+            do
+            {
+                const auto left = gsl::narrow_cast<SHORT>(current & 0xFFFF);
+                const auto right = gsl::narrow_cast<SHORT>(current >> 16);
+                desired = current == 0 ? _PackColumns(region.Left, region.Right) :
+                                         _PackColumns(std::min(left, region.Left), std::max(right, region.Right));
+            } while (desired != current && !slot.compare_exchange_weak(current, desired, std::memory_order_relaxed));
+        }
+
+        AtomicMin(_rowsTop, top);
+        AtomicMax(_rowsBottom, bottom);
+    }
+
+    _pending.store(true, std::memory_order_release);
+}
+
+// Routine Description:
+// - Records that the cursor was drawn at or moved to the given position.
+// - Only the first, topmost and last positions within a frame are kept. The
+//   cursor is painted at exactly one of them, and the others are the places it
+//   could have been painted at in the previous frame.
+// Arguments:
+// - position - Viewport-relative position of the cursor.
+// - doubleWidth - Whether the cursor spans two cells at that position.
+// Return Value:
+// - <none>
+void InvalidationAccumulator::InvalidateCursor(const COORD position, const bool doubleWidth) noexcept
+{
+    const auto scrollX = _scrollX.load(std::memory_order_relaxed);
+    const auto scrollY = _scrollY.load(std::memory_order_relaxed);
+    const int32_t x = position.X - scrollX;
+    const int32_t y = position.Y - scrollY;
+
+    if (x < std::numeric_limits<SHORT>::min() || x > std::numeric_limits<SHORT>::max())
+    {
+        _InvalidateOverflow(x, y, x + (doubleWidth ? 2 : 1), y + 1);
+    }
+    else
+    {
+        _RecordCursor(_PackCursor(gsl::narrow_cast<SHORT>(x), y));
+        if (doubleWidth)
+        {
+            _cursorDoubleWidth.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    _pending.store(true, std::memory_order_release);
+}
+
+// Routine Description:
+// - Records that the contents of the viewport moved by the given distance.
+// Arguments:
+// - delta - The distance the contents moved.
+// Return Value:
+// - <none>
+void InvalidationAccumulator::InvalidateScroll(const COORD delta) noexcept
+{
+    _scrollX.fetch_add(delta.X, std::memory_order_relaxed);
+    _scrollY.fetch_add(delta.Y, std::memory_order_relaxed);
+    _pending.store(true, std::memory_order_release);
+}
+
+// Routine Description:
+// - Records that the selection changed. The rectangles are computed when the
+//   frame is drained, since only the final selection of a frame gets painted.
+void InvalidationAccumulator::InvalidateSelection() noexcept
+{
+    _selection.store(true, std::memory_order_relaxed);
+    _pending.store(true, std::memory_order_release);
+}
+
+// Routine Description:
+// - Records that the entire viewport needs to be repainted.
+void InvalidationAccumulator::InvalidateAll() noexcept
+{
+    _all.store(true, std::memory_order_relaxed);
+    _pending.store(true, std::memory_order_release);
+}
+
+// Routine Description:
+// - Returns true if anything was recorded since the last drain.
+bool InvalidationAccumulator::HasPending() const noexcept
+{
+    return _pending.load(std::memory_order_acquire);
+}
+
+// Routine Description:
+// - Moves everything recorded since the last drain into the given frame and
+//   resets the accumulator for the next one.
+// - Regions on consecutive rows that share the same columns are merged, and
+//   everything is translated by the frame's scroll, so the caller should apply
+//   the scroll to an engine before the regions and cursor positions.
+// Arguments:
+// - frame - Receives the invalidations. It's cleared first, but its storage is reused.
+// Return Value:
+// - <none>
+void InvalidationAccumulator::Drain(Frame& frame)
+{
+    frame.Clear();
+
+    if (!_pending.exchange(false, std::memory_order_acquire))
+    {
+        return;
+    }
+
+    frame.all = _all.exchange(false, std::memory_order_relaxed);
+    frame.selection = _selection.exchange(false, std::memory_order_relaxed);
+    frame.scroll = { _scrollX.exchange(0, std::memory_order_relaxed), _scrollY.exchange(0, std::memory_order_relaxed) };
+
+    const auto dx = gsl::narrow_cast<int32_t>(frame.scroll.x());
+    const auto dy = gsl::narrow_cast<int32_t>(frame.scroll.y());
+
+    // Everything was stored relative to the start of the frame. Shift it by the
+    // frame's scroll and drop whatever scrolled off the top or left edge.
+    // Anything past the bottom or right edge is left for the caller to clip.
+    const auto appendRegion = [&](const int32_t left, const int32_t top, const int32_t right, const int32_t bottom) {
+        constexpr int32_t maxShort = std::numeric_limits<SHORT>::max();
+        const auto l = std::clamp(left + dx, 0, maxShort);
+        const auto t = std::clamp(top + dy, 0, maxShort);
+        const auto r = std::clamp(right + dx, 0, maxShort);
+        const auto b = std::clamp(bottom + dy, 0, maxShort);
+        if (l < r && t < b)
+        {
+            frame.regions.push_back({ gsl::narrow_cast<SHORT>(l), gsl::narrow_cast<SHORT>(t), gsl::narrow_cast<SHORT>(r), gsl::narrow_cast<SHORT>(b) });
+        }
+    };
+
+    const auto top = _rowsTop.exchange(emptyLow, std::memory_order_relaxed);
+    const auto bottom = _rowsBottom.exchange(emptyHigh, std::memory_order_relaxed);
+    int32_t runTop = 0;
+    uint32_t runColumns = 0;
+    for (auto row = top; row < bottom; ++row)
+    {
+        const auto columns = til::at(_rows, row).exchange(0, std::memory_order_relaxed);
+        if (columns == runColumns)
+        {
+            continue;
+        }
+
+        if (runColumns != 0)
+        {
+            appendRegion(runColumns & 0xFFFF, runTop, runColumns >> 16, row);
+        }
+        runTop = row;
+        runColumns = columns;
+    }
+    if (runColumns != 0)
+    {
+        appendRegion(runColumns & 0xFFFF, runTop, runColumns >> 16, bottom);
+    }
+
+    const auto overflowLeft = _overflowLeft.exchange(emptyLow, std::memory_order_relaxed);
+    const auto overflowTop = _overflowTop.exchange(emptyLow, std::memory_order_relaxed);
+    const auto overflowRight = _overflowRight.exchange(emptyHigh, std::memory_order_relaxed);
+    const auto overflowBottom = _overflowBottom.exchange(emptyHigh, std::memory_order_relaxed);
+    if (overflowLeft < overflowRight && overflowTop < overflowBottom)
+    {
+        appendRegion(overflowLeft, overflowTop, overflowRight, overflowBottom);
+    }
+
+    const auto first = _cursorFirst.exchange(_noCursor, std::memory_order_relaxed);
+    const auto topmost = _cursorTop.exchange(_noCursor, std::memory_order_relaxed);
+    const auto last = _cursorLast.exchange(_noCursor, std::memory_order_relaxed);
+    for (const auto packed : { first, topmost, last })
+    {
+        if (packed != _noCursor)
+        {
+            const auto position = _UnpackCursor(packed) + til::point{ dx, dy };
+            if (position.x() >= 0 && position.y() >= 0 &&
+                std::find(frame.cursors.begin(), frame.cursors.end(), position) == frame.cursors.end())
+            {
+                frame.cursors.push_back(position);
+            }
+        }
+    }
+    frame.cursorDoubleWidth = _cursorDoubleWidth.exchange(false, std::memory_order_relaxed);
+}
+
+void InvalidationAccumulator::_RecordCursor(const uint64_t packed) noexcept
+{
+    auto expected = _noCursor;
+    _cursorFirst.compare_exchange_strong(expected, packed, std::memory_order_relaxed);
+
+    const auto y = gsl::narrow_cast<int32_t>(packed >> 32);
+    auto current = _cursorTop.load(std::memory_order_relaxed);
+    while ((current == _noCursor || y < gsl::narrow_cast<int32_t>(current >> 32)) &&
+           !_cursorTop.compare_exchange_weak(current, packed, std::memory_order_relaxed))
+    {
+    }
+
+    _cursorLast.store(packed, std::memory_order_relaxed);
+}
+
+void InvalidationAccumulator::_InvalidateOverflow(const int32_t left, const int32_t top, const int32_t right, const int32_t bottom) noexcept
+{
+    AtomicMin(_overflowLeft, left);
+    AtomicMin(_overflowTop, top);
+    AtomicMax(_overflowRight, right);
+    AtomicMax(_overflowBottom, bottom);
+}
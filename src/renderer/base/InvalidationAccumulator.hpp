@@ -0,0 +1,94 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- InvalidationAccumulator.hpp
+
+Abstract:
+- Collects the invalidations raised by writers (text output, cursor movement,
+  scrolling, selection) over the course of a frame, so the render thread can
+  hand them to the engines once per frame instead of every writer call
+  walking every engine.
+- Recording only touches atomics: a packed column range per tracked row, a
+  bounding rectangle for anything that doesn't fit in the row table, the
+  accumulated scroll delta, a few cursor positions and some flags.
+- Regions and cursor positions are stored relative to the viewport as it was
+  at the start of the frame (i.e. with the scroll recorded so far backed out).
+  The drain shifts everything by the frame's scroll, so an engine that's given
+  the scroll first and the regions after it ends up with what it would have
+  had if it had seen each call in order.
+- Recording and draining are individually lock-free, but the scroll
+  bookkeeping assumes writers are serialized against the drain. The renderer
+  only records and drains while holding the console lock, which provides that.
+--*/
+
+#pragma once
+
+namespace Microsoft::Console::Render
+{
+    class InvalidationAccumulator final
+    {
+    public:
+        // Rows outside of this many (frame-start relative) rows are folded into
+        // one bounding rectangle. It comfortably covers a viewport plus a few
+        // hundred lines of output scrolling through it between two frames.
+        static constexpr size_t TrackedRows = 512;
+
+        struct Frame
+        {
+            bool all = false;
+            bool selection = false;
+            bool cursorDoubleWidth = false;
+            til::point scroll;
+            std::vector<SMALL_RECT> regions; // exclusive, relative to the viewport after scrolling
+            std::vector<til::point> cursors; // relative to the viewport after scrolling
+
+            void Clear() noexcept;
+            bool empty() const noexcept;
+        };
+
+        InvalidationAccumulator() noexcept;
+
+        void Invalidate(const SMALL_RECT& region) noexcept;
+        void InvalidateCursor(const COORD position, const bool doubleWidth) noexcept;
+        void InvalidateScroll(const COORD delta) noexcept;
+        void InvalidateSelection() noexcept;
+        void InvalidateAll() noexcept;
+
+        bool HasPending() const noexcept;
+        void Drain(Frame& frame);
+
+    private:
+        // Cursor positions are packed as { x:16, valid:1, y:32 } so that zero can mean "none".
+        static constexpr uint64_t _noCursor = 0;
+
+        static constexpr uint32_t _PackColumns(const SHORT left, const SHORT right) noexcept;
+        static constexpr uint64_t _PackCursor(const SHORT x, const int32_t y) noexcept;
+        static constexpr til::point _UnpackCursor(const uint64_t packed) noexcept;
+
+        void _RecordCursor(const uint64_t packed) noexcept;
+        void _InvalidateOverflow(const int32_t left, const int32_t top, const int32_t right, const int32_t bottom) noexcept;
+
+        std::array<std::atomic<uint32_t>, TrackedRows> _rows;
+        std::atomic<int32_t> _rowsTop;
+        std::atomic<int32_t> _rowsBottom;
+
+        std::atomic<int32_t> _overflowLeft;
+        std::atomic<int32_t> _overflowTop;
+        std::atomic<int32_t> _overflowRight;
+        std::atomic<int32_t> _overflowBottom;
+
+        std::atomic<int32_t> _scrollX;
+        std::atomic<int32_t> _scrollY;
+
+        std::atomic<uint64_t> _cursorFirst;
+        std::atomic<uint64_t> _cursorTop;
+        std::atomic<uint64_t> _cursorLast;
+        std::atomic<bool> _cursorDoubleWidth;
+
+        std::atomic<bool> _selection;
+        std::atomic<bool> _all;
+        std::atomic<bool> _pending;
+    };
+}
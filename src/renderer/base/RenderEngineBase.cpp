@@ -47,3 +47,20 @@ void RenderEngineBase::WaitUntilCanRender() noexcept
 {
     // do nothing by default
 }
+
+// Method Description:
+// - Returns true if the engine needs every Invalidate* call as it happens.
+//   By default, the renderer collects the invalidations of a frame and hands
+//   them to the engine once, at the start of painting it.
+bool RenderEngineBase::RequiresSynchronousInvalidation() const noexcept
+{
+    return false;
+}
+
+// Method Description:
+// - Returns true if the engine wants another frame painted soon, even if
+//   nothing else is invalidated. By default, engines only paint on demand.
+bool RenderEngineBase::RequiresContinuousRedraw() noexcept
+{
+    return false;
+}
@@ -0,0 +1,380 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "RenderSnapshot.hpp"
+
+#include "../../buffer/out/textBuffer.hpp"
+
+#pragma hdrstop
+
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::Types;
+
+RenderSnapshot::CellIterator::CellIterator(const RenderSnapshot& snapshot, const Cell* const cells, const ptrdiff_t position, const ptrdiff_t end) noexcept :
+    _snapshot{ snapshot },
+    _cells{ cells },
+    _position{ position },
+    _end{ end },
+    _view{ {}, {}, {}, TextAttributeBehavior::Stored }
+{
+    _GenerateView();
+}
+
+RenderSnapshot::CellIterator::operator bool() const noexcept
+{
+    return _cells != nullptr && _position < _end;
+}
+
+RenderSnapshot::CellIterator& RenderSnapshot::CellIterator::operator+=(const ptrdiff_t movement) noexcept
+{
+    _position += movement;
+    _GenerateView();
+    return *this;
+}
+
+RenderSnapshot::CellIterator& RenderSnapshot::CellIterator::operator++() noexcept
+{
+    return *this += 1;
+}
+
+const OutputCellView& RenderSnapshot::CellIterator::operator*() const noexcept
+{
+    return _view;
+}
+
+const OutputCellView* RenderSnapshot::CellIterator::operator->() const noexcept
+{
+    return &_view;
+}
+
+void RenderSnapshot::CellIterator::_GenerateView() noexcept
+{
+    if (*this)
+    {
+        // The position was checked against the row's bounds when the iterator was created.
+        const auto& cell = _cells[_position];
+        const std::wstring_view text{ _snapshot._text.data() + cell.textOffset, cell.textLength };
+        _view = OutputCellView(text, cell.dbcsAttribute, til::at(_snapshot._attributes, cell.attribute), TextAttributeBehavior::Stored);
+    }
+}
+
+RenderSnapshot::RenderSnapshot() :
+    _pSource{ nullptr },
+    _viewport{ Viewport::Empty() },
+    _bufferWidth{ 0 },
+    _textBufferEnd{ 0, 0 },
+    _cursorPosition{ 0, 0 },
+    _cursorVisible{ false },
+    _cursorOn{ false },
+    _cursorHeight{ 0 },
+    _cursorStyle{ CursorType::Legacy },
+    _cursorPixelWidth{ 0 },
+    _cursorColor{ INVALID_COLOR },
+    _cursorDoubleWidth{ false },
+    _screenReversed{ false },
+    _gridLineDrawingAllowed{ false }
+{
+}
+
+// Routine Description:
+// - Copies everything needed to paint a frame out of the given render data.
+//   Of the text buffer, only the rows of the viewport that intersect the dirty
+//   areas are copied, across the entire width of the viewport.
+// - Must be called with the console lock held.
+// Arguments:
+// - source - The render data to copy from.
+// - dirtyAreas - The viewport-relative areas the engine is going to repaint.
+// Return Value:
+// - <none>
+void RenderSnapshot::Capture(IRenderData& source, const std::vector<til::rectangle>& dirtyAreas)
+{
+    _pSource = &source;
+
+    _viewport = source.GetViewport();
+    const auto& buffer = source.GetTextBuffer();
+    _bufferWidth = buffer.GetSize().Width();
+    _textBufferEnd = source.GetTextBufferEndPosition();
+
+    _attributes.clear();
+    _colors.clear();
+    _hyperlinks.clear();
+    _InternAttribute(source, source.GetDefaultBrushColors());
+
+    _cells.clear();
+    _text.clear();
+    const auto height = gsl::narrow_cast<size_t>(_viewport.Height());
+    _rows.assign(height, { _notCaptured, false });
+
+    for (const auto& dirty : dirtyAreas)
+    {
+        const auto top = std::max<ptrdiff_t>(dirty.top(), 0);
+        const auto bottom = std::min(dirty.bottom(), gsl::narrow_cast<ptrdiff_t>(height));
+        for (auto row = top; row < bottom; ++row)
+        {
+            if (til::at(_rows, row).firstCell == _notCaptured)
+            {
+                _CaptureRow(source, buffer, gsl::narrow_cast<SHORT>(row));
+            }
+        }
+    }
+
+    _selectionRects = source.GetSelectionRects();
+
+    _cursorPosition = source.GetCursorPosition();
+    _cursorVisible = source.IsCursorVisible();
+    _cursorOn = source.IsCursorOn();
+    _cursorHeight = source.GetCursorHeight();
+    _cursorStyle = source.GetCursorStyle();
+    _cursorPixelWidth = source.GetCursorPixelWidth();
+    _cursorColor = source.GetCursorColor();
+    _cursorDoubleWidth = source.IsCursorDoubleWidth();
+
+    _screenReversed = source.IsScreenReversed();
+    _gridLineDrawingAllowed = source.IsGridLineDrawingAllowed();
+    _title = source.GetConsoleTitle();
+}
+
+// Routine Description:
+// - Copies one row of the viewport.
+// Arguments:
+// - source - The render data to resolve the colors of new attributes with.
+// - buffer - The text buffer to copy from.
+// - row - The viewport-relative row to copy.
+// Return Value:
+// - <none>
+void RenderSnapshot::_CaptureRow(IRenderData& source, const TextBuffer& buffer, const SHORT row)
+{
+    const auto bufferRow = gsl::narrow_cast<SHORT>(_viewport.Top() + row);
+    const auto line = Viewport::FromDimensions({ _viewport.Left(), bufferRow }, { _viewport.Width(), 1 });
+
+    auto& captured = til::at(_rows, row);
+    captured.firstCell = _cells.size();
+    captured.wrapped = buffer.GetRowByOffset(bufferRow).GetCharRow().WasWrapForced();
+
+    // Consecutive cells mostly share their attribute, so only look it up when it changes.
+    std::optional<TextAttribute> lastAttr;
+    uint16_t attribute = 0;
+    for (auto it = buffer.GetCellDataAt(line.Origin(), line); it; ++it)
+    {
+        const auto attr = it->TextAttr();
+        if (!lastAttr || *lastAttr != attr)
+        {
+            attribute = _InternAttribute(source, attr);
+            lastAttr = attr;
+        }
+
+        const auto& chars = it->Chars();
+        _cells.push_back({ gsl::narrow<uint32_t>(_text.size()), gsl::narrow<uint16_t>(chars.size()), attribute, it->DbcsAttr() });
+        _text.insert(_text.end(), chars.begin(), chars.end());
+    }
+}
+
+// Routine Description:
+// - Returns the index of the given attribute in the attribute table, adding it
+//   (and the colors and hyperlink it resolves to) if it isn't there yet.
+// - A frame has only a handful of distinct attributes, so a linear search is fine.
+// Arguments:
+// - source - The render data to resolve the attribute with.
+// - attr - The attribute to look up.
+// Return Value:
+// - The index of the attribute.
+uint16_t RenderSnapshot::_InternAttribute(IRenderData& source, const TextAttribute& attr)
+{
+    const auto found = std::find(_attributes.begin(), _attributes.end(), attr);
+    if (found != _attributes.end())
+    {
+        return gsl::narrow_cast<uint16_t>(found - _attributes.begin());
+    }
+
+    _attributes.push_back(attr);
+    _colors.push_back(source.GetAttributeColors(attr));
+
+    if (attr.IsHyperlink())
+    {
+        const auto id = attr.GetHyperlinkId();
+        const auto known = std::find_if(_hyperlinks.begin(), _hyperlinks.end(), [&](const auto& hyperlink) { return hyperlink.id == id; });
+        if (known == _hyperlinks.end())
+        {
+            _hyperlinks.push_back({ id, source.GetHyperlinkUri(id), source.GetHyperlinkCustomId(id) });
+        }
+    }
+
+    return gsl::narrow<uint16_t>(_attributes.size() - 1);
+}
+
+// Routine Description:
+// - Returns an iterator over the captured cells of one row, limited to the
+//   given columns. If the row wasn't captured, the iterator is empty.
+// Arguments:
+// - at - The buffer position to start at.
+// - limit - The buffer area to stop at. Only its columns are used.
+// Return Value:
+// - An iterator for the requested cells.
+RenderSnapshot::CellIterator RenderSnapshot::GetCellDataAt(const COORD at, const Viewport limit) const noexcept
+{
+    const auto row = at.Y - _viewport.Top();
+    if (row < 0 || gsl::narrow_cast<size_t>(row) >= _rows.size() || til::at(_rows, row).firstCell == _notCaptured)
+    {
+        return { *this, nullptr, 0, 0 };
+    }
+
+    // Captured rows span the width of the viewport, so clamp the columns to it.
+    const auto left = std::max(at.X, _viewport.Left());
+    const auto right = std::min(limit.RightExclusive(), _viewport.RightExclusive());
+    const auto cells = _cells.data() + til::at(_rows, row).firstCell;
+    return { *this, cells, left - _viewport.Left(), right - _viewport.Left() };
+}
+
+// Routine Description:
+// - Returns whether the given buffer row was wrapped when it was captured.
+bool RenderSnapshot::WasWrapForced(const SHORT row) const noexcept
+{
+    const auto index = row - _viewport.Top();
+    return index >= 0 && gsl::narrow_cast<size_t>(index) < _rows.size() && til::at(_rows, index).wrapped;
+}
+
+// Routine Description:
+// - Returns the width of the text buffer the rows were captured from.
+SHORT RenderSnapshot::GetBufferWidth() const noexcept
+{
+    return _bufferWidth;
+}
+
+#pragma region IBaseData
+
+Viewport RenderSnapshot::GetViewport() noexcept
+{
+    return _viewport;
+}
+
+COORD RenderSnapshot::GetTextBufferEndPosition() const noexcept
+{
+    return _textBufferEnd;
+}
+
+// Routine Description:
+// - The text buffer and font aren't copied. These return the live objects of
+//   the data the snapshot was captured from, which may only be read with the
+//   console lock held. The renderer reads the text through GetCellDataAt.
+const TextBuffer& RenderSnapshot::GetTextBuffer() noexcept
+{
+    return _pSource->GetTextBuffer();
+}
+
+const FontInfo& RenderSnapshot::GetFontInfo() noexcept
+{
+    return _pSource->GetFontInfo();
+}
+
+std::vector<Viewport> RenderSnapshot::GetSelectionRects() noexcept
+{
+    return _selectionRects;
+}
+
+// Routine Description:
+// - The snapshot belongs to the render thread, so there's nothing to lock.
+void RenderSnapshot::LockConsole() noexcept
+{
+}
+
+void RenderSnapshot::UnlockConsole() noexcept
+{
+}
+
+#pragma endregion
+
+#pragma region IRenderData
+
+const TextAttribute RenderSnapshot::GetDefaultBrushColors() noexcept
+{
+    return _attributes.front();
+}
+
+// Routine Description:
+// - Returns the colors the given attribute resolved to when it was captured.
+//   Attributes that don't appear in the captured rows get the default colors.
+std::pair<COLORREF, COLORREF> RenderSnapshot::GetAttributeColors(const TextAttribute& attr) const noexcept
+{
+    const auto found = std::find(_attributes.begin(), _attributes.end(), attr);
+    const auto index = found != _attributes.end() ? found - _attributes.begin() : 0;
+    return til::at(_colors, index);
+}
+
+COORD RenderSnapshot::GetCursorPosition() const noexcept
+{
+    return _cursorPosition;
+}
+
+bool RenderSnapshot::IsCursorVisible() const noexcept
+{
+    return _cursorVisible;
+}
+
+bool RenderSnapshot::IsCursorOn() const noexcept
+{
+    return _cursorOn;
+}
+
+ULONG RenderSnapshot::GetCursorHeight() const noexcept
+{
+    return _cursorHeight;
+}
+
+CursorType RenderSnapshot::GetCursorStyle() const noexcept
+{
+    return _cursorStyle;
+}
+
+ULONG RenderSnapshot::GetCursorPixelWidth() const noexcept
+{
+    return _cursorPixelWidth;
+}
+
+COLORREF RenderSnapshot::GetCursorColor() const noexcept
+{
+    return _cursorColor;
+}
+
+bool RenderSnapshot::IsCursorDoubleWidth() const
+{
+    return _cursorDoubleWidth;
+}
+
+bool RenderSnapshot::IsScreenReversed() const noexcept
+{
+    return _screenReversed;
+}
+
+// Routine Description:
+// - Overlays are references into the live data, so they can't be part of a
+//   snapshot. The renderer paints frames with overlays under the lock instead.
+const std::vector<RenderOverlay> RenderSnapshot::GetOverlays() const noexcept
+{
+    return {};
+}
+
+const bool RenderSnapshot::IsGridLineDrawingAllowed() noexcept
+{
+    return _gridLineDrawingAllowed;
+}
+
+const std::wstring RenderSnapshot::GetConsoleTitle() const noexcept
+{
+    return _title;
+}
+
+const std::wstring RenderSnapshot::GetHyperlinkUri(uint16_t id) const noexcept
+{
+    const auto found = std::find_if(_hyperlinks.begin(), _hyperlinks.end(), [&](const auto& hyperlink) { return hyperlink.id == id; });
+    return found != _hyperlinks.end() ? found->uri : std::wstring{};
+}
+
+const std::wstring RenderSnapshot::GetHyperlinkCustomId(uint16_t id) const noexcept
+{
+    const auto found = std::find_if(_hyperlinks.begin(), _hyperlinks.end(), [&](const auto& hyperlink) { return hyperlink.id == id; });
+    return found != _hyperlinks.end() ? found->customId : std::wstring{};
+}
+
+#pragma endregion
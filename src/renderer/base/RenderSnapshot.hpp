@@ -0,0 +1,161 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- RenderSnapshot.hpp
+
+Abstract:
+- A copy of what the renderer needs to paint one frame for one engine: the text
+  and attributes of the rows the engine is about to repaint, the cursor, the
+  selection, the viewport, the title and the colors of every attribute used.
+- It's captured while the console lock is held. After that the lock can be
+  released and the frame painted from the copy while writers carry on.
+- Cells refer to their attribute by an index into a table of the distinct
+  attributes in the frame, which also holds the colors they resolved to.
+- The storage is kept between frames, so once it has grown to fit the viewport
+  capturing doesn't allocate anymore.
+--*/
+
+#pragma once
+
+#include "../inc/IRenderData.hpp"
+
+#include "../../buffer/out/OutputCellView.hpp"
+
+namespace Microsoft::Console::Render
+{
+    class RenderSnapshot final : public IRenderData
+    {
+    private:
+        struct Cell
+        {
+            uint32_t textOffset;
+            uint16_t textLength;
+            uint16_t attribute;
+            DbcsAttribute dbcsAttribute;
+        };
+
+    public:
+        // Walks the cells of one captured row, the same way a
+        // TextBufferCellIterator limited to that row would.
+        class CellIterator final
+        {
+        public:
+            CellIterator(const RenderSnapshot& snapshot, const Cell* const cells, const ptrdiff_t position, const ptrdiff_t end) noexcept;
+
+            operator bool() const noexcept;
+
+            CellIterator& operator+=(const ptrdiff_t movement) noexcept;
+            CellIterator& operator++() noexcept;
+
+            const OutputCellView& operator*() const noexcept;
+            const OutputCellView* operator->() const noexcept;
+
+        private:
+            void _GenerateView() noexcept;
+
+            const RenderSnapshot& _snapshot;
+            const Cell* _cells;
+            ptrdiff_t _position;
+            ptrdiff_t _end;
+            OutputCellView _view;
+        };
+
+        RenderSnapshot();
+
+        void Capture(IRenderData& source, const std::vector<til::rectangle>& dirtyAreas);
+
+        CellIterator GetCellDataAt(const COORD at, const Microsoft::Console::Types::Viewport limit) const noexcept;
+        bool WasWrapForced(const SHORT row) const noexcept;
+        SHORT GetBufferWidth() const noexcept;
+
+#pragma region IBaseData
+        Microsoft::Console::Types::Viewport GetViewport() noexcept override;
+        COORD GetTextBufferEndPosition() const noexcept override;
+        const TextBuffer& GetTextBuffer() noexcept override;
+        const FontInfo& GetFontInfo() noexcept override;
+
+        std::vector<Microsoft::Console::Types::Viewport> GetSelectionRects() noexcept override;
+
+        void LockConsole() noexcept override;
+        void UnlockConsole() noexcept override;
+#pragma endregion
+
+#pragma region IRenderData
+        const TextAttribute GetDefaultBrushColors() noexcept override;
+
+        std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept override;
+
+        COORD GetCursorPosition() const noexcept override;
+        bool IsCursorVisible() const noexcept override;
+        bool IsCursorOn() const noexcept override;
+        ULONG GetCursorHeight() const noexcept override;
+        CursorType GetCursorStyle() const noexcept override;
+        ULONG GetCursorPixelWidth() const noexcept override;
+        COLORREF GetCursorColor() const noexcept override;
+        bool IsCursorDoubleWidth() const override;
+
+        bool IsScreenReversed() const noexcept override;
+
+        const std::vector<RenderOverlay> GetOverlays() const noexcept override;
+
+        const bool IsGridLineDrawingAllowed() noexcept override;
+        const std::wstring GetConsoleTitle() const noexcept override;
+
+        const std::wstring GetHyperlinkUri(uint16_t id) const noexcept override;
+        const std::wstring GetHyperlinkCustomId(uint16_t id) const noexcept override;
+#pragma endregion
+
+    private:
+        static constexpr size_t _notCaptured = std::numeric_limits<size_t>::max();
+
+        struct Hyperlink
+        {
+            uint16_t id;
+            std::wstring uri;
+            std::wstring customId;
+        };
+
+        void _CaptureRow(IRenderData& source, const TextBuffer& buffer, const SHORT row);
+        uint16_t _InternAttribute(IRenderData& source, const TextAttribute& attr);
+
+        IRenderData* _pSource;
+
+        Microsoft::Console::Types::Viewport _viewport;
+        SHORT _bufferWidth;
+        COORD _textBufferEnd;
+
+        struct Row
+        {
+            size_t firstCell; // _notCaptured if the row wasn't dirty
+            bool wrapped;
+        };
+
+        // One entry per row of the viewport.
+        std::vector<Row> _rows;
+        std::vector<Cell> _cells;
+        std::vector<wchar_t> _text;
+
+        // The distinct attributes in this frame and the colors they resolved to.
+        // The first entry is always the default brush colors.
+        std::vector<TextAttribute> _attributes;
+        std::vector<std::pair<COLORREF, COLORREF>> _colors;
+        std::vector<Hyperlink> _hyperlinks;
+
+        std::vector<Microsoft::Console::Types::Viewport> _selectionRects;
+
+        COORD _cursorPosition;
+        bool _cursorVisible;
+        bool _cursorOn;
+        ULONG _cursorHeight;
+        CursorType _cursorStyle;
+        ULONG _cursorPixelWidth;
+        COLORREF _cursorColor;
+        bool _cursorDoubleWidth;
+
+        bool _screenReversed;
+        bool _gridLineDrawingAllowed;
+        std::wstring _title;
+    };
+}
@@ -0,0 +1,191 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "SelectionTracker.hpp"
+
+#pragma hdrstop
+
+using namespace Microsoft::Console::Render;
+
+// Routine Description:
+// - Replaces the selection with the given one and finds the cells whose
+//   selected state differs between the two.
+// Arguments:
+// - rectangles - the new selection, as exclusive rectangles relative to the viewport
+// - viewport - the size of the viewport. The changes are clipped to it.
+// - changes - receives the regions that changed, as exclusive rectangles.
+//             Consecutive rows with the same changed columns are merged.
+// Return Value:
+// - true if the selection changed at all, even if only outside of the viewport.
+bool SelectionTracker::Update(const std::vector<SMALL_RECT>& rectangles,
+                              const til::size viewport,
+                              std::vector<SMALL_RECT>& changes)
+{
+    changes.clear();
+
+    _ToSpans(rectangles, _next);
+
+    _changed.clear();
+    auto a = _spans.data();
+    const auto aEnd = a + _spans.size();
+    auto b = _next.data();
+    const auto bEnd = b + _next.size();
+    while (a != aEnd || b != bEnd)
+    {
+        // Take all the spans of the next row either selection has.
+        const auto row = a == aEnd ? b->row : b == bEnd ? a->row : std::min(a->row, b->row);
+        const auto aRow = std::find_if(a, aEnd, [row](const Span& span) { return span.row != row; });
+        const auto bRow = std::find_if(b, bEnd, [row](const Span& span) { return span.row != row; });
+        _AppendDifference(a, aRow, b, bRow, _changed);
+        a = aRow;
+        b = bRow;
+    }
+
+    std::swap(_spans, _next);
+
+    for (const auto& span : _changed)
+    {
+        const auto left = std::max<ptrdiff_t>(span.left, 0);
+        const auto right = std::min(span.right, viewport.width());
+        if (span.row < 0 || span.row >= viewport.height() || left >= right)
+        {
+            continue;
+        }
+
+        const SMALL_RECT rect{
+            gsl::narrow_cast<SHORT>(left),
+            gsl::narrow_cast<SHORT>(span.row),
+            gsl::narrow_cast<SHORT>(right),
+            gsl::narrow_cast<SHORT>(span.row + 1)
+        };
+
+        if (!changes.empty())
+        {
+            auto& last = changes.back();
+            if (last.Bottom == rect.Top && last.Left == rect.Left && last.Right == rect.Right)
+            {
+                last.Bottom = rect.Bottom;
+                continue;
+            }
+        }
+        changes.push_back(rect);
+    }
+
+    return !_changed.empty();
+}
+
+// Routine Description:
+// - Moves the selection along with the contents of the viewport.
+// Arguments:
+// - delta - how far the contents moved
+// Return Value:
+// - <none>
+void SelectionTracker::Scroll(const til::point delta) noexcept
+{
+    for (auto& span : _spans)
+    {
+        span.row += delta.y();
+        span.left += delta.x();
+        span.right += delta.x();
+    }
+}
+
+// Routine Description:
+// - Splits the given rectangles into rows, and merges the spans that overlap or touch.
+// Arguments:
+// - rectangles - exclusive rectangles
+// - spans - receives the spans, sorted by row and column
+// Return Value:
+// - <none>
+void SelectionTracker::_ToSpans(const std::vector<SMALL_RECT>& rectangles, std::vector<Span>& spans)
+{
+    spans.clear();
+    for (const auto& rect : rectangles)
+    {
+        if (rect.Left < rect.Right)
+        {
+            for (ptrdiff_t row = rect.Top; row < rect.Bottom; ++row)
+            {
+                spans.push_back({ row, rect.Left, rect.Right });
+            }
+        }
+    }
+
+    std::sort(spans.begin(), spans.end(), [](const Span& lhs, const Span& rhs) {
+        return lhs.row != rhs.row ? lhs.row < rhs.row : lhs.left < rhs.left;
+    });
+
+    // The rectangles of a selection are usually one per row and already in
+    // order, so this rarely merges anything.
+    auto out = spans.begin();
+    for (auto it = spans.begin(); it != spans.end(); ++it)
+    {
+        if (out != spans.begin())
+        {
+            auto& last = *(out - 1);
+            if (last.row == it->row && it->left <= last.right)
+            {
+                last.right = std::max(last.right, it->right);
+                continue;
+            }
+        }
+        *out++ = *it;
+    }
+    spans.erase(out, spans.end());
+}
+
+// Routine Description:
+// - Appends the columns that are in exactly one of the two given sets of
+//   spans, which are all on the same row.
+// Arguments:
+// - a, aEnd - the first spans, sorted and not touching
+// - b, bEnd - the second spans, sorted and not touching
+// - out - receives the difference
+// Return Value:
+// - <none>
+void SelectionTracker::_AppendDifference(const Span* a, const Span* const aEnd, const Span* b, const Span* const bEnd, std::vector<Span>& out)
+{
+    // Walk every boundary of either set in order. Between two boundaries, a
+    // column is either in a set or not, so the same goes for all of them.
+    auto inA = false;
+    auto inB = false;
+    auto start = std::numeric_limits<ptrdiff_t>::min();
+
+    while (a != aEnd || b != bEnd)
+    {
+        const auto aNext = a == aEnd ? std::numeric_limits<ptrdiff_t>::max() : inA ? a->right : a->left;
+        const auto bNext = b == bEnd ? std::numeric_limits<ptrdiff_t>::max() : inB ? b->right : b->left;
+        const auto position = std::min(aNext, bNext);
+        const auto row = a != aEnd ? a->row : b->row;
+
+        const auto wasDifferent = inA != inB;
+        if (aNext == position)
+        {
+            inA = !inA;
+            if (!inA)
+            {
+                ++a;
+            }
+        }
+        if (bNext == position)
+        {
+            inB = !inB;
+            if (!inB)
+            {
+                ++b;
+            }
+        }
+        const auto isDifferent = inA != inB;
+
+        if (isDifferent && !wasDifferent)
+        {
+            start = position;
+        }
+        else if (wasDifferent && !isDifferent)
+        {
+            out.push_back({ row, start, position });
+        }
+    }
+}
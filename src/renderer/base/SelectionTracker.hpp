@@ -0,0 +1,48 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- SelectionTracker.hpp
+
+Abstract:
+- Remembers the selection that the engines were last told about, as one span
+  of columns per row, so that when the selection changes only the cells that
+  went in or out of it need to be invalidated and repainted. Dragging the end
+  of a selection that covers many rows then touches a cell or two instead of
+  all the rows the old and the new selection cover.
+- Everything is relative to the viewport. The spans are kept as they were
+  given, so a selection that extends outside of the viewport is still known
+  correctly after it's scrolled back into view.
+--*/
+
+#pragma once
+
+namespace Microsoft::Console::Render
+{
+    class SelectionTracker final
+    {
+    public:
+        bool Update(const std::vector<SMALL_RECT>& rectangles,
+                    const til::size viewport,
+                    std::vector<SMALL_RECT>& changes);
+        void Scroll(const til::point delta) noexcept;
+
+    private:
+        // The selected columns [left, right) of a row.
+        struct Span
+        {
+            ptrdiff_t row;
+            ptrdiff_t left;
+            ptrdiff_t right;
+        };
+
+        static void _ToSpans(const std::vector<SMALL_RECT>& rectangles, std::vector<Span>& spans);
+        static void _AppendDifference(const Span* a, const Span* const aEnd, const Span* b, const Span* const bEnd, std::vector<Span>& out);
+
+        // Sorted by row and then by column. Spans on the same row don't touch.
+        std::vector<Span> _spans;
+        std::vector<Span> _next;
+        std::vector<Span> _changed;
+    };
+}
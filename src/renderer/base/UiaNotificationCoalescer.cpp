@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "UiaNotificationCoalescer.hpp"
+
+#pragma hdrstop
+
+using namespace Microsoft::Console::Render;
+using namespace std::chrono;
+
+UiaNotificationCoalescer::UiaNotificationCoalescer() :
+    UiaNotificationCoalescer(&steady_clock::now)
+{
+}
+
+UiaNotificationCoalescer::UiaNotificationCoalescer(Clock clock) :
+    _clock{ std::move(clock) },
+    _lastTaken{},
+    _pending{}
+{
+}
+
+// Routine Description:
+// - Records that the text changed.
+void UiaNotificationCoalescer::TextChanged() noexcept
+{
+    _pending.textChanged = true;
+}
+
+// Routine Description:
+// - Records that the selection changed.
+void UiaNotificationCoalescer::SelectionChanged() noexcept
+{
+    _pending.selectionChanged = true;
+}
+
+// Routine Description:
+// - Records that the cursor moved.
+void UiaNotificationCoalescer::CursorChanged() noexcept
+{
+    _pending.cursorChanged = true;
+}
+
+// Routine Description:
+// - Returns true if there are changes that haven't been handed out yet,
+//   whether or not their window has closed.
+bool UiaNotificationCoalescer::HasPending() const noexcept
+{
+    return _pending.textChanged || _pending.selectionChanged || _pending.cursorChanged;
+}
+
+// Routine Description:
+// - Hands out the changes collected so far, unless the window that started
+//   with the last notification is still open.
+// Arguments:
+// - <none>
+// Return Value:
+// - the merged changes, or nullopt if there are none or it's too early.
+//   In that case the changes are kept for later.
+std::optional<UiaNotificationCoalescer::Notification> UiaNotificationCoalescer::Take()
+{
+    if (!HasPending())
+    {
+        return std::nullopt;
+    }
+
+    const auto now = _clock();
+    if (_lastTaken && now - *_lastTaken < Window)
+    {
+        return std::nullopt;
+    }
+
+    _lastTaken = now;
+    return std::exchange(_pending, Notification{});
+}
@@ -0,0 +1,53 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- UiaNotificationCoalescer.hpp
+
+Abstract:
+- Collects the changes that automation clients are told about (text,
+  selection and cursor) and hands them out at most once per time window.
+- The first change after a quiet window is handed out right away. Changes
+  that come in while the window is still open are merged, and handed out
+  together once it closes.
+  That way a flood of output costs one text changed event per window,
+  instead of one per frame.
+- This knows nothing about UIA itself. The clock is injectable so the policy
+  can be tested without sleeping.
+--*/
+
+#pragma once
+
+namespace Microsoft::Console::Render
+{
+    class UiaNotificationCoalescer final
+    {
+    public:
+        using Clock = std::function<std::chrono::steady_clock::time_point()>;
+
+        static constexpr std::chrono::milliseconds Window{ 100 };
+
+        struct Notification
+        {
+            bool textChanged;
+            bool selectionChanged;
+            bool cursorChanged;
+        };
+
+        UiaNotificationCoalescer();
+        explicit UiaNotificationCoalescer(Clock clock);
+
+        void TextChanged() noexcept;
+        void SelectionChanged() noexcept;
+        void CursorChanged() noexcept;
+
+        bool HasPending() const noexcept;
+        std::optional<Notification> Take();
+
+    private:
+        Clock _clock;
+        std::optional<std::chrono::steady_clock::time_point> _lastTaken;
+        Notification _pending;
+    };
+}
@@ -27,6 +27,7 @@ Renderer::Renderer(IRenderData* pData,
                    const size_t cEngines,
                    std::unique_ptr<IRenderThread> thread) :
     _pData(THROW_HR_IF_NULL(E_INVALIDARG, pData)),
+    _pPaintData(pData),
     _pThread{ std::move(thread) },
     _destructing{ false },
     _clusterBuffer{},
@@ -99,6 +100,13 @@ Renderer::~Renderer()
             LOG_IF_FAILED(hr);
             break;
         }
+
+        // This isn't output, so it mustn't count towards the pacer's
+        // back-off: frames that paint nothing would slow down the real ones.
+        if (pEngine->RequiresContinuousRedraw() && _pThread)
+        {
+            _pThread->NotifyRedraw();
+        }
     }
 
     return S_OK;
@@ -114,9 +122,14 @@ try
         _pData->UnlockConsole();
     });
 
+    std::unique_lock<std::mutex> paintLock{ _paintLock };
+
     // Last chance check if anything scrolled without an explicit invalidate notification since the last frame.
     _CheckViewportAndScroll();
 
+    // Hand everything the writers invalidated since the last frame to the engines that defer it.
+    _ApplyPendingInvalidations();
+
     // Try to start painting a frame
     HRESULT const hr = pEngine->StartPaint();
     RETURN_IF_FAILED(hr);
@@ -133,8 +146,28 @@ try
         LOG_IF_FAILED(pEngine->EndPaint());
     });
 
+    // Engines that are invalidated synchronously are told about changes while
+    // the writers hold the lock, so they have to keep painting under it as well.
+    // So do engines that the host changes directly while holding the lock (see
+    // PaintUnderConsoleLock), and frames with overlays (IME composition), which
+    // are only references into the live data. Everything else gets a copy of
+    // the rows it is about to repaint, and the lock is released before painting
+    // starts.
+    if (!pEngine->RequiresSynchronousInvalidation() &&
+        std::find(_lockedEngines.begin(), _lockedEngines.end(), pEngine) == _lockedEngines.end() &&
+        _pData->GetOverlays().empty())
+    {
+        _snapshot.Capture(*_pData, pEngine->GetDirtyArea());
+        _pPaintData = &_snapshot;
+        unlock.reset();
+    }
+
+    auto restorePaintData = wil::scope_exit([&]() {
+        _pPaintData = _pData;
+    });
+
     // A. Prep Colors
-    RETURN_IF_FAILED(_UpdateDrawingBrushes(pEngine, _pData->GetDefaultBrushColors(), true));
+    RETURN_IF_FAILED(_UpdateDrawingBrushes(pEngine, _pPaintData->GetDefaultBrushColors(), true));
 
     // B. Perform Scroll Operations
     RETURN_IF_FAILED(_PerformScrolling(pEngine));
@@ -164,6 +197,7 @@ try
     endPaint.reset();
 
     // Force scope exit unlock to let go of global lock so other threads can run
+    // (unless it was already let go of before painting from the snapshot)
     unlock.reset();
 
     // Trigger out-of-lock presentation for renderers that can support it
@@ -192,6 +226,7 @@ void Renderer::_NotifyPaintFrame()
 // - <none>
 void Renderer::TriggerSystemRedraw(const RECT* const prcDirtyClient)
 {
+    std::lock_guard<std::mutex> paintLock{ _paintLock };
     std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
         LOG_IF_FAILED(pEngine->InvalidateSystem(prcDirtyClient));
     });
@@ -213,9 +248,11 @@ void Renderer::TriggerRedraw(const Viewport& region)
     if (view.TrimToViewport(&srUpdateRegion))
     {
         view.ConvertToOrigin(&srUpdateRegion);
-        std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
+        for (IRenderEngine* const pEngine : _synchronousEngines)
+        {
             LOG_IF_FAILED(pEngine->Invalidate(&srUpdateRegion));
-        });
+        }
+        _invalidations.Invalidate(srUpdateRegion);
 
         _NotifyPaintFrame();
     }
@@ -249,17 +286,19 @@ void Renderer::TriggerRedrawCursor(const COORD* const pcoord)
     if (view.IsInBounds(updateCoord))
     {
         view.ConvertToOrigin(&updateCoord);
-        for (IRenderEngine* pEngine : _rgpEngines)
+        const bool doubleWidth = _pData->IsCursorDoubleWidth();
+        for (IRenderEngine* pEngine : _synchronousEngines)
         {
             LOG_IF_FAILED(pEngine->InvalidateCursor(&updateCoord));
 
             // Double-wide cursors need to invalidate the right half as well.
-            if (_pData->IsCursorDoubleWidth())
+            if (doubleWidth)
             {
-                updateCoord.X++;
-                LOG_IF_FAILED(pEngine->InvalidateCursor(&updateCoord));
+                const COORD rightHalf{ gsl::narrow_cast<SHORT>(updateCoord.X + 1), updateCoord.Y };
+                LOG_IF_FAILED(pEngine->InvalidateCursor(&rightHalf));
             }
         }
+        _invalidations.InvalidateCursor(updateCoord, doubleWidth);
 
         _NotifyPaintFrame();
     }
@@ -274,9 +313,11 @@ void Renderer::TriggerRedrawCursor(const COORD* const pcoord)
 // - <none>
 void Renderer::TriggerRedrawAll()
 {
-    std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
+    for (IRenderEngine* const pEngine : _synchronousEngines)
+    {
         LOG_IF_FAILED(pEngine->InvalidateAll());
-    });
+    }
+    _invalidations.InvalidateAll();
 
     _NotifyPaintFrame();
 }
@@ -309,41 +350,41 @@ void Renderer::TriggerTeardown()
 
 // Routine Description:
 // - Called when the selected area in the console has changed.
+// - The selection rectangles are only computed once per frame, when the
+//   engines are told about the invalidations (see _ApplyPendingInvalidations).
 // Arguments:
 // - <none>
 // Return Value:
 // - <none>
 void Renderer::TriggerSelection()
+{
+    _invalidations.InvalidateSelection();
+    _NotifyPaintFrame();
+}
+
+// Routine Description:
+// - Invalidates the cells that went into or out of the selection since it was
+//   last invalidated, on all engines. Cells that stayed selected (or stayed
+//   unselected) are left alone. Engines aren't called at all if nothing changed.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_InvalidateSelection()
 {
     try
     {
         // Get selection rectangles
         const auto rects = _GetSelectionRects();
 
-        // Restrict all previous selection rectangles to inside the current viewport bounds
-        for (auto& sr : _previousSelection)
+        // Only the changes inside the current viewport bounds are given to the engines.
+        const til::size viewport{ _pData->GetViewport().Dimensions() };
+        if (_selection.Update(rects, viewport, _selectionChanges))
         {
-            // Make the exclusive SMALL_RECT into a til::rectangle.
-            til::rectangle rc{ Viewport::FromExclusive(sr).ToInclusive() };
-
-            // Make a viewport representing the coordinates that are currently presentable.
-            const til::rectangle viewport{ til::size{ _pData->GetViewport().Dimensions() } };
-
-            // Intersect them so we only invalidate things that are still visible.
-            rc &= viewport;
-
-            // Convert back into the exclusive SMALL_RECT and store in the vector.
-            sr = Viewport::FromInclusive(rc).ToExclusive();
+            std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
+                LOG_IF_FAILED(pEngine->InvalidateSelection(_selectionChanges));
+            });
         }
-
-        std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
-            LOG_IF_FAILED(pEngine->InvalidateSelection(_previousSelection));
-            LOG_IF_FAILED(pEngine->InvalidateSelection(rects));
-        });
-
-        _previousSelection = rects;
-
-        _NotifyPaintFrame();
     }
     CATCH_LOG();
 }
@@ -363,32 +404,135 @@ bool Renderer::_CheckViewportAndScroll()
     coordDelta.X = srOldViewport.Left - srNewViewport.Left;
     coordDelta.Y = srOldViewport.Top - srNewViewport.Top;
 
-    for (auto engine : _rgpEngines)
+    // The other engines are told about the new viewport at the start of the
+    // next frame (see _ApplyPendingInvalidations), since one of them may be
+    // in the middle of painting one right now.
+    for (auto engine : _synchronousEngines)
     {
         LOG_IF_FAILED(engine->UpdateViewport(srNewViewport));
     }
 
     _viewport = Viewport::FromInclusive(srNewViewport);
 
+    if (coordDelta.X != 0 || coordDelta.Y != 0)
+    {
+        for (auto engine : _synchronousEngines)
+        {
+            LOG_IF_FAILED(engine->InvalidateScroll(&coordDelta));
+        }
+        _invalidations.InvalidateScroll(coordDelta);
+
+        _selection.Scroll(coordDelta);
+
+        return true;
+    }
+
+    return false;
+}
+
+// Routine Description:
+// - Hands the invalidations collected since the last frame to the engines that
+//   don't require them synchronously. Writers only record into the accumulator,
+//   so this is the one place per frame where those engines are walked.
+// - The same goes for the viewport and the title. Writers who change them
+//   don't call into those engines, so they never wait for a frame that's being
+//   painted without the console lock.
+// - The frame's scroll is applied first. The accumulator has already shifted
+//   the regions and cursor positions by it, so each engine ends up with the
+//   same invalid area it would have had if it had seen every call in order.
+// - Must be called with the console lock held. Writers record under the same
+//   lock, which keeps the scroll and the regions recorded around it consistent.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_ApplyPendingInvalidations()
+{
+    const auto viewport = _viewport.ToInclusive();
+    for (IRenderEngine* const pEngine : _deferredEngines)
+    {
+        LOG_IF_FAILED(pEngine->UpdateViewport(viewport));
+    }
+
     // If we're keeping some buffers between calls, let them know about the viewport size
     // so they can prepare the buffers for changes to either preallocate memory at once
     // (instead of growing naturally) or shrink down to reduce usage as appropriate.
-    const size_t lineLength = gsl::narrow_cast<size_t>(til::rectangle{ srNewViewport }.width());
+    const size_t lineLength = gsl::narrow_cast<size_t>(_viewport.Width());
     til::manage_vector(_clusterBuffer, lineLength, _shrinkThreshold);
 
-    if (coordDelta.X != 0 || coordDelta.Y != 0)
+    if (_titleChanged.exchange(false))
     {
-        for (auto engine : _rgpEngines)
+        const std::wstring newTitle = _pData->GetConsoleTitle();
+        for (IRenderEngine* const pEngine : _deferredEngines)
         {
-            LOG_IF_FAILED(engine->InvalidateScroll(&coordDelta));
+            LOG_IF_FAILED(pEngine->InvalidateTitle(newTitle));
         }
+    }
+
+    if (!_invalidations.HasPending())
+    {
+        return;
+    }
 
-        _ScrollPreviousSelection(coordDelta);
+    _invalidations.Drain(_pendingInvalidations);
+    const auto& frame = _pendingInvalidations;
 
-        return true;
+    const auto viewportSize = _viewport.Dimensions();
+    constexpr ptrdiff_t maxShort = std::numeric_limits<SHORT>::max();
+    const bool scrollFits = std::abs(frame.scroll.x()) <= maxShort && std::abs(frame.scroll.y()) <= maxShort;
+
+    for (IRenderEngine* const pEngine : _deferredEngines)
+    {
+        if (!scrollFits)
+        {
+            // Everything moved further than an engine could represent, so nothing
+            // it has invalidated (or painted) is of any use anymore.
+            LOG_IF_FAILED(pEngine->InvalidateAll());
+        }
+        else if (frame.scroll != til::point{})
+        {
+            const COORD delta{ gsl::narrow_cast<SHORT>(frame.scroll.x()), gsl::narrow_cast<SHORT>(frame.scroll.y()) };
+            LOG_IF_FAILED(pEngine->InvalidateScroll(&delta));
+        }
+
+        if (frame.all)
+        {
+            LOG_IF_FAILED(pEngine->InvalidateAll());
+        }
+
+        for (auto region : frame.regions)
+        {
+            region.Right = std::min(region.Right, viewportSize.X);
+            region.Bottom = std::min(region.Bottom, viewportSize.Y);
+            if (region.Left < region.Right && region.Top < region.Bottom)
+            {
+                LOG_IF_FAILED(pEngine->Invalidate(&region));
+            }
+        }
+
+        for (const auto& position : frame.cursors)
+        {
+            if (position.x() < viewportSize.X && position.y() < viewportSize.Y)
+            {
+                COORD coord{ gsl::narrow_cast<SHORT>(position.x()), gsl::narrow_cast<SHORT>(position.y()) };
+                LOG_IF_FAILED(pEngine->InvalidateCursor(&coord));
+
+                // Double-wide cursors need to invalidate the right half as well.
+                if (frame.cursorDoubleWidth)
+                {
+                    coord.X++;
+                    LOG_IF_FAILED(pEngine->InvalidateCursor(&coord));
+                }
+            }
+        }
     }
 
-    return false;
+    // The selection is computed now, once, and goes to every engine. It's
+    // relative to the current viewport, so it has to come after the scroll.
+    if (frame.selection)
+    {
+        _InvalidateSelection();
+    }
 }
 
 // Routine Description:
@@ -417,11 +561,13 @@ void Renderer::TriggerScroll()
 // - <none>
 void Renderer::TriggerScroll(const COORD* const pcoordDelta)
 {
-    std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
+    for (IRenderEngine* const pEngine : _synchronousEngines)
+    {
         LOG_IF_FAILED(pEngine->InvalidateScroll(pcoordDelta));
-    });
+    }
+    _invalidations.InvalidateScroll(*pcoordDelta);
 
-    _ScrollPreviousSelection(*pcoordDelta);
+    _selection.Scroll(*pcoordDelta);
 
     _NotifyPaintFrame();
 }
@@ -429,13 +575,15 @@ void Renderer::TriggerScroll(const COORD* const pcoordDelta)
 // Routine Description:
 // - Called when the text buffer is about to circle its backing buffer.
 //      A renderer might want to get painted before that happens.
+// - Only the engines that are invalidated synchronously (VT) care. The others
+//   aren't asked, so writers don't wait for a frame they're painting.
 // Arguments:
 // - <none>
 // Return Value:
 // - <none>
 void Renderer::TriggerCircling()
 {
-    for (IRenderEngine* const pEngine : _rgpEngines)
+    for (IRenderEngine* const pEngine : _synchronousEngines)
     {
         bool fEngineRequestsRepaint = false;
         HRESULT hr = pEngine->InvalidateCircling(&fEngineRequestsRepaint);
@@ -458,13 +606,43 @@ void Renderer::TriggerCircling()
 void Renderer::TriggerTitleChange()
 {
     const std::wstring newTitle = _pData->GetConsoleTitle();
-    for (IRenderEngine* const pEngine : _rgpEngines)
+    for (IRenderEngine* const pEngine : _synchronousEngines)
     {
         LOG_IF_FAILED(pEngine->InvalidateTitle(newTitle));
     }
+
+    // The other engines get the title at the start of the next frame.
+    _titleChanged = true;
     _NotifyPaintFrame();
 }
 
+// Routine Description:
+// - Called when the user typed or clicked into the console. Lets the render
+//      thread paint the next frame (most likely an echo) without delay.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::NotifyUserInput()
+{
+    // If we're running in the unittests, we might not have a render thread.
+    if (_pThread)
+    {
+        _pThread->NotifyUserInput();
+    }
+}
+
+// Method Description:
+// - Returns timing information about the frames the render thread painted so far.
+// Arguments:
+// - <none>
+// Return Value:
+// - A snapshot of the frame statistics, or empty statistics without a render thread.
+FrameStats Renderer::GetFrameStats() const
+{
+    return _pThread ? _pThread->GetFrameStats() : FrameStats{};
+}
+
 // Routine Description:
 // - Update the title for a particular engine.
 // Arguments:
@@ -473,7 +651,7 @@ void Renderer::TriggerTitleChange()
 // - the HRESULT of the underlying engine's UpdateTitle call.
 HRESULT Renderer::_PaintTitle(IRenderEngine* const pEngine)
 {
-    const std::wstring newTitle = _pData->GetConsoleTitle();
+    const std::wstring newTitle = _pPaintData->GetConsoleTitle();
     return pEngine->UpdateTitle(newTitle);
 }
 
@@ -487,10 +665,14 @@ HRESULT Renderer::_PaintTitle(IRenderEngine* const pEngine)
 // - <none>
 void Renderer::TriggerFontChange(const int iDpi, const FontInfoDesired& FontInfoDesired, _Out_ FontInfo& FontInfo)
 {
-    std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
-        LOG_IF_FAILED(pEngine->UpdateDpi(iDpi));
-        LOG_IF_FAILED(pEngine->UpdateFont(FontInfoDesired, FontInfo));
-    });
+    {
+        std::lock_guard<std::mutex> paintLock{ _paintLock };
+        std::lock_guard<std::mutex> measureLock{ _measureLock };
+        std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
+            LOG_IF_FAILED(pEngine->UpdateDpi(iDpi));
+            LOG_IF_FAILED(pEngine->UpdateFont(FontInfoDesired, FontInfo));
+        });
+    }
 
     _NotifyPaintFrame();
 }
@@ -520,6 +702,7 @@ void Renderer::TriggerFontChange(const int iDpi, const FontInfoDesired& FontInfo
     //      Only return the result of the successful one if it's not S_FALSE (which is the VT renderer)
     // TODO: 14560740 - The Window might be able to get at this info in a more sane manner
     FAIL_FAST_IF(!(_rgpEngines.size() <= 2));
+    std::lock_guard<std::mutex> paintLock{ _paintLock };
     for (IRenderEngine* const pEngine : _rgpEngines)
     {
         const HRESULT hr = LOG_IF_FAILED(pEngine->GetProposedFont(FontInfoDesired, FontInfo, iDpi));
@@ -538,6 +721,9 @@ void Renderer::TriggerFontChange(const int iDpi, const FontInfoDesired& FontInfo
 // full-width (inscribed in a square, twice as wide as a standard Western character, typically used for CJK
 // languages) or half-width.
 // - Typically used to determine how many positions in the backing buffer a particular character should fill.
+// - Writers call this with the console lock held, so it doesn't wait for the
+//   frame that's being painted. The engines measure with their own objects,
+//   which only change along with the font.
 // NOTE: This only handles 1 or 2 wide (in monospace terms) characters.
 // Arguments:
 // - glyph - the utf16 encoded codepoint to test
@@ -552,6 +738,7 @@ bool Renderer::IsGlyphWideByFont(const std::wstring_view glyph)
     //      Only return the result of the successful one if it's not S_FALSE (which is the VT renderer)
     // TODO: 14560740 - The Window might be able to get at this info in a more sane manner
     FAIL_FAST_IF(!(_rgpEngines.size() <= 2));
+    std::lock_guard<std::mutex> measureLock{ _measureLock };
     for (IRenderEngine* const pEngine : _rgpEngines)
     {
         const HRESULT hr = LOG_IF_FAILED(pEngine->IsGlyphWideByFont(glyph, &fIsFullWidth));
@@ -613,7 +800,7 @@ void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
     // This is the subsection of the entire screen buffer that is currently being presented.
     // It can move left/right or top/bottom depending on how the viewport is scrolled
     // relative to the entire buffer.
-    const auto view = _pData->GetViewport();
+    const auto view = _pPaintData->GetViewport();
 
     // This is effectively the number of cells on the visible screen that need to be redrawn.
     // The origin is always 0, 0 because it represents the screen itself, not the underlying buffer.
@@ -635,9 +822,6 @@ void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
         // Shortcut: don't bother redrawing if the width is 0.
         if (redraw.Width() > 0)
         {
-            // Retrieve the text buffer so we can read information out of it.
-            const auto& buffer = _pData->GetTextBuffer();
-
             // Now walk through each row of text that we need to redraw.
             for (auto row = redraw.Top(); row < redraw.BottomExclusive(); row++)
             {
@@ -652,6 +836,20 @@ void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
                 // This means that we need 14,27 out of the backing buffer to fill in the 1,1 cell of the screen.
                 const auto screenLine = Viewport::Offset(bufferLine, -view.Origin());
 
+                // The snapshot only holds the rows of the viewport, and the lock
+                // may already be gone, so the text buffer is off limits.
+                if (_pPaintData == &_snapshot)
+                {
+                    const auto lineWrapped = _snapshot.WasWrapForced(bufferLine.Origin().Y) &&
+                                             (bufferLine.RightExclusive() == _snapshot.GetBufferWidth());
+
+                    _PaintBufferOutputHelper(pEngine, _snapshot.GetCellDataAt(bufferLine.Origin(), bufferLine), screenLine.Origin(), lineWrapped);
+                    continue;
+                }
+
+                // Retrieve the text buffer so we can read information out of it.
+                const auto& buffer = _pData->GetTextBuffer();
+
                 // Retrieve the cell information iterator limited to just this line we want to redraw.
                 auto it = buffer.GetCellDataAt(bufferLine.Origin(), bufferLine);
 
@@ -675,12 +873,16 @@ static bool _IsAllSpaces(const std::wstring_view v)
     return v.find_first_not_of(L" ") == decltype(v)::npos;
 }
 
+// Routine Description:
+// - Paints one line of cells, one run of identical attributes at a time.
+// - Works with both TextBufferCellIterator and RenderSnapshot::CellIterator.
+template<typename TIterator>
 void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
-                                        TextBufferCellIterator it,
+                                        TIterator it,
                                         const COORD target,
                                         const bool lineWrapped)
 {
-    auto globalInvert{ _pData->IsScreenReversed() };
+    auto globalInvert{ _pPaintData->IsScreenReversed() };
 
     // If we have valid data, let's figure out how to draw it.
     if (it)
@@ -794,7 +996,7 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
 
             // If we're allowed to do grid drawing, draw that now too (since it will be coupled with the color data)
             // We're only allowed to draw the grid lines under certain circumstances.
-            if (_pData->IsGridLineDrawingAllowed())
+            if (_pPaintData->IsGridLineDrawingAllowed())
             {
                 // See GH: 803
                 // If we found a wide character while we looped above, it's possible we skipped over the right half
@@ -904,7 +1106,7 @@ void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngin
     if (lines != IRenderEngine::GridLines::None)
     {
         // Get the current foreground color to render the lines.
-        const COLORREF rgb = _pData->GetAttributeColors(textAttribute).first;
+        const COLORREF rgb = _pPaintData->GetAttributeColors(textAttribute).first;
         // Draw the lines
         LOG_IF_FAILED(pEngine->PaintBufferGridLines(lines, rgb, cchLine, coordTarget));
     }
@@ -922,35 +1124,35 @@ void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngin
 // - nullopt if the cursor is off or out-of-frame, otherwise a CursorOptions
 [[nodiscard]] std::optional<CursorOptions> Renderer::_GetCursorInfo()
 {
-    if (_pData->IsCursorVisible())
+    if (_pPaintData->IsCursorVisible())
     {
         // Get cursor position in buffer
-        COORD coordCursor = _pData->GetCursorPosition();
+        COORD coordCursor = _pPaintData->GetCursorPosition();
 
         // GH#3166: Only draw the cursor if it's actually in the viewport. It
         // might be on the line that's in that partially visible row at the
         // bottom of the viewport, the space that's not quite a full line in
         // height. Since we don't draw that text, we shouldn't draw the cursor
         // there either.
-        Viewport view = _pData->GetViewport();
+        Viewport view = _pPaintData->GetViewport();
         if (view.IsInBounds(coordCursor))
         {
             // Adjust cursor to viewport
             view.ConvertToOrigin(&coordCursor);
 
-            COLORREF cursorColor = _pData->GetCursorColor();
+            COLORREF cursorColor = _pPaintData->GetCursorColor();
             bool useColor = cursorColor != INVALID_COLOR;
 
             // Build up the cursor parameters including position, color, and drawing options
             CursorOptions options;
             options.coordCursor = coordCursor;
-            options.ulCursorHeightPercent = _pData->GetCursorHeight();
-            options.cursorPixelWidth = _pData->GetCursorPixelWidth();
-            options.fIsDoubleWidth = _pData->IsCursorDoubleWidth();
-            options.cursorType = _pData->GetCursorStyle();
+            options.ulCursorHeightPercent = _pPaintData->GetCursorHeight();
+            options.cursorPixelWidth = _pPaintData->GetCursorPixelWidth();
+            options.fIsDoubleWidth = _pPaintData->IsCursorDoubleWidth();
+            options.cursorType = _pPaintData->GetCursorStyle();
             options.fUseColor = useColor;
             options.cursorColor = cursorColor;
-            options.isOn = _pData->IsCursorOn();
+            options.isOn = _pPaintData->IsCursorOn();
 
             return { options };
         }
@@ -1005,7 +1207,7 @@ void Renderer::_PaintOverlay(IRenderEngine& engine,
     try
     {
         // First get the screen buffer's viewport.
-        Viewport view = _pData->GetViewport();
+        Viewport view = _pPaintData->GetViewport();
 
         // Now get the overlay's viewport and adjust it to where it is supposed to be relative to the window.
 
@@ -1055,7 +1257,7 @@ void Renderer::_PaintOverlays(_In_ IRenderEngine* const pEngine)
 {
     try
     {
-        const auto overlays = _pData->GetOverlays();
+        const auto overlays = _pPaintData->GetOverlays();
 
         for (const auto& overlay : overlays)
         {
@@ -1112,7 +1314,7 @@ void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine)
 {
     // The last color needs to be each engine's responsibility. If it's local to this function,
     //      then on the next engine we might not update the color.
-    return pEngine->UpdateDrawingBrushes(textAttributes, _pData, isSettingDefaultBrushes);
+    return pEngine->UpdateDrawingBrushes(textAttributes, _pPaintData, isSettingDefaultBrushes);
 }
 
 // Routine Description:
@@ -1134,9 +1336,9 @@ void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine)
 // - A vector of rectangles representing the regions to select, line by line.
 std::vector<SMALL_RECT> Renderer::_GetSelectionRects() const
 {
-    auto rects = _pData->GetSelectionRects();
+    auto rects = _pPaintData->GetSelectionRects();
     // Adjust rectangles to viewport
-    Viewport view = _pData->GetViewport();
+    Viewport view = _pPaintData->GetViewport();
 
     std::vector<SMALL_RECT> result;
 
@@ -1155,45 +1357,43 @@ std::vector<SMALL_RECT> Renderer::_GetSelectionRects() const
 }
 
 // Method Description:
-// - Offsets all of the selection rectangles we might be holding onto
-//   as the previously selected area. If the whole viewport scrolls,
-//   we need to scroll these areas also to ensure they're invalidated
-//   properly when the selection further changes.
+// - Adds another Render engine to this renderer. Future rendering calls will
+//      also be sent to the new renderer.
 // Arguments:
-// - delta - The scroll delta
+// - pEngine: The new render engine to be added
 // Return Value:
-// - <none> - Updates internal state instead.
-void Renderer::_ScrollPreviousSelection(const til::point delta)
+// - <none>
+// Throws if we ran out of memory or there was some other error appending the
+//      engine to our collection.
+void Renderer::AddRenderEngine(_In_ IRenderEngine* const pEngine)
 {
-    if (delta != til::point{ 0, 0 })
-    {
-        for (auto& sr : _previousSelection)
-        {
-            // Get a rectangle representing this piece of the selection.
-            til::rectangle rc = Viewport::FromExclusive(sr).ToInclusive();
-
-            // Offset the entire existing rectangle by the delta.
-            rc += delta;
+    THROW_HR_IF_NULL(E_INVALIDARG, pEngine);
+    _rgpEngines.push_back(pEngine);
 
-            // Store it back into the vector.
-            sr = Viewport::FromInclusive(rc).ToExclusive();
-        }
+    if (pEngine->RequiresSynchronousInvalidation())
+    {
+        _synchronousEngines.push_back(pEngine);
+    }
+    else
+    {
+        _deferredEngines.push_back(pEngine);
     }
 }
 
 // Method Description:
-// - Adds another Render engine to this renderer. Future rendering calls will
-//      also be sent to the new renderer.
+// - Keeps painting the given engine with the console lock held, instead of
+//   from a snapshot after letting go of it. Hosts that change the state of an
+//   engine directly (its settings, its size), and rely on holding the console
+//   lock to keep that from happening in the middle of a frame, need this.
 // Arguments:
-// - pEngine: The new render engine to be added
+// - pEngine: An engine that was added to this renderer.
 // Return Value:
 // - <none>
-// Throws if we ran out of memory or there was some other error appending the
-//      engine to our collection.
-void Renderer::AddRenderEngine(_In_ IRenderEngine* const pEngine)
+void Renderer::PaintUnderConsoleLock(_In_ IRenderEngine* const pEngine)
 {
     THROW_HR_IF_NULL(E_INVALIDARG, pEngine);
-    _rgpEngines.push_back(pEngine);
+    std::lock_guard<std::mutex> paintLock{ _paintLock };
+    _lockedEngines.push_back(pEngine);
 }
 
 // Method Description:
@@ -21,6 +21,9 @@ Author(s):
 #include "../inc/IRenderData.hpp"
 
 #include "thread.hpp"
+#include "InvalidationAccumulator.hpp"
+#include "RenderSnapshot.hpp"
+#include "SelectionTracker.hpp"
 
 #include "../../buffer/out/textBuffer.hpp"
 #include "../../buffer/out/CharRow.hpp"
@@ -60,6 +63,7 @@ namespace Microsoft::Console::Render
 
         void TriggerCircling() override;
         void TriggerTitleChange() override;
+        void NotifyUserInput() override;
 
         void TriggerFontChange(const int iDpi,
                                const FontInfoDesired& FontInfoDesired,
@@ -76,15 +80,44 @@ namespace Microsoft::Console::Render
         void WaitUntilCanRender() override;
 
         void AddRenderEngine(_In_ IRenderEngine* const pEngine) override;
+        void PaintUnderConsoleLock(_In_ IRenderEngine* const pEngine);
+
+        FrameStats GetFrameStats() const;
 
         void SetRendererEnteredErrorStateCallback(std::function<void()> pfn);
         void ResetErrorStateAndResume();
 
     private:
         std::deque<IRenderEngine*> _rgpEngines;
+        std::vector<IRenderEngine*> _synchronousEngines;
+        std::vector<IRenderEngine*> _deferredEngines;
+        std::vector<IRenderEngine*> _lockedEngines;
+
+        InvalidationAccumulator _invalidations;
+        InvalidationAccumulator::Frame _pendingInvalidations;
 
         IRenderData* _pData; // Non-ownership pointer
 
+        // What the frame that's being painted reads from: either _pData, with
+        // the console lock held, or _snapshot, without it.
+        IRenderData* _pPaintData; // Non-ownership pointer
+        RenderSnapshot _snapshot;
+
+        // Held by the render thread while it paints a frame (with or without the
+        // console lock), and by the few callers that change the engines directly
+        // (font, DPI, system redraw). Writers, who hold the console lock, never
+        // take it: what they change is recorded and handed to the engines at the
+        // start of the next frame.
+        std::mutex _paintLock;
+
+        // Held while measuring glyphs, and while changing the font they're
+        // measured with. Always taken after _paintLock.
+        std::mutex _measureLock;
+
+        // Set when the title changed, until the engines that aren't told
+        // synchronously were given the new one.
+        std::atomic<bool> _titleChanged{ false };
+
         std::unique_ptr<IRenderThread> _pThread;
         bool _destructing = false;
 
@@ -93,13 +126,16 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT _PaintFrameForEngine(_In_ IRenderEngine* const pEngine) noexcept;
 
         bool _CheckViewportAndScroll();
+        void _ApplyPendingInvalidations();
+        void _InvalidateSelection();
 
         [[nodiscard]] HRESULT _PaintBackground(_In_ IRenderEngine* const pEngine);
 
         void _PaintBufferOutput(_In_ IRenderEngine* const pEngine);
 
+        template<typename TIterator>
         void _PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
-                                      TextBufferCellIterator it,
+                                      TIterator it,
                                       const COORD target,
                                       const bool lineWrapped);
 
@@ -126,8 +162,8 @@ namespace Microsoft::Console::Render
         std::vector<Cluster> _clusterBuffer;
 
         std::vector<SMALL_RECT> _GetSelectionRects() const;
-        void _ScrollPreviousSelection(const til::point delta);
-        std::vector<SMALL_RECT> _previousSelection;
+        SelectionTracker _selection;
+        std::vector<SMALL_RECT> _selectionChanges;
 
         [[nodiscard]] HRESULT _PaintTitle(IRenderEngine* const pEngine);
 
@@ -13,6 +13,7 @@ RenderThread::RenderThread() :
     _pRenderer(nullptr),
     _hThread(nullptr),
     _hEvent(nullptr),
+    _hPacingEvent(nullptr),
     _hPaintCompletedEvent(nullptr),
     _fKeepRunning(true),
     _hPaintEnabledEvent(nullptr),
@@ -27,6 +28,7 @@ RenderThread::~RenderThread()
     {
         _fKeepRunning = false; // stop loop after final run
         EnablePainting(); // if we want to get the last frame out, we need to make sure it's enabled
+        SetEvent(_hPacingEvent); // don't sit out a flood back-off before the final paint
         SignalObjectAndWait(_hEvent, _hThread, INFINITE, FALSE); // signal final paint and wait for thread to finish.
 
         CloseHandle(_hThread);
@@ -39,6 +41,12 @@ RenderThread::~RenderThread()
         _hEvent = nullptr;
     }
 
+    if (_hPacingEvent)
+    {
+        CloseHandle(_hPacingEvent);
+        _hPacingEvent = nullptr;
+    }
+
     if (_hPaintEnabledEvent)
     {
         CloseHandle(_hPaintEnabledEvent);
@@ -85,6 +93,24 @@ RenderThread::~RenderThread()
         }
     }
 
+    if (SUCCEEDED(hr))
+    {
+        HANDLE hPacingEvent = CreateEventW(nullptr, // non-inheritable security attributes
+                                           FALSE, // auto reset event
+                                           FALSE, // initially unsignaled
+                                           nullptr // no name
+        );
+
+        if (hPacingEvent == nullptr)
+        {
+            hr = HRESULT_FROM_WIN32(GetLastError());
+        }
+        else
+        {
+            _hPacingEvent = hPacingEvent;
+        }
+    }
+
     if (SUCCEEDED(hr))
     {
         HANDLE hPaintEnabledEvent = CreateEventW(nullptr,
@@ -202,14 +228,23 @@ DWORD WINAPI RenderThread::_ThreadProc()
         ResetEvent(_hPaintCompletedEvent);
 
         _pRenderer->WaitUntilCanRender();
+
+        _pacer.FrameStarted();
         LOG_IF_FAILED(_pRenderer->PaintFrame());
+        _pacer.FrameCompleted();
 
         SetEvent(_hPaintCompletedEvent);
 
         // extra check before we sleep since it's a "long" activity, relatively speaking.
         if (_fKeepRunning)
         {
-            Sleep(s_FrameLimitMilliseconds);
+            // The pacer stretches this out during floods of output. User input
+            // signals the event to cut it short, so an echo isn't held back.
+            const auto delay = _pacer.NextFrameDelay();
+            if (delay.count() > 0)
+            {
+                WaitForSingleObject(_hPacingEvent, gsl::narrow_cast<DWORD>(delay.count()));
+            }
         }
     }
 
@@ -217,6 +252,26 @@ DWORD WINAPI RenderThread::_ThreadProc()
 }
 
 void RenderThread::NotifyPaint()
+{
+    _pacer.NotifyOutput();
+    _RequestFrame();
+}
+
+// Method Description:
+// - Asks for another frame without counting it as output. It's painted after
+//      the usual gap between frames, and doesn't make the pacer back off the
+//      way a flood of output does. For engines that need to be painted again
+//      once some time has passed, even though nothing changed.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void RenderThread::NotifyRedraw()
+{
+    _RequestFrame();
+}
+
+void RenderThread::_RequestFrame()
 {
     if (_fWaiting.load(std::memory_order_acquire))
     {
@@ -228,6 +283,31 @@ void RenderThread::NotifyPaint()
     }
 }
 
+// Method Description:
+// - Lets the thread know the user just interacted with the console, so the next
+//      frame is painted as soon as it's requested rather than after the usual
+//      gap between frames.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void RenderThread::NotifyUserInput()
+{
+    _pacer.NotifyUserInput();
+    SetEvent(_hPacingEvent);
+}
+
+// Method Description:
+// - Returns timing information about the frames painted so far.
+// Arguments:
+// - <none>
+// Return Value:
+// - A snapshot of the frame statistics.
+FrameStats RenderThread::GetFrameStats() const
+{
+    return _pacer.GetStats();
+}
+
 void RenderThread::EnablePainting()
 {
     SetEvent(_hPaintEnabledEvent);
@@ -16,6 +16,7 @@ Author(s):
 
 #include "..\inc\IRenderer.hpp"
 #include "..\inc\IRenderThread.hpp"
+#include "FramePacer.hpp"
 
 namespace Microsoft::Console::Render
 {
@@ -28,25 +29,31 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT Initialize(_In_ IRenderer* const pRendererParent) noexcept;
 
         void NotifyPaint() override;
+        void NotifyRedraw() override;
+        void NotifyUserInput() override;
 
         void EnablePainting() override;
         void DisablePainting() override;
         void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) override;
 
+        FrameStats GetFrameStats() const override;
+
     private:
         static DWORD WINAPI s_ThreadProc(_In_ LPVOID lpParameter);
         DWORD WINAPI _ThreadProc();
-
-        static DWORD const s_FrameLimitMilliseconds = 8;
+        void _RequestFrame();
 
         HANDLE _hThread;
         HANDLE _hEvent;
+        HANDLE _hPacingEvent;
 
         HANDLE _hPaintEnabledEvent;
         HANDLE _hPaintCompletedEvent;
 
         IRenderer* _pRenderer; // Non-ownership pointer
 
+        FramePacer _pacer;
+
         bool _fKeepRunning;
         std::atomic<bool> _fNextFrameRequested;
         std::atomic<bool> _fWaiting;
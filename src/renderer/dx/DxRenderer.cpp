@@ -99,6 +99,7 @@ DxEngine::DxEngine() :
     _prevScale{ 1.0f },
     _chainMode{ SwapChainMode::ForComposition },
     _customLayout{},
+    _measureLayout{},
     _customRenderer{ ::Microsoft::WRL::Make<CustomTextRenderer>() },
     _drawingContext{}
 {
@@ -1773,6 +1774,7 @@ try
 
     // Prepare the text layout
     _customLayout = WRL::Make<CustomTextLayout>(_dwriteFactory.Get(), _dwriteTextAnalyzer.Get(), _dwriteTextFormat.Get(), _dwriteFontFace.Get(), _glyphCell.width(), _boxDrawingEffect.Get());
+    _measureLayout = WRL::Make<CustomTextLayout>(_dwriteFactory.Get(), _dwriteTextAnalyzer.Get(), _dwriteTextFormat.Get(), _dwriteFontFace.Get(), _glyphCell.width(), _boxDrawingEffect.Get());
 
     return S_OK;
 }
@@ -1903,11 +1905,11 @@ try
 
     const Cluster cluster(glyph, 0); // columns don't matter, we're doing analysis not layout.
 
-    RETURN_IF_FAILED(_customLayout->Reset());
-    RETURN_IF_FAILED(_customLayout->AppendClusters({ &cluster, 1 }));
+    RETURN_IF_FAILED(_measureLayout->Reset());
+    RETURN_IF_FAILED(_measureLayout->AppendClusters({ &cluster, 1 }));
 
     UINT32 columns = 0;
-    RETURN_IF_FAILED(_customLayout->GetColumns(&columns));
+    RETURN_IF_FAILED(_measureLayout->GetColumns(&columns));
 
     *pResult = columns != 1;
 
@@ -84,6 +84,9 @@ namespace Microsoft::Console::Render
 
         PAINTSTRUCT _psInvalidData;
         HDC _hdcMemoryContext;
+        // Glyph widths are measured with their own context, since that can
+        // happen while a frame is being painted on another thread.
+        HDC _hdcMeasureContext;
         bool _isTrueTypeFont;
         UINT _fontCodepage;
         HFONT _hfont;
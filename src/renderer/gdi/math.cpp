@@ -44,7 +44,7 @@ std::vector<til::rectangle> GdiEngine::GetDirtyArea()
         if (_IsFontTrueType())
         {
             ABC abc;
-            if (GetCharABCWidthsW(_hdcMemoryContext, wch, wch, &abc))
+            if (GetCharABCWidthsW(_hdcMeasureContext, wch, wch, &abc))
             {
                 int const totalWidth = abc.abcA + abc.abcB + abc.abcC;
 
@@ -54,7 +54,7 @@ std::vector<til::rectangle> GdiEngine::GetDirtyArea()
         else
         {
             INT cpxWidth = 0;
-            if (GetCharWidth32W(_hdcMemoryContext, wch, wch, &cpxWidth))
+            if (GetCharWidth32W(_hdcMeasureContext, wch, wch, &cpxWidth))
             {
                 isFullWidth = cpxWidth > _GetFontSize().X;
             }
@@ -40,6 +40,9 @@ GdiEngine::GdiEngine() :
     _hdcMemoryContext = CreateCompatibleDC(nullptr);
     THROW_HR_IF_NULL(E_FAIL, _hdcMemoryContext);
 
+    _hdcMeasureContext = CreateCompatibleDC(nullptr);
+    THROW_HR_IF_NULL(E_FAIL, _hdcMeasureContext);
+
     // On session zero, text GDI APIs might not be ready.
     // Calling GetTextFace causes a wait that will be
     // satisfied while GDI text APIs come online.
@@ -93,6 +96,12 @@ GdiEngine::~GdiEngine()
         LOG_HR_IF(E_FAIL, !(DeleteObject(_hdcMemoryContext)));
         _hdcMemoryContext = nullptr;
     }
+
+    if (_hdcMeasureContext != nullptr)
+    {
+        LOG_HR_IF(E_FAIL, !(DeleteObject(_hdcMeasureContext)));
+        _hdcMeasureContext = nullptr;
+    }
 }
 
 // Routine Description:
@@ -228,6 +237,7 @@ GdiEngine::~GdiEngine()
 
     // Select into DC
     RETURN_HR_IF_NULL(E_FAIL, SelectFont(_hdcMemoryContext, hFont.get()));
+    RETURN_HR_IF_NULL(E_FAIL, SelectFont(_hdcMeasureContext, hFont.get()));
 
     // Save off the font metrics for various other calculations
     RETURN_HR_IF(E_FAIL, !(GetTextMetricsW(_hdcMemoryContext, &_tmFontMetrics)));
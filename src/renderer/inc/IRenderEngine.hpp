@@ -69,6 +69,8 @@ namespace Microsoft::Console::Render
         [[nodiscard]] virtual HRESULT InvalidateScroll(const COORD* const pcoordDelta) noexcept = 0;
         [[nodiscard]] virtual HRESULT InvalidateAll() noexcept = 0;
         [[nodiscard]] virtual HRESULT InvalidateCircling(_Out_ bool* const pForcePaint) noexcept = 0;
+        virtual bool RequiresSynchronousInvalidation() const noexcept = 0;
+        virtual bool RequiresContinuousRedraw() noexcept = 0;
 
         [[nodiscard]] virtual HRESULT InvalidateTitle(const std::wstring& proposedTitle) noexcept = 0;
 
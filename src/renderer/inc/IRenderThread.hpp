@@ -15,6 +15,17 @@ Author(s):
 #pragma once
 namespace Microsoft::Console::Render
 {
+    // Timing information about the frames a render thread has painted so far.
+    struct FrameStats
+    {
+        uint64_t frames = 0;
+        uint64_t fastPathFrames = 0; // frames painted right after user input
+        std::chrono::microseconds lastPaintDuration{};
+        std::chrono::microseconds averagePaintDuration{};
+        std::chrono::milliseconds interval{}; // current gap between frames
+        double outputRequestsPerSecond = 0;
+    };
+
     class IRenderThread
     {
     public:
@@ -25,10 +36,14 @@ namespace Microsoft::Console::Render
         IRenderThread& operator=(IRenderThread&&) = default;
 
         virtual void NotifyPaint() = 0;
+        virtual void NotifyRedraw() = 0;
+        virtual void NotifyUserInput() = 0;
         virtual void EnablePainting() = 0;
         virtual void DisablePainting() = 0;
         virtual void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) = 0;
 
+        virtual FrameStats GetFrameStats() const = 0;
+
     protected:
         IRenderThread() = default;
     };
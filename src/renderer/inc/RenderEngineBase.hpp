@@ -42,6 +42,10 @@ namespace Microsoft::Console::Render
 
         void WaitUntilCanRender() noexcept override;
 
+        bool RequiresSynchronousInvalidation() const noexcept override;
+
+        bool RequiresContinuousRedraw() noexcept override;
+
     protected:
         [[nodiscard]] virtual HRESULT _DoUpdateTitle(const std::wstring& newTitle) noexcept = 0;
 
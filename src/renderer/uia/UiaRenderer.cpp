@@ -16,11 +16,9 @@ using namespace Microsoft::Console::Types;
 UiaEngine::UiaEngine(IUiaEventDispatcher* dispatcher) :
     _dispatcher{ THROW_HR_IF_NULL(E_INVALIDARG, dispatcher) },
     _isPainting{ false },
-    _selectionChanged{ false },
-    _textBufferChanged{ false },
-    _cursorChanged{ false },
+    _notifications{},
+    _notification{},
     _isEnabled{ true },
-    _prevSelection{},
     RenderEngineBase()
 {
 }
@@ -58,7 +56,7 @@ UiaEngine::UiaEngine(IUiaEventDispatcher* dispatcher) :
 // - S_OK, else an appropriate HRESULT for failing to allocate or write.
 [[nodiscard]] HRESULT UiaEngine::Invalidate(const SMALL_RECT* const /*psrRegion*/) noexcept
 {
-    _textBufferChanged = true;
+    _notifications.TextChanged();
     return S_OK;
 }
 
@@ -78,7 +76,7 @@ try
     if (*pcoordCursor != _prevCursorPos)
     {
         _prevCursorPos = *pcoordCursor;
-        _cursorChanged = true;
+        _notifications.CursorChanged();
     }
     return S_OK;
 }
@@ -99,44 +97,16 @@ CATCH_RETURN();
 // Routine Description:
 // - Notifies us that the console has changed the selection region and would
 //      like it updated
+// - The renderer only calls this when the selection actually changed, with
+//      the cells that went into or out of it. So any call is a change, even
+//      one whose cells are all outside of the viewport.
 // Arguments:
-// - rectangles - One or more rectangles describing character positions on the grid
+// - rectangles - Zero or more rectangles describing character positions on the grid
 // Return Value:
 // - S_OK
-[[nodiscard]] HRESULT UiaEngine::InvalidateSelection(const std::vector<SMALL_RECT>& rectangles) noexcept
+[[nodiscard]] HRESULT UiaEngine::InvalidateSelection(const std::vector<SMALL_RECT>& /*rectangles*/) noexcept
 {
-    // early exit: different number of rows
-    if (_prevSelection.size() != rectangles.size())
-    {
-        try
-        {
-            _selectionChanged = true;
-            _prevSelection = rectangles;
-        }
-        CATCH_LOG_RETURN_HR(E_FAIL);
-        return S_OK;
-    }
-
-    for (size_t i = 0; i < rectangles.size(); i++)
-    {
-        try
-        {
-            const auto prevRect = _prevSelection.at(i);
-            const auto newRect = rectangles.at(i);
-
-            // if any value is different, selection has changed
-            if (prevRect.Top != newRect.Top || prevRect.Right != newRect.Right || prevRect.Left != newRect.Left || prevRect.Bottom != newRect.Bottom)
-            {
-                _selectionChanged = true;
-                _prevSelection = rectangles;
-                return S_OK;
-            }
-        }
-        CATCH_LOG_RETURN_HR(E_FAIL);
-    }
-
-    // assume selection has not changed
-    _selectionChanged = false;
+    _notifications.SelectionChanged();
     return S_OK;
 }
 
@@ -163,7 +133,7 @@ CATCH_RETURN();
 // - S_OK, else an appropriate HRESULT for failing to allocate or write.
 [[nodiscard]] HRESULT UiaEngine::InvalidateAll() noexcept
 {
-    _textBufferChanged = true;
+    _notifications.TextChanged();
     return S_OK;
 }
 
@@ -181,6 +151,18 @@ CATCH_RETURN();
     return S_FALSE;
 }
 
+// Routine Description:
+// - Asks for more frames while there are changes that are held back until
+//   their time window closes, so they are sent even if nothing else changes.
+// Arguments:
+// - <none>
+// Return Value:
+// - true if there are changes to send later
+bool UiaEngine::RequiresContinuousRedraw() noexcept
+{
+    return _isEnabled && _notifications.HasPending();
+}
+
 // Routine Description:
 // - This is unused by this renderer.
 // Arguments:
@@ -205,11 +187,13 @@ CATCH_RETURN();
 {
     RETURN_HR_IF(S_FALSE, !_isEnabled);
 
-    // add more events here
-    const bool somethingToDo = _selectionChanged || _textBufferChanged || _cursorChanged;
-
-    // If there's nothing to do, quick return
-    RETURN_HR_IF(S_FALSE, !somethingToDo);
+    // If there's nothing to do, or it's too soon since the last notification, quick return
+    try
+    {
+        _notification = _notifications.Take();
+    }
+    CATCH_RETURN();
+    RETURN_HR_IF(S_FALSE, !_notification);
 
     _isPainting = true;
     return S_OK;
@@ -227,7 +211,7 @@ CATCH_RETURN();
     RETURN_HR_IF(E_INVALIDARG, !_isPainting); // invalid to end paint when we're not painting
 
     // Fire UIA Events here
-    if (_selectionChanged)
+    if (_notification->selectionChanged)
     {
         try
         {
@@ -235,7 +219,7 @@ CATCH_RETURN();
         }
         CATCH_LOG();
     }
-    if (_textBufferChanged)
+    if (_notification->textChanged)
     {
         try
         {
@@ -243,7 +227,7 @@ CATCH_RETURN();
         }
         CATCH_LOG();
     }
-    if (_cursorChanged)
+    if (_notification->cursorChanged)
     {
         try
         {
@@ -252,9 +236,7 @@ CATCH_RETURN();
         CATCH_LOG();
     }
 
-    _selectionChanged = false;
-    _textBufferChanged = false;
-    _cursorChanged = false;
+    _notification.reset();
     _isPainting = false;
 
     return S_OK;
@@ -8,6 +8,8 @@ Module Name:
 Abstract:
 - This is the definition of the UIA specific implementation of the renderer
 - It keeps track of what regions of the display have changed and notifies automation clients.
+- Changes are merged over a short time window (see UiaNotificationCoalescer),
+  so that a flood of output doesn't turn into an event for every frame.
 
 Author(s):
 - Carlos Zamora (CaZamor) Sep-2019
@@ -16,6 +18,7 @@ Author(s):
 #pragma once
 
 #include "../../renderer/inc/RenderEngineBase.hpp"
+#include "../../renderer/base/UiaNotificationCoalescer.hpp"
 
 #include "../../types/IUiaEventDispatcher.h"
 #include "../../types/inc/Viewport.hpp"
@@ -49,6 +52,7 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT InvalidateScroll(const COORD* const pcoordDelta) noexcept override;
         [[nodiscard]] HRESULT InvalidateAll() noexcept override;
         [[nodiscard]] HRESULT InvalidateCircling(_Out_ bool* const pForcePaint) noexcept override;
+        bool RequiresContinuousRedraw() noexcept override;
 
         [[nodiscard]] HRESULT PaintBackground() noexcept override;
         [[nodiscard]] HRESULT PaintBufferLine(gsl::span<const Cluster> const clusters,
@@ -79,13 +83,11 @@ namespace Microsoft::Console::Render
     private:
         bool _isEnabled;
         bool _isPainting;
-        bool _selectionChanged;
-        bool _textBufferChanged;
-        bool _cursorChanged;
+        UiaNotificationCoalescer _notifications;
+        std::optional<UiaNotificationCoalescer::Notification> _notification;
 
         Microsoft::Console::Types::IUiaEventDispatcher* _dispatcher;
 
-        std::vector<SMALL_RECT> _prevSelection;
         til::point _prevCursorPos;
     };
 }
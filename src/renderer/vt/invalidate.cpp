@@ -97,6 +97,17 @@ try
 }
 CATCH_RETURN();
 
+// Method Description:
+// - The VT engine needs to see every invalidation as it happens. Its cursor
+//      tracking relies on the order of the cursor invalidations, and it has to
+//      be able to paint (on circling) with exactly what's been written so far.
+// Return Value:
+// - true
+bool VtEngine::RequiresSynchronousInvalidation() const noexcept
+{
+    return true;
+}
+
 // Method Description:
 // - Notifies us that we're about to circle the buffer, giving us a chance to
 //      force a repaint before the buffer contents are lost. The VT renderer
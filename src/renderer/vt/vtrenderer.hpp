@@ -53,6 +53,7 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT InvalidateAll() noexcept override;
         [[nodiscard]] HRESULT InvalidateCircling(_Out_ bool* const pForcePaint) noexcept override;
         [[nodiscard]] HRESULT PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept override;
+        bool RequiresSynchronousInvalidation() const noexcept override;
 
         [[nodiscard]] virtual HRESULT StartPaint() noexcept override;
         [[nodiscard]] virtual HRESULT EndPaint() noexcept override;
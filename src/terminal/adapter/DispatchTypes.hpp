@@ -89,6 +89,191 @@ namespace Microsoft::Console::VirtualTerminal
         uint64_t _idAccumulator = 0;
         size_t _idShift = 0;
     };
+
+    // Routine Description:
+    // - A lightweight view of the parameters collected for a control sequence.
+    //   Parameters are held as a span of numeric values, and any sub-parameters
+    //   (the colon-delimited values of ITU T.416, as in "38:2::r:g:b") are held
+    //   in a separate flat span. Each parameter records the range of that flat
+    //   span which belongs to it.
+    // - The view doesn't own any storage, so it's cheap to pass by value, but it
+    //   is only valid for as long as the storage it was built from.
+    class VTParameters
+    {
+    public:
+        using SubParameterRange = std::pair<uint8_t, uint8_t>;
+
+        constexpr VTParameters() noexcept = default;
+
+        constexpr VTParameters(const size_t* values, const size_t count) noexcept :
+            _values{ values, count }
+        {
+        }
+
+        constexpr VTParameters(const gsl::span<const size_t> values,
+                               const gsl::span<const size_t> subParameters,
+                               const gsl::span<const SubParameterRange> subParameterRanges) noexcept :
+            _values{ values },
+            _subParameters{ subParameters },
+            _subParameterRanges{ subParameterRanges }
+        {
+        }
+
+        constexpr size_t size() const noexcept
+        {
+            return _values.size();
+        }
+
+        constexpr bool empty() const noexcept
+        {
+            return _values.empty();
+        }
+
+        size_t at(const size_t index) const
+        {
+            return gsl::at(_values, index);
+        }
+
+        constexpr auto begin() const noexcept
+        {
+            return _values.begin();
+        }
+
+        constexpr auto end() const noexcept
+        {
+            return _values.end();
+        }
+
+        VTParameters subspan(const size_t offset) const
+        {
+            const auto rangeOffset = std::min(offset, _subParameterRanges.size());
+            return { _values.subspan(offset), _subParameters, _subParameterRanges.subspan(rangeOffset) };
+        }
+
+        bool hasSubParameters() const noexcept
+        {
+            return !_subParameters.empty();
+        }
+
+        gsl::span<const size_t> subParametersFor(const size_t index) const noexcept
+        {
+            if (index >= _subParameterRanges.size())
+            {
+                return {};
+            }
+            const auto [start, end] = til::at(_subParameterRanges, index);
+            return _subParameters.subspan(start, gsl::narrow_cast<size_t>(end - start));
+        }
+
+        // Most sequences have no use for sub-parameters, so they can treat
+        // the view as a plain span of values.
+        constexpr operator gsl::span<const size_t>() const noexcept
+        {
+            return _values;
+        }
+
+    private:
+        gsl::span<const size_t> _values;
+        gsl::span<const size_t> _subParameters;
+        gsl::span<const SubParameterRange> _subParameterRanges;
+    };
+
+    // Routine Description:
+    // - Accumulates the parameters of a control sequence into fixed-capacity
+    //   inline storage, so that parsing never has to touch the heap. Like other
+    //   terminals, we ignore any parameters and sub-parameters beyond the limits
+    //   below rather than failing the whole sequence.
+    class VTParameterBuilder
+    {
+    public:
+        static constexpr size_t MaxParameterCount = 32;
+        static constexpr size_t MaxSubParameterCount = 6;
+
+        void Clear() noexcept
+        {
+            _parameterCount = 0;
+            _subParameterCount = 0;
+            _inSubParameter = false;
+            _overflow = false;
+        }
+
+        void AddParameter(const size_t value) noexcept
+        {
+            _inSubParameter = false;
+            _overflow = _parameterCount >= MaxParameterCount;
+            if (!_overflow)
+            {
+                const auto subParameterEnd = gsl::narrow_cast<uint8_t>(_subParameterCount);
+                til::at(_values, _parameterCount) = value;
+                til::at(_subParameterRanges, _parameterCount) = { subParameterEnd, subParameterEnd };
+                _parameterCount++;
+            }
+        }
+
+        void AddSubParameter() noexcept
+        {
+            _inSubParameter = true;
+            if (_parameterCount == 0)
+            {
+                _overflow = true;
+                return;
+            }
+            // Once the parameter itself has overflowed, its sub-parameters
+            // are discarded along with it.
+            auto& range = til::at(_subParameterRanges, _parameterCount - 1);
+            _overflow = _overflow || gsl::narrow_cast<size_t>(range.second - range.first) >= MaxSubParameterCount;
+            if (!_overflow)
+            {
+                til::at(_subParameters, _subParameterCount) = 0;
+                _subParameterCount++;
+                range.second++;
+            }
+        }
+
+        // Returns the value that digits should currently be accumulated into,
+        // which is the most recent sub-parameter if one has been started, or
+        // otherwise the most recent parameter. Once the storage limits have
+        // been reached, digits are accumulated into a scratch value instead.
+        size_t& CurrentValue() noexcept
+        {
+            if (_overflow || _parameterCount == 0)
+            {
+                return _discarded;
+            }
+            if (_inSubParameter)
+            {
+                return til::at(_subParameters, _subParameterCount - 1);
+            }
+            return til::at(_values, _parameterCount - 1);
+        }
+
+        size_t size() const noexcept
+        {
+            return _parameterCount;
+        }
+
+        bool empty() const noexcept
+        {
+            return _parameterCount == 0;
+        }
+
+        VTParameters View() const noexcept
+        {
+            return { { _values.data(), _parameterCount },
+                     { _subParameters.data(), _subParameterCount },
+                     { _subParameterRanges.data(), _parameterCount } };
+        }
+
+    private:
+        std::array<size_t, MaxParameterCount> _values{};
+        std::array<VTParameters::SubParameterRange, MaxParameterCount> _subParameterRanges{};
+        std::array<size_t, MaxParameterCount * MaxSubParameterCount> _subParameters{};
+        size_t _parameterCount = 0;
+        size_t _subParameterCount = 0;
+        size_t _discarded = 0;
+        bool _inSubParameter = false;
+        bool _overflow = false;
+    };
 }
 
 namespace Microsoft::Console::VirtualTerminal::DispatchTypes
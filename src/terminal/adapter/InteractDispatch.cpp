@@ -53,6 +53,10 @@ bool InteractDispatch::WriteCtrlKey(const KeyEvent& event)
 // Method Description:
 // - Writes a string of input to the host. The string is converted to keystrokes
 //      that will faithfully represent the input by CharToKeyEvents.
+// - This is what a paste turns into, so it has to be fast for long strings:
+//      the keys for each ASCII character are looked up once per string rather
+//      than once per character, and all of the keypresses are written to the
+//      input in a single write.
 // Arguments:
 // - string : a string to write to the console.
 // Return Value:
@@ -70,8 +74,26 @@ bool InteractDispatch::WriteString(const std::wstring_view string)
     {
         std::deque<std::unique_ptr<IInputEvent>> keyEvents;
 
+        // The keypresses for each ASCII character, looked up the first time the
+        // character appears in the string.
+        std::array<std::optional<std::deque<std::unique_ptr<KeyEvent>>>, 128> asciiEvents;
+
         for (const auto& wch : string)
         {
+            if (wch < asciiEvents.size())
+            {
+                auto& cachedEvents = til::at(asciiEvents, wch);
+                if (!cachedEvents.has_value())
+                {
+                    cachedEvents = CharToKeyEvents(wch, codepage);
+                }
+                for (const auto& event : *cachedEvents)
+                {
+                    keyEvents.push_back(std::make_unique<KeyEvent>(*event));
+                }
+                continue;
+            }
+
             std::deque<std::unique_ptr<KeyEvent>> convertedEvents = CharToKeyEvents(wch, codepage);
 
             std::move(convertedEvents.begin(),
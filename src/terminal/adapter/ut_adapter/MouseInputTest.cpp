@@ -644,4 +644,97 @@ public:
         mouseInput->EnableAlternateScroll(true);
         VERIFY_IS_FALSE(mouseInput->HandleMouse({ 0, 0 }, WM_MOUSEWHEEL, noModifierKeys, WHEEL_DELTA, {}));
     }
+
+    TEST_METHOD(MotionCoalescingTests)
+    {
+        Log::Comment(L"Starting test...");
+
+        struct MouseEvent
+        {
+            COORD position;
+            unsigned int button;
+            short delta;
+            TerminalInput::MouseButtonState state;
+        };
+
+        Log::Comment(L"Build a stream of hovering, a drag, a wheel event, and more hovering.");
+        constexpr size_t moves = 500;
+        std::vector<MouseEvent> stream;
+        for (size_t i = 0; i < moves; ++i)
+        {
+            stream.push_back({ { gsl::narrow<short>(i % 100), gsl::narrow<short>(i / 100) }, WM_MOUSEMOVE, 0, {} });
+        }
+        stream.push_back({ { 10, 10 }, WM_LBUTTONDOWN, 0, { true, false, false } });
+        for (size_t i = 0; i < moves; ++i)
+        {
+            stream.push_back({ { gsl::narrow<short>(i % 100), gsl::narrow<short>(i / 100) }, WM_MOUSEMOVE, 0, { true, false, false } });
+        }
+        stream.push_back({ { 20, 20 }, WM_LBUTTONUP, 0, {} });
+        stream.push_back({ { 20, 20 }, WM_MOUSEWHEEL, WHEEL_DELTA, {} });
+        for (size_t i = 0; i < moves; ++i)
+        {
+            stream.push_back({ { gsl::narrow<short>(i % 100), gsl::narrow<short>(i / 100) }, WM_MOUSEMOVE, 0, {} });
+        }
+
+        const auto run = [&](const unsigned int maxRate) {
+            std::vector<std::wstring> sent;
+            TerminalInput input{ [&](std::deque<std::unique_ptr<IInputEvent>>& events) {
+                std::wstring sequence;
+                for (const auto& event : events)
+                {
+                    sequence.push_back(static_cast<const KeyEvent*>(event.get())->GetCharData());
+                }
+                sent.push_back(std::move(sequence));
+            } };
+            input.SetSGRExtendedMode(true);
+            input.EnableAnyEventTracking(true);
+            input.SetMouseMotionRateLimit(maxRate);
+
+            for (const auto& event : stream)
+            {
+                VERIFY_IS_TRUE(input.HandleMouse(event.position, event.button, 0, event.delta, event.state));
+            }
+            input.FlushPendingMouseMotion();
+            return sent;
+        };
+
+        const auto everything = run(0);
+        Log::Comment(L"Without a limit, every event is sent.");
+        VERIFY_ARE_EQUAL(stream.size(), everything.size());
+
+        // The whole stream takes far less than a second, so with a limit of
+        // one motion event per second, only the motion events that start a
+        // hover or drag, and the ones right before other events, get through.
+        const auto coalesced = run(1);
+        Log::Comment(L"With a limit, motion is coalesced, but presses, releases and the wheel aren't.");
+        const size_t expected[]{
+            0, // the first hover
+            moves - 1, // the last hover, before the press
+            moves, // the press
+            moves + 1, // the first drag
+            2 * moves, // the last drag, before the release
+            2 * moves + 1, // the release
+            2 * moves + 2, // the wheel
+            2 * moves + 3, // the first hover
+            3 * moves + 2, // the last hover, sent by FlushPendingMouseMotion
+        };
+        VERIFY_ARE_EQUAL(std::size(expected), coalesced.size());
+        for (size_t i = 0; i < coalesced.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(String(everything.at(til::at(expected, i)).c_str()), String(coalesced.at(i).c_str()));
+        }
+
+        const auto countChars = [](const std::vector<std::wstring>& sequences) {
+            size_t count = 0;
+            for (const auto& sequence : sequences)
+            {
+                count += sequence.size();
+            }
+            return count;
+        };
+        Log::Comment(NoThrowString().Format(L"%zu events: %zu characters sent without a limit, %zu with one",
+                                            stream.size(),
+                                            countChars(everything),
+                                            countChars(coalesced)));
+    }
 };
@@ -1255,7 +1255,7 @@ public:
 
         _testGetSet->PrepData();
 
-        DispatchTypes::GraphicsOptions rgOptions[16];
+        size_t rgOptions[16];
         size_t cOptions = 0;
 
         VERIFY_IS_TRUE(_pDispatch.get()->SetGraphicsRendition({ rgOptions, cOptions }));
@@ -1292,7 +1292,7 @@ public:
         VERIFY_SUCCEEDED_RETURN(TestData::TryGetValue(L"uiGraphicsOptions", uiGraphicsOption));
         graphicsOption = (DispatchTypes::GraphicsOptions)uiGraphicsOption;
 
-        DispatchTypes::GraphicsOptions rgOptions[16];
+        size_t rgOptions[16];
         size_t cOptions = 1;
         rgOptions[0] = graphicsOption;
 
@@ -1605,7 +1605,7 @@ public:
 
         _testGetSet->PrepData(); // default color from here is gray on black, FOREGROUND_BLUE | FOREGROUND_GREEN | FOREGROUND_RED
 
-        DispatchTypes::GraphicsOptions rgOptions[16];
+        size_t rgOptions[16];
         size_t cOptions = 1;
 
         Log::Comment(L"Test 1: Basic brightness test");
@@ -2094,7 +2094,7 @@ public:
 
         _testGetSet->PrepData(); // default color from here is gray on black, FOREGROUND_BLUE | FOREGROUND_GREEN | FOREGROUND_RED
 
-        DispatchTypes::GraphicsOptions rgOptions[16];
+        size_t rgOptions[16];
         size_t cOptions = 3;
 
         _testGetSet->_privateGetColorTableEntryResult = true;
@@ -2139,6 +2139,61 @@ public:
         VERIFY_IS_TRUE(_pDispatch.get()->SetGraphicsRendition({ rgOptions, cOptions }));
     }
 
+    TEST_METHOD(GraphicsSubParameterTest)
+    {
+        Log::Comment(L"Starting test...");
+
+        _testGetSet->PrepData();
+        _testGetSet->_expectedAttribute = _testGetSet->_attribute;
+
+        Log::Comment(L"Test 1: Change Foreground to RGB color with a color space id");
+        {
+            const size_t values[] = { DispatchTypes::GraphicsOptions::ForegroundExtended };
+            const size_t subParameters[] = { 2, 0, 255, 128, 0 };
+            const VTParameters::SubParameterRange ranges[] = { { 0, 5 } };
+            _testGetSet->_expectedAttribute.SetForeground(RGB(255, 128, 0));
+            VERIFY_IS_TRUE(_pDispatch.get()->SetGraphicsRendition({ values, subParameters, ranges }));
+        }
+
+        Log::Comment(L"Test 2: Change Background to RGB color without a color space id");
+        {
+            const size_t values[] = { DispatchTypes::GraphicsOptions::BackgroundExtended };
+            const size_t subParameters[] = { 2, 1, 2, 3 };
+            const VTParameters::SubParameterRange ranges[] = { { 0, 4 } };
+            _testGetSet->_expectedAttribute.SetBackground(RGB(1, 2, 3));
+            VERIFY_IS_TRUE(_pDispatch.get()->SetGraphicsRendition({ values, subParameters, ranges }));
+        }
+
+        Log::Comment(L"Test 3: An indexed color doesn't consume the parameters that follow it");
+        {
+            const size_t values[] = { DispatchTypes::GraphicsOptions::ForegroundExtended, DispatchTypes::GraphicsOptions::BoldBright };
+            const size_t subParameters[] = { 5, 42 };
+            const VTParameters::SubParameterRange ranges[] = { { 0, 2 }, { 2, 2 } };
+            _testGetSet->_expectedAttribute.SetIndexedForeground256(42);
+            _testGetSet->_expectedAttribute.SetBold(true);
+            VERIFY_IS_TRUE(_pDispatch.get()->SetGraphicsRendition({ values, subParameters, ranges }));
+        }
+
+        Log::Comment(L"Test 4: Select the underline style");
+        {
+            const size_t values[] = { DispatchTypes::GraphicsOptions::Underline };
+            const VTParameters::SubParameterRange ranges[] = { { 0, 1 } };
+
+            const size_t doubleStyle[] = { 2 };
+            _testGetSet->_expectedAttribute.SetDoublyUnderlined(true);
+            VERIFY_IS_TRUE(_pDispatch.get()->SetGraphicsRendition({ values, doubleStyle, ranges }));
+
+            const size_t curlyStyle[] = { 3 };
+            _testGetSet->_expectedAttribute.SetDoublyUnderlined(false);
+            _testGetSet->_expectedAttribute.SetUnderlined(true);
+            VERIFY_IS_TRUE(_pDispatch.get()->SetGraphicsRendition({ values, curlyStyle, ranges }));
+
+            const size_t noStyle[] = { 0 };
+            _testGetSet->_expectedAttribute.SetUnderlined(false);
+            VERIFY_IS_TRUE(_pDispatch.get()->SetGraphicsRendition({ values, noStyle, ranges }));
+        }
+    }
+
     TEST_METHOD(SetColorTableValue)
     {
         _testGetSet->PrepData();
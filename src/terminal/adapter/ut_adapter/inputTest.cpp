@@ -46,6 +46,8 @@ public:
     TEST_METHOD(TerminalInputNullKeyTests);
     TEST_METHOD(DifferentModifiersTest);
     TEST_METHOD(CtrlNumTest);
+    TEST_METHOD(InputModesTest);
+    TEST_METHOD(KeyTranslationPerformance);
 
     wchar_t GetModifierChar(const bool fShift, const bool fAlt, const bool fCtrl)
     {
@@ -739,3 +741,96 @@ void InputTest::CtrlNumTest()
     s_expectedInput = L"9";
     TestKey(pInput, uiKeystate, vkey);
 }
+
+void InputTest::InputModesTest()
+{
+    Log::Comment(L"Starting test...");
+
+    TerminalInput input{ s_TerminalInputTestCallback };
+
+    Log::Comment(L"Cursor keys follow the cursor keys mode, and everything else the keypad mode.");
+    input.ChangeCursorKeysMode(true);
+    s_expectedInput = L"\x1bOA";
+    TestKey(&input, 0, VK_UP);
+    s_expectedInput = L"\x1b[6~";
+    TestKey(&input, 0, VK_NEXT);
+
+    input.ChangeKeypadMode(true);
+    s_expectedInput = L"\x1bOF";
+    TestKey(&input, 0, VK_END);
+    s_expectedInput = L"\x1bOP";
+    TestKey(&input, 0, VK_F1);
+
+    input.ChangeCursorKeysMode(false);
+    s_expectedInput = L"\x1b[D";
+    TestKey(&input, 0, VK_LEFT);
+
+    Log::Comment(L"VT52 mode has its own sequences, whatever the other modes are.");
+    input.ChangeAnsiMode(false);
+    s_expectedInput = L"\x1b" L"A";
+    TestKey(&input, 0, VK_UP);
+    s_expectedInput = L"\x1bR";
+    TestKey(&input, 0, VK_F3);
+    s_expectedInput = L"\x1b[15~";
+    TestKey(&input, 0, VK_F5);
+
+    Log::Comment(L"Modified keys are the same in every mode.");
+    s_expectedInput = L"\x1b[1;6A";
+    TestKey(&input, SHIFT_PRESSED | LEFT_CTRL_PRESSED, VK_UP);
+    input.ChangeAnsiMode(true);
+    TestKey(&input, SHIFT_PRESSED | LEFT_CTRL_PRESSED, VK_UP);
+    s_expectedInput = L"\x1b[24;8~";
+    TestKey(&input, SHIFT_PRESSED | LEFT_ALT_PRESSED | RIGHT_CTRL_PRESSED, VK_F12);
+}
+
+void InputTest::KeyTranslationPerformance()
+{
+    BEGIN_TEST_METHOD_PROPERTIES()
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD_PROPERTIES()
+
+    Log::Comment(L"Starting test...");
+
+    size_t sequences = 0;
+    TerminalInput input{ [&](std::deque<std::unique_ptr<IInputEvent>>& inEvents) {
+        sequences += inEvents.empty() ? 0 : 1;
+    } };
+
+    // A key repeat flood of the keys that are looked up in the tables, with
+    // and without modifiers.
+    constexpr BYTE vkeys[]{ VK_UP, VK_DOWN, VK_PRIOR, VK_DELETE, VK_F1, VK_F5, VK_F12, VK_BACK, VK_TAB, VK_ESCAPE };
+    constexpr DWORD modifiers[]{ 0, SHIFT_PRESSED, LEFT_CTRL_PRESSED, LEFT_ALT_PRESSED | SHIFT_PRESSED };
+
+    std::vector<std::unique_ptr<IInputEvent>> events;
+    for (const auto vkey : vkeys)
+    {
+        for (const auto modifier : modifiers)
+        {
+            INPUT_RECORD irTest = { 0 };
+            irTest.EventType = KEY_EVENT;
+            irTest.Event.KeyEvent.dwControlKeyState = modifier;
+            irTest.Event.KeyEvent.wRepeatCount = 1;
+            irTest.Event.KeyEvent.wVirtualKeyCode = vkey;
+            irTest.Event.KeyEvent.bKeyDown = TRUE;
+            events.push_back(IInputEvent::Create(irTest));
+        }
+    }
+
+    constexpr auto iterations = 10000;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < iterations; ++i)
+    {
+        for (const auto& event : events)
+        {
+            VERIFY_IS_TRUE(input.HandleKey(event.get()));
+        }
+    }
+    const auto time = std::chrono::steady_clock::now() - start;
+
+    Log::Comment(NoThrowString().Format(L"%zu keys translated in %lldus",
+                                        iterations * events.size(),
+                                        std::chrono::duration_cast<std::chrono::microseconds>(time).count()));
+
+    VERIFY_ARE_EQUAL(iterations * events.size(), sequences);
+}
@@ -291,6 +291,85 @@ bool TerminalInput::IsTrackingMouseInput() const noexcept
     return (_mouseInputState.trackingMode != TrackingMode::None);
 }
 
+// Routine Description:
+// - Determines if a motion event is being held back by the rate limit. A host
+//      that sees one should call FlushPendingMouseMotion once the mouse has
+//      been idle for as long as the limit allows between motion events.
+// Parameters:
+// - <none>
+// Return value:
+// - true, if there is a motion event waiting to be sent.
+bool TerminalInput::HasPendingMouseMotion() const noexcept
+{
+    return !_mouseInputState.pendingMotion.empty();
+}
+
+// Routine Description:
+// - Sends the motion event that was held back by the rate limit, if there is
+//      one. See SetMouseMotionRateLimit.
+// Parameters:
+// - <none>
+// Return value:
+// - true, if there was a motion event to send.
+bool TerminalInput::FlushPendingMouseMotion()
+{
+    if (_mouseInputState.pendingMotion.empty())
+    {
+        return false;
+    }
+
+    _SendInputSequence(_mouseInputState.pendingMotion);
+    _mouseInputState.pendingMotion.clear();
+    _mouseInputState.lastMotionTime = std::chrono::steady_clock::now();
+    return true;
+}
+
+// Routine Description:
+// - Sends an encoded mouse event to the input, coalescing motion events that
+//      come in faster than the rate limit allows. A motion event is only held
+//      back if it has the same buttons pressed as the last one sent, so the
+//      start and end of a drag always go through, and any held back motion is
+//      sent before the next event that isn't coalesced with it.
+// Parameters:
+// - sequence - the encoded event
+// - isMotion - true if the event is a WM_MOUSEMOVE
+// - realButton - the button that was pressed during a motion event, or
+//      WM_LBUTTONUP if none were.
+// Return value:
+// - <none>
+void TerminalInput::_SendMouseSequence(const std::wstring& sequence, const bool isMotion, const unsigned int realButton)
+{
+    auto& state = _mouseInputState;
+
+    if (isMotion)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        const auto sameButtons = realButton == state.lastMotionButton;
+        if (sameButtons && now - state.lastMotionTime < state.motionInterval)
+        {
+            // This replaces any motion we were already holding back.
+            state.pendingMotion = sequence;
+            return;
+        }
+
+        if (sameButtons)
+        {
+            // This motion makes the one we were holding back obsolete.
+            state.pendingMotion.clear();
+        }
+        FlushPendingMouseMotion();
+
+        state.lastMotionTime = now;
+        state.lastMotionButton = realButton;
+    }
+    else
+    {
+        FlushPendingMouseMotion();
+    }
+
+    _SendInputSequence(sequence);
+}
+
 // Routine Description:
 // - Attempt to handle the given mouse coordinates and windows button as a VT-style mouse event.
 //     If the event should be transmitted in the selected mouse mode, then we'll try and
@@ -338,6 +417,7 @@ bool TerminalInput::HandleMouse(const COORD position,
     bool success = false;
     if (_ShouldSendAlternateScroll(button, delta))
     {
+        FlushPendingMouseMotion();
         success = _SendAlternateScroll(delta);
     }
     else
@@ -411,7 +491,7 @@ bool TerminalInput::HandleMouse(const COORD position,
 
                 if (success)
                 {
-                    _SendInputSequence(sequence);
+                    _SendMouseSequence(sequence, isHover, realButton);
                     success = true;
                 }
                 if (_mouseInputState.trackingMode == TrackingMode::ButtonEvent || _mouseInputState.trackingMode == TrackingMode::AnyEvent)
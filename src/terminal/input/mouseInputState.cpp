@@ -47,6 +47,7 @@ void TerminalInput::EnableDefaultTracking(const bool enable) noexcept
     _mouseInputState.trackingMode = enable ? TrackingMode::Default : TrackingMode::None;
     _mouseInputState.lastPos = { -1, -1 }; // Clear out the last saved mouse position & button.
     _mouseInputState.lastButton = 0;
+    _mouseInputState.pendingMotion.clear();
 }
 
 // Routine Description:
@@ -63,6 +64,7 @@ void TerminalInput::EnableButtonEventTracking(const bool enable) noexcept
     _mouseInputState.trackingMode = enable ? TrackingMode::ButtonEvent : TrackingMode::None;
     _mouseInputState.lastPos = { -1, -1 }; // Clear out the last saved mouse position & button.
     _mouseInputState.lastButton = 0;
+    _mouseInputState.pendingMotion.clear();
 }
 
 // Routine Description:
@@ -79,6 +81,7 @@ void TerminalInput::EnableAnyEventTracking(const bool enable) noexcept
     _mouseInputState.trackingMode = enable ? TrackingMode::AnyEvent : TrackingMode::None;
     _mouseInputState.lastPos = { -1, -1 }; // Clear out the last saved mouse position & button.
     _mouseInputState.lastButton = 0;
+    _mouseInputState.pendingMotion.clear();
 }
 
 // Routine Description:
@@ -113,3 +116,20 @@ void TerminalInput::UseMainScreenBuffer() noexcept
 {
     _mouseInputState.inAlternateBuffer = false;
 }
+
+// Routine Description:
+// - Limits how many mouse motion events are sent per second. Motion events
+//      that come in faster than that are coalesced: only the latest one is
+//      kept, and it's sent with the next event, or by FlushPendingMouseMotion.
+//      Button presses and releases and wheel events are never coalesced.
+//   A host that sets a limit should call FlushPendingMouseMotion when the
+//      mouse goes idle, so that the last position isn't held back.
+// Parameters:
+// - maxRate - the most motion events to send per second, or 0 for no limit.
+// Return value:
+// <none>
+void TerminalInput::SetMouseMotionRateLimit(const unsigned int maxRate) noexcept
+{
+    using namespace std::chrono;
+    _mouseInputState.motionInterval = maxRate ? duration_cast<steady_clock::duration>(seconds{ 1 }) / maxRate : steady_clock::duration{};
+}
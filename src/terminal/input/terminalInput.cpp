@@ -276,231 +276,263 @@ void TerminalInput::ForceDisableWin32InputMode(const bool win32InputMode) noexce
     _forceDisableWin32InputMode = win32InputMode;
 }
 
-static const gsl::span<const TermKeyMap> _getKeyMapping(const KeyEvent& keyEvent,
-                                                        const bool ansiMode,
-                                                        const bool cursorApplicationMode,
-                                                        const bool keypadApplicationMode) noexcept
+// The keys in all of the tables above have virtual key codes below this, so
+// the tables below can be indexed by the virtual key code directly.
+static constexpr size_t s_keyTableSize = 0x80;
+
+// The sequence a key translates to, kept right in the tables below so that
+// translating a key is a single lookup. An empty sequence means that the key
+// doesn't translate to one.
+struct KeySequence
 {
-    if (ansiMode)
+    std::array<wchar_t, 7> chars{};
+    uint16_t length{};
+
+    constexpr KeySequence() noexcept = default;
+
+    constexpr KeySequence(const std::wstring_view sequence) :
+        length{ static_cast<uint16_t>(sequence.size()) }
     {
-        if (keyEvent.IsCursorKey())
+        for (size_t i = 0; i < sequence.size(); ++i)
         {
+            // Throws if the sequence is too long, which fails the build.
+            chars.at(i) = sequence.at(i);
+        }
+    }
+
+    constexpr std::wstring_view view() const noexcept
+    {
+        return { chars.data(), length };
+    }
+};
+
+using KeyTable = std::array<KeySequence, s_keyTableSize>;
+
+template<size_t N>
+static constexpr void _addToKeyTable(KeyTable& table, const std::array<TermKeyMap, N>& mapping)
+{
+    for (const auto& map : mapping)
+    {
+        table.at(map.vkey) = KeySequence{ map.sequence };
+    }
+}
+
+// Routine Description:
+// - Gets the index into s_keyTables of the table for the given input modes.
+static constexpr size_t _getModeIndex(const bool ansiMode,
+                                      const bool cursorApplicationMode,
+                                      const bool keypadApplicationMode) noexcept
+{
+    if (!ansiMode)
+    {
+        return 4;
+    }
+    return (cursorApplicationMode ? 1 : 0) + (keypadApplicationMode ? 2 : 0);
+}
+
+// Routine Description:
+// - Gets the index into s_modifiedKeyTables of the table for the given
+//      modifiers. This is one less than the VT encoding of the modifiers.
+static constexpr size_t _getModifierIndex(const bool shift, const bool alt, const bool ctrl) noexcept
+{
+    return (shift ? 1 : 0) + (alt ? 2 : 0) + (ctrl ? 4 : 0);
+}
+
+// Routine Description:
+// - Merges the cursor key and keypad mappings for each combination of input
+//      modes into one table. The cursor keys are never in the keypad
+//      mappings, so the merged tables translate each key the same way as
+//      looking in the mapping for its kind of key would.
+static constexpr std::array<KeyTable, 5> _makeKeyTables()
+{
+    std::array<KeyTable, 5> tables{};
+
+    for (const auto cursorApplicationMode : { false, true })
+    {
+        for (const auto keypadApplicationMode : { false, true })
+        {
+            auto& table = tables.at(_getModeIndex(true, cursorApplicationMode, keypadApplicationMode));
             if (cursorApplicationMode)
             {
-                return { s_cursorKeysApplicationMapping.data(), s_cursorKeysApplicationMapping.size() };
+                _addToKeyTable(table, s_cursorKeysApplicationMapping);
             }
             else
             {
-                return { s_cursorKeysNormalMapping.data(), s_cursorKeysNormalMapping.size() };
+                _addToKeyTable(table, s_cursorKeysNormalMapping);
             }
-        }
-        else
-        {
             if (keypadApplicationMode)
             {
-                return { s_keypadApplicationMapping.data(), s_keypadApplicationMapping.size() };
+                _addToKeyTable(table, s_keypadApplicationMapping);
             }
             else
             {
-                return { s_keypadNumericMapping.data(), s_keypadNumericMapping.size() };
+                _addToKeyTable(table, s_keypadNumericMapping);
             }
         }
     }
-    else
+
+    auto& vt52Table = tables.at(_getModeIndex(false, false, false));
+    _addToKeyTable(vt52Table, s_cursorKeysVt52Mapping);
+    _addToKeyTable(vt52Table, s_keypadVt52Mapping);
+
+    return tables;
+}
+
+// Routine Description:
+// - Builds a table for each combination of modifiers, with the sequences of
+//      s_modifierKeyMapping already encoding those modifiers, and the
+//      sequences of s_simpleModifiedKeyMapping that require exactly them.
+static constexpr std::array<KeyTable, 8> _makeModifiedKeyTables()
+{
+    std::array<KeyTable, 8> tables{};
+
+    for (size_t modifiers = 1; modifiers < tables.size(); ++modifiers)
     {
-        if (keyEvent.IsCursorKey())
+        for (const auto& map : s_modifierKeyMapping)
         {
-            return { s_cursorKeysVt52Mapping.data(), s_cursorKeysVt52Mapping.size() };
+            KeySequence sequence{ map.sequence };
+            // Replace the 'm' with the character for these modifiers.
+            sequence.chars.at(sequence.length - 2) = static_cast<wchar_t>(L'1' + modifiers);
+            tables.at(modifiers).at(map.vkey) = sequence;
         }
-        else
+    }
+
+    for (const auto& map : s_simpleModifiedKeyMapping)
+    {
+        const auto modifiers = _getModifierIndex((map.modifiers & SHIFT_PRESSED) != 0,
+                                                 (map.modifiers & ALT_PRESSED) != 0,
+                                                 (map.modifiers & CTRL_PRESSED) != 0);
+        auto& entry = tables.at(modifiers).at(map.vkey);
+        if (entry.length == 0)
         {
-            return { s_keypadVt52Mapping.data(), s_keypadVt52Mapping.size() };
+            entry = KeySequence{ map.sequence };
         }
     }
+
+    return tables;
 }
 
+// Indexed by _getModeIndex, then by virtual key code.
+static constexpr auto s_keyTables = _makeKeyTables();
+
+// Indexed by _getModifierIndex, then by virtual key code.
+static constexpr auto s_modifiedKeyTables = _makeModifiedKeyTables();
+
 // Routine Description:
-// - Searches the keyMapping for a entry corresponding to this key event, and returns it.
+// - Looks up the sequence for this key event in the given table.
 // Arguments:
+// - table - The table to look in
 // - keyEvent - Key event to translate
-// - keyMapping - Array of key mappings to search
 // Return Value:
-// - Has value if there was a match to a key translation.
-static std::optional<const TermKeyMap> _searchKeyMapping(const KeyEvent& keyEvent,
-                                                         gsl::span<const TermKeyMap> keyMapping) noexcept
+// - The sequence, or an empty one if the key doesn't translate to one.
+static std::wstring_view _getKeySequence(const KeyTable& table, const KeyEvent& keyEvent) noexcept
 {
-    for (auto& map : keyMapping)
+    const size_t vkey = keyEvent.GetVirtualKeyCode();
+    if (vkey >= table.size())
     {
-        if (map.vkey == keyEvent.GetVirtualKeyCode())
-        {
-            // If the mapping has no modifiers set, then it doesn't really care
-            //      what the modifiers are on the key. The caller will likely do
-            //      something with them.
-            // However, if there are modifiers set, then we only want to match
-            //      if the key's modifiers are the same as the modifiers in the
-            //      mapping.
-            bool modifiersMatch = WI_AreAllFlagsClear(map.modifiers, MOD_PRESSED);
-            if (!modifiersMatch)
-            {
-                // The modifier mapping expects certain modifier keys to be
-                //      pressed. Check those as well.
-                modifiersMatch =
-                    (WI_IsFlagSet(map.modifiers, SHIFT_PRESSED) == keyEvent.IsShiftPressed()) &&
-                    (WI_IsAnyFlagSet(map.modifiers, ALT_PRESSED) == keyEvent.IsAltPressed()) &&
-                    (WI_IsAnyFlagSet(map.modifiers, CTRL_PRESSED) == keyEvent.IsCtrlPressed());
-            }
-
-            if (modifiersMatch)
-            {
-                return map;
-            }
-        }
+        return {};
     }
-    return std::nullopt;
+    return til::at(table, vkey).view();
 }
 
 typedef std::function<void(const std::wstring_view)> InputSender;
 
 // Routine Description:
-// - Searches the s_modifierKeyMapping for a entry corresponding to this key event.
-//      Changes the second to last byte to correspond to the currently pressed modifier keys
-//      before sending to the input.
+// - Looks up the sequence for this key event with the modifiers that are
+//      pressed, and sends it to the input.
 // Arguments:
 // - keyEvent - Key event to translate
 // - sender - Function to use to dispatch translated event
 // Return Value:
-// - True if there was a match to a key translation, and we successfully modified and sent it to the input
+// - True if there was a match to a key translation, and we successfully sent it to the input
 static bool _searchWithModifier(const KeyEvent& keyEvent, InputSender sender)
 {
     bool success = false;
 
-    const auto match = _searchKeyMapping(keyEvent,
-                                         { s_modifierKeyMapping.data(), s_modifierKeyMapping.size() });
-    if (match)
+    const auto modifiers = _getModifierIndex(keyEvent.IsShiftPressed(), keyEvent.IsAltPressed(), keyEvent.IsCtrlPressed());
+    const auto sequence = _getKeySequence(til::at(s_modifiedKeyTables, modifiers), keyEvent);
+    if (!sequence.empty())
     {
-        const auto& v = match.value();
-        if (!v.sequence.empty())
-        {
-            std::wstring modified{ v.sequence }; // Make a copy so we can modify it.
-            const bool shift = keyEvent.IsShiftPressed();
-            const bool alt = keyEvent.IsAltPressed();
-            const bool ctrl = keyEvent.IsCtrlPressed();
-            modified.at(modified.size() - 2) = L'1' + (shift ? 1 : 0) + (alt ? 2 : 0) + (ctrl ? 4 : 0);
-            sender(modified);
-            success = true;
-        }
+        sender(sequence);
+        success = true;
     }
     else
     {
-        // We didn't find the key in the map of modified keys that need editing,
-        //      maybe it's in the other map of modified keys with sequences that
-        //      don't need editing before sending.
-        const auto match2 = _searchKeyMapping(keyEvent,
-                                              { s_simpleModifiedKeyMapping.data(), s_simpleModifiedKeyMapping.size() });
-        if (match2)
+        // One last check:
+        // * C-/ is supposed to be ^_ (the C0 character US)
+        // * C-? is supposed to be DEL
+        // * C-M-/ is supposed to be ^[^_
+        // * C-M-? is supposed to be ^[^?
+        //
+        // But this whole scenario is tricky. '/' is not the same VKEY on
+        // all keyboards. On USASCII keyboards, '/' and '?' share the _same_
+        // key. So we have to figure out the vkey at runtime, and we have to
+        // determine if the key that was pressed was '?' with some
+        // modifiers, or '/' with some modifiers.
+        //
+        // These translations are not in s_simpleModifiedKeyMapping, because
+        // the aforementioned fact that they aren't the same VKEY on all
+        // keyboards.
+        //
+        // See GH#3079 for details.
+        // Also see https://github.com/microsoft/terminal/pull/4947#issuecomment-600382856
+
+        // VkKeyScan will give us both the Vkey of the key needed for this
+        // character, and the modifiers the user might need to press to get
+        // this character.
+        const auto slashKeyScan = VkKeyScan(L'/'); // On USASCII: 0x00bf
+        const auto questionMarkKeyScan = VkKeyScan(L'?'); //On USASCII: 0x01bf
+
+        const auto slashVkey = LOBYTE(slashKeyScan);
+        const auto questionMarkVkey = LOBYTE(questionMarkKeyScan);
+
+        const auto ctrl = keyEvent.IsCtrlPressed();
+        const auto alt = keyEvent.IsAltPressed();
+        const bool shift = keyEvent.IsShiftPressed();
+
+        // From the KeyEvent we're translating, synthesize the equivalent VkKeyScan result
+        const auto vkey = keyEvent.GetVirtualKeyCode();
+        const short keyScanFromEvent = vkey |
+                                       (shift ? 0x100 : 0) |
+                                       (ctrl ? 0x200 : 0) |
+                                       (alt ? 0x400 : 0);
+
+        // Make sure the VKEY is an _exact_ match, and that the modifier
+        // bits also match. This handles the hypothetical case we get a
+        // keyscan back that's ctrl+alt+some_random_VK, and some_random_VK
+        // has bits that are a superset of the bits set for question mark.
+        const bool wasQuestionMark = vkey == questionMarkVkey && WI_AreAllFlagsSet(keyScanFromEvent, questionMarkKeyScan);
+        const bool wasSlash = vkey == slashVkey && WI_AreAllFlagsSet(keyScanFromEvent, slashKeyScan);
+
+        // If the key pressed was exactly the ? key, then try to send the
+        // appropriate sequence for a modified '?'. Otherwise, check if this
+        // was a modified '/' keypress. These mappings don't need to be
+        // changed at all.
+        if ((ctrl && alt) && wasQuestionMark)
         {
-            // This mapping doesn't need to be changed at all.
-            sender(match2.value().sequence);
+            sender(CTRL_ALT_QUESTIONMARK_SEQUENCE);
             success = true;
         }
-        else
+        else if (ctrl && wasQuestionMark)
         {
-            // One last check:
-            // * C-/ is supposed to be ^_ (the C0 character US)
-            // * C-? is supposed to be DEL
-            // * C-M-/ is supposed to be ^[^_
-            // * C-M-? is supposed to be ^[^?
-            //
-            // But this whole scenario is tricky. '/' is not the same VKEY on
-            // all keyboards. On USASCII keyboards, '/' and '?' share the _same_
-            // key. So we have to figure out the vkey at runtime, and we have to
-            // determine if the key that was pressed was '?' with some
-            // modifiers, or '/' with some modifiers.
-            //
-            // These translations are not in s_simpleModifiedKeyMapping, because
-            // the aforementioned fact that they aren't the same VKEY on all
-            // keyboards.
-            //
-            // See GH#3079 for details.
-            // Also see https://github.com/microsoft/terminal/pull/4947#issuecomment-600382856
-
-            // VkKeyScan will give us both the Vkey of the key needed for this
-            // character, and the modifiers the user might need to press to get
-            // this character.
-            const auto slashKeyScan = VkKeyScan(L'/'); // On USASCII: 0x00bf
-            const auto questionMarkKeyScan = VkKeyScan(L'?'); //On USASCII: 0x01bf
-
-            const auto slashVkey = LOBYTE(slashKeyScan);
-            const auto questionMarkVkey = LOBYTE(questionMarkKeyScan);
-
-            const auto ctrl = keyEvent.IsCtrlPressed();
-            const auto alt = keyEvent.IsAltPressed();
-            const bool shift = keyEvent.IsShiftPressed();
-
-            // From the KeyEvent we're translating, synthesize the equivalent VkKeyScan result
-            const auto vkey = keyEvent.GetVirtualKeyCode();
-            const short keyScanFromEvent = vkey |
-                                           (shift ? 0x100 : 0) |
-                                           (ctrl ? 0x200 : 0) |
-                                           (alt ? 0x400 : 0);
-
-            // Make sure the VKEY is an _exact_ match, and that the modifier
-            // bits also match. This handles the hypothetical case we get a
-            // keyscan back that's ctrl+alt+some_random_VK, and some_random_VK
-            // has bits that are a superset of the bits set for question mark.
-            const bool wasQuestionMark = vkey == questionMarkVkey && WI_AreAllFlagsSet(keyScanFromEvent, questionMarkKeyScan);
-            const bool wasSlash = vkey == slashVkey && WI_AreAllFlagsSet(keyScanFromEvent, slashKeyScan);
-
-            // If the key pressed was exactly the ? key, then try to send the
-            // appropriate sequence for a modified '?'. Otherwise, check if this
-            // was a modified '/' keypress. These mappings don't need to be
-            // changed at all.
-            if ((ctrl && alt) && wasQuestionMark)
-            {
-                sender(CTRL_ALT_QUESTIONMARK_SEQUENCE);
-                success = true;
-            }
-            else if (ctrl && wasQuestionMark)
-            {
-                sender(CTRL_QUESTIONMARK_SEQUENCE);
-                success = true;
-            }
-            else if ((ctrl && alt) && wasSlash)
-            {
-                sender(CTRL_ALT_SLASH_SEQUENCE);
-                success = true;
-            }
-            else if (ctrl && wasSlash)
-            {
-                sender(CTRL_SLASH_SEQUENCE);
-                success = true;
-            }
+            sender(CTRL_QUESTIONMARK_SEQUENCE);
+            success = true;
+        }
+        else if ((ctrl && alt) && wasSlash)
+        {
+            sender(CTRL_ALT_SLASH_SEQUENCE);
+            success = true;
+        }
+        else if (ctrl && wasSlash)
+        {
+            sender(CTRL_SLASH_SEQUENCE);
+            success = true;
         }
     }
 
     return success;
 }
 
-// Routine Description:
-// - Searches the input array of mappings, and sends it to the input if a match was found.
-// Arguments:
-// - keyEvent - Key event to translate
-// - keyMapping - Array of key mappings to search
-// - sender - Function to use to dispatch translated event
-// Return Value:
-// - True if there was a match to a key translation, and we successfully sent it to the input
-static bool _translateDefaultMapping(const KeyEvent& keyEvent,
-                                     const gsl::span<const TermKeyMap> keyMapping,
-                                     InputSender sender)
-{
-    const auto match = _searchKeyMapping(keyEvent, keyMapping);
-    if (match)
-    {
-        sender(match->sequence);
-    }
-    return match.has_value();
-}
-
 // Routine Description:
 // - Sends the given input event to the shell.
 // - The caller should attempt to fill the char data in pInEvent if possible.
@@ -630,9 +662,11 @@ bool TerminalInput::HandleKey(const IInputEvent* const pInEvent)
     }
 
     // Check any other key mappings (like those for the F1-F12 keys).
-    const auto mapping = _getKeyMapping(keyEvent, _ansiMode, _cursorApplicationMode, _keypadApplicationMode);
-    if (_translateDefaultMapping(keyEvent, mapping, senderFunc))
+    const auto modes = _getModeIndex(_ansiMode, _cursorApplicationMode, _keypadApplicationMode);
+    const auto sequence = _getKeySequence(til::at(s_keyTables, modes), keyEvent);
+    if (!sequence.empty())
     {
+        _SendInputSequence(sequence);
         return true;
     }
 
@@ -13,6 +13,7 @@ Author(s):
 - Michael Niksa (MiNiksa) 30-Oct-2015
 --*/
 
+#include <chrono>
 #include <functional>
 #include "../../types/inc/IInputEvent.hpp"
 #pragma once
@@ -58,6 +59,8 @@ namespace Microsoft::Console::VirtualTerminal
                          const MouseButtonState state);
 
         bool IsTrackingMouseInput() const noexcept;
+        bool HasPendingMouseMotion() const noexcept;
+        bool FlushPendingMouseMotion();
 #pragma endregion
 
 #pragma region MouseInputState Management
@@ -72,6 +75,8 @@ namespace Microsoft::Console::VirtualTerminal
         void EnableAlternateScroll(const bool enable) noexcept;
         void UseAlternateScreenBuffer() noexcept;
         void UseMainScreenBuffer() noexcept;
+
+        void SetMouseMotionRateLimit(const unsigned int maxRate) noexcept;
 #pragma endregion
 
     private:
@@ -119,6 +124,13 @@ namespace Microsoft::Console::VirtualTerminal
             COORD lastPos{ -1, -1 };
             unsigned int lastButton{ 0 };
             int accumulatedDelta{ 0 };
+
+            // Motion events are coalesced when they come in faster than this.
+            // Zero disables coalescing.
+            std::chrono::steady_clock::duration motionInterval{};
+            std::chrono::steady_clock::time_point lastMotionTime{};
+            unsigned int lastMotionButton{ 0 };
+            std::wstring pendingMotion;
         };
 
         MouseInputState _mouseInputState;
@@ -144,6 +156,7 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool _ShouldSendAlternateScroll(const unsigned int button, const short delta) const noexcept;
         bool _SendAlternateScroll(const short delta) const noexcept;
+        void _SendMouseSequence(const std::wstring& sequence, const bool isMotion, const unsigned int realButton);
 
         static constexpr unsigned int s_GetPressedButton(const MouseButtonState state) noexcept;
 #pragma endregion
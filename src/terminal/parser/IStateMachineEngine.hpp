@@ -34,8 +34,8 @@ namespace Microsoft::Console::VirtualTerminal
         virtual bool ActionPassThroughString(const std::wstring_view string) = 0;
 
         virtual bool ActionEscDispatch(const VTID id) = 0;
-        virtual bool ActionVt52EscDispatch(const VTID id, const gsl::span<const size_t> parameters) = 0;
-        virtual bool ActionCsiDispatch(const VTID id, const gsl::span<const size_t> parameters) = 0;
+        virtual bool ActionVt52EscDispatch(const VTID id, const VTParameters parameters) = 0;
+        virtual bool ActionCsiDispatch(const VTID id, const VTParameters parameters) = 0;
 
         virtual bool ActionClear() = 0;
 
@@ -46,7 +46,7 @@ namespace Microsoft::Console::VirtualTerminal
                                        const std::wstring_view string) = 0;
 
         virtual bool ActionSs3Dispatch(const wchar_t wch,
-                                       const gsl::span<const size_t> parameters) = 0;
+                                       const VTParameters parameters) = 0;
 
         virtual bool ParseControlSequenceAfterSs3() const = 0;
         virtual bool FlushAtEndOfString() const = 0;
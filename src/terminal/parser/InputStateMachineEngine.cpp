@@ -344,7 +344,7 @@ bool InputStateMachineEngine::ActionEscDispatch(const VTID id)
 // - parameters - Set of parameters collected while parsing the sequence.
 // Return Value:
 // - true iff we successfully dispatched the sequence.
-bool InputStateMachineEngine::ActionVt52EscDispatch(const VTID /*id*/, const gsl::span<const size_t> /*parameters*/) noexcept
+bool InputStateMachineEngine::ActionVt52EscDispatch(const VTID /*id*/, const VTParameters /*parameters*/) noexcept
 {
     // VT52 escape sequences are not used in the input state machine.
     return false;
@@ -359,7 +359,7 @@ bool InputStateMachineEngine::ActionVt52EscDispatch(const VTID /*id*/, const gsl
 // - parameters - set of numeric parameters collected while parsing the sequence.
 // Return Value:
 // - true iff we successfully dispatched the sequence.
-bool InputStateMachineEngine::ActionCsiDispatch(const VTID id, const gsl::span<const size_t> parameters)
+bool InputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameters parameters)
 {
     // GH#4999 - If the client was in VT input mode, but we received a
     // win32-input-mode sequence, then _don't_ passthrough the sequence to the
@@ -374,6 +374,13 @@ bool InputStateMachineEngine::ActionCsiDispatch(const VTID id, const gsl::span<c
         return _pfnFlushToInputQueue();
     }
 
+    // None of the input sequences we understand have sub-parameters, so we
+    // don't attempt to interpret any sequence that does.
+    if (parameters.hasSubParameters())
+    {
+        return false;
+    }
+
     DWORD modifierState = 0;
     short vkey = 0;
     unsigned int function = 0;
@@ -507,7 +514,7 @@ bool InputStateMachineEngine::ActionCsiDispatch(const VTID id, const gsl::span<c
 // Return Value:
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionSs3Dispatch(const wchar_t wch,
-                                                const gsl::span<const size_t> /*parameters*/)
+                                                const VTParameters /*parameters*/)
 {
     if (_pDispatch->IsVtInputEnabled() && _pfnFlushToInputQueue)
     {
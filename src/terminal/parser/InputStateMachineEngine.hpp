@@ -142,9 +142,9 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool ActionEscDispatch(const VTID id) override;
 
-        bool ActionVt52EscDispatch(const VTID id, const gsl::span<const size_t> parameters) noexcept override;
+        bool ActionVt52EscDispatch(const VTID id, const VTParameters parameters) noexcept override;
 
-        bool ActionCsiDispatch(const VTID id, const gsl::span<const size_t> parameters) override;
+        bool ActionCsiDispatch(const VTID id, const VTParameters parameters) override;
 
         bool ActionClear() noexcept override;
 
@@ -155,7 +155,7 @@ namespace Microsoft::Console::VirtualTerminal
                                const std::wstring_view string) noexcept override;
 
         bool ActionSs3Dispatch(const wchar_t wch,
-                               const gsl::span<const size_t> parameters) override;
+                               const VTParameters parameters) override;
 
         bool ParseControlSequenceAfterSs3() const noexcept override;
         bool FlushAtEndOfString() const noexcept override;
@@ -326,7 +326,7 @@ bool OutputStateMachineEngine::ActionEscDispatch(const VTID id)
 // - parameters - Set of parameters collected while parsing the sequence.
 // Return Value:
 // - true iff we successfully dispatched the sequence.
-bool OutputStateMachineEngine::ActionVt52EscDispatch(const VTID id, const gsl::span<const size_t> parameters)
+bool OutputStateMachineEngine::ActionVt52EscDispatch(const VTID id, const VTParameters parameters)
 {
     bool success = false;
 
@@ -402,7 +402,7 @@ bool OutputStateMachineEngine::ActionVt52EscDispatch(const VTID id, const gsl::s
 // - parameters - set of numeric parameters collected while parsing the sequence.
 // Return Value:
 // - true iff we successfully dispatched the sequence.
-bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, gsl::span<const size_t> parameters)
+bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameters parameters)
 {
     bool success = false;
     size_t distance = 0;
@@ -415,17 +415,19 @@ bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, gsl::span<const
     unsigned int function = 0;
     DispatchTypes::EraseType eraseType = DispatchTypes::EraseType::ToEnd;
     std::vector<DispatchTypes::PrivateModeParams> privateModeParams;
-    // We hold the vector in the class because client applications that do a lot of color work
-    // would spend a lot of time reallocating/resizing the vector.
-    _graphicsOptions.clear();
+    VTParameters graphicsOptions;
     DispatchTypes::AnsiStatusType deviceStatusType = static_cast<DispatchTypes::AnsiStatusType>(0); // there is no default status type.
     size_t repeatCount = 0;
     DispatchTypes::CursorStyle cursorStyle = DefaultCursorStyle;
     // This is all the args after the first arg, and the count of args not including the first one.
     const auto remainingParams = parameters.size() > 1 ? parameters.subspan(1) : gsl::span<const size_t>{};
+    // Sub-parameters are only defined for SGR, so any other sequence that has them can't
+    // be interpreted reliably. We treat those as unrecognized, which still allows them
+    // to be flushed through to the terminal when there is one.
+    const auto dispatchId = parameters.hasSubParameters() && id != CsiActionCodes::SGR_SetGraphicsRendition ? VTID{ 0 } : id;
 
     // fill params
-    switch (id)
+    switch (dispatchId)
     {
     case CsiActionCodes::CUU_CursorUp:
     case CsiActionCodes::CUD_CursorDown:
@@ -459,7 +461,7 @@ bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, gsl::span<const
         success = _GetPrivateModeParams(parameters, privateModeParams);
         break;
     case CsiActionCodes::SGR_SetGraphicsRendition:
-        success = _GetGraphicsOptions(parameters, _graphicsOptions);
+        success = _GetGraphicsOptions(parameters, graphicsOptions);
         break;
     case CsiActionCodes::DSR_DeviceStatusReport:
         success = _GetDeviceStatusOperation(parameters, deviceStatusType);
@@ -506,7 +508,7 @@ bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, gsl::span<const
     // if param filling successful, try to dispatch
     if (success)
     {
-        switch (id)
+        switch (dispatchId)
         {
         case CsiActionCodes::CUU_CursorUp:
             success = _dispatch->CursorUp(distance);
@@ -584,7 +586,7 @@ bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, gsl::span<const
             TermTelemetry::Instance().Log(TermTelemetry::Codes::DECRST);
             break;
         case CsiActionCodes::SGR_SetGraphicsRendition:
-            success = _dispatch->SetGraphicsRendition({ _graphicsOptions.data(), _graphicsOptions.size() });
+            success = _dispatch->SetGraphicsRendition(graphicsOptions);
             TermTelemetry::Instance().Log(TermTelemetry::Codes::SGR);
             break;
         case CsiActionCodes::DSR_DeviceStatusReport:
@@ -844,7 +846,7 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
 // Return Value:
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionSs3Dispatch(const wchar_t /*wch*/,
-                                                 const gsl::span<const size_t> /*parameters*/) noexcept
+                                                 const VTParameters /*parameters*/) noexcept
 {
     // The output engine doesn't handle any SS3 sequences.
     _ClearLastChar();
@@ -853,38 +855,25 @@ bool OutputStateMachineEngine::ActionSs3Dispatch(const wchar_t /*wch*/,
 
 // Routine Description:
 // - Retrieves the listed graphics options to be applied in order to the "font style" of the next characters inserted into the buffer.
+//   The options are passed through as a view of the parameters, sub-parameters included, so no copy is made.
 // Arguments:
 // - parameters - The parameters to parse
-// - options - Space that will be filled with valid options from the GraphicsOptions enum
+// - options - Receives the options to apply, which is the default option if no parameters were given
 // Return Value:
-// - True if we successfully retrieved an array of valid graphics options from the parameters we've stored. False otherwise.
-bool OutputStateMachineEngine::_GetGraphicsOptions(const gsl::span<const size_t> parameters,
-                                                   std::vector<DispatchTypes::GraphicsOptions>& options) const
+// - True if we successfully retrieved the graphics options from the parameters we've stored. False otherwise.
+bool OutputStateMachineEngine::_GetGraphicsOptions(const VTParameters parameters,
+                                                   VTParameters& options) const noexcept
 {
-    bool success = false;
-
     if (parameters.empty())
     {
-        options.push_back(DefaultGraphicsOption);
-        success = true;
+        options = { &DefaultGraphicsOption, 1 };
     }
     else
     {
-        for (const auto& p : parameters)
-        {
-            options.push_back((DispatchTypes::GraphicsOptions)p);
-        }
-        success = true;
+        options = parameters;
     }
 
-    // If we were unable to process the string, and there's a TTY attached to us,
-    //      trigger the state machine to flush the string to the terminal.
-    if (_pfnFlushToTerminal != nullptr && !success)
-    {
-        success = _pfnFlushToTerminal();
-    }
-
-    return success;
+    return true;
 }
 
 // Routine Description:
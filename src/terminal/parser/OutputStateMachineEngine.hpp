@@ -35,9 +35,9 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool ActionEscDispatch(const VTID id) override;
 
-        bool ActionVt52EscDispatch(const VTID id, const gsl::span<const size_t> parameters) override;
+        bool ActionVt52EscDispatch(const VTID id, const VTParameters parameters) override;
 
-        bool ActionCsiDispatch(const VTID id, const gsl::span<const size_t> parameters) override;
+        bool ActionCsiDispatch(const VTID id, const VTParameters parameters) override;
 
         bool ActionClear() noexcept override;
 
@@ -48,7 +48,7 @@ namespace Microsoft::Console::VirtualTerminal
                                const std::wstring_view string) override;
 
         bool ActionSs3Dispatch(const wchar_t wch,
-                               const gsl::span<const size_t> parameters) noexcept override;
+                               const VTParameters parameters) noexcept override;
 
         bool ParseControlSequenceAfterSs3() const noexcept override;
         bool FlushAtEndOfString() const noexcept override;
@@ -66,7 +66,6 @@ namespace Microsoft::Console::VirtualTerminal
         Microsoft::Console::ITerminalOutputConnection* _pTtyConnection;
         std::function<bool()> _pfnFlushToTerminal;
         wchar_t _lastPrintedChar;
-        std::vector<DispatchTypes::GraphicsOptions> _graphicsOptions;
 
         enum EscActionCodes : uint64_t
         {
@@ -170,9 +169,9 @@ namespace Microsoft::Console::VirtualTerminal
             ResetCursorColor = 112
         };
 
-        static constexpr DispatchTypes::GraphicsOptions DefaultGraphicsOption = DispatchTypes::GraphicsOptions::Off;
-        bool _GetGraphicsOptions(const gsl::span<const size_t> parameters,
-                                 std::vector<DispatchTypes::GraphicsOptions>& options) const;
+        static constexpr size_t DefaultGraphicsOption = DispatchTypes::GraphicsOptions::Off;
+        bool _GetGraphicsOptions(const VTParameters parameters,
+                                 VTParameters& options) const noexcept;
 
         static constexpr DispatchTypes::EraseType DefaultEraseType = DispatchTypes::EraseType::ToEnd;
         bool _GetEraseOperation(const gsl::span<const size_t> parameters,
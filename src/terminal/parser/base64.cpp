@@ -4,16 +4,323 @@
 #include "precomp.h"
 #include "base64.hpp"
 
+#if defined(_M_IX86) || defined(_M_X64)
+#include <intrin.h>
+#endif
+
 using namespace Microsoft::Console::VirtualTerminal;
 
-static const wchar_t base64Chars[] = L"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-static const wchar_t padChar = L'=';
+static constexpr std::string_view base64Chars{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" };
+static constexpr wchar_t padChar = L'=';
+
+// Maps the ASCII range onto the 6-bit value each base64 character represents.
+static constexpr uint8_t invalidChar = 0xff;
+static constexpr auto decodeTable = []() {
+    std::array<uint8_t, 128> table{};
+    for (auto& entry : table)
+    {
+        entry = invalidChar;
+    }
+    for (size_t i = 0; i < base64Chars.size(); i++)
+    {
+        table[base64Chars[i]] = gsl::narrow_cast<uint8_t>(i);
+    }
+    return table;
+}();
+
+// The number of UTF-16 code units s_Encode converts to UTF-8 at a time.
+static constexpr size_t encodeChunkSize = 1024;
+
+#pragma warning(disable : 26429 26446 26447 26481 26482 26485 26490 26493 26494)
+
+namespace
+{
+    // Collects decoded bytes in a fixed buffer and converts them from UTF-8 to
+    // UTF-16 straight into the destination string whenever the buffer fills up.
+    // A partial UTF-8 sequence at the end of the buffer is carried over to the
+    // next conversion, so no intermediate string is needed for either encoding.
+    class Utf16Writer
+    {
+    public:
+        Utf16Writer(std::wstring& dst) noexcept :
+            _dst{ dst },
+            _buffer{},
+            _size{ 0 }
+        {
+        }
+
+        // Returns space for at least count bytes (at most 32) at the end of the buffer.
+        char* Reserve(const size_t count) noexcept
+        {
+            if (_size + count > _buffer.size())
+            {
+                Flush(false);
+            }
+            return _buffer.data() + _size;
+        }
+
+        void Commit(const size_t count) noexcept
+        {
+            _size += count;
+        }
+
+        // Converts all complete UTF-8 sequences in the buffer. If this is the
+        // final flush, any incomplete sequence at the end is converted as well
+        // (turning into U+FFFD) instead of being carried over.
+        void Flush(const bool final) noexcept
+        {
+            const auto complete = final ? _size : _size - _IncompleteTailLength();
+            if (complete != 0)
+            {
+                const auto offset = _dst.size();
+                _dst.resize(offset + complete); // UTF-16 never needs more code units than UTF-8.
+                const auto written = MultiByteToWideChar(CP_UTF8,
+                                                         0,
+                                                         _buffer.data(),
+                                                         gsl::narrow_cast<int>(complete),
+                                                         _dst.data() + offset,
+                                                         gsl::narrow_cast<int>(complete));
+                _dst.resize(offset + gsl::narrow_cast<size_t>(written));
+            }
+
+            std::copy(_buffer.data() + complete, _buffer.data() + _size, _buffer.data());
+            _size -= complete;
+        }
+
+    private:
+        // Returns the number of bytes at the end of the buffer which belong to a
+        // UTF-8 sequence that hasn't been completed yet.
+        size_t _IncompleteTailLength() const noexcept
+        {
+            for (size_t i = 1; i <= std::min<size_t>(_size, 3); i++)
+            {
+                const auto byte = gsl::narrow_cast<uint8_t>(_buffer[_size - i]);
+                if ((byte & 0xc0) != 0x80) // The lead byte of the last sequence.
+                {
+                    const size_t length = byte >= 0xf0 ? 4 : byte >= 0xe0 ? 3 : byte >= 0xc0 ? 2 : 1;
+                    return length > i ? i : 0;
+                }
+            }
+            return 0;
+        }
+
+        std::wstring& _dst;
+        std::array<char, 4096> _buffer;
+        size_t _size;
+    };
+
+    // Encodes complete groups of 3 bytes into 4 base64 characters each.
+    void EncodeGroupScalar(const char* src, wchar_t* dst) noexcept
+    {
+        const auto b0 = gsl::narrow_cast<uint8_t>(src[0]);
+        const auto b1 = gsl::narrow_cast<uint8_t>(src[1]);
+        const auto b2 = gsl::narrow_cast<uint8_t>(src[2]);
+        dst[0] = base64Chars[b0 >> 2];
+        dst[1] = base64Chars[(b0 & 0x03) << 4 | b1 >> 4];
+        dst[2] = base64Chars[(b1 & 0x0f) << 2 | b2 >> 6];
+        dst[3] = base64Chars[b2 & 0x3f];
+    }
+
+#if defined(_M_IX86) || defined(_M_X64)
+    struct CpuSupport
+    {
+        bool ssse3;
+        bool avx2;
+    };
+
+    const CpuSupport& GetCpuSupport() noexcept
+    {
+        static const auto support = []() noexcept {
+            CpuSupport result{};
+            int info[4]{};
+
+            __cpuid(info, 0);
+            const auto maxLeaf = info[0];
+            if (maxLeaf >= 1)
+            {
+                __cpuid(info, 1);
+                result.ssse3 = WI_IsFlagSet(info[2], 1 << 9);
+
+                // AVX2 additionally requires the OS to preserve the YMM registers.
+                const auto osxsave = WI_IsFlagSet(info[2], 1 << 27);
+                const auto avx = WI_IsFlagSet(info[2], 1 << 28);
+                if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6)
+                {
+                    __cpuidex(info, 7, 0);
+                    result.avx2 = WI_IsFlagSet(info[1], 1 << 5);
+                }
+            }
+
+            return result;
+        }();
+        return support;
+    }
+
+    // The decoding kernels below are based on the vectorized base64 algorithms
+    // by Wojciech Muła and Daniel Lemire. Each input byte is validated and
+    // translated with a pair of nibble lookup tables, and the resulting 6-bit
+    // values are merged into 24-bit groups with two multiply-adds.
+    //
+    // Our input is UTF-16, so it's first narrowed with a saturating pack. Any
+    // code unit outside of the Latin-1 range turns into 0x00 or 0xFF, neither
+    // of which is a base64 character, so it'll be caught by the validation.
+
+    // Decodes 16 base64 characters into 12 bytes. Writes 16 bytes to dst.
+    // Returns false without decoding anything if any of them is invalid,
+    // which includes whitespace and padding.
+    bool DecodeBlockSsse3(const wchar_t* src, char* dst) noexcept
+    {
+        const auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        const auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+        const auto in = _mm_packus_epi16(lo, hi);
+
+        const auto lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+        const auto lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+        const auto lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+        const auto nibbleMask = _mm_set1_epi8(0x0f);
+
+        const auto hiNibbles = _mm_and_si128(_mm_srli_epi32(in, 4), nibbleMask);
+        const auto loNibbles = _mm_and_si128(in, nibbleMask);
+        const auto invalid = _mm_and_si128(_mm_shuffle_epi8(lutLo, loNibbles), _mm_shuffle_epi8(lutHi, hiNibbles));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(invalid, _mm_setzero_si128())) != 0xffff)
+        {
+            return false;
+        }
+
+        const auto isSlash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+        const auto roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(isSlash, hiNibbles));
+        const auto values = _mm_add_epi8(in, roll);
+
+        const auto pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        const auto groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        const auto out = _mm_shuffle_epi8(groups, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), out);
+        return true;
+    }
+
+    // Same as DecodeBlockSsse3, but for 32 base64 characters into 24 bytes.
+    // Writes 32 bytes to dst.
+    bool DecodeBlockAvx2(const wchar_t* src, char* dst) noexcept
+    {
+        const auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        const auto hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 16));
+        // The pack works within each 128-bit lane, so the quadwords need to be put back in order.
+        const auto in = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xd8);
+
+        const auto lutLo = _mm256_broadcastsi128_si256(_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a));
+        const auto lutHi = _mm256_broadcastsi128_si256(_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10));
+        const auto lutRoll = _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0));
+        const auto nibbleMask = _mm256_set1_epi8(0x0f);
+
+        const auto hiNibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), nibbleMask);
+        const auto loNibbles = _mm256_and_si256(in, nibbleMask);
+        const auto invalid = _mm256_and_si256(_mm256_shuffle_epi8(lutLo, loNibbles), _mm256_shuffle_epi8(lutHi, hiNibbles));
+        if (!_mm256_testz_si256(invalid, invalid))
+        {
+            return false;
+        }
+
+        const auto isSlash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+        const auto roll = _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(isSlash, hiNibbles));
+        const auto values = _mm256_add_epi8(in, roll);
+
+        const auto pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        const auto groups = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        const auto packed = _mm256_shuffle_epi8(groups, _mm256_broadcastsi128_si256(_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+        // Each lane now holds 12 bytes. Move them next to each other.
+        const auto out = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), out);
+        return true;
+    }
+
+    // Encodes 12 bytes into 16 base64 characters. Reads 16 bytes from src.
+    void EncodeBlockSsse3(const char* src, wchar_t* dst) noexcept
+    {
+        auto in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
 
-#pragma warning(disable : 26446 26447 26482 26485 26493 26494)
+        // Split each group of 3 bytes into 4 bytes holding 6 bits each.
+        const auto t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+        const auto t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        const auto t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+        const auto t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        const auto indices = _mm_or_si128(t1, t3);
+
+        // Map each range of the alphabet (A-Z, a-z, 0-9, +, /) onto the offset
+        // that turns its 6-bit values into ASCII.
+        const auto shiftLut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+        auto ranges = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        const auto isUpper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+        ranges = _mm_or_si128(ranges, _mm_and_si128(isUpper, _mm_set1_epi8(13)));
+        const auto out = _mm_add_epi8(_mm_shuffle_epi8(shiftLut, ranges), indices);
+
+        const auto zero = _mm_setzero_si128();
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi8(out, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), _mm_unpackhi_epi8(out, zero));
+    }
+#endif
+
+    // Decodes as many blocks of base64 characters as possible with SIMD, until
+    // we run out of input or come across a block with whitespace or padding.
+    // Returns the number of characters consumed, which is a multiple of 4.
+    size_t DecodeBlocks(const wchar_t* src, const size_t count, Utf16Writer& writer) noexcept
+    {
+        size_t consumed = 0;
+#if defined(_M_IX86) || defined(_M_X64)
+        const auto& cpu = GetCpuSupport();
+        if (cpu.avx2)
+        {
+            while (count - consumed >= 32 && DecodeBlockAvx2(src + consumed, writer.Reserve(32)))
+            {
+                writer.Commit(24);
+                consumed += 32;
+            }
+        }
+        if (cpu.ssse3)
+        {
+            while (count - consumed >= 16 && DecodeBlockSsse3(src + consumed, writer.Reserve(16)))
+            {
+                writer.Commit(12);
+                consumed += 16;
+            }
+        }
+#else
+        UNREFERENCED_PARAMETER(src);
+        UNREFERENCED_PARAMETER(count);
+        UNREFERENCED_PARAMETER(writer);
+#endif
+        return consumed;
+    }
+
+    // Encodes complete groups of 3 bytes and appends the result to dst.
+    void EncodeGroups(const char* src, const size_t groups, std::wstring& dst) noexcept
+    {
+        const auto offset = dst.size();
+        dst.resize(offset + groups * 4);
+        auto out = dst.data() + offset;
+
+        size_t i = 0;
+#if defined(_M_IX86) || defined(_M_X64)
+        if (GetCpuSupport().ssse3)
+        {
+            // Each block consumes 4 groups but reads 16 bytes, so make sure
+            // there are at least 6 groups left to not read past the input.
+            for (; i + 6 <= groups; i += 4)
+            {
+                EncodeBlockSsse3(src + i * 3, out + i * 4);
+            }
+        }
+#endif
+        for (; i < groups; i++)
+        {
+            EncodeGroupScalar(src + i * 3, out + i * 4);
+        }
+    }
+}
 
 // Routine Description:
-// - Encode a string using base64. When there are not enough characters
-//      for one quantum, paddings are added.
+// - Encode a string using base64. The string is encoded as UTF-8 first.
+//      When there are not enough bytes for one quantum, paddings are added.
 // Arguments:
 // - src - String to base64 encode.
 // Return Value:
@@ -21,44 +328,54 @@ static const wchar_t padChar = L'=';
 std::wstring Base64::s_Encode(const std::wstring_view src) noexcept
 {
     std::wstring dst;
-    wchar_t input[3];
-
-    const auto len = (src.size() + 2) / 3 * 4;
-    if (len == 0)
+    if (src.empty())
     {
         return dst;
     }
-    dst.reserve(len);
+    dst.reserve((src.size() + 2) / 3 * 4);
 
-    auto iter = src.cbegin();
-    // Encode each three chars into one quantum (four chars).
-    while (iter < src.cend() - 2)
-    {
-        input[0] = *iter++;
-        input[1] = *iter++;
-        input[2] = *iter++;
-        dst.push_back(base64Chars[input[0] >> 2]);
-        dst.push_back(base64Chars[(input[0] & 0x03) << 4 | input[1] >> 4]);
-        dst.push_back(base64Chars[(input[1] & 0x0f) << 2 | input[2] >> 6]);
-        dst.push_back(base64Chars[(input[2] & 0x3f)]);
-    }
+    // The UTF-8 conversion happens one chunk at a time, so that we never need
+    // a copy of the entire input. Up to 2 bytes that didn't make up a complete
+    // group in one chunk are carried over to the front of the next one.
+    std::array<char, encodeChunkSize * 3 + 2> bytes;
+    size_t carry = 0;
 
-    // Here only zero, or one, or two chars are left. We may need to add paddings.
-    if (iter < src.cend())
+    auto remaining = src;
+    while (!remaining.empty())
     {
-        input[0] = *iter++;
-        dst.push_back(base64Chars[input[0] >> 2]);
-        if (iter < src.cend()) // Two chars left.
+        auto count = std::min(remaining.size(), encodeChunkSize);
+        // Don't split a surrogate pair across two conversions.
+        if (count < remaining.size() && IS_HIGH_SURROGATE(remaining.at(count - 1)))
         {
-            input[1] = *iter++;
-            dst.push_back(base64Chars[(input[0] & 0x03) << 4 | input[1] >> 4]);
-            dst.push_back(base64Chars[(input[1] & 0x0f) << 2]);
-        }
-        else // Only one char left.
-        {
-            dst.push_back(base64Chars[(input[0] & 0x03) << 4]);
-            dst.push_back(padChar);
+            count--;
         }
+
+        const auto converted = WideCharToMultiByte(CP_UTF8,
+                                                   0,
+                                                   remaining.data(),
+                                                   gsl::narrow_cast<int>(count),
+                                                   bytes.data() + carry,
+                                                   gsl::narrow_cast<int>(bytes.size() - carry),
+                                                   nullptr,
+                                                   nullptr);
+        remaining = remaining.substr(count);
+
+        const auto total = carry + gsl::narrow_cast<size_t>(converted);
+        const auto groups = total / 3;
+        EncodeGroups(bytes.data(), groups, dst);
+
+        carry = total - groups * 3;
+        std::copy_n(bytes.data() + groups * 3, carry, bytes.data());
+    }
+
+    // Here only zero, or one, or two bytes are left. We may need to add paddings.
+    if (carry != 0)
+    {
+        const auto b0 = gsl::narrow_cast<uint8_t>(bytes[0]);
+        const auto b1 = carry == 2 ? gsl::narrow_cast<uint8_t>(bytes[1]) : uint8_t{ 0 };
+        dst.push_back(base64Chars[b0 >> 2]);
+        dst.push_back(base64Chars[(b0 & 0x03) << 4 | b1 >> 4]);
+        dst.push_back(carry == 2 ? base64Chars[(b1 & 0x0f) << 2] : padChar);
         dst.push_back(padChar);
     }
 
@@ -66,8 +383,11 @@ std::wstring Base64::s_Encode(const std::wstring_view src) noexcept
 }
 
 // Routine Description:
-// - Decode a base64 string. This requires the base64 string is properly padded.
-//      Otherwise, false will be returned.
+// - Decode a base64 string and append it to dst. The decoded bytes are
+//      expected to be UTF-8, and are converted to UTF-16 as they're decoded.
+//      This requires the base64 string is properly padded, and contains nothing
+//      but base64 characters and whitespace. Otherwise, false will be returned
+//      and dst is left unchanged.
 // Arguments:
 // - src - String to decode.
 // - dst - Destination to decode into.
@@ -75,19 +395,38 @@ std::wstring Base64::s_Encode(const std::wstring_view src) noexcept
 // - true if decoding successfully, otherwise false.
 bool Base64::s_Decode(const std::wstring_view src, std::wstring& dst) noexcept
 {
-    int state = 0;
-    wchar_t tmp;
-
     const auto len = src.size() / 4 * 3;
     if (len == 0)
     {
         return false;
     }
-    dst.reserve(len);
 
-    auto iter = src.cbegin();
-    while (iter < src.cend())
+    const auto originalSize = dst.size();
+    dst.reserve(originalSize + len);
+
+    Utf16Writer writer{ dst };
+    const auto fail = [&]() noexcept {
+        dst.resize(originalSize);
+        return false;
+    };
+
+    uint32_t accumulator = 0;
+    int state = 0;
+
+    auto iter = src.data();
+    const auto end = iter + src.size();
+    while (iter < end)
     {
+        // On a quantum boundary, try to decode whole blocks at once.
+        if (state == 0)
+        {
+            iter += DecodeBlocks(iter, gsl::narrow_cast<size_t>(end - iter), writer);
+            if (iter == end)
+            {
+                break;
+            }
+        }
+
         if (s_IsSpace(*iter)) // Skip whitespace anywhere.
         {
             iter++;
@@ -99,83 +438,75 @@ bool Base64::s_Decode(const std::wstring_view src, std::wstring& dst) noexcept
             break;
         }
 
-        auto pos = wcschr(base64Chars, *iter);
-        if (!pos) // A non-base64 character found.
+        const auto value = *iter < decodeTable.size() ? decodeTable.at(*iter) : invalidChar;
+        if (value == invalidChar) // A non-base64 character found.
         {
-            return false;
+            return fail();
         }
 
-        switch (state)
+        accumulator = accumulator << 6 | value;
+        if (++state == 4)
         {
-        case 0:
-            tmp = (wchar_t)(pos - base64Chars) << 2;
-            state = 1;
-            break;
-        case 1:
-            tmp |= (pos - base64Chars) >> 4;
-            dst.push_back(tmp);
-            tmp = (wchar_t)((pos - base64Chars) & 0x0f) << 4;
-            state = 2;
-            break;
-        case 2:
-            tmp |= (pos - base64Chars) >> 2;
-            dst.push_back(tmp);
-            tmp = (wchar_t)((pos - base64Chars) & 0x03) << 6;
-            state = 3;
-            break;
-        case 3:
-            tmp |= pos - base64Chars;
-            dst.push_back(tmp);
+            const auto out = writer.Reserve(3);
+            out[0] = gsl::narrow_cast<char>(accumulator >> 16);
+            out[1] = gsl::narrow_cast<char>(accumulator >> 8);
+            out[2] = gsl::narrow_cast<char>(accumulator);
+            writer.Commit(3);
+            accumulator = 0;
             state = 0;
-            break;
-        default:
-            break;
         }
 
         iter++;
     }
 
-    if (iter < src.cend()) // Padding char is met.
+    if (iter < end) // Padding char is met.
     {
         iter++;
-        switch (state)
+        if (state == 2)
         {
-        // Invalid when state is 0 or 1.
-        case 0:
-        case 1:
-            return false;
-        case 2:
             // Skip any number of spaces.
-            while (iter < src.cend() && s_IsSpace(*iter))
+            while (iter < end && s_IsSpace(*iter))
             {
                 iter++;
             }
             // Make sure there is another trailing padding character.
-            if (iter == src.cend() || *iter != padChar)
+            if (iter == end || *iter != padChar)
             {
-                return false;
+                return fail();
             }
-            iter++; // Skip the padding character and fallthrough to "single trailing padding character" case.
-            [[fallthrough]];
-        case 3:
-            while (iter < src.cend())
+            iter++;
+
+            writer.Reserve(1)[0] = gsl::narrow_cast<char>(accumulator >> 4);
+            writer.Commit(1);
+        }
+        else if (state == 3)
+        {
+            const auto out = writer.Reserve(2);
+            out[0] = gsl::narrow_cast<char>(accumulator >> 10);
+            out[1] = gsl::narrow_cast<char>(accumulator >> 2);
+            writer.Commit(2);
+        }
+        else // Invalid when state is 0 or 1.
+        {
+            return fail();
+        }
+
+        // Only whitespace may follow the padding.
+        while (iter < end)
+        {
+            if (!s_IsSpace(*iter))
             {
-                if (!s_IsSpace(*iter))
-                {
-                    return false;
-                }
-                iter++;
+                return fail();
             }
-            break;
-        default:
-            break;
+            iter++;
         }
     }
     else if (state != 0) // When no padding, we must be in state 0.
     {
-        return false;
+        return fail();
     }
 
+    writer.Flush(true);
     return true;
 }
 
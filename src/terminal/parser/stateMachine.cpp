@@ -16,6 +16,7 @@ StateMachine::StateMachine(std::unique_ptr<IStateMachineEngine> engine) :
     _trace(Microsoft::Console::VirtualTerminal::ParserTracing()),
     _isInAnsiMode(true),
     _parameters{},
+    _oscView{},
     _oscString{},
     _cachedSequence{ std::nullopt },
     _processingIndividually(false)
@@ -177,12 +178,14 @@ static constexpr bool _isCsiPrivateMarker(const wchar_t wch) noexcept
 }
 
 // Routine Description:
-// - Determines if a character is invalid in a control sequence
+// - Determines if a character is a delimiter between a parameter and its sub-parameters,
+//   or between two sub-parameters, in a control sequence (see ITU T.416).
+//   Only CSI sequences support sub-parameters. Other sequences treat this as invalid.
 // Arguments:
 // - wch - Character to check.
 // Return Value:
 // - True if it is. False if it isn't.
-static constexpr bool _isCsiInvalid(const wchar_t wch) noexcept
+static constexpr bool _isSubParameterDelimiter(const wchar_t wch) noexcept
 {
     return wch == L':'; // 0x3A
 }
@@ -196,7 +199,7 @@ static constexpr bool _isCsiInvalid(const wchar_t wch) noexcept
 static constexpr bool _isIntermediateInvalid(const wchar_t wch) noexcept
 {
     // 0x30 - 0x3F
-    return _isNumericParamValue(wch) || _isCsiInvalid(wch) || _isParameterDelimiter(wch) || _isCsiPrivateMarker(wch);
+    return _isNumericParamValue(wch) || _isSubParameterDelimiter(wch) || _isParameterDelimiter(wch) || _isCsiPrivateMarker(wch);
 }
 
 // Routine Description:
@@ -208,7 +211,7 @@ static constexpr bool _isIntermediateInvalid(const wchar_t wch) noexcept
 static constexpr bool _isParameterInvalid(const wchar_t wch) noexcept
 {
     // 0x3A, 0x3C - 0x3F
-    return _isCsiInvalid(wch) || _isCsiPrivateMarker(wch);
+    return _isSubParameterDelimiter(wch) || _isCsiPrivateMarker(wch);
 }
 
 // Routine Description:
@@ -371,6 +374,19 @@ static constexpr bool _isActionableFromGround(const wchar_t wch) noexcept
     return (wch <= AsciiChars::US) || _isC1ControlCharacter(wch) || _isDelete(wch);
 }
 
+// Routine Description:
+// - Determines if a character can change the state of (or be dropped from) a
+//     "Variable Length String". Everything else is plain payload that's either
+//     collected (OSC) or has no effect at all (DCS pass through, SOS/PM/APC).
+// Arguments:
+// - wch - Character to check.
+// Return Value:
+// - True if it is. False if it isn't.
+static constexpr bool _isVariableLengthStringControl(const wchar_t wch) noexcept
+{
+    return (wch <= AsciiChars::US) || _isC1ControlCharacter(wch);
+}
+
 #pragma warning(pop)
 
 // Routine Description:
@@ -445,8 +461,7 @@ void StateMachine::_ActionVt52EscDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"Vt52EscDispatch");
 
-    const bool success = _engine->ActionVt52EscDispatch(_identifier.Finalize(wch),
-                                                        { _parameters.data(), _parameters.size() });
+    const bool success = _engine->ActionVt52EscDispatch(_identifier.Finalize(wch), _parameters.View());
 
     // Trace the result.
     _trace.DispatchSequenceTrace(success);
@@ -469,8 +484,7 @@ void StateMachine::_ActionCsiDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"CsiDispatch");
 
-    const bool success = _engine->ActionCsiDispatch(_identifier.Finalize(wch),
-                                                    { _parameters.data(), _parameters.size() });
+    const bool success = _engine->ActionCsiDispatch(_identifier.Finalize(wch), _parameters.View());
 
     // Trace the result.
     _trace.DispatchSequenceTrace(success);
@@ -510,7 +524,7 @@ void StateMachine::_ActionParam(const wchar_t wch)
     // If we have no parameters and we're about to add one, get the 0 value ready here.
     if (_parameters.empty())
     {
-        _parameters.push_back(0);
+        _parameters.AddParameter(0);
     }
 
     // On a delimiter, increase the number of params we've seen.
@@ -519,13 +533,35 @@ void StateMachine::_ActionParam(const wchar_t wch)
     if (wch == L';')
     {
         // Move to next param.
-        _parameters.push_back(0);
+        _parameters.AddParameter(0);
     }
     else
     {
-        // Accumulate the character given into the last (current) parameter
-        _AccumulateTo(wch, _parameters.back());
+        // Accumulate the character given into the last (current) parameter,
+        // or into its last sub-parameter if we've seen a colon since.
+        _AccumulateTo(wch, _parameters.CurrentValue());
+    }
+}
+
+// Routine Description:
+// - Triggers the SubParam action to indicate that the state machine should start a new
+//   sub-parameter of the current parameter. As with parameters, "empty" sub-parameters
+//   still count, eg "\x1b[38:2::255:0:0m" has an empty color space id.
+// Arguments:
+// - wch - Character to dispatch.
+// Return Value:
+// - <none>
+void StateMachine::_ActionSubParam(const wchar_t /*wch*/)
+{
+    _trace.TraceOnAction(L"SubParam");
+
+    // A sub-parameter always belongs to a parameter, even an empty one.
+    if (_parameters.empty())
+    {
+        _parameters.AddParameter(0);
     }
+
+    _parameters.AddSubParameter();
 }
 
 // Routine Description:
@@ -541,8 +577,9 @@ void StateMachine::_ActionClear()
     // clear all internal stored state.
     _identifier.Clear();
 
-    _parameters.clear();
+    _parameters.Clear();
 
+    _oscView = {};
     _oscString.clear();
     _oscParameter = 0;
 
@@ -584,9 +621,39 @@ void StateMachine::_ActionOscPut(const wchar_t wch)
 {
     _trace.TraceOnAction(L"OscPut");
 
+    _SpillOscView();
     _oscString.push_back(wch);
 }
 
+// Routine Description:
+// - Stores a run of characters as part of the OSC string. If nothing has been
+//   collected yet, or the run directly continues the one we already have,
+//   only the view is updated and no characters are copied.
+// - The given string must remain valid until the end of the current call to
+//   ProcessString, at which point any view still held is spilled into _oscString.
+// Arguments:
+// - string - Characters to collect.
+// Return Value:
+// - <none>
+void StateMachine::_ActionOscPutString(const std::wstring_view string)
+{
+    _trace.TraceOnAction(L"OscPutString");
+
+    if (_oscString.empty() && _oscView.empty())
+    {
+        _oscView = string;
+    }
+    else if (_oscString.empty() && _oscView.data() + _oscView.size() == string.data())
+    {
+        _oscView = { _oscView.data(), _oscView.size() + string.size() };
+    }
+    else
+    {
+        _SpillOscView();
+        _oscString.append(string);
+    }
+}
+
 // Routine Description:
 // - Triggers the CsiDispatch action to indicate that the listener should handle a control sequence.
 //   These sequences perform various API-type commands that can include many parameters.
@@ -598,7 +665,15 @@ void StateMachine::_ActionOscDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"OscDispatch");
 
-    const bool success = _engine->ActionOscDispatch(wch, _oscParameter, _oscString);
+    // If the whole payload arrived in one piece, hand the engine a view of the
+    // input directly. Otherwise it has been accumulated in _oscString.
+    const std::wstring_view payload = _oscString.empty() ? _oscView : std::wstring_view{ _oscString };
+    const bool success = _engine->ActionOscDispatch(wch, _oscParameter, payload);
+
+    // The payload is done with. Let go of it now, so that the spill at the end
+    // of ProcessString doesn't copy a finished payload for nothing.
+    _oscView = {};
+    _oscString.clear();
 
     // Trace the result.
     _trace.DispatchSequenceTrace(success);
@@ -621,7 +696,7 @@ void StateMachine::_ActionSs3Dispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"Ss3Dispatch");
 
-    const bool success = _engine->ActionSs3Dispatch(wch, { _parameters.data(), _parameters.size() });
+    const bool success = _engine->ActionSs3Dispatch(wch, _parameters.View());
 
     // Trace the result.
     _trace.DispatchSequenceTrace(success);
@@ -1112,7 +1187,7 @@ void StateMachine::_EventEscapeIntermediate(const wchar_t wch)
 //   2. Ignore Delete characters
 //   3. Collect Intermediate characters
 //   4. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
-//   5. Store parameter data
+//   5. Store parameter and sub-parameter data
 //   6. Collect Control Sequence Private markers
 //   7. Dispatch a control sequence with parameters for action
 // Arguments:
@@ -1135,15 +1210,16 @@ void StateMachine::_EventCsiEntry(const wchar_t wch)
         _ActionCollect(wch);
         _EnterCsiIntermediate();
     }
-    else if (_isCsiInvalid(wch))
-    {
-        _EnterCsiIgnore();
-    }
     else if (_isNumericParamValue(wch) || _isParameterDelimiter(wch))
     {
         _ActionParam(wch);
         _EnterCsiParam();
     }
+    else if (_isSubParameterDelimiter(wch))
+    {
+        _ActionSubParam(wch);
+        _EnterCsiParam();
+    }
     else if (_isCsiPrivateMarker(wch))
     {
         _ActionCollect(wch);
@@ -1238,7 +1314,7 @@ void StateMachine::_EventCsiIgnore(const wchar_t wch)
 //   2. Ignore Delete characters
 //   3. Collect Intermediate characters
 //   4. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
-//   5. Store parameter data
+//   5. Store parameter and sub-parameter data
 //   6. Dispatch a control sequence with parameters for action
 // Arguments:
 // - wch - Character that triggered the event
@@ -1259,6 +1335,10 @@ void StateMachine::_EventCsiParam(const wchar_t wch)
     {
         _ActionParam(wch);
     }
+    else if (_isSubParameterDelimiter(wch))
+    {
+        _ActionSubParam(wch);
+    }
     else if (_isIntermediate(wch))
     {
         _ActionCollect(wch);
@@ -1376,7 +1456,7 @@ void StateMachine::_EventSs3Entry(const wchar_t wch)
     {
         _ActionIgnore();
     }
-    else if (_isCsiInvalid(wch))
+    else if (_isSubParameterDelimiter(wch))
     {
         // It's safe for us to go into the CSI ignore here, because both SS3 and
         //      CSI sequences ignore characters the same way.
@@ -1456,7 +1536,7 @@ void StateMachine::_EventVt52Param(const wchar_t wch)
     }
     else
     {
-        _parameters.push_back(wch);
+        _parameters.AddParameter(wch);
         if (_parameters.size() == 2)
         {
             // The command character is processed before the parameter values,
@@ -1494,7 +1574,7 @@ void StateMachine::_EventDcsEntry(const wchar_t wch)
     {
         _ActionIgnore();
     }
-    else if (_isCsiInvalid(wch))
+    else if (_isSubParameterDelimiter(wch))
     {
         _EnterDcsIgnore();
     }
@@ -1864,6 +1944,20 @@ void StateMachine::ProcessString(const std::wstring_view string)
         // fallback that picks up this _run inside `FlushToTerminal` above.
         _run = string.substr(start, current - start + 1);
 
+        if (_processingIndividually && _IsVariableLengthStringState())
+        {
+            // A "Variable Length String" can be very long (an OSC 52 clipboard write
+            // can be megabytes), so rather than feeding its payload through the state
+            // machine one character at a time, scan ahead to the next character that
+            // might actually end the string, and consume everything before it at once.
+            const auto next = _ScanVariableLengthString(string, current);
+            if (next != current)
+            {
+                current = next;
+                continue;
+            }
+        }
+
         if (_processingIndividually)
         {
             // If we're processing characters individually, send it to the state machine.
@@ -1906,6 +2000,10 @@ void StateMachine::ProcessString(const std::wstring_view string)
     // to include the final character (unlike the one inside the top of the loop above.)
     _run = start < string.size() ? string.substr(start) : std::wstring_view{};
 
+    // Any OSC payload we're still holding as a view into the given string
+    // must be copied out now, since the string won't outlive this call.
+    _SpillOscView();
+
     // If we're at the end of the string and have remaining un-printed characters,
     if (!_processingIndividually && !_run.empty())
     {
@@ -1980,7 +2078,13 @@ void StateMachine::ProcessString(const std::wstring_view string)
             // If the engine doesn't require flushing at the end of the string, we
             // want to cache the partial sequence in case we have to flush the whole
             // thing to the terminal later.
-            _cachedSequence = _cachedSequence.value_or(std::wstring{}) + std::wstring{ _run };
+            // Append in place, so that a long sequence which spans many writes
+            // isn't copied in its entirety again for every one of them.
+            if (!_cachedSequence.has_value())
+            {
+                _cachedSequence.emplace();
+            }
+            _cachedSequence->append(_run);
         }
     }
 }
@@ -2034,3 +2138,46 @@ const bool StateMachine::_IsVariableLengthStringState() const noexcept
 {
     return _state == VTStates::OscString || _state == VTStates::DcsPassThrough || _state == VTStates::SosPmApcString;
 }
+
+// Routine Description:
+// - Copies the OSC payload we've been tracking as a view into the caller's
+//   string over into our own buffer. This is necessary whenever the view can't
+//   simply be extended, or is about to outlive the string it points into.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void StateMachine::_SpillOscView()
+{
+    if (!_oscView.empty())
+    {
+        _oscString.append(_oscView);
+        _oscView = {};
+    }
+}
+
+// Routine Description:
+// - Consumes as much of a "Variable Length String" payload as possible in one
+//   step, starting at the given offset. Only characters which can't terminate
+//   the string or be ignored by it are consumed. OSC payloads are collected
+//   as a single run; DCS pass through and SOS/PM/APC payloads have no effect.
+// - Whatever character stops the scan is left to ProcessCharacter.
+// Arguments:
+// - string - The string currently being processed.
+// - offset - The position of the next character to process.
+// Return Value:
+// - The position of the first character that wasn't consumed.
+size_t StateMachine::_ScanVariableLengthString(const std::wstring_view string, const size_t offset)
+{
+    const auto begin = string.cbegin() + offset;
+    const auto end = std::find_if(begin, string.cend(), _isVariableLengthStringControl);
+    const auto count = gsl::narrow_cast<size_t>(end - begin);
+
+    if (count != 0 && _state == VTStates::OscString)
+    {
+        _ActionOscPutString(string.substr(offset, count));
+    }
+
+    return offset + count;
+}
+
@@ -32,6 +32,7 @@ namespace Microsoft::Console::VirtualTerminal
 #ifdef UNIT_TESTING
         friend class OutputEngineTest;
         friend class InputEngineTest;
+        friend class StateMachineTest;
 #endif
 
     public:
@@ -57,9 +58,11 @@ namespace Microsoft::Console::VirtualTerminal
         void _ActionVt52EscDispatch(const wchar_t wch);
         void _ActionCollect(const wchar_t wch) noexcept;
         void _ActionParam(const wchar_t wch);
+        void _ActionSubParam(const wchar_t wch);
         void _ActionCsiDispatch(const wchar_t wch);
         void _ActionOscParam(const wchar_t wch) noexcept;
         void _ActionOscPut(const wchar_t wch);
+        void _ActionOscPutString(const std::wstring_view string);
         void _ActionOscDispatch(const wchar_t wch);
         void _ActionSs3Dispatch(const wchar_t wch);
         void _ActionDcsPassThrough(const wchar_t wch);
@@ -111,6 +114,8 @@ namespace Microsoft::Console::VirtualTerminal
 
         void _AccumulateTo(const wchar_t wch, size_t& value) noexcept;
         const bool _IsVariableLengthStringState() const noexcept;
+        size_t _ScanVariableLengthString(const std::wstring_view string, const size_t offset);
+        void _SpillOscView();
 
         enum class VTStates
         {
@@ -148,8 +153,12 @@ namespace Microsoft::Console::VirtualTerminal
         std::wstring_view _run;
 
         VTIDBuilder _identifier;
-        std::vector<size_t> _parameters;
+        VTParameterBuilder _parameters;
 
+        // The OSC payload is captured as a view into the string given to
+        // ProcessString for as long as it stays within that one string. Only
+        // once a payload spans multiple calls is it copied into _oscString.
+        std::wstring_view _oscView;
         std::wstring _oscString;
         size_t _oscParameter;
 
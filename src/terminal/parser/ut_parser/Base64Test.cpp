@@ -85,4 +85,127 @@ class Microsoft::Console::VirtualTerminal::Base64Test
         success = Base64::s_Decode(L"Zm9vYg=", result);
         VERIFY_ARE_EQUAL(false, success);
     }
+
+    TEST_METHOD(TestBase64EncodeUtf8)
+    {
+        VERIFY_ARE_EQUAL(L"w6l0w6k=", Base64::s_Encode(L"\x00e9t\x00e9"));
+        VERIFY_ARE_EQUAL(L"4oKsMTAw", Base64::s_Encode(L"\x20ac" L"100"));
+        VERIFY_ARE_EQUAL(L"8J+Ygg==", Base64::s_Encode(L"\xD83D\xDE02"));
+    }
+
+    TEST_METHOD(TestBase64DecodeUtf8)
+    {
+        std::wstring result;
+
+        VERIFY_IS_TRUE(Base64::s_Decode(L"w6l0w6k=", result));
+        VERIFY_ARE_EQUAL(L"\x00e9t\x00e9", result);
+
+        result = L"";
+        VERIFY_IS_TRUE(Base64::s_Decode(L"4oKs\r\nMTAw", result));
+        VERIFY_ARE_EQUAL(L"\x20ac" L"100", result);
+
+        result = L"";
+        VERIFY_IS_TRUE(Base64::s_Decode(L"8J+Ygg==", result));
+        VERIFY_ARE_EQUAL(L"\xD83D\xDE02", result);
+
+        Log::Comment(L"Decoded text is appended to the existing content.");
+        result = L"foo";
+        VERIFY_IS_TRUE(Base64::s_Decode(L"YmFy", result));
+        VERIFY_ARE_EQUAL(L"foobar", result);
+    }
+
+    TEST_METHOD(TestBase64DecodeInvalid)
+    {
+        // Long enough to be decoded in blocks, with a single bad character at various positions.
+        const std::wstring valid = Base64::s_Encode(std::wstring(300, L'x'));
+
+        for (const auto bad : { L'!', L'-', L'_', L'\0', L'\x00c3', L'\x0141', L'\xff41', L'\x2028' })
+        {
+            for (size_t i = 0; i < valid.size(); i += 7)
+            {
+                auto input = valid;
+                input[i] = bad;
+
+                std::wstring result{ L"UNCHANGED" };
+                VERIFY_IS_FALSE(Base64::s_Decode(input, result));
+                VERIFY_ARE_EQUAL(L"UNCHANGED", result);
+            }
+        }
+
+        std::wstring result{ L"UNCHANGED" };
+        // Padding in the middle of the string.
+        VERIFY_IS_FALSE(Base64::s_Decode(L"Zm9v=Zm9v", result));
+        // Anything but whitespace after the padding.
+        VERIFY_IS_FALSE(Base64::s_Decode(L"Zm8=Zm9v", result));
+        VERIFY_IS_FALSE(Base64::s_Decode(L"Zg==\r\nZ", result));
+        // Too much padding.
+        VERIFY_IS_FALSE(Base64::s_Decode(L"Zg===", result));
+        VERIFY_ARE_EQUAL(L"UNCHANGED", result);
+    }
+
+    TEST_METHOD(TestBase64RoundTrip)
+    {
+        // A mix of 1, 2, 3 and 4 byte UTF-8 sequences, so that they end up
+        // split across block boundaries at every possible offset.
+        constexpr std::wstring_view alphabet{ L"a\x00e9\x20ac\xD83D\xDE02" };
+
+        std::wstring text;
+        for (size_t length = 0; length < 4096; length += 1 + length / 16)
+        {
+            while (text.size() < length)
+            {
+                text.append(alphabet.substr(text.size() % 4, text.size() % 4 == 3 ? 2 : 1));
+            }
+
+            const auto encoded = Base64::s_Encode(text);
+            if (text.empty())
+            {
+                VERIFY_ARE_EQUAL(L"", encoded);
+                continue;
+            }
+
+            std::wstring result;
+            VERIFY_IS_TRUE(Base64::s_Decode(encoded, result));
+            VERIFY_ARE_EQUAL(text, result);
+
+            // Line breaks every 76 characters, like most encoders produce.
+            std::wstring wrapped;
+            for (size_t i = 0; i < encoded.size(); i += 76)
+            {
+                wrapped.append(encoded.substr(i, 76)).append(L"\r\n");
+            }
+
+            result = L"";
+            VERIFY_IS_TRUE(Base64::s_Decode(wrapped, result));
+            VERIFY_ARE_EQUAL(text, result);
+        }
+    }
+
+    TEST_METHOD(TestBase64Throughput)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+        END_TEST_METHOD_PROPERTIES()
+
+        // 4 MB of text, which is what a large OSC 52 clipboard write looks like.
+        std::wstring text;
+        while (text.size() < 4 * 1024 * 1024)
+        {
+            text.append(L"The quick brown fox jumps over the lazy dog. \x00e9\x20ac\r\n");
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto encoded = Base64::s_Encode(text);
+        const auto encodeEnd = std::chrono::steady_clock::now();
+
+        std::wstring result;
+        VERIFY_IS_TRUE(Base64::s_Decode(encoded, result));
+        const auto decodeEnd = std::chrono::steady_clock::now();
+        VERIFY_ARE_EQUAL(text, result);
+
+        const auto encodeTime = std::chrono::duration_cast<std::chrono::milliseconds>(encodeEnd - start);
+        const auto decodeTime = std::chrono::duration_cast<std::chrono::milliseconds>(decodeEnd - encodeEnd);
+        Log::Comment(NoThrowString().Format(L"Encoded %zu characters in %lld ms", text.size(), encodeTime.count()));
+        Log::Comment(NoThrowString().Format(L"Decoded %zu characters in %lld ms", encoded.size(), decodeTime.count()));
+    }
 };
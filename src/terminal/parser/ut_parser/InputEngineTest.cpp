@@ -282,6 +282,8 @@ class Microsoft::Console::VirtualTerminal::InputEngineTest
     TEST_METHOD(TestWin32InputParsing);
     TEST_METHOD(TestWin32InputOptionals);
 
+    TEST_METHOD(PrintStringMatchesWriteString);
+
     friend class TestInteractDispatch;
 };
 
@@ -1565,3 +1567,49 @@ void InputEngineTest::TestWin32InputOptionals()
         }
     }
 }
+
+void InputEngineTest::PrintStringMatchesWriteString()
+{
+    std::vector<INPUT_RECORD> written;
+    size_t writes = 0;
+    auto pfn = [&](std::deque<std::unique_ptr<IInputEvent>>& inEvents) {
+        const auto records = IInputEvent::ToInputRecords(inEvents);
+        written.insert(written.end(), records.begin(), records.end());
+        ++writes;
+    };
+
+    auto dispatch = std::make_unique<TestInteractDispatch>(pfn, &testState);
+    auto engine = std::make_unique<InputStateMachineEngine>(std::move(dispatch));
+    auto stateMachine = std::make_unique<StateMachine>(std::move(engine));
+
+    // Every printable ASCII character, some that need shift, and a few that
+    // aren't on a US keyboard at all, mixed into a paste-sized string.
+    std::wstring string;
+    for (auto i = 0; i < 200; ++i)
+    {
+        for (wchar_t wch = L' '; wch < L'\x7f'; ++wch)
+        {
+            string.push_back(wch);
+        }
+        string.append(i % 10 == 0 ? L"\x041B\u65C5\x00e9" : L"Hello, World!");
+    }
+
+    std::vector<INPUT_RECORD> expected;
+    auto referencePfn = [&](std::deque<std::unique_ptr<IInputEvent>>& inEvents) {
+        expected = IInputEvent::ToInputRecords(inEvents);
+    };
+    TestInteractDispatch reference{ referencePfn, &testState };
+    reference.WriteString(string);
+
+    stateMachine->ProcessString(string);
+
+    Log::Comment(L"The string is typed with exactly the keypresses WriteString would have used.");
+    VERIFY_ARE_EQUAL(expected.size(), written.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        VERIFY_ARE_EQUAL(expected.at(i), written.at(i));
+    }
+
+    Log::Comment(L"The whole string is handed to WriteString, and written to the input at once.");
+    VERIFY_ARE_EQUAL(size_t{ 1 }, writes);
+}
@@ -336,11 +336,11 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
         mach.ProcessCharacter(L'J');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
 
-        VERIFY_ARE_EQUAL(mach._parameters.size(), 4u);
-        VERIFY_ARE_EQUAL(mach._parameters.at(0), 0u);
-        VERIFY_ARE_EQUAL(mach._parameters.at(1), 324u);
-        VERIFY_ARE_EQUAL(mach._parameters.at(2), 0u);
-        VERIFY_ARE_EQUAL(mach._parameters.at(3), 8u);
+        VERIFY_ARE_EQUAL(mach._parameters.View().size(), 4u);
+        VERIFY_ARE_EQUAL(mach._parameters.View().at(0), 0u);
+        VERIFY_ARE_EQUAL(mach._parameters.View().at(1), 324u);
+        VERIFY_ARE_EQUAL(mach._parameters.View().at(2), 0u);
+        VERIFY_ARE_EQUAL(mach._parameters.View().at(3), 8u);
     }
 
     TEST_METHOD(TestLeadingZeroCsiParam)
@@ -364,7 +364,7 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
             mach.ProcessCharacter((wchar_t)(L'1' + i));
             VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiParam);
         }
-        VERIFY_ARE_EQUAL(mach._parameters.back(), 12345u);
+        VERIFY_ARE_EQUAL(mach._parameters.View().at(0), 12345u);
         mach.ProcessCharacter(L'J');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
     }
@@ -380,11 +380,15 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Escape);
         mach.ProcessCharacter(L'[');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiEntry);
-        mach.ProcessCharacter(L':');
+        mach.ProcessCharacter(L'4');
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiParam);
+        mach.ProcessCharacter(L';');
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiParam);
+        mach.ProcessCharacter(L'?');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiIgnore);
-        mach.ProcessCharacter(L'3');
+        mach.ProcessCharacter(L'8');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiIgnore);
-        mach.ProcessCharacter(L'q');
+        mach.ProcessCharacter(L'J');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
 
         mach.ProcessCharacter(AsciiChars::ESC);
@@ -393,31 +397,119 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiEntry);
         mach.ProcessCharacter(L'4');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiParam);
-        mach.ProcessCharacter(L';');
-        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiParam);
+        mach.ProcessCharacter(L'#');
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiIntermediate);
         mach.ProcessCharacter(L':');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiIgnore);
         mach.ProcessCharacter(L'8');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiIgnore);
         mach.ProcessCharacter(L'J');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
+    }
 
+    TEST_METHOD(TestCsiSubParam)
+    {
+        auto dispatch = std::make_unique<DummyDispatch>();
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        StateMachine mach(std::move(engine));
+
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
         mach.ProcessCharacter(AsciiChars::ESC);
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Escape);
         mach.ProcessCharacter(L'[');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiEntry);
-        mach.ProcessCharacter(L'4');
+        mach.ProcessCharacter(L':');
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiParam);
+        mach.ProcessCharacter(L'3');
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiParam);
+        mach.ProcessCharacter(L';');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiParam);
+        mach.ProcessCharacter(L'3');
+        mach.ProcessCharacter(L'8');
+        mach.ProcessCharacter(L':');
+        mach.ProcessCharacter(L'2');
+        mach.ProcessCharacter(L':');
+        mach.ProcessCharacter(L':');
+        mach.ProcessCharacter(L'2');
+        mach.ProcessCharacter(L'5');
+        mach.ProcessCharacter(L'5');
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiParam);
+        mach.ProcessCharacter(L';');
+        mach.ProcessCharacter(L'1');
+        mach.ProcessCharacter(L'm');
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
+
+        const auto parameters = mach._parameters.View();
+        VERIFY_ARE_EQUAL(parameters.size(), 3u);
+        VERIFY_IS_TRUE(parameters.hasSubParameters());
+
+        // An empty parameter with a single sub-parameter.
+        VERIFY_ARE_EQUAL(parameters.at(0), 0u);
+        VERIFY_ARE_EQUAL(parameters.subParametersFor(0).size(), 1u);
+        VERIFY_ARE_EQUAL(til::at(parameters.subParametersFor(0), 0), 3u);
+
+        // Empty sub-parameters still count.
+        VERIFY_ARE_EQUAL(parameters.at(1), 38u);
+        const auto color = parameters.subParametersFor(1);
+        VERIFY_ARE_EQUAL(color.size(), 3u);
+        VERIFY_ARE_EQUAL(til::at(color, 0), 2u);
+        VERIFY_ARE_EQUAL(til::at(color, 1), 0u);
+        VERIFY_ARE_EQUAL(til::at(color, 2), 255u);
+
+        VERIFY_ARE_EQUAL(parameters.at(2), 1u);
+        VERIFY_IS_TRUE(parameters.subParametersFor(2).empty());
+
+        // A sub-parameter delimiter after an intermediate is still invalid.
+        mach.ProcessCharacter(AsciiChars::ESC);
+        mach.ProcessCharacter(L'[');
+        mach.ProcessCharacter(L'4');
         mach.ProcessCharacter(L'#');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiIntermediate);
         mach.ProcessCharacter(L':');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiIgnore);
-        mach.ProcessCharacter(L'8');
-        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiIgnore);
         mach.ProcessCharacter(L'J');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
     }
 
+    TEST_METHOD(TestCsiParamLimits)
+    {
+        auto dispatch = std::make_unique<DummyDispatch>();
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        StateMachine mach(std::move(engine));
+
+        Log::Comment(L"Parameters beyond the storage limit should be ignored.");
+        std::wstring sequence = L"\x1b[";
+        for (size_t i = 1; i <= VTParameterBuilder::MaxParameterCount + 8; i++)
+        {
+            sequence += std::to_wstring(i) + L";";
+        }
+        sequence += L"m";
+        mach.ProcessString(sequence);
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
+
+        auto parameters = mach._parameters.View();
+        VERIFY_ARE_EQUAL(parameters.size(), VTParameterBuilder::MaxParameterCount);
+        VERIFY_ARE_EQUAL(parameters.at(VTParameterBuilder::MaxParameterCount - 1), VTParameterBuilder::MaxParameterCount);
+
+        Log::Comment(L"Sub-parameters beyond the storage limit should be ignored.");
+        sequence = L"\x1b[4";
+        for (size_t i = 1; i <= VTParameterBuilder::MaxSubParameterCount + 2; i++)
+        {
+            sequence += L":" + std::to_wstring(i);
+        }
+        sequence += L";5m";
+        mach.ProcessString(sequence);
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
+
+        parameters = mach._parameters.View();
+        VERIFY_ARE_EQUAL(parameters.size(), 2u);
+        VERIFY_ARE_EQUAL(parameters.at(0), 4u);
+        VERIFY_ARE_EQUAL(parameters.subParametersFor(0).size(), VTParameterBuilder::MaxSubParameterCount);
+        VERIFY_ARE_EQUAL(til::at(parameters.subParametersFor(0), VTParameterBuilder::MaxSubParameterCount - 1), VTParameterBuilder::MaxSubParameterCount);
+        VERIFY_ARE_EQUAL(parameters.at(1), 5u);
+        VERIFY_IS_TRUE(parameters.subParametersFor(1).empty());
+    }
+
     TEST_METHOD(TestC1Osc)
     {
         auto dispatch = std::make_unique<DummyDispatch>();
@@ -747,11 +839,11 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
         mach.ProcessCharacter(L'8');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::DcsParam);
 
-        VERIFY_ARE_EQUAL(mach._parameters.size(), 4u);
-        VERIFY_ARE_EQUAL(mach._parameters.at(0), 0u);
-        VERIFY_ARE_EQUAL(mach._parameters.at(1), 324u);
-        VERIFY_ARE_EQUAL(mach._parameters.at(2), 0u);
-        VERIFY_ARE_EQUAL(mach._parameters.at(3), 8u);
+        VERIFY_ARE_EQUAL(mach._parameters.View().size(), 4u);
+        VERIFY_ARE_EQUAL(mach._parameters.View().at(0), 0u);
+        VERIFY_ARE_EQUAL(mach._parameters.View().at(1), 324u);
+        VERIFY_ARE_EQUAL(mach._parameters.View().at(2), 0u);
+        VERIFY_ARE_EQUAL(mach._parameters.View().at(3), 8u);
 
         mach.ProcessCharacter(AsciiChars::ESC);
         mach.ProcessCharacter(L'\\');
@@ -1143,10 +1235,17 @@ public:
         return true;
     }
 
-    bool SetGraphicsRendition(const gsl::span<const DispatchTypes::GraphicsOptions> options) noexcept override
+    bool SetGraphicsRendition(const VTParameters options) noexcept override
     try
     {
-        _options.assign(options.begin(), options.end());
+        _options.clear();
+        _subParameters.clear();
+        for (size_t i = 0; i < options.size(); i++)
+        {
+            const auto subParameters = options.subParametersFor(i);
+            _options.push_back(static_cast<DispatchTypes::GraphicsOptions>(options.at(i)));
+            _subParameters.emplace_back(subParameters.begin(), subParameters.end());
+        }
         _setGraphics = true;
         return true;
     }
@@ -1434,6 +1533,7 @@ public:
     static const size_t s_cMaxOptions = 16;
     static const size_t s_uiGraphicsCleared = UINT_MAX;
     std::vector<DispatchTypes::GraphicsOptions> _options;
+    std::vector<std::vector<size_t>> _subParameters;
 };
 
 class StateMachineExternalTest final
@@ -2151,6 +2251,59 @@ class StateMachineExternalTest final
         VerifyDispatchTypes({ rgExpected, 3 }, *pDispatch);
 
         pDispatch->ClearState();
+
+        Log::Comment(L"Test 6: Test colon-delimited sub-parameters");
+
+        sequence = L"\x1b[38:2::255:128:0;4:3;48:5:42m";
+        mach.ProcessString(sequence);
+        VERIFY_IS_TRUE(pDispatch->_setGraphics);
+
+        rgExpected[0] = DispatchTypes::GraphicsOptions::ForegroundExtended;
+        rgExpected[1] = DispatchTypes::GraphicsOptions::Underline;
+        rgExpected[2] = DispatchTypes::GraphicsOptions::BackgroundExtended;
+        VerifyDispatchTypes({ rgExpected, 3 }, *pDispatch);
+        VERIFY_IS_TRUE((std::vector<size_t>{ 2, 0, 255, 128, 0 }) == pDispatch->_subParameters.at(0));
+        VERIFY_IS_TRUE((std::vector<size_t>{ 3 }) == pDispatch->_subParameters.at(1));
+        VERIFY_IS_TRUE((std::vector<size_t>{ 5, 42 }) == pDispatch->_subParameters.at(2));
+
+        pDispatch->ClearState();
+
+        Log::Comment(L"Test 7: Sub-parameters are not accepted outside of SGR");
+
+        sequence = L"\x1b[1:2H";
+        mach.ProcessString(sequence);
+        VERIFY_IS_FALSE(pDispatch->_cursorPosition);
+
+        pDispatch->ClearState();
+    }
+
+    TEST_METHOD(TestSetGraphicsRenditionPerformance)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+        END_TEST_METHOD_PROPERTIES()
+
+        auto dispatch = std::make_unique<DummyDispatch>();
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        StateMachine mach(std::move(engine));
+
+        // The kind of output a colorized diff or a true-color prompt produces,
+        // with both the legacy and the colon-delimited forms of extended colors.
+        std::wstring text;
+        for (size_t i = 0; text.size() < 4 * 1024 * 1024; i++)
+        {
+            const auto value = std::to_wstring(i % 256);
+            text.append(L"\x1b[0;1;38;2;" + value + L";64;128;48;5;" + value + L"mA");
+            text.append(L"\x1b[4:3;38:2::" + value + L":128:64;58:5:" + value + L"mB\x1b[m");
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        mach.ProcessString(text);
+        const auto end = std::chrono::steady_clock::now();
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
+
+        const auto time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        Log::Comment(NoThrowString().Format(L"Parsed %zu characters of SGR sequences in %lld ms", text.size(), time.count()));
     }
 
     TEST_METHOD(TestDeviceStatusReport)
@@ -2627,6 +2780,12 @@ class StateMachineExternalTest final
 
         pDispatch->ClearState();
 
+        // The decoded `Pd` param is UTF-8.
+        mach.ProcessString(L"\x1b]52;;w6l0w6kg8J+Ygg==\x07");
+        VERIFY_ARE_EQUAL(L"\x00e9t\x00e9 \xD83D\xDE02", pDispatch->_copyContent);
+
+        pDispatch->ClearState();
+
         // Passing a non-empty `Pc` param (`s0` is ignored) and a valid `Pd` param works.
         mach.ProcessString(L"\x1b]52;s0;Zm9v\x07");
         VERIFY_ARE_EQUAL(L"foo", pDispatch->_copyContent);
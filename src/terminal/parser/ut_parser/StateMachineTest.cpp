@@ -33,6 +33,10 @@ public:
         printed.clear();
         passedThrough.clear();
         csiParams.reset();
+        oscString.clear();
+        oscParameter = 0;
+        oscPayload = nullptr;
+        oscDispatchCount = 0;
     }
 
     bool ActionExecute(const wchar_t /* wch */) override { return true; };
@@ -52,16 +56,21 @@ public:
 
     bool ActionEscDispatch(const VTID /* id */) override { return true; };
 
-    bool ActionVt52EscDispatch(const VTID /*id*/, const gsl::span<const size_t> /*parameters*/) override { return true; };
+    bool ActionVt52EscDispatch(const VTID /*id*/, const VTParameters /*parameters*/) override { return true; };
 
     bool ActionClear() override { return true; };
 
     bool ActionIgnore() override { return true; };
 
     bool ActionOscDispatch(const wchar_t /* wch */,
-                           const size_t /* parameter */,
-                           const std::wstring_view /* string */) override
+                           const size_t parameter,
+                           const std::wstring_view string) override
     {
+        oscParameter = parameter;
+        oscString = string;
+        oscPayload = string.data();
+        ++oscDispatchCount;
+
         if (pfnFlushToTerminal)
         {
             pfnFlushToTerminal();
@@ -71,7 +80,7 @@ public:
     };
 
     bool ActionSs3Dispatch(const wchar_t /* wch */,
-                           const gsl::span<const size_t> /* parameters */) override { return true; };
+                           const VTParameters /* parameters */) override { return true; };
 
     bool ParseControlSequenceAfterSs3() const override { return false; }
     bool FlushAtEndOfString() const override { return false; };
@@ -79,7 +88,7 @@ public:
     bool DispatchIntermediatesFromEscape() const override { return false; };
 
     // ActionCsiDispatch is the only method that's actually implemented.
-    bool ActionCsiDispatch(const VTID /*id*/, const gsl::span<const size_t> parameters) override
+    bool ActionCsiDispatch(const VTID /*id*/, const VTParameters parameters) override
     {
         // If flush to terminal is registered for a test, then use it.
         if (pfnFlushToTerminal)
@@ -97,6 +106,15 @@ public:
     // This will only be populated if ActionCsiDispatch is called.
     std::optional<std::vector<size_t>> csiParams;
 
+    // These will only be populated if ActionOscDispatch is called.
+    std::wstring oscString;
+    size_t oscParameter{ 0 };
+    size_t oscDispatchCount{ 0 };
+
+    // The address of the last dispatched OSC payload. Used to check whether the
+    // payload was handed over as a view of the input rather than a copy.
+    const wchar_t* oscPayload{ nullptr };
+
     // Flush function for pass-through test.
     std::function<bool()> pfnFlushToTerminal;
 
@@ -127,6 +145,14 @@ class Microsoft::Console::VirtualTerminal::StateMachineTest
     TEST_METHOD(RunStorageBeforeEscape);
     TEST_METHOD(BulkTextPrint);
     TEST_METHOD(PassThroughUnhandledSplitAcrossWrites);
+
+    TEST_METHOD(OscStringFromSingleWriteIsNotCopied);
+    TEST_METHOD(OscStringSplitAcrossWrites);
+    TEST_METHOD(OscStringIgnoresInvalidCharacters);
+    TEST_METHOD(OscStringIsReleasedAfterDispatch);
+    TEST_METHOD(DcsPassThroughSplitAcrossWrites);
+
+    TEST_METHOD(OscSetClipboardPerformance);
 };
 
 void StateMachineTest::TwoStateMachinesDoNotInterfereWithEachother()
@@ -244,3 +270,202 @@ void StateMachineTest::PassThroughUnhandledSplitAcrossWrites()
     VERIFY_ARE_EQUAL(L"\x1b]99;foo\x1b\\", engine.passedThrough);
     VERIFY_ARE_EQUAL(L"", engine.printed);
 }
+
+void StateMachineTest::OscStringFromSingleWriteIsNotCopied()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    const std::wstring_view belTerminated{ L"\x1b]52;c;Zm9vYmFy\x07" };
+    machine.ProcessString(belTerminated);
+    VERIFY_ARE_EQUAL(1u, engine.oscDispatchCount);
+    VERIFY_ARE_EQUAL(52u, engine.oscParameter);
+    VERIFY_ARE_EQUAL(L"c;Zm9vYmFy", engine.oscString);
+    Log::Comment(L"The payload should point directly into the input string.");
+    VERIFY_IS_TRUE(belTerminated.data() + 5 == engine.oscPayload);
+
+    engine.ResetTestState();
+
+    const std::wstring_view stTerminated{ L"Hello\x1b]0;title\x1b\\World" };
+    machine.ProcessString(stTerminated);
+    VERIFY_ARE_EQUAL(1u, engine.oscDispatchCount);
+    VERIFY_ARE_EQUAL(0u, engine.oscParameter);
+    VERIFY_ARE_EQUAL(L"title", engine.oscString);
+    VERIFY_IS_TRUE(stTerminated.data() + 9 == engine.oscPayload);
+    VERIFY_ARE_EQUAL(L"HelloWorld", engine.printed);
+
+    engine.ResetTestState();
+
+    const std::wstring_view c1Terminated{ L"\x9d"
+                                          L"2;title\x9c" };
+    machine.ProcessString(c1Terminated);
+    VERIFY_ARE_EQUAL(1u, engine.oscDispatchCount);
+    VERIFY_ARE_EQUAL(2u, engine.oscParameter);
+    VERIFY_ARE_EQUAL(L"title", engine.oscString);
+    VERIFY_IS_TRUE(c1Terminated.data() + 3 == engine.oscPayload);
+}
+
+void StateMachineTest::OscStringSplitAcrossWrites()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    const std::wstring_view sequences[] = {
+        L"\x1b]52;c;SGVsbG8gV29ybGQ=\x07",
+        L"\x1b]52;c;SGVsbG8gV29ybGQ=\x1b\\",
+        L"\x1b]52;c;SGVsbG8gV29ybGQ=\x9c",
+    };
+
+    for (const auto sequence : sequences)
+    {
+        // Split the sequence in two at every possible position.
+        for (size_t split = 1; split < sequence.size(); split++)
+        {
+            Log::Comment(NoThrowString().Format(L"Splitting at %zu", split));
+            engine.ResetTestState();
+
+            // Copy the pieces so that any view the state machine holds onto
+            // across writes would be pointing at freed memory.
+            auto first = std::make_unique<std::wstring>(sequence.substr(0, split));
+            machine.ProcessString(*first);
+            first.reset();
+            VERIFY_ARE_EQUAL(0u, engine.oscDispatchCount);
+
+            machine.ProcessString(std::wstring{ sequence.substr(split) });
+            VERIFY_ARE_EQUAL(1u, engine.oscDispatchCount);
+            VERIFY_ARE_EQUAL(52u, engine.oscParameter);
+            VERIFY_ARE_EQUAL(L"c;SGVsbG8gV29ybGQ=", engine.oscString);
+            VERIFY_ARE_EQUAL(L"", engine.printed);
+        }
+
+        // Then feed it through one character at a time.
+        engine.ResetTestState();
+        for (const auto wch : sequence)
+        {
+            machine.ProcessString(std::wstring(1, wch));
+        }
+        VERIFY_ARE_EQUAL(1u, engine.oscDispatchCount);
+        VERIFY_ARE_EQUAL(L"c;SGVsbG8gV29ybGQ=", engine.oscString);
+    }
+
+    Log::Comment(L"Three pieces, with the payload split twice.");
+    engine.ResetTestState();
+    machine.ProcessString(L"\x1b]0;Hel");
+    machine.ProcessString(L"lo Wor");
+    machine.ProcessString(L"ld\x07Printed");
+    VERIFY_ARE_EQUAL(1u, engine.oscDispatchCount);
+    VERIFY_ARE_EQUAL(L"Hello World", engine.oscString);
+    VERIFY_ARE_EQUAL(L"Printed", engine.printed);
+
+    Log::Comment(L"A split payload followed by a single write payload shouldn't leak into each other.");
+    engine.ResetTestState();
+    machine.ProcessString(L"\x1b]0;first");
+    machine.ProcessString(L"\x07\x1b]0;second\x07");
+    VERIFY_ARE_EQUAL(2u, engine.oscDispatchCount);
+    VERIFY_ARE_EQUAL(L"second", engine.oscString);
+}
+
+void StateMachineTest::OscStringIsReleasedAfterDispatch()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    Log::Comment(L"A payload dispatched from a single write isn't copied at the end of the write.");
+    machine.ProcessString(L"\x1b]52;c;Zm9vYmFy\x07Printed");
+    VERIFY_ARE_EQUAL(1u, engine.oscDispatchCount);
+    VERIFY_IS_TRUE(machine._oscView.empty());
+    VERIFY_IS_TRUE(machine._oscString.empty());
+
+    Log::Comment(L"Nor is one that was accumulated across writes kept around.");
+    engine.ResetTestState();
+    machine.ProcessString(L"\x1b]52;c;Zm9v");
+    VERIFY_IS_FALSE(machine._oscString.empty());
+    machine.ProcessString(L"YmFy\x1b\\");
+    VERIFY_ARE_EQUAL(1u, engine.oscDispatchCount);
+    VERIFY_ARE_EQUAL(L"c;Zm9vYmFy", engine.oscString);
+    VERIFY_IS_TRUE(machine._oscView.empty());
+    VERIFY_IS_TRUE(machine._oscString.empty());
+}
+
+void StateMachineTest::OscStringIgnoresInvalidCharacters()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    machine.ProcessString(L"\x1b]0;ab\x01"
+                          L"cd\x1f"
+                          L"ef\x07");
+    VERIFY_ARE_EQUAL(1u, engine.oscDispatchCount);
+    VERIFY_ARE_EQUAL(L"abcdef", engine.oscString);
+
+    engine.ResetTestState();
+
+    Log::Comment(L"CAN should abort the OSC string without dispatching it.");
+    machine.ProcessString(L"\x1b]0;abc\x18"
+                          L"def");
+    VERIFY_ARE_EQUAL(0u, engine.oscDispatchCount);
+    VERIFY_ARE_EQUAL(L"def", engine.printed);
+}
+
+void StateMachineTest::DcsPassThroughSplitAcrossWrites()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    machine.ProcessString(L"\x1bP1$tx");
+    machine.ProcessString(L"some data string");
+    machine.ProcessString(L"\x1b");
+    machine.ProcessString(L"\\Printed");
+    VERIFY_ARE_EQUAL(L"Printed", engine.printed);
+
+    engine.ResetTestState();
+
+    machine.ProcessString(L"\x1bPq#0;2;0;0;0#1;2;100;100;0#1~~@@vv@@~~@@~~$\x1b\\Printed");
+    VERIFY_ARE_EQUAL(L"Printed", engine.printed);
+}
+
+void StateMachineTest::OscSetClipboardPerformance()
+{
+    BEGIN_TEST_METHOD_PROPERTIES()
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD_PROPERTIES()
+
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    // An OSC 52 with 1 MB of base64 payload.
+    constexpr size_t payloadSize = 1024 * 1024;
+    std::wstring sequence{ L"\x1b]52;c;" };
+    for (size_t i = 0; i < payloadSize; i++)
+    {
+        sequence.push_back(L"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[i % 64]);
+    }
+    sequence.push_back(L'\x07');
+
+    Log::Comment(L"Processing the sequence in a single write.");
+    machine.ProcessString(sequence);
+    VERIFY_ARE_EQUAL(1u, engine.oscDispatchCount);
+    VERIFY_ARE_EQUAL(payloadSize + 2, engine.oscString.size());
+
+    Log::Comment(L"Processing the sequence in 4 KB writes.");
+    engine.ResetTestState();
+    const std::wstring_view view{ sequence };
+    for (size_t offset = 0; offset < view.size(); offset += 4096)
+    {
+        machine.ProcessString(view.substr(offset, 4096));
+    }
+    VERIFY_ARE_EQUAL(1u, engine.oscDispatchCount);
+    VERIFY_ARE_EQUAL(payloadSize + 2, engine.oscString.size());
+}
@@ -3,6 +3,7 @@
 
 #include "precomp.h"
 #include "inc/CodepointWidthDetector.hpp"
+#include "inc/Utf16Parser.hpp"
 
 namespace
 {
@@ -353,6 +354,7 @@ namespace
 // - Constructs an instance of the CodepointWidthDetector class
 CodepointWidthDetector::CodepointWidthDetector() noexcept :
     _fallbackCache{},
+    _fontGeneration{ 1 },
     _pfnFallbackMethod{}
 {
 }
@@ -368,37 +370,65 @@ CodepointWidth CodepointWidthDetector::GetWidth(const std::wstring_view glyph) c
     THROW_HR_IF(E_INVALIDARG, glyph.empty());
     if (glyph.size() == 1)
     {
-        // We first attempt to look at our custom quick lookup table of char width preferences.
-        const auto width = GetQuickCharWidth(glyph.front());
+        return _getBmpWidth(glyph.front());
+    }
+    else
+    {
+        return _lookupGlyphWidthWithCache(glyph);
+    }
+}
+
+// Routine Description:
+// - Measures the glyphs at the start of the given text in one go, so that
+//   walking a string doesn't look up each glyph separately. Printable ASCII
+//   is narrow without a lookup, the rest of the BMP is measured with a
+//   table, and surrogate pairs are measured as one glyph.
+// - Measuring stops after 64 characters, or at a surrogate that isn't part
+//   of a pair. Such text has to be measured glyph by glyph.
+// Arguments:
+// - text - the utf16 encoded text to measure
+// Return Value:
+// - the widths of the glyphs that were measured
+GlyphWidthRun CodepointWidthDetector::MeasureRun(const std::wstring_view text) const noexcept
+{
+    GlyphWidthRun run{};
+    const auto limit = std::min<size_t>(text.size(), 64);
 
-        // If it's invalid, the quick width had no opinion, so go to the lookup table.
-        if (width == CodepointWidth::Invalid)
+    while (run.length < limit)
+    {
+        const auto wch = til::at(text, run.length);
+        const auto bit = uint64_t{ 1 } << run.length;
+
+        if (wch >= 0x20 && wch <= 0x7e)
         {
-            return _lookupGlyphWidthWithCache(glyph);
+            run.length++;
         }
-        // If it's ambiguous, the quick width wanted us to ask the font directly, try that if we can.
-        // If not, go to the lookup table.
-        else if (width == CodepointWidth::Ambiguous)
+        else if (!Utf16Parser::IsLeadingSurrogate(wch) && !Utf16Parser::IsTrailingSurrogate(wch))
         {
-            if (_pfnFallbackMethod)
+            if (_getBmpWidth(wch) == CodepointWidth::Wide)
             {
-                return _checkFallbackViaCache(glyph) ? CodepointWidth::Wide : CodepointWidth::Ambiguous;
+                run.wide |= bit;
             }
-            else
+            run.length++;
+        }
+        else if (Utf16Parser::IsLeadingSurrogate(wch) &&
+                 run.length + 1 < limit &&
+                 Utf16Parser::IsTrailingSurrogate(til::at(text, run.length + 1)))
+        {
+            if (_lookupGlyphWidthWithCache(text.substr(run.length, 2)) == CodepointWidth::Wide)
             {
-                return _lookupGlyphWidthWithCache(glyph);
+                run.wide |= bit;
             }
+            run.pairs |= bit;
+            run.length += 2;
         }
-        // Otherwise, return Width as it is.
         else
         {
-            return width;
+            break;
         }
     }
-    else
-    {
-        return _lookupGlyphWidthWithCache(glyph);
-    }
+
+    return run;
 }
 
 // Routine Description:
@@ -429,13 +459,75 @@ bool CodepointWidthDetector::IsWide(const std::wstring_view glyph) const
     return GetWidth(glyph) == CodepointWidth::Wide;
 }
 
+// Routine Description:
+// - Gets the widths of all the BMP characters, built the first time they're
+//   needed. Each is what GetQuickCharWidth or, failing that, the lookup table
+//   says, with AskFontFlag set if the font gets the last word on it.
+// Arguments:
+// - <none>
+// Return Value:
+// - the width of each BMP character
+const std::array<BYTE, 0x10000>& CodepointWidthDetector::_getBmpWidths() noexcept
+{
+    static const auto widths = []() noexcept {
+        std::array<BYTE, 0x10000> widths{};
+        for (size_t i = 0; i < widths.size(); ++i)
+        {
+            const auto wch = gsl::narrow_cast<wchar_t>(i);
+
+            // The quick width has the first say. If it's invalid it has no
+            // opinion, so go to the lookup table. If it's ambiguous, it
+            // wants us to ask the font, or if we can't, the lookup table.
+            const auto quickWidth = GetQuickCharWidth(wch);
+            if (quickWidth == CodepointWidth::Narrow || quickWidth == CodepointWidth::Wide)
+            {
+                til::at(widths, i) = static_cast<BYTE>(quickWidth);
+                continue;
+            }
+
+            const auto width = _lookupGlyphWidth({ &wch, 1 });
+            til::at(widths, i) = static_cast<BYTE>(width);
+            if (quickWidth == CodepointWidth::Ambiguous || width == CodepointWidth::Ambiguous)
+            {
+                til::at(widths, i) |= AskFontFlag;
+            }
+        }
+        return widths;
+    }();
+    return widths;
+}
+
+// Routine Description:
+// - returns the width type of a BMP character, asking the font through the
+//   fallback cache if it's ambiguous.
+// Arguments:
+// - wch - the character to check the width of
+// Return Value:
+// - the width type of the character
+CodepointWidth CodepointWidthDetector::_getBmpWidth(const wchar_t wch) const noexcept
+{
+    const auto width = til::at(_getBmpWidths(), wch);
+    if (WI_IsFlagSet(width, AskFontFlag) && _pfnFallbackMethod)
+    {
+        try
+        {
+            return _checkFallbackViaCache({ &wch, 1 }) ? CodepointWidth::Wide : CodepointWidth::Ambiguous;
+        }
+        CATCH_LOG();
+
+        // It's better to be too wide than too narrow.
+        return CodepointWidth::Wide;
+    }
+    return static_cast<CodepointWidth>(WI_ClearAllFlags(width, AskFontFlag));
+}
+
 // Routine Description:
 // - returns the width type of codepoint by searching the map generated from the unicode spec
 // Arguments:
 // - glyph - the utf16 encoded codepoint to search for
 // Return Value:
 // - the width type of the codepoint
-CodepointWidth CodepointWidthDetector::_lookupGlyphWidth(const std::wstring_view glyph) const
+CodepointWidth CodepointWidthDetector::_lookupGlyphWidth(const std::wstring_view glyph)
 {
     if (glyph.empty())
     {
@@ -497,25 +589,27 @@ CodepointWidth CodepointWidthDetector::_lookupGlyphWidthWithCache(const std::wst
 // - Checks the fallback function but caches the results until the font changes
 //   because the lookup function is usually very expensive and will return the same results
 //   for the same inputs.
+// - The cache is a fixed number of slots indexed by a hash of the codepoint,
+//   which are read and written without a lock. Two threads asking about the
+//   same glyph at once may both ask the font, but they get the same answer.
 // Arguments:
 // - glyph - the utf16 encoded codepoint to check width of
 // - true if codepoint is wide or false if it is narrow
 bool CodepointWidthDetector::_checkFallbackViaCache(const std::wstring_view glyph) const
 {
-    const std::wstring findMe{ glyph };
+    const auto codepoint = _extractCodepoint(glyph);
+    const uint64_t generation = _fontGeneration.load(std::memory_order_relaxed);
+    auto& slot = til::at(_fallbackCache, (codepoint * 2654435761u >> 20) % FallbackCacheSize);
 
-    // TODO: Cache needs to be emptied when font changes.
-    const auto it = _fallbackCache.find(findMe);
-    if (it == _fallbackCache.end())
-    {
-        auto result = _pfnFallbackMethod(glyph);
-        _fallbackCache.insert_or_assign(findMe, result);
-        return result;
-    }
-    else
+    const auto entry = slot.load(std::memory_order_relaxed);
+    if ((entry >> 32) == generation && (entry & FallbackCodepointMask) == codepoint)
     {
-        return it->second;
+        return WI_IsFlagSet(entry, FallbackWideFlag);
     }
+
+    const auto result = _pfnFallbackMethod(glyph);
+    slot.store(generation << 32 | (result ? FallbackWideFlag : 0) | codepoint, std::memory_order_relaxed);
+    return result;
 }
 
 // Routine Description:
@@ -568,5 +662,5 @@ void CodepointWidthDetector::SetFallbackMethod(std::function<bool(const std::wst
 // - <none>
 void CodepointWidthDetector::NotifyFontChanged() const noexcept
 {
-    _fallbackCache.clear();
+    _fontGeneration.fetch_add(1, std::memory_order_relaxed);
 }
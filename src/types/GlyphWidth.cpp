@@ -25,6 +25,14 @@ bool IsGlyphFullWidth(const wchar_t wch) noexcept
     return widthDetector.IsWide(wch);
 }
 
+// Function Description:
+// - measures the glyphs at the start of the string all at once.
+//      See CodepointWidthDetector::MeasureRun
+GlyphWidthRun MeasureGlyphRun(const std::wstring_view text) noexcept
+{
+    return widthDetector.MeasureRun(text);
+}
+
 // Function Description:
 // - Sets a function that should be used by the global CodepointWidthDetector
 //      as the fallback mechanism for determining a particular glyph's width,
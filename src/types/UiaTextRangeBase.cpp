@@ -534,15 +534,23 @@ try
         bufferSize.DecrementInBounds(inclusiveEnd, true);
 
         const auto textRects = buffer.GetTextRects(_start, inclusiveEnd, _blockRange);
-        const auto bufferData = buffer.GetText(true,
-                                               false,
-                                               textRects);
 
-        const size_t textDataSize = base::ClampMul(bufferData.text.size(), bufferSize.Width());
+        const size_t textDataSize = base::ClampMul(textRects.size(), bufferSize.Width() + 2);
         textData.reserve(textDataSize);
-        for (const auto& text : bufferData.text)
+        for (size_t i = 0; i < textRects.size(); ++i)
         {
-            textData += text;
+            // The text of rows that haven't changed since they were last read
+            // comes out of the buffer's cache.
+            const auto& rect = til::at(textRects, i);
+            textData += buffer.GetRowText(rect);
+
+            // Like GetText, every row but the last ends in a CR/LF, unless it
+            // wraps onto the next one.
+            if (i < textRects.size() - 1 && !buffer.GetRowByOffset(rect.Top).GetCharRow().WasWrapForced())
+            {
+                textData.push_back(UNICODE_CARRIAGERETURN);
+                textData.push_back(UNICODE_LINEFEED);
+            }
         }
     }
 
@@ -14,6 +14,7 @@ Author:
 #pragma once
 
 #include "convert.hpp"
+#include "GlyphWidth.hpp"
 #include <functional>
 
 static_assert(sizeof(unsigned int) == sizeof(wchar_t) * 2,
@@ -33,6 +34,7 @@ public:
     CodepointWidth GetWidth(const std::wstring_view glyph) const;
     bool IsWide(const std::wstring_view glyph) const;
     bool IsWide(const wchar_t wch) const noexcept;
+    GlyphWidthRun MeasureRun(const std::wstring_view text) const noexcept;
     void SetFallbackMethod(std::function<bool(const std::wstring_view)> pfnFallback);
     void NotifyFontChanged() const noexcept;
 
@@ -41,11 +43,26 @@ public:
 #endif
 
 private:
-    CodepointWidth _lookupGlyphWidth(const std::wstring_view glyph) const;
+    // Set in the width of a BMP character if the font should be asked about it.
+    static constexpr BYTE AskFontFlag = 0x80;
+
+    // The fallback cache keeps the answers for this many codepoints at most.
+    // A codepoint whose slot is taken by another simply asks the font again.
+    static constexpr size_t FallbackCacheSize = 4096;
+    static constexpr uint64_t FallbackCodepointMask = 0x1FFFFF;
+    static constexpr uint64_t FallbackWideFlag = 0x200000;
+
+    static const std::array<BYTE, 0x10000>& _getBmpWidths() noexcept;
+    CodepointWidth _getBmpWidth(const wchar_t wch) const noexcept;
+    static CodepointWidth _lookupGlyphWidth(const std::wstring_view glyph);
     CodepointWidth _lookupGlyphWidthWithCache(const std::wstring_view glyph) const noexcept;
     bool _checkFallbackViaCache(const std::wstring_view glyph) const;
     static unsigned int _extractCodepoint(const std::wstring_view glyph) noexcept;
 
-    mutable std::unordered_map<std::wstring, bool> _fallbackCache;
+    // Each slot holds a codepoint, whether it's wide and the generation of
+    // the font it was measured with. Any thread may read or replace a slot,
+    // and changing the font just starts a new generation.
+    mutable std::array<std::atomic<uint64_t>, FallbackCacheSize> _fallbackCache;
+    mutable std::atomic<uint32_t> _fontGeneration;
     std::function<bool(std::wstring_view)> _pfnFallbackMethod;
 };
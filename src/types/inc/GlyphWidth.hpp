@@ -9,10 +9,24 @@ Abstract:
 
 */
 
+#pragma once
+
 #include <functional>
 #include <string_view>
 
+// The widths of the glyphs at the start of a string, see MeasureGlyphRun.
+struct GlyphWidthRun
+{
+    // The number of characters measured, at most 64.
+    size_t length;
+    // Bit i is set if the glyph that starts at character i is wide.
+    uint64_t wide;
+    // Bit i is set if character i starts a surrogate pair, which is one glyph.
+    uint64_t pairs;
+};
+
 bool IsGlyphFullWidth(const std::wstring_view glyph);
 bool IsGlyphFullWidth(const wchar_t wch) noexcept;
+GlyphWidthRun MeasureGlyphRun(const std::wstring_view text) noexcept;
 void SetGlyphWidthFallback(std::function<bool(std::wstring_view)> pfnFallback);
 void NotifyGlyphWidthFontChanged() noexcept;